@@ -0,0 +1,240 @@
+﻿#include "DirectoryModel.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace ace::editor
+{
+    namespace {
+        char Fold(char c) { return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c; }
+
+        // Packs case-folded name bytes [from, from + count) into an integer
+        // that orders like them, most significant first
+        uint64_t PackFolded(std::string_view name, size_t from, size_t count)
+        {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t c = from + i < name.size() ? (uint8_t)Fold(name[from + i]) : 0;
+                bits = bits << 8 | c;
+            }
+            return bits;
+        }
+
+        constexpr size_t kKeyBytes = 15;        // name bytes held in the sort key
+
+        // Names ignoring case, then as stored so the order is total. Bytes
+        // before 'from' are known to be equal ignoring case.
+        int CompareNames(std::string_view a, std::string_view b, size_t from = 0)
+        {
+            const size_t n = std::min(a.size(), b.size());
+            for (size_t i = from; i < n; ++i) {
+                const uint8_t ca = (uint8_t)Fold(a[i]), cb = (uint8_t)Fold(b[i]);
+                if (ca != cb) return ca < cb ? -1 : 1;
+            }
+            if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+            return a.compare(b);
+        }
+
+        // Calls fn(name, isDir) for each folder and regular file in 'dir'.
+        // directory_iterator builds and parses a full path per entry, which
+        // is most of the cost of listing a large folder; the native calls
+        // hand out bare names, with the type for all but links.
+#ifdef _WIN32
+        template<class Fn>
+        bool ForEachEntry(const std::filesystem::path& dir, Fn&& fn)
+        {
+            WIN32_FIND_DATAW fd;
+            HANDLE h = FindFirstFileExW((dir / L"*").c_str(), FindExInfoBasic, &fd,
+                                        FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+            if (h == INVALID_HANDLE_VALUE) return false;
+            do {
+                const wchar_t* n = fd.cFileName;
+                if (n[0] == L'.' && (n[1] == 0 || (n[1] == L'.' && n[2] == 0))) continue;
+                if (fd.dwFileAttributes & FILE_ATTRIBUTE_DEVICE) continue;
+                fn(std::filesystem::path(n).string(), (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+            } while (FindNextFileW(h, &fd));
+            FindClose(h);
+            return true;
+        }
+#else
+        template<class Fn>
+        bool ForEachEntry(const std::filesystem::path& dir, Fn&& fn)
+        {
+            DIR* d = opendir(dir.c_str());
+            if (!d) return false;
+            while (const dirent* e = readdir(d)) {
+                const char* n = e->d_name;
+                if (n[0] == '.' && (n[1] == 0 || (n[1] == '.' && n[2] == 0))) continue;
+                bool isDir = e->d_type == DT_DIR, isFile = e->d_type == DT_REG;
+                if (e->d_type == DT_LNK || e->d_type == DT_UNKNOWN) {
+                    // Links count as what they point to, like is_directory()
+                    struct stat st;
+                    if (fstatat(dirfd(d), n, &st, 0) != 0) continue;
+                    isDir = S_ISDIR(st.st_mode);
+                    isFile = S_ISREG(st.st_mode);
+                }
+                if (isDir || isFile) fn(std::string_view(n), isDir);
+            }
+            closedir(d);
+            return true;
+        }
+#endif
+    }
+
+    bool ForEachDirectoryEntry(const std::filesystem::path& dir,
+                               const std::function<void(std::string_view name, bool isDir)>& fn)
+    {
+        return ForEachEntry(dir, fn);
+    }
+
+    int CompareFileNames(std::string_view a, std::string_view b)
+    {
+        return CompareNames(a, b);
+    }
+
+    const std::filesystem::path& DirectoryModel::Path(size_t i) const
+    {
+        auto& p = Paths[i];
+        if (p.empty()) {
+            p = BaseDir / std::filesystem::path(Key(i));
+            if (!Listing) p.make_preferred();
+        }
+        return p;
+    }
+
+    void DirectoryModel::Reset(const std::filesystem::path& base, bool listing)
+    {
+        BaseDir = base;
+        Listing = listing;
+        Filter.clear();
+        Items.clear();
+        Text.clear();
+        Paths.clear();
+    }
+
+    void DirectoryModel::Clear()
+    {
+        Reset({}, false);
+        Items.shrink_to_fit();
+        Text.shrink_to_fit();
+        Paths.shrink_to_fit();
+    }
+
+    DirectoryModel::Item DirectoryModel::Add(std::string_view key, size_t nameStart, bool isDir)
+    {
+        Item item;
+        SetSortKey(item, key.substr(nameStart), isDir);
+        item.Offset = (uint32_t)Text.size();
+        item.Length = (uint16_t)key.size();
+        item.NameStart = (uint16_t)nameStart;
+        item.Flags = isDir ? kDir : 0;
+        Text.append(key);
+        return item;
+    }
+
+    bool DirectoryModel::Matches(std::string_view name) const
+    {
+        if (Filter.empty()) return true;
+        return std::search(name.begin(), name.end(), Filter.begin(), Filter.end(),
+                           [](char a, char b) { return Fold(a) == b; }) != name.end();
+    }
+
+    void DirectoryModel::SetSortKey(Item& item, std::string_view name, bool isDir)
+    {
+        item.SortKey[0] = (isDir ? 0 : 1ull << 63) | PackFolded(name, 0, 7);
+        item.SortKey[1] = PackFolded(name, 7, 8);
+    }
+
+    bool DirectoryModel::Less(const Item& a, const Item& b) const
+    {
+        if (a.SortKey[0] != b.SortKey[0]) return a.SortKey[0] < b.SortKey[0];
+        if (a.SortKey[1] != b.SortKey[1]) return a.SortKey[1] < b.SortKey[1];
+        return CompareNames(NameOf(a), NameOf(b), kKeyBytes) < 0;
+    }
+
+    bool DirectoryModel::List(const std::filesystem::path& dir, std::string_view filter)
+    {
+        ACE_PROFILE_FUNCTION();
+        Reset(dir, true);
+        Filter.assign(filter);
+        for (char& c : Filter) c = Fold(c);
+
+        const bool read = ForEachEntry(dir, [&](std::string_view name, bool isDir) {
+            if (name.size() <= UINT16_MAX && Matches(name)) Items.push_back(Add(name, 0, isDir));
+        });
+        {
+            ACE_PROFILE_SCOPE("DirectoryModel::Sort");
+            std::sort(Items.begin(), Items.end(), [this](const Item& a, const Item& b) { return Less(a, b); });
+        }
+        Paths.resize(Items.size());
+        return read;
+    }
+
+    void DirectoryModel::Assign(const std::filesystem::path& root, const std::vector<SearchHit>& hits)
+    {
+        Reset(root, false);
+        Items.reserve(hits.size());
+        for (const auto& h : hits) {
+            if (h.Path.size() > UINT16_MAX) continue;
+            const size_t slash = h.Path.rfind('/');
+            Items.push_back(Add(h.Path, slash == std::string::npos ? 0 : slash + 1, h.IsDir));
+        }
+        Paths.resize(Items.size());
+    }
+
+    size_t DirectoryModel::IndexOf(std::string_view name) const
+    {
+        // The key is unknown without the type, so try both places
+        for (const bool isDir : {true, false}) {
+            Item probe;
+            SetSortKey(probe, name, isDir);
+            const auto it = std::lower_bound(Items.begin(), Items.end(), probe, [&](const Item& a, const Item& p) {
+                if (a.SortKey[0] != p.SortKey[0]) return a.SortKey[0] < p.SortKey[0];
+                if (a.SortKey[1] != p.SortKey[1]) return a.SortKey[1] < p.SortKey[1];
+                return CompareNames(NameOf(a), name, kKeyBytes) < 0;
+            });
+            if (it != Items.end() && NameOf(*it) == name && IsDir((size_t)(it - Items.begin())) == isDir)
+                return (size_t)(it - Items.begin());
+        }
+        return SIZE_MAX;
+    }
+
+    bool DirectoryModel::Apply(const FileChange& change)
+    {
+        if (!Listing || change.Kind == FileChangeKind::Rescan) return false;
+        const std::string name = change.Path.filename().string();
+        const size_t at = IndexOf(name);
+
+        bool isDir = false, isFile = false;
+        if (change.Kind != FileChangeKind::Removed) {
+            std::error_code ec;
+            const auto st = std::filesystem::status(change.Path, ec);
+            isDir = std::filesystem::is_directory(st);
+            isFile = std::filesystem::is_regular_file(st);
+        }
+        if (at != SIZE_MAX) {
+            if ((isDir || isFile) && IsDir(at) == isDir) return true;     // modified in place
+            Items.erase(Items.begin() + (ptrdiff_t)at);
+            Paths.erase(Paths.begin() + (ptrdiff_t)at);
+        }
+        if ((!isDir && !isFile) || name.size() > UINT16_MAX || !Matches(name)) return true;
+
+        const Item item = Add(name, 0, isDir);
+        const auto pos = std::upper_bound(Items.begin(), Items.end(), item, [this](const Item& a, const Item& b) { return Less(a, b); });
+        const ptrdiff_t index = pos - Items.begin();
+        Items.insert(pos, item);
+        Paths.emplace(Paths.begin() + index);
+        return true;
+    }
+}
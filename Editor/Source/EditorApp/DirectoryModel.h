@@ -0,0 +1,91 @@
+﻿#pragma once
+#include "Runtime/Asset/SearchIndex.h"
+#include "Runtime/IO/FileWatcher.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ace::editor
+{
+    // Calls fn(name, isDir) for each folder and regular file in 'dir', in no
+    // particular order, using the native calls rather than directory_iterator.
+    // False if 'dir' can't be read.
+    bool ForEachDirectoryEntry(const std::filesystem::path& dir,
+                               const std::function<void(std::string_view name, bool isDir)>& fn);
+
+    // The order the content browser shows names in: ignoring case, then as
+    // stored. <0, 0 or >0.
+    int CompareFileNames(std::string_view a, std::string_view b);
+
+    // What the content browser grid shows: the folders and files of one
+    // folder, or search hits below it.
+    //
+    // Names are stored back to back in one string. Each item keeps its offset
+    // and a 128-bit sort key: "is a file", then the first 15 case-folded
+    // bytes of its name, so sorting a folder compares integers and only
+    // falls back to the names on longer equal prefixes. Full paths are built
+    // the first time an item is drawn or acted on and kept, so a listing of
+    // 100k files costs a few allocations rather than several per file.
+    //
+    // Rebuilt when the folder or filter changes; Apply() folds file watcher
+    // events on the folder's own entries in place.
+    class DirectoryModel {
+    public:
+        // Lists the folders and regular files in 'dir', folders first, then
+        // files, each by name ignoring case. A non-empty 'filter' keeps the
+        // names containing it, ignoring case. False if 'dir' can't be read.
+        bool List(const std::filesystem::path& dir, std::string_view filter = {});
+        // Search hits, in their order; their paths are relative to 'root'
+        void Assign(const std::filesystem::path& root, const std::vector<SearchHit>& hits);
+        void Clear();
+
+        // Updates a listing for an event on one of the listed folder's
+        // entries. False when it has to be rebuilt instead: a rescan, or the
+        // model holds search hits.
+        bool Apply(const FileChange& change);
+
+        const std::filesystem::path& Base() const { return BaseDir; }
+        bool   IsListing() const { return Listing; }
+        size_t Count() const { return Items.size(); }
+
+        // Path relative to Base(), '/'-separated; unique within the model
+        std::string_view Key(size_t i) const { return {Text.data() + Items[i].Offset, Items[i].Length}; }
+        std::string_view Name(size_t i) const { return Key(i).substr(Items[i].NameStart); }
+        bool IsDir(size_t i) const { return (Items[i].Flags & kDir) != 0; }
+        // Absolute; built on first use
+        const std::filesystem::path& Path(size_t i) const;
+
+    private:
+        enum : uint8_t { kDir = 1 };
+
+        struct Item {
+            uint64_t SortKey[2] = {};
+            uint32_t Offset = 0;                // into Text
+            uint16_t Length = 0;
+            uint16_t NameStart = 0;             // file name within the key
+            uint8_t  Flags = 0;
+        };
+
+        void Reset(const std::filesystem::path& base, bool listing);
+        Item Add(std::string_view key, size_t nameStart, bool isDir);
+        bool Matches(std::string_view name) const;
+        size_t IndexOf(std::string_view name) const;
+        static void SetSortKey(Item& item, std::string_view name, bool isDir);
+        bool Less(const Item& a, const Item& b) const;
+        std::string_view NameOf(const Item& item) const
+        {
+            return {Text.data() + item.Offset + item.NameStart, (size_t)(item.Length - item.NameStart)};
+        }
+
+        std::filesystem::path BaseDir;
+        std::string           Filter;           // case-folded
+        bool                  Listing = false;
+        std::vector<Item>     Items;
+        std::string           Text;             // keys, back to back; Apply() leaves removed ones behind
+        mutable std::vector<std::filesystem::path> Paths;   // per item; empty until first use
+    };
+}
@@ -1,4 +1,6 @@
 ﻿#include "EditorCodegen.h"
+#include "HeaderCodegen.h"
+#include <cstdio>
 #include <fstream>
 #include <system_error>
 
@@ -11,12 +13,28 @@ void WriteGeneratedStubIfMissing(const std::filesystem::path& headerPath)
             std::error_code ec;
             std::filesystem::create_directories(gen.parent_path(), ec);
             std::ofstream out(gen, std::ios::binary | std::ios::trunc);
-            if (out) {
-                out << "#pragma once\n"
-                       "// Auto-generated stub by ACE Editor. Replaced by header tool later.\n";
-            }
+            if (out) out << ace::hdr::GenerateEmptyHeader(headerPath.filename());
         }
     } catch (...) {
         // non-fatal convenience
     }
 }
+
+bool RunHeaderTool(const std::filesystem::path& sourceDir,
+                   const std::filesystem::path& intermediateDir,
+                   std::vector<std::string>& messages)
+{
+    ace::hdr::RunOptions opt;
+    opt.SourceDir = sourceDir;
+    opt.CacheFile = intermediateDir / "HeaderTool" / "Cache.json";
+
+    ace::hdr::RunStats stats;
+    const bool ok = ace::hdr::RunIncremental(opt, stats);
+    messages = std::move(stats.Messages);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "HeaderTool: %zu headers, %zu parsed, %zu written, %zu error(s) in %.1f ms",
+                  stats.Headers, stats.Parsed, stats.Written, stats.Errors, stats.Seconds * 1000.0);
+    messages.emplace_back(line);
+    return ok;
+}
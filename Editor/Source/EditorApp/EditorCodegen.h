@@ -1,7 +1,16 @@
 ﻿#pragma once
 #include <filesystem>
+#include <string>
+#include <vector>
 
 // Ensures <Class>.generated.h exists next to <Class>.h.
-// Creates a minimal stub if missing so the project compiles today.
-// Safe to call multiple times.
+// Creates a stub (GENERATED_BODY() as a no-op) if missing so the project compiles
+// before the header tool has run. Safe to call multiple times.
 void WriteGeneratedStubIfMissing(const std::filesystem::path& headerPath);
+
+// Runs ACEHeaderTool in-process over a project's Source/ directory.
+// Only headers whose content changed are re-parsed; cache lives in <Project>/Intermediate.
+// 'messages' receives diagnostics and a one-line summary. Returns false on errors.
+bool RunHeaderTool(const std::filesystem::path& sourceDir,
+                   const std::filesystem::path& intermediateDir,
+                   std::vector<std::string>& messages);
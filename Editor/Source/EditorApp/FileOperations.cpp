@@ -0,0 +1,483 @@
+﻿#include "FileOperations.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <mutex>
+#include <system_error>
+#include <unordered_set>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+#endif
+
+namespace ace::editor
+{
+    namespace {
+        using Reserved = std::unordered_set<std::filesystem::path::string_type>;
+
+        // UniqueSibling, also avoiding names an earlier item of the batch took
+        std::filesystem::path UniqueName(const std::filesystem::path& parent, const std::string& base, const Reserved& reserved)
+        {
+            const auto free = [&](const std::filesystem::path& p) {
+                std::error_code ec;
+                return !reserved.count(p.native()) && !std::filesystem::exists(p, ec);
+            };
+            std::filesystem::path candidate = parent / base;
+            if (free(candidate)) return candidate;
+            const std::string name = std::filesystem::path(base).stem().string();
+            const std::string extension = std::filesystem::path(base).extension().string();
+            candidate = parent / (name + " - Copy" + extension);
+            if (free(candidate)) return candidate;
+            for (int i = 2; i < 1000; ++i) {
+                candidate = parent / (name + " - Copy (" + std::to_string(i) + ")" + extension);
+                if (free(candidate)) return candidate;
+            }
+            return parent / (name + " - Copy (999)" + extension);
+        }
+
+        std::string Describe(const char* verb, const std::vector<std::filesystem::path>& items, const std::filesystem::path& destDir)
+        {
+            std::string s = verb;
+            if (items.size() == 1) s += " '" + items.front().filename().string() + "'";
+            else                   s += " " + std::to_string(items.size()) + " items";
+            if (!destDir.empty())  s += " to " + destDir.filename().string();
+            return s;
+        }
+
+        struct FileCopy {
+            std::filesystem::path From, To;
+            uint64_t              Size = 0;
+        };
+
+        // First error of a batch, from any worker
+        struct Failures {
+            std::mutex   Mutex;
+            std::string& First;
+            size_t       Count = 0;
+
+            explicit Failures(std::string& first) : First(first) {}
+            void Add(const std::string& what)
+            {
+                std::lock_guard lock(Mutex);
+                if (First.empty()) First = what;
+                ++Count;
+            }
+        };
+
+        bool IsFinal(FileOpState s) { return s != FileOpState::Queued && s != FileOpState::Running; }
+
+        // Creates the folders of 'src' under 'dest' and lists its files
+        void CollectTree(const std::filesystem::path& src, const std::filesystem::path& dest,
+                         std::vector<FileCopy>& files, Failures& fail, const std::atomic<bool>& cancel)
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(dest, ec);
+            if (ec) { fail.Add("Failed to create '" + dest.string() + "': " + ec.message()); return; }
+            for (std::filesystem::recursive_directory_iterator it(src, ec), end; !ec && it != end && !cancel; it.increment(ec)) {
+                std::error_code e;
+                const auto to = dest / it->path().lexically_relative(src);
+                if (it->is_directory(e)) {
+                    std::filesystem::create_directories(to, e);
+                    if (e) fail.Add("Failed to create '" + to.string() + "': " + e.message());
+                } else if (it->is_regular_file(e)) {
+                    files.push_back({it->path(), to, it->file_size(e)});
+                }
+            }
+            if (ec) fail.Add("Failed to read '" + src.string() + "': " + ec.message());
+        }
+
+        // Copies the files on all workers, counting progress into the batch
+        void CopyFiles(const std::vector<FileCopy>& files, std::atomic<uint64_t>& bytesDone,
+                       std::atomic<uint32_t>& filesDone, Failures& fail, const std::atomic<bool>& cancel)
+        {
+            JobSystem::Get().ParallelFor(files.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end && !cancel; ++i) {
+                    const FileCopy& f = files[i];
+                    uint64_t reported = 0;
+                    std::string err;
+                    const bool ok = CopyFileFast(f.From, f.To, [&](uint64_t copied) {
+                        bytesDone += copied - reported;
+                        reported = copied;
+                        return !cancel;
+                    }, err);
+                    if (!ok && !cancel) fail.Add("Failed to copy '" + f.From.string() + "': " + err);
+                    if (reported < f.Size) bytesDone += f.Size - reported;    // keep the bar honest on failures
+                    ++filesDone;
+                }
+            });
+        }
+
+#ifdef _WIN32
+        DWORD CALLBACK OnCopyProgress(LARGE_INTEGER, LARGE_INTEGER transferred, LARGE_INTEGER, LARGE_INTEGER,
+                                      DWORD, DWORD, HANDLE, HANDLE, LPVOID data)
+        {
+            const auto& progress = *static_cast<const std::function<bool(uint64_t)>*>(data);
+            return progress((uint64_t)transferred.QuadPart) ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+        }
+#endif
+    }
+
+    std::filesystem::path UniqueSibling(const std::filesystem::path& parent, const std::string& base)
+    {
+        return UniqueName(parent, base, {});
+    }
+
+#ifdef _WIN32
+    bool CopyFileFast(const std::filesystem::path& from, const std::filesystem::path& to,
+                      const std::function<bool(uint64_t copied)>& progress, std::string& err)
+    {
+        // Removes the partial copy itself when cancelled
+        if (CopyFileExW(from.c_str(), to.c_str(), OnCopyProgress, const_cast<std::function<bool(uint64_t)>*>(&progress),
+                        nullptr, COPY_FILE_FAIL_IF_EXISTS))
+            return true;
+        err = std::system_category().message((int)GetLastError());
+        return false;
+    }
+#else
+    bool CopyFileFast(const std::filesystem::path& from, const std::filesystem::path& to,
+                      const std::function<bool(uint64_t copied)>& progress, std::string& err)
+    {
+        constexpr size_t kChunk = 8u << 20;     // between progress calls
+        const auto fail = [&](int e) { err = std::generic_category().message(e); return false; };
+
+        const int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) return fail(errno);
+        struct stat st;
+        if (fstat(in, &st) != 0) { const int e = errno; close(in); return fail(e); }
+        const int out = open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0777);
+        if (out < 0) { const int e = errno; close(in); return fail(e); }
+
+        const uint64_t size = (uint64_t)st.st_size;
+        uint64_t copied = 0;
+        int error = 0;
+        bool cancelled = false;
+#if defined(__linux__) && defined(FICLONE)
+        // Shares the extents on Btrfs, XFS and the like: no data is copied
+        if (size && ioctl(out, FICLONE, in) == 0) copied = size;
+#endif
+#ifdef __linux__
+        bool inKernel = true;
+#else
+        bool inKernel = false;
+#endif
+        std::vector<char> buffer;
+        while (copied < size) {
+            const size_t chunk = (size_t)std::min<uint64_t>(size - copied, kChunk);
+            ssize_t n = 0;
+#ifdef __linux__
+            if (inKernel) {
+                n = copy_file_range(in, nullptr, out, nullptr, chunk, 0);
+                if (n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP || errno == EPERM)) {
+                    inKernel = false;           // carries on from the same offsets
+                    continue;
+                }
+            }
+#endif
+            if (!inKernel) {
+                if (buffer.empty()) buffer.resize(1u << 20);
+                n = read(in, buffer.data(), std::min(chunk, buffer.size()));
+                for (ssize_t written = 0; n > 0 && written < n;) {
+                    const ssize_t w = write(out, buffer.data() + written, (size_t)(n - written));
+                    if (w < 0 && errno != EINTR) { n = -1; break; }
+                    if (w > 0) written += w;
+                }
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error = errno;
+                break;
+            }
+            if (n == 0) break;                  // the file shrank
+            copied += (uint64_t)n;
+            if (!progress(copied)) { cancelled = true; break; }
+        }
+        if (!error && !cancelled) progress(copied);
+
+        close(in);
+        if (close(out) != 0 && !error) error = errno;
+        if (error || cancelled) {
+            unlink(to.c_str());
+            if (cancelled) { err = "Cancelled"; return false; }
+            return fail(error);
+        }
+        return true;
+    }
+#endif
+
+    FileOperationQueue::~FileOperationQueue()
+    {
+        if (!Stopped) Shutdown();
+    }
+
+    void FileOperationQueue::Shutdown()
+    {
+        for (auto& b : Batches) b->CancelRequested = true;
+        JobSystem::Get().Wait(JobsDone);
+        Running = false;
+        Stopped = true;
+    }
+
+    uint64_t FileOperationQueue::Add(FileOpKind kind, std::vector<Item> items, std::filesystem::path destDir, std::string label)
+    {
+        if (items.empty()) return 0;
+        auto b = std::make_shared<Batch>();
+        b->Id = NextId++;
+        b->Kind = kind;
+        b->Items = std::move(items);
+        b->DestDir = std::move(destDir);
+        b->Label = std::move(label);
+        b->ItemsTotal = (uint32_t)b->Items.size();
+        Batches.push_back(std::move(b));
+        return Batches.back()->Id;
+    }
+
+    uint64_t FileOperationQueue::Copy(std::vector<std::filesystem::path> sources, const std::filesystem::path& destDir)
+    {
+        std::string label = Describe("Copying", sources, destDir);
+        std::vector<Item> items;
+        for (auto& s : sources) items.push_back({std::move(s), {}});
+        return Add(FileOpKind::Copy, std::move(items), destDir, std::move(label));
+    }
+
+    uint64_t FileOperationQueue::Move(std::vector<std::filesystem::path> sources, const std::filesystem::path& destDir)
+    {
+        std::string label = Describe("Moving", sources, destDir);
+        std::vector<Item> items;
+        for (auto& s : sources) items.push_back({std::move(s), {}});
+        return Add(FileOpKind::Move, std::move(items), destDir, std::move(label));
+    }
+
+    uint64_t FileOperationQueue::Delete(std::vector<std::filesystem::path> paths)
+    {
+        std::string label = Describe("Deleting", paths, {});
+        std::vector<Item> items;
+        for (auto& p : paths) items.push_back({std::move(p), {}});
+        return Add(FileOpKind::Delete, std::move(items), {}, std::move(label));
+    }
+
+    uint64_t FileOperationQueue::Undo(uint64_t id)
+    {
+        for (auto& b : Batches) {
+            if (b->Id != id) continue;
+            if (b->Kind != FileOpKind::Move || !IsFinal(b->State) || b->Undone || b->Result.Moved.empty()) return 0;
+            b->Undone = true;
+            std::vector<Item> items;
+            for (auto it = b->Result.Moved.rbegin(); it != b->Result.Moved.rend(); ++it) items.push_back({it->second, it->first});
+            return Add(FileOpKind::Move, std::move(items), {}, "Undoing: " + b->Label);
+        }
+        return 0;
+    }
+
+    void FileOperationQueue::Cancel(uint64_t id)
+    {
+        for (auto& b : Batches) {
+            if (b->Id != id) continue;
+            b->CancelRequested = true;
+            if (b->State == FileOpState::Queued) {
+                b->Result.Id = b->Id;
+                b->Result.Kind = b->Kind;
+                b->Result.State = FileOpState::Cancelled;
+                b->State = FileOpState::Cancelled;
+            }
+        }
+    }
+
+    void FileOperationQueue::Dismiss(uint64_t id)
+    {
+        std::erase_if(Batches, [&](const std::shared_ptr<Batch>& b) { return b->Id == id && b->Reported; });
+    }
+
+    bool FileOperationQueue::Busy() const
+    {
+        return Running || std::any_of(Batches.begin(), Batches.end(),
+                                      [](const auto& b) { return b->State == FileOpState::Queued; });
+    }
+
+    void FileOperationQueue::Update(std::vector<FileOpResult>& finished)
+    {
+        ACE_PROFILE_FUNCTION();
+        if (Running && JobsDone.IsDone()) Running = false;
+
+        for (auto& b : Batches) {
+            if (b->Reported || !IsFinal(b->State)) continue;
+            b->Reported = true;
+            finished.push_back(b->Result);
+        }
+
+        // One batch at a time, in order: a later one may work on what an
+        // earlier one made
+        if (!Running && !Stopped) {
+            for (auto& b : Batches) {
+                if (b->State != FileOpState::Queued) continue;
+                b->State = FileOpState::Running;
+                Running = true;
+                JobSystem::Get().Run([b] { Execute(*b); }, &JobsDone);
+                break;
+            }
+        }
+
+        size_t done = (size_t)std::count_if(Batches.begin(), Batches.end(), [](const auto& b) { return b->Reported; });
+        for (auto it = Batches.begin(); done > kMaxFinished && it != Batches.end();) {
+            if ((*it)->Reported) { it = Batches.erase(it); --done; }
+            else ++it;
+        }
+    }
+
+    void FileOperationQueue::GetProgress(std::vector<FileOpProgress>& out) const
+    {
+        out.clear();
+        for (const auto& b : Batches) {
+            FileOpProgress p;
+            p.Id = b->Id;
+            p.Kind = b->Kind;
+            p.State = b->State;
+            p.Label = b->Label;
+            p.BytesDone = b->BytesDone;
+            p.BytesTotal = b->BytesTotal;
+            p.ItemsDone = b->ItemsDone;
+            p.ItemsTotal = b->ItemsTotal;
+            if (IsFinal(p.State)) {
+                p.CanUndo = b->Kind == FileOpKind::Move && !b->Undone && !b->Result.Moved.empty();
+                p.Error = b->Result.Error;
+            }
+            out.push_back(std::move(p));
+        }
+    }
+
+    void FileOperationQueue::Execute(Batch& b)
+    {
+        ACE_PROFILE_FUNCTION();
+        switch (b.Kind) {
+            case FileOpKind::Copy:   ExecuteCopy(b);   break;
+            case FileOpKind::Move:   ExecuteMove(b);   break;
+            case FileOpKind::Delete: ExecuteDelete(b); break;
+        }
+        FileOpResult& r = b.Result;
+        r.Id = b.Id;
+        r.Kind = b.Kind;
+        r.State = b.CancelRequested ? FileOpState::Cancelled : r.Error.empty() ? FileOpState::Done : FileOpState::Failed;
+        b.State.store(r.State, std::memory_order_release);
+    }
+
+    void FileOperationQueue::ExecuteCopy(Batch& b)
+    {
+        Failures fail(b.Result.Error);
+        std::error_code ec;
+        std::filesystem::create_directories(b.DestDir, ec);
+
+        // Destinations and folders first, for the byte total
+        Reserved reserved;
+        std::vector<FileCopy> files;
+        std::vector<std::filesystem::path> created;
+        for (const Item& item : b.Items) {
+            if (b.CancelRequested) break;
+            const auto st = std::filesystem::status(item.Source, ec);
+            const bool isDir = std::filesystem::is_directory(st);
+            if (!isDir && !std::filesystem::is_regular_file(st)) { fail.Add("'" + item.Source.string() + "' does not exist"); continue; }
+            if (isDir && IsWithin(item.Source, b.DestDir)) { fail.Add("Can't copy '" + item.Source.string() + "' into itself"); continue; }
+
+            const auto dest = UniqueName(b.DestDir, item.Source.filename().string(), reserved);
+            reserved.insert(dest.native());
+            created.push_back(dest);
+            if (isDir) CollectTree(item.Source, dest, files, fail, b.CancelRequested);
+            else       files.push_back({item.Source, dest, std::filesystem::file_size(item.Source, ec)});
+        }
+        uint64_t total = 0;
+        for (const auto& f : files) total += f.Size;
+        b.BytesTotal = total;
+        b.ItemsTotal = (uint32_t)files.size();
+
+        CopyFiles(files, b.BytesDone, b.ItemsDone, fail, b.CancelRequested);
+
+        // A cancelled copy leaves nothing behind
+        for (const auto& dest : created) {
+            if (b.CancelRequested) std::filesystem::remove_all(dest, ec);
+            else if (std::filesystem::exists(dest, ec)) b.Result.Created.push_back(dest);
+        }
+    }
+
+    void FileOperationQueue::ExecuteMove(Batch& b)
+    {
+        Failures fail(b.Result.Error);
+        std::error_code ec;
+        if (!b.DestDir.empty()) std::filesystem::create_directories(b.DestDir, ec);
+
+        Reserved reserved;
+        for (const Item& item : b.Items) {
+            if (b.CancelRequested) break;
+            const auto st = std::filesystem::status(item.Source, ec);
+            const bool isDir = std::filesystem::is_directory(st);
+            if (!std::filesystem::exists(st)) { fail.Add("'" + item.Source.string() + "' does not exist"); ++b.ItemsDone; continue; }
+
+            std::filesystem::path dest = item.Dest;
+            if (dest.empty()) {
+                // Already there: nothing to do
+                if (item.Source.parent_path().lexically_normal() == b.DestDir.lexically_normal()) { ++b.ItemsDone; continue; }
+                if (isDir && IsWithin(item.Source, b.DestDir)) {
+                    fail.Add("Can't move '" + item.Source.string() + "' into itself");
+                    ++b.ItemsDone;
+                    continue;
+                }
+                dest = UniqueName(b.DestDir, item.Source.filename().string(), reserved);
+            } else if (std::filesystem::exists(dest, ec)) {
+                fail.Add("'" + dest.string() + "' already exists");
+                ++b.ItemsDone;
+                continue;
+            } else {
+                std::filesystem::create_directories(dest.parent_path(), ec);
+            }
+            reserved.insert(dest.native());
+
+            std::filesystem::rename(item.Source, dest, ec);
+            if (!ec) {
+                b.Result.Moved.emplace_back(item.Source, dest);
+                ++b.ItemsDone;
+                continue;
+            }
+
+            // Another volume (or a file in use): copy, then delete the source
+            std::vector<FileCopy> files;
+            if (isDir) CollectTree(item.Source, dest, files, fail, b.CancelRequested);
+            else       files.push_back({item.Source, dest, std::filesystem::file_size(item.Source, ec)});
+            uint64_t total = 0;
+            for (const auto& f : files) total += f.Size;
+            b.BytesTotal += total;
+            std::atomic<uint32_t> copied{0};
+            const size_t failedBefore = fail.Count;
+            CopyFiles(files, b.BytesDone, copied, fail, b.CancelRequested);
+            if (b.CancelRequested || fail.Count != failedBefore) {
+                std::filesystem::remove_all(dest, ec);      // the source stays whole
+            } else {
+                std::filesystem::remove_all(item.Source, ec);
+                if (ec) fail.Add("Copied '" + item.Source.string() + "', but failed to delete it: " + ec.message());
+                b.Result.Moved.emplace_back(item.Source, dest);
+            }
+            ++b.ItemsDone;
+        }
+    }
+
+    void FileOperationQueue::ExecuteDelete(Batch& b)
+    {
+        Failures fail(b.Result.Error);
+        for (const Item& item : b.Items) {
+            if (b.CancelRequested) break;
+            std::error_code ec;
+            std::filesystem::remove_all(item.Source, ec);
+            if (ec) fail.Add("Failed to delete '" + item.Source.string() + "': " + ec.message());
+            b.Result.Removed.push_back(item.Source);         // possibly in part
+            ++b.ItemsDone;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+﻿#pragma once
+#include "Runtime/Core/JobSystem.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ace::editor
+{
+    // "Name.ext" in 'parent', or "Name - Copy.ext", "Name - Copy (2).ext", ...
+    // when taken
+    std::filesystem::path UniqueSibling(const std::filesystem::path& parent, const std::string& base);
+
+    // Copies one file to a new path (fails if 'to' exists). Clones it where
+    // the file system can (reflink on Linux; ReFS block cloning through
+    // CopyFileEx on Windows), else copies in the kernel (copy_file_range),
+    // else through a buffer. 'progress' is called with the bytes copied so
+    // far; returning false cancels, and the partial copy is removed.
+    bool CopyFileFast(const std::filesystem::path& from, const std::filesystem::path& to,
+                      const std::function<bool(uint64_t copied)>& progress, std::string& err);
+
+    enum class FileOpKind : uint8_t { Copy, Move, Delete };
+    enum class FileOpState : uint8_t { Queued, Running, Done, Cancelled, Failed };
+
+    // One batch, for the progress UI
+    struct FileOpProgress {
+        uint64_t    Id = 0;
+        FileOpKind  Kind = FileOpKind::Copy;
+        FileOpState State = FileOpState::Queued;
+        std::string Label;                      // e.g. "Copying 3 items to Maps"
+        uint64_t    BytesDone = 0;
+        uint64_t    BytesTotal = 0;
+        uint32_t    ItemsDone = 0;              // files for copies, top-level items otherwise
+        uint32_t    ItemsTotal = 0;
+        bool        CanUndo = false;            // a finished move not undone yet
+        std::string Error;                      // first failure
+    };
+
+    // What a finished batch changed, for the asset registry and the UI
+    struct FileOpResult {
+        uint64_t    Id = 0;
+        FileOpKind  Kind = FileOpKind::Copy;
+        FileOpState State = FileOpState::Done;
+        std::vector<std::pair<std::filesystem::path, std::filesystem::path>> Moved;     // from, to
+        std::vector<std::filesystem::path> Created;     // copies, top-level
+        std::vector<std::filesystem::path> Removed;     // deleted, top-level
+        std::string Error;
+    };
+
+    // Copies, moves and deletes for the content browser, run on workers one
+    // batch at a time, in the order queued, so the editor keeps drawing.
+    //
+    // A copy walks its sources first for a byte total, then copies the files
+    // in parallel. A move renames each item and falls back to copy and
+    // delete across volumes. Cancel() stops a batch between files or copy
+    // chunks: a cancelled copy removes what it created, a cancelled move
+    // keeps the items already moved. Finished moves can be undone, which
+    // queues the reverse moves.
+    //
+    // Update() reports each finished batch once, with everything it moved,
+    // created or removed, so the caller can fix up asset references for the
+    // whole batch at the end.
+    //
+    // Main thread only, except for the workers.
+    class FileOperationQueue {
+    public:
+        static constexpr size_t kMaxFinished = 4;   // finished batches kept for the UI
+
+        FileOperationQueue() = default;
+        ~FileOperationQueue();
+        FileOperationQueue(const FileOperationQueue&) = delete;
+        FileOperationQueue& operator=(const FileOperationQueue&) = delete;
+
+        // Into 'destDir', with unique names for items already there; return the batch id
+        uint64_t Copy(std::vector<std::filesystem::path> sources, const std::filesystem::path& destDir);
+        uint64_t Move(std::vector<std::filesystem::path> sources, const std::filesystem::path& destDir);
+        uint64_t Delete(std::vector<std::filesystem::path> paths);
+        // Moves a finished move's items back; 0 if there is nothing to undo
+        uint64_t Undo(uint64_t id);
+
+        void Cancel(uint64_t id);
+        // Forgets a finished batch
+        void Dismiss(uint64_t id);
+
+        // Once per frame: appends the batches that finished since the last
+        // call to 'finished' and starts the next one
+        void Update(std::vector<FileOpResult>& finished);
+        void GetProgress(std::vector<FileOpProgress>& out) const;
+        bool Busy() const;
+
+        // Cancels everything and waits; call while the job system is still up
+        void Shutdown();
+
+    private:
+        struct Item {
+            std::filesystem::path Source;
+            std::filesystem::path Dest;         // empty: a unique name in DestDir
+        };
+
+        struct Batch {
+            uint64_t               Id = 0;
+            FileOpKind             Kind = FileOpKind::Copy;
+            std::vector<Item>      Items;
+            std::filesystem::path  DestDir;
+            std::string            Label;
+            bool                   Undone = false;
+            bool                   Reported = false;
+
+            // Progress, written by the worker
+            std::atomic<uint64_t>    BytesDone{0};
+            std::atomic<uint64_t>    BytesTotal{0};
+            std::atomic<uint32_t>    ItemsDone{0};
+            std::atomic<uint32_t>    ItemsTotal{0};
+            std::atomic<bool>        CancelRequested{false};
+            std::atomic<FileOpState> State{FileOpState::Queued};
+            FileOpResult             Result;    // read once State is final
+        };
+
+        uint64_t Add(FileOpKind kind, std::vector<Item> items, std::filesystem::path destDir, std::string label);
+        static void Execute(Batch& b);
+        static void ExecuteCopy(Batch& b);
+        static void ExecuteMove(Batch& b);
+        static void ExecuteDelete(Batch& b);
+
+        std::deque<std::shared_ptr<Batch>> Batches;     // oldest first
+        uint64_t                NextId = 1;
+        bool                    Running = false;
+        bool                    Stopped = false;
+        JobCounter              JobsDone;
+    };
+}
@@ -0,0 +1,259 @@
+﻿#include "FolderTree.h"
+#include "DirectoryModel.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+
+namespace ace::editor
+{
+    namespace {
+        constexpr uint32_t kMaxJobs = 2;
+    }
+
+    FolderTree::~FolderTree()
+    {
+        if (Stopped) return;
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();
+        }
+        JobSystem::Get().Wait(JobsDone);
+    }
+
+    void FolderTree::Shutdown()
+    {
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();
+        }
+        JobSystem::Get().Wait(JobsDone);
+        Stopped = true;
+    }
+
+    void FolderTree::SetRoot(const std::filesystem::path& root)
+    {
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();
+            Done.clear();
+            ++Epoch;
+        }
+        Nodes.clear();
+        Free.clear();
+        ByPath.clear();
+        RootDir = root;
+        if (root.empty()) return;
+
+        Node& n = Nodes.emplace_back();
+        n.Path = root;
+        n.Name = root.filename().string();
+        n.Alive = true;
+        ByPath.emplace(root.native(), 0);
+        Enqueue(0, true);
+    }
+
+    FolderTree::NodeId FolderTree::Find(const std::filesystem::path& path) const
+    {
+        const auto it = ByPath.find(path.native());
+        return it == ByPath.end() ? kNone : it->second;
+    }
+
+    size_t FolderTree::Pending() const
+    {
+        std::lock_guard lock(Mutex);
+        return Queue.size();
+    }
+
+    FolderTree::NodeId FolderTree::AddNode(NodeId parent, std::string name)
+    {
+        NodeId id;
+        if (!Free.empty()) { id = Free.back(); Free.pop_back(); }
+        else               { id = (NodeId)Nodes.size(); Nodes.emplace_back(); }
+        Node& n = Nodes[id];
+        const uint32_t gen = n.Gen + 1;         // reads of a freed node must not match
+        n = Node{};
+        n.Gen = gen;
+        n.Path = Nodes[parent].Path / name;
+        n.Name = std::move(name);
+        n.Parent = parent;
+        n.Alive = true;
+        ByPath.emplace(n.Path.native(), id);
+        return id;
+    }
+
+    // Frees the node and its subtree; the caller unlinks it from its parent
+    void FolderTree::RemoveNode(NodeId id)
+    {
+        for (const NodeId c : Nodes[id].Children) RemoveNode(c);
+        Node& n = Nodes[id];
+        ByPath.erase(n.Path.native());
+        n.Children.clear();
+        n.Path.clear();
+        n.Name.clear();
+        n.Status = State::Unread;
+        n.Alive = false;
+        ++n.Gen;
+        Free.push_back(id);
+    }
+
+    void FolderTree::InsertChild(NodeId parent, const std::string& name)
+    {
+        const auto& kids = Nodes[parent].Children;
+        const auto pos = std::lower_bound(kids.begin(), kids.end(), name, [&](NodeId c, const std::string& n) {
+            return CompareFileNames(Nodes[c].Name, n) < 0;
+        });
+        if (pos != kids.end() && Nodes[*pos].Name == name) return;
+        const ptrdiff_t at = pos - kids.begin();
+        const NodeId id = AddNode(parent, name);                     // may move Nodes
+        Nodes[parent].Children.insert(Nodes[parent].Children.begin() + at, id);
+        Enqueue(id, false);
+    }
+
+    // Replaces the children of 'id' with the folders just read, keeping the
+    // nodes (and subtrees) of those still there
+    void FolderTree::Merge(NodeId id, std::vector<std::string>& names)
+    {
+        std::vector<NodeId> old = std::move(Nodes[id].Children);
+        std::vector<NodeId> kids;
+        kids.reserve(names.size());
+        size_t i = 0;
+        for (auto& name : names) {
+            while (i < old.size() && CompareFileNames(Nodes[old[i]].Name, name) < 0) RemoveNode(old[i++]);
+            if (i < old.size() && Nodes[old[i]].Name == name) kids.push_back(old[i++]);
+            else                                              kids.push_back(AddNode(id, std::move(name)));
+        }
+        while (i < old.size()) RemoveNode(old[i++]);
+        Nodes[id].Children = std::move(kids);
+        Nodes[id].Listed = true;
+    }
+
+    void FolderTree::Enqueue(NodeId id, bool urgent)
+    {
+        Node& n = Nodes[id];
+        if (n.Status == State::Queued && (!urgent || n.Urgent)) return;
+        n.Status = State::Queued;
+        n.Urgent = urgent;
+        n.RequestGen = n.Gen;
+        std::lock_guard lock(Mutex);
+        Request r{n.Path, id, n.Gen, Epoch};
+        if (urgent) Queue.push_back(std::move(r));
+        else        Queue.push_front(std::move(r));
+    }
+
+    // Reads the subtree again; its nodes stay until the reads come back
+    void FolderTree::Reread(NodeId id)
+    {
+        Node& n = Nodes[id];
+        if (n.Status == State::Unread) return;
+        ++n.Gen;
+        if (n.Status == State::Read) Enqueue(id, false);
+        for (size_t i = 0; i < Nodes[id].Children.size(); ++i) Reread(Nodes[id].Children[i]);
+    }
+
+    void FolderTree::Touch(NodeId id)
+    {
+        const Node& n = Nodes[id];
+        if (n.Status == State::Unread || (n.Status == State::Queued && !n.Urgent)) Enqueue(id, true);
+    }
+
+    void FolderTree::Apply(const FileChange& change)
+    {
+        if (Nodes.empty()) return;
+        const auto& path = change.Path;
+        if (change.Kind == FileChangeKind::Rescan) {
+            NodeId id = Find(path);
+            if (id == kNone && IsWithin(path, RootDir)) id = 0;
+            if (id != kNone) Reread(id);
+            return;
+        }
+
+        const NodeId parent = Find(path.parent_path());
+        if (parent == kNone) return;
+        Node& p = Nodes[parent];
+        // A read under way may or may not have seen this change: do it again
+        if (p.Status == State::Queued) ++p.Gen;
+        if (!p.Listed) return;
+
+        if (change.Kind == FileChangeKind::Removed) {
+            const NodeId id = Find(path);
+            if (id == kNone) return;
+            std::erase(p.Children, id);
+            RemoveNode(id);
+        } else if (change.IsDir) {
+            InsertChild(parent, path.filename().string());
+        }
+    }
+
+    void FolderTree::Update()
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<Result> done;
+        {
+            std::lock_guard lock(Mutex);
+            done.swap(Done);
+        }
+
+        for (Result& r : done) {
+            if (r.Epoch != Epoch || r.Id >= Nodes.size()) continue;
+            Node& n = Nodes[r.Id];
+            // A newer request for the node is pending, or it was freed
+            if (!n.Alive || n.Status != State::Queued || r.Gen != n.RequestGen) continue;
+            if (r.Gen != n.Gen) {
+                // Changed while it was being read
+                const bool urgent = n.Urgent;
+                n.Status = State::Unread;
+                Enqueue(r.Id, urgent);
+                continue;
+            }
+            n.Status = State::Read;
+            n.Urgent = false;
+            Merge(r.Id, r.Names);
+
+            // Prefetch the next level, behind anything on screen
+            if (Count() < kMaxNodes)
+                for (const NodeId c : Nodes[r.Id].Children)
+                    if (Nodes[c].Status == State::Unread) Enqueue(c, false);
+        }
+        Dispatch();
+    }
+
+    void FolderTree::Dispatch()
+    {
+        std::lock_guard lock(Mutex);
+        const uint32_t maxJobs = std::min(kMaxJobs, std::max(1u, JobSystem::Get().NumWorkers()));
+        while (Jobs < maxJobs && Jobs < Queue.size()) {
+            ++Jobs;
+            JobSystem::Get().Run([this] { WorkJob(); }, &JobsDone);
+        }
+    }
+
+    // Worker side: next request until the queue is empty
+    void FolderTree::WorkJob()
+    {
+        for (;;) {
+            Request req;
+            {
+                std::lock_guard lock(Mutex);
+                if (Queue.empty()) { --Jobs; return; }
+                req = std::move(Queue.back());
+                Queue.pop_back();
+            }
+
+            ACE_PROFILE_SCOPE("FolderTree::Read");
+            Result res;
+            res.Id = req.Id;
+            res.Gen = req.Gen;
+            res.Epoch = req.Epoch;
+            // A folder that can't be read shows as empty; its parent's
+            // watcher event removes it if it is gone
+            ForEachDirectoryEntry(req.Path, [&](std::string_view name, bool isDir) {
+                if (isDir) res.Names.emplace_back(name);
+            });
+            std::sort(res.Names.begin(), res.Names.end(),
+                      [](const std::string& a, const std::string& b) { return CompareFileNames(a, b) < 0; });
+
+            std::lock_guard lock(Mutex);
+            Done.push_back(std::move(res));
+        }
+    }
+}
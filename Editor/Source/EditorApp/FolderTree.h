@@ -0,0 +1,122 @@
+﻿#pragma once
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/IO/FileWatcher.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ace::editor
+{
+    // The content browser's folder tree, read on workers and kept in memory,
+    // so drawing it touches no file system.
+    //
+    // Folders are read by up to two background jobs, each read yielding the
+    // sorted subfolders. Nodes drawn on screen (Touch()) are read first;
+    // behind them the jobs work through the subfolders of every folder
+    // read, so expanding a node normally finds its children and whether
+    // they have children already there. Prefetching stops at kMaxNodes; past
+    // that only nodes that are drawn get read.
+    //
+    // Apply() keeps the tree current from file watcher events: folders are
+    // added and removed in place, and a rescan rereads the affected subtree
+    // in the background while the old nodes stay on screen.
+    //
+    // Main thread only, except for the workers.
+    class FolderTree {
+    public:
+        using NodeId = uint32_t;
+        static constexpr NodeId kNone = ~0u;
+        static constexpr size_t kMaxNodes = 100000;
+
+        FolderTree() = default;
+        ~FolderTree();
+        FolderTree(const FolderTree&) = delete;
+        FolderTree& operator=(const FolderTree&) = delete;
+
+        // Drops every node and starts reading 'root'; empty = no tree
+        void SetRoot(const std::filesystem::path& root);
+        const std::filesystem::path& Root() const { return RootDir; }
+        NodeId RootNode() const { return Nodes.empty() ? kNone : 0; }
+
+        const std::filesystem::path& Path(NodeId id) const { return Nodes[id].Path; }
+        const std::string& Name(NodeId id) const { return Nodes[id].Name; }
+        // Subfolders by name (CompareFileNames); empty until the folder is read
+        const std::vector<NodeId>& Children(NodeId id) const { return Nodes[id].Children; }
+        // False once the folder is known to have no subfolders
+        bool MayHaveChildren(NodeId id) const { return !Nodes[id].Listed || !Nodes[id].Children.empty(); }
+        // Node at an absolute path, or kNone if it is not in the tree (yet)
+        NodeId Find(const std::filesystem::path& path) const;
+
+        // The node is on screen: read it ahead of prefetching if it is not yet
+        void Touch(NodeId id);
+
+        // Folds in one watcher event; paths outside the root are ignored
+        void Apply(const FileChange& change);
+
+        // Once per frame: takes in finished reads and starts the job
+        void Update();
+        // Waits for the job; call while the job system is still up
+        void Shutdown();
+
+        size_t Count() const { return Nodes.size() - Free.size(); }
+        size_t Pending() const;                 // folders waiting to be read
+
+    private:
+        enum class State : uint8_t { Unread, Queued, Read };
+
+        struct Node {
+            std::filesystem::path Path;
+            std::string           Name;
+            NodeId                Parent = kNone;
+            std::vector<NodeId>   Children;
+            uint32_t              Gen = 0;              // bumped when its children may have changed
+            uint32_t              RequestGen = 0;       // Gen of the latest read requested
+            State                 Status = State::Unread;
+            bool                  Listed = false;       // Children were read at least once
+            bool                  Urgent = false;       // queued by Touch()
+            bool                  Alive = false;
+        };
+
+        struct Request {
+            std::filesystem::path Path;
+            NodeId                Id = kNone;
+            uint32_t              Gen = 0;
+            uint32_t              Epoch = 0;
+        };
+
+        struct Result {
+            NodeId                   Id = kNone;
+            uint32_t                 Gen = 0;
+            uint32_t                 Epoch = 0;
+            std::vector<std::string> Names;             // sorted subfolders
+        };
+
+        NodeId AddNode(NodeId parent, std::string name);
+        void   RemoveNode(NodeId id);
+        void   InsertChild(NodeId parent, const std::string& name);
+        void   Merge(NodeId id, std::vector<std::string>& names);
+        void   Enqueue(NodeId id, bool urgent);
+        void   Reread(NodeId id);
+        void   Dispatch();
+        void   WorkJob();
+
+        std::filesystem::path   RootDir;
+        std::vector<Node>       Nodes;              // 0 is the root
+        std::vector<NodeId>     Free;
+        std::unordered_map<std::filesystem::path::string_type, NodeId> ByPath;
+        bool                    Stopped = false;
+
+        // Shared with the job
+        mutable std::mutex      Mutex;
+        std::deque<Request>     Queue;              // back = next; prefetches go in front
+        std::vector<Result>     Done;
+        uint32_t                Epoch = 0;          // bumped by SetRoot; older results are dropped
+        uint32_t                Jobs = 0;
+        JobCounter              JobsDone;
+    };
+}
@@ -0,0 +1,251 @@
+﻿#include "SelectionSet.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <bit>
+
+namespace ace::editor
+{
+    void SelectionSet::SetRoot(const std::filesystem::path& root)
+    {
+        RootDir = root;
+        Model = nullptr;
+        Prefix.clear();
+        RowBits.clear();
+        PendingBits.clear();
+        Rows = 0;
+        Clear();
+    }
+
+    void SelectionSet::Clear()
+    {
+        // Nothing stays selected, so every id goes
+        Text.clear();
+        Entries.clear();
+        std::fill(Table.begin(), Table.end(), kNone);
+        Selected = 0;
+        NextOrder = 0;
+        std::fill(RowBits.begin(), RowBits.end(), 0);
+        std::fill(PendingBits.begin(), PendingBits.end(), 0);
+        PendingCount = 0;
+    }
+
+    void SelectionSet::Bind(const DirectoryModel& model)
+    {
+        ACE_PROFILE_FUNCTION();
+        Model = &model;
+        Rows = model.Count();
+        RowBits.assign((Rows + 63) / 64, 0);
+        PendingBits.assign(RowBits.size(), 0);
+        PendingCount = 0;
+        Prefix = model.Base().lexically_relative(RootDir).generic_string();
+        if (Prefix == ".") Prefix.clear();
+        if (!Prefix.empty()) Prefix.push_back('/');
+        if (Selected == 0) return;
+
+        for (size_t i = 0; i < Rows; ++i) {
+            const std::string_view key = RowKey(i, Scratch);
+            const uint32_t id = Find(key, HashString(key));
+            if (id != kNone && Entries[id].Selected) RowBits[i >> 6] |= 1ull << (i & 63);
+        }
+    }
+
+    void SelectionSet::Unbind()
+    {
+        Flush();
+        Model = nullptr;
+        Rows = 0;
+        RowBits.clear();
+        PendingBits.clear();
+    }
+
+    std::string_view SelectionSet::RowKey(size_t row, std::string& scratch) const
+    {
+        const std::string_view key = Model->Key(row);
+        if (Prefix.empty()) return key;
+        scratch.assign(Prefix).append(key);
+        return scratch;
+    }
+
+    uint32_t SelectionSet::Find(std::string_view key, uint64_t hash) const
+    {
+        if (Table.empty()) return kNone;
+        const size_t mask = Table.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const uint32_t id = Table[slot];
+            if (id == kNone) return kNone;
+            if (Entries[id].Hash == hash && KeyOf(Entries[id]) == key) return id;
+        }
+    }
+
+    uint32_t SelectionSet::Intern(std::string_view key)
+    {
+        const uint64_t hash = HashString(key);
+        if (const uint32_t id = Find(key, hash); id != kNone) return id;
+        Grow(Entries.size() + 1);
+
+        const uint32_t id = (uint32_t)Entries.size();
+        Entry& e = Entries.emplace_back();
+        e.Hash = hash;
+        e.Offset = (uint32_t)Text.size();
+        e.Length = (uint32_t)key.size();
+        Text.append(key);
+
+        const size_t mask = Table.size() - 1;
+        size_t slot = hash & mask;
+        while (Table[slot] != kNone) slot = (slot + 1) & mask;
+        Table[slot] = id;
+        return id;
+    }
+
+    // Makes room for 'count' ids, keeping the table at most half full
+    void SelectionSet::Grow(size_t count)
+    {
+        size_t size = std::max<size_t>(64, Table.size());
+        while (count * 2 > size) size *= 2;
+        if (size == Table.size()) return;
+
+        Table.assign(size, kNone);
+        const size_t mask = size - 1;
+        for (uint32_t id = 0; id < (uint32_t)Entries.size(); ++id) {
+            size_t slot = Entries[id].Hash & mask;
+            while (Table[slot] != kNone) slot = (slot + 1) & mask;
+            Table[slot] = id;
+        }
+    }
+
+    // Rebuilds the keys and the table from the selected entries only. Ids
+    // change; nothing outside refers to them.
+    void SelectionSet::Compact()
+    {
+        ACE_PROFILE_FUNCTION();
+        std::string text;
+        std::vector<Entry> entries;
+        entries.reserve(Selected);
+        for (const Entry& e : Entries) {
+            if (!e.Selected) continue;
+            Entry& c = entries.emplace_back(e);
+            c.Offset = (uint32_t)text.size();
+            text.append(KeyOf(e));
+        }
+        Text.swap(text);
+        Entries.swap(entries);
+        Table.clear();
+        Grow(Entries.size());
+    }
+
+    void SelectionSet::Mark(uint32_t id)
+    {
+        Entry& e = Entries[id];
+        if (!e.Selected) { e.Selected = true; ++Selected; }
+        e.Order = NextOrder++;
+    }
+
+    void SelectionSet::Flush()
+    {
+        if (PendingCount == 0) return;
+        ACE_PROFILE_FUNCTION();
+        Grow(Entries.size() + PendingCount);
+        Entries.reserve(Entries.size() + PendingCount);
+        for (size_t w = 0; w < PendingBits.size(); ++w)
+            for (uint64_t bits = PendingBits[w]; bits; bits &= bits - 1)
+                Mark(Intern(RowKey(w * 64 + std::countr_zero(bits), Scratch)));
+        std::fill(PendingBits.begin(), PendingBits.end(), 0);
+        PendingCount = 0;
+    }
+
+    void SelectionSet::Select(size_t row)
+    {
+        if (row >= Rows || IsSelected(row)) return;
+        const uint64_t bit = 1ull << (row & 63);
+        RowBits[row >> 6] |= bit;
+        PendingBits[row >> 6] |= bit;
+        ++PendingCount;
+    }
+
+    void SelectionSet::Deselect(size_t row)
+    {
+        if (!IsSelected(row)) return;
+        const uint64_t bit = 1ull << (row & 63);
+        RowBits[row >> 6] &= ~bit;
+        if (PendingBits[row >> 6] & bit) {
+            PendingBits[row >> 6] &= ~bit;
+            --PendingCount;
+            return;
+        }
+        const std::string_view key = RowKey(row, Scratch);
+        const uint32_t id = Find(key, HashString(key));
+        if (id == kNone || !Entries[id].Selected) return;
+        Entries[id].Selected = false;
+        --Selected;
+        if (Entries.size() > 64 && Selected * 2 < Entries.size()) Compact();
+    }
+
+    void SelectionSet::SelectRange(size_t first, size_t last)
+    {
+        if (first > last) std::swap(first, last);
+        if (Rows == 0 || first >= Rows) return;
+        last = std::min(last, Rows - 1);
+        for (size_t w = first >> 6; w <= last >> 6; ++w) {
+            uint64_t mask = ~0ull;
+            if (w == first >> 6) mask &= ~0ull << (first & 63);
+            if (w == last >> 6)  mask &= ~0ull >> (63 - (last & 63));
+            const uint64_t added = mask & ~RowBits[w];
+            RowBits[w] |= added;
+            PendingBits[w] |= added;
+            PendingCount += (size_t)std::popcount(added);
+        }
+    }
+
+    void SelectionSet::SelectAll()
+    {
+        if (Rows) SelectRange(0, Rows - 1);
+    }
+
+    void SelectionSet::Select(const std::filesystem::path& path)
+    {
+        const std::string key = path.lexically_relative(RootDir).generic_string();
+        if (key.empty() || key == ".") return;
+        Flush();
+        Mark(Intern(key));
+        if (Model) Bind(*Model);
+    }
+
+    std::filesystem::path SelectionSet::PathOf(std::string_view key) const
+    {
+        std::filesystem::path p = RootDir / std::filesystem::path(key);
+        p.make_preferred();
+        return p;
+    }
+
+    std::vector<std::filesystem::path> SelectionSet::Paths() const
+    {
+        std::vector<const Entry*> sel;
+        sel.reserve(Selected);
+        for (const Entry& e : Entries)
+            if (e.Selected) sel.push_back(&e);
+        std::sort(sel.begin(), sel.end(), [](const Entry* a, const Entry* b) { return a->Order < b->Order; });
+
+        std::vector<std::filesystem::path> out;
+        out.reserve(Count());
+        for (const Entry* e : sel) out.push_back(PathOf(KeyOf(*e)));
+        std::string scratch;
+        for (size_t w = 0; w < PendingBits.size(); ++w)
+            for (uint64_t bits = PendingBits[w]; bits; bits &= bits - 1)
+                out.push_back(PathOf(RowKey(w * 64 + std::countr_zero(bits), scratch)));
+        return out;
+    }
+
+    std::filesystem::path SelectionSet::First() const
+    {
+        const Entry* first = nullptr;
+        for (const Entry& e : Entries)
+            if (e.Selected && (!first || e.Order < first->Order)) first = &e;
+        if (first) return PathOf(KeyOf(*first));
+
+        std::string scratch;
+        for (size_t w = 0; w < PendingBits.size(); ++w)
+            if (PendingBits[w]) return PathOf(RowKey(w * 64 + std::countr_zero(PendingBits[w]), scratch));
+        return {};
+    }
+}
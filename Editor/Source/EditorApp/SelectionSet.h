@@ -0,0 +1,98 @@
+﻿#pragma once
+#include "DirectoryModel.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ace::editor
+{
+    // The content browser selection.
+    //
+    // Selected items are interned by their path relative to the content
+    // root: the paths go back to back into one string and an open-addressing
+    // table maps them to ids. The selection is the set of ids marked
+    // selected, so it outlives the listing (a filter being typed, watcher
+    // events) without a path object per item. Deselected items keep their
+    // id until they outnumber the selected ones; then the table is rebuilt
+    // from the selection alone.
+    //
+    // The listing on screen mirrors it in a bitset by row, which is all the
+    // grid reads: drawing a cell tests a bit. Selecting rows only sets bits
+    // (a word at a time for ranges and select-all); their names are interned
+    // when the listing is about to change, or read straight from it for
+    // Paths(), so selecting 100k rows costs no more than drawing a frame.
+    //
+    // Unbind() before the bound model changes, Bind() it again after; row
+    // indices refer to the model last bound.
+    class SelectionSet {
+    public:
+        // Keys are relative to 'root'; changing it clears the selection
+        void SetRoot(const std::filesystem::path& root);
+        void Clear();
+
+        bool   Empty() const { return Count() == 0; }
+        size_t Count() const { return Selected + PendingCount; }
+
+        // Mirrors the selection onto the rows of 'model' (O(rows) when
+        // anything is selected); 'model' must outlive the binding
+        void Bind(const DirectoryModel& model);
+        // Interns the rows selected since the last call, so the model can change
+        void Unbind();
+        bool IsSelected(size_t row) const { return row < Rows && (RowBits[row >> 6] >> (row & 63) & 1) != 0; }
+
+        void Select(size_t row);
+        void Deselect(size_t row);
+        // Rows first..last, inclusive, in either order
+        void SelectRange(size_t first, size_t last);
+        void SelectAll();
+        // An item below the root that may not be listed yet (just created);
+        // its row is marked when a listing holding it is bound
+        void Select(const std::filesystem::path& path);
+
+        // Absolute paths in the order selected (rows not interned yet last,
+        // in row order); builds a path per item
+        std::vector<std::filesystem::path> Paths() const;
+        // The earliest still selected, or empty
+        std::filesystem::path First() const;
+
+    private:
+        static constexpr uint32_t kNone = ~0u;
+
+        struct Entry {
+            uint64_t Hash = 0;
+            uint32_t Offset = 0;                // into Text
+            uint32_t Length = 0;
+            uint32_t Order = 0;                 // when last selected
+            bool     Selected = false;
+        };
+
+        std::string_view RowKey(size_t row, std::string& scratch) const;
+        std::string_view KeyOf(const Entry& e) const { return {Text.data() + e.Offset, e.Length}; }
+        uint32_t Find(std::string_view key, uint64_t hash) const;
+        uint32_t Intern(std::string_view key);
+        void     Grow(size_t count);
+        void     Mark(uint32_t id);
+        void     Flush();
+        void     Compact();
+        std::filesystem::path PathOf(std::string_view key) const;
+
+        std::filesystem::path RootDir;
+        std::string           Text;             // interned keys, back to back
+        std::vector<Entry>    Entries;          // by id
+        std::vector<uint32_t> Table;            // id per slot, kNone = empty; size is a power of two
+        size_t                Selected = 0;
+        uint32_t              NextOrder = 0;
+
+        // The bound listing
+        const DirectoryModel* Model = nullptr;
+        std::string           Prefix;           // model base relative to the root, with a trailing '/'
+        std::string           Scratch;
+        std::vector<uint64_t> RowBits;
+        std::vector<uint64_t> PendingBits;      // selected rows not interned yet
+        size_t                PendingCount = 0;
+        size_t                Rows = 0;
+    };
+}
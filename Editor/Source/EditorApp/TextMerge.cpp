@@ -0,0 +1,240 @@
+﻿#include "TextMerge.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ace::editor
+{
+    namespace {
+        constexpr std::string_view kOursMarker   = "<<<<<<< Editor\n";
+        constexpr std::string_view kSplitMarker  = "=======\n";
+        constexpr std::string_view kTheirsMarker = ">>>>>>> Disk\n";
+
+        // A text as line ids; equal lines share an id across all three texts
+        struct Lines {
+            std::vector<std::string_view> Text;     // each with its '\n', if any
+            std::vector<uint32_t>         Ids;
+        };
+
+        class Interner {
+        public:
+            void Split(std::string_view text, Lines& out)
+            {
+                size_t begin = 0;
+                while (begin < text.size()) {
+                    const size_t nl = text.find('\n', begin);
+                    const size_t end = nl == std::string_view::npos ? text.size() : nl + 1;
+                    const std::string_view line = text.substr(begin, end - begin);
+                    out.Text.push_back(line);
+                    out.Ids.push_back(Ids.try_emplace(line, (uint32_t)Ids.size()).first->second);
+                    begin = end;
+                }
+            }
+
+        private:
+            std::unordered_map<std::string_view, uint32_t> Ids;
+        };
+
+        // Myers' O((N+M)D) diff in linear space (the "middle snake" split).
+        // Produces Match[i] = index in B of line i of A, or -1. Past a work
+        // limit the remaining regions are left unmatched, i.e. replaced, so
+        // a rewritten file costs tens of milliseconds rather than seconds.
+        class Differ {
+        public:
+            static constexpr int64_t kMaxSteps = 1 << 22;
+
+            Differ(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<int32_t>& match)
+                : A(a), B(b), Match(match)
+            {
+                Match.assign(A.size(), -1);
+                const size_t max = (A.size() + B.size() + 1) / 2 + 1;
+                Forward.resize(2 * max + 1);
+                Backward.resize(2 * max + 1);
+                Offset = (int)max;
+            }
+
+            void Run() { Diff(0, (int)A.size(), 0, (int)B.size()); }
+
+        private:
+            struct Snake { int X, Y, U, V; };
+
+            void Diff(int aLo, int aHi, int bLo, int bHi)
+            {
+                // Common head and tail cost one comparison per line
+                while (aLo < aHi && bLo < bHi && A[aLo] == B[bLo]) Match[aLo++] = bLo++;
+                while (aLo < aHi && bLo < bHi && A[aHi - 1] == B[bHi - 1]) Match[--aHi] = --bHi;
+                if (aLo == aHi || bLo == bHi) return;   // pure insertion or deletion
+
+                Snake s;
+                if (!MiddleSnake(aLo, aHi, bLo, bHi, s)) return;
+                // Both sides are non-empty and differ at both ends, so D >= 2
+                // and each half is strictly smaller; the guard is for safety
+                if ((s.U == 0 && s.V == 0) || (s.X == aHi - aLo && s.Y == bHi - bLo)) return;
+                Diff(aLo, aLo + s.X, bLo, bLo + s.Y);
+                for (int x = s.X, y = s.Y; x < s.U; ++x, ++y) Match[aLo + x] = bLo + y;
+                Diff(aLo + s.U, aHi, bLo + s.V, bHi);
+            }
+
+            // Coordinates relative to (aLo, bLo); false once out of steps
+            bool MiddleSnake(int aLo, int aHi, int bLo, int bHi, Snake& s)
+            {
+                const int n = aHi - aLo, m = bHi - bLo;
+                const int delta = n - m;
+                const bool odd = (delta & 1) != 0;
+                const int maxD = (n + m + 1) / 2;
+                int* vf = Forward.data() + Offset;
+                int* vb = Backward.data() + Offset;
+                vf[1] = 0;
+                vb[1] = 0;
+                for (int d = 0; d <= maxD; ++d) {
+                    if ((Steps -= 2 * (d + 1)) < 0) return false;
+                    for (int k = -d; k <= d; k += 2) {
+                        int x = (k == -d || (k != d && vf[k - 1] < vf[k + 1])) ? vf[k + 1] : vf[k - 1] + 1;
+                        int y = x - k;
+                        const int x0 = x, y0 = y;
+                        while (x < n && y < m && A[aLo + x] == B[bLo + y]) { ++x; ++y; }
+                        vf[k] = x;
+                        // Backward paths of d - 1 edits on the same diagonal
+                        const int kb = delta - k;
+                        if (odd && kb >= -(d - 1) && kb <= d - 1 && x + vb[kb] >= n) {
+                            s = {x0, y0, x, y};
+                            return true;
+                        }
+                    }
+                    for (int k = -d; k <= d; k += 2) {
+                        // Same walk over the reversed texts
+                        int x = (k == -d || (k != d && vb[k - 1] < vb[k + 1])) ? vb[k + 1] : vb[k - 1] + 1;
+                        int y = x - k;
+                        const int x0 = x, y0 = y;
+                        while (x < n && y < m && A[aHi - 1 - x] == B[bHi - 1 - y]) { ++x; ++y; }
+                        vb[k] = x;
+                        const int kf = delta - k;
+                        if (!odd && kf >= -d && kf <= d && x + vf[kf] >= n) {
+                            s = {n - x, m - y, n - x0, m - y0};
+                            return true;
+                        }
+                    }
+                }
+                return false;           // unreachable
+            }
+
+            const std::vector<uint32_t>& A;
+            const std::vector<uint32_t>& B;
+            std::vector<int32_t>&        Match;
+            std::vector<int>             Forward, Backward;
+            int                          Offset = 0;
+            int64_t                      Steps = kMaxSteps;
+        };
+
+        bool SameLines(const Lines& a, size_t aLo, size_t aHi, const Lines& b, size_t bLo, size_t bHi)
+        {
+            return aHi - aLo == bHi - bLo && std::equal(a.Ids.begin() + (ptrdiff_t)aLo, a.Ids.begin() + (ptrdiff_t)aHi,
+                                                         b.Ids.begin() + (ptrdiff_t)bLo);
+        }
+
+        // Bytes of whole lines the three texts start with
+        size_t CommonHead(std::string_view a, std::string_view b, std::string_view c)
+        {
+            const size_t n = std::min({a.size(), b.size(), c.size()});
+            size_t i = 0;
+            while (i < n && a[i] == b[i] && a[i] == c[i]) ++i;
+            while (i && a[i - 1] != '\n') --i;
+            return i;
+        }
+
+        // Same for whole lines they end with, not overlapping 'head'
+        size_t CommonTail(std::string_view a, std::string_view b, std::string_view c, size_t head)
+        {
+            const size_t n = std::min({a.size(), b.size(), c.size()}) - head;
+            size_t i = 0;
+            while (i < n && a[a.size() - 1 - i] == b[b.size() - 1 - i] && a[a.size() - 1 - i] == c[c.size() - 1 - i]) ++i;
+            // Must start a line in all three; else start after its first newline
+            const auto startsLine = [&](std::string_view t) {
+                const size_t p = t.size() - i;
+                return p == head || t[p - 1] == '\n';
+            };
+            if (!startsLine(a) || !startsLine(b) || !startsLine(c)) {
+                const size_t nl = a.substr(a.size() - i).find('\n');
+                i = nl == std::string_view::npos ? 0 : i - nl - 1;
+            }
+            return i;
+        }
+
+        void Emit(const Lines& l, size_t lo, size_t hi, std::string& out)
+        {
+            for (size_t i = lo; i < hi; ++i) out += l.Text[i];
+        }
+
+        // Conflict sides must end in a newline or the marker after them
+        // would join their last line
+        void EmitSide(const Lines& l, size_t lo, size_t hi, std::string& out)
+        {
+            Emit(l, lo, hi, out);
+            if (hi > lo && out.back() != '\n') out += '\n';
+        }
+    }
+
+    size_t MergeText(std::string_view base, std::string_view ours, std::string_view theirs, std::string& out)
+    {
+        ACE_PROFILE_FUNCTION();
+        out.clear();
+        if (ours == theirs || theirs == base) { out.assign(ours); return 0; }
+        if (ours == base)                     { out.assign(theirs); return 0; }
+
+        // Only the lines between the common head and tail need diffing
+        const size_t head = CommonHead(base, ours, theirs);
+        const size_t tail = CommonTail(base, ours, theirs, head);
+        out.reserve(std::max(ours.size(), theirs.size()));
+        out.assign(base.substr(0, head));
+        base   = base.substr(head, base.size() - head - tail);
+        ours   = ours.substr(head, ours.size() - head - tail);
+        theirs = theirs.substr(head, theirs.size() - head - tail);
+
+        Interner interner;
+        Lines o, a, b;                          // base, ours, theirs
+        interner.Split(base, o);
+        interner.Split(ours, a);
+        interner.Split(theirs, b);
+
+        std::vector<int32_t> toA, toB;          // base line -> ours / theirs line, or -1
+        Differ(o.Ids, a.Ids, toA).Run();
+        Differ(o.Ids, b.Ids, toB).Run();
+
+        const size_t nO = o.Ids.size(), nA = a.Ids.size(), nB = b.Ids.size();
+        size_t io = 0, ia = 0, ib = 0, conflicts = 0;
+        while (io < nO || ia < nA || ib < nB) {
+            // Stable run: base lines both sides kept in place
+            size_t k = 0;
+            while (io + k < nO && toA[io + k] == (int32_t)(ia + k) && toB[io + k] == (int32_t)(ib + k)) ++k;
+            if (k) {
+                Emit(o, io, io + k, out);
+                io += k; ia += k; ib += k;
+                continue;
+            }
+
+            // Unstable run: up to the next base line both sides kept
+            size_t jo = io;
+            while (jo < nO && (toA[jo] < 0 || toB[jo] < 0)) ++jo;
+            const size_t ja = jo < nO ? (size_t)toA[jo] : nA;
+            const size_t jb = jo < nO ? (size_t)toB[jo] : nB;
+
+            if (SameLines(o, io, jo, a, ia, ja)) {
+                Emit(b, ib, jb, out);               // only theirs changed
+            } else if (SameLines(o, io, jo, b, ib, jb) || SameLines(a, ia, ja, b, ib, jb)) {
+                Emit(a, ia, ja, out);               // only ours changed, or both alike
+            } else {
+                ++conflicts;
+                out += kOursMarker;
+                EmitSide(a, ia, ja, out);
+                out += kSplitMarker;
+                EmitSide(b, ib, jb, out);
+                out += kTheirsMarker;
+            }
+            io = jo; ia = ja; ib = jb;
+        }
+        out.append(theirs.data() + theirs.size(), tail);    // the common tail follows each middle
+        return conflicts;
+    }
+}
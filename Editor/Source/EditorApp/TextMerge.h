@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ace::editor
+{
+    // Three-way merge by lines, for a text tab whose file changed on disk
+    // while it had unsaved edits: 'base' is the file as the tab last loaded
+    // or saved it, 'ours' the tab's text, 'theirs' the file now.
+    //
+    // Each side is diffed against base (Myers, linear space, after trimming
+    // the common head and tail, so the work grows with the size of the
+    // edits rather than of the file). Regions changed on one side only take
+    // that side; regions both sides changed identically are taken once;
+    // anything else is a conflict, written between git-style markers:
+    //
+    //     <<<<<<< Editor
+    //     ours
+    //     =======
+    //     theirs
+    //     >>>>>>> Disk
+    //
+    // Writes the result to 'out' and returns the number of conflicts.
+    size_t MergeText(std::string_view base, std::string_view ours, std::string_view theirs, std::string& out);
+}
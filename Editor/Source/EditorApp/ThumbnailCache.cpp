@@ -0,0 +1,522 @@
+﻿#include "ThumbnailCache.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/Image.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/Core/Math.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/MapBinary.h"
+#include "Runtime/World/World.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <string>
+
+#ifdef _WIN32
+  #include <Windows.h>
+#endif
+#include <GL/gl.h>
+
+namespace ace::editor
+{
+    namespace {
+        constexpr uint32_t kThumbnailVersion = 1;       // bump when any generator's output changes
+        constexpr int      kSize          = ThumbnailCache::kSize;
+        constexpr size_t   kPixelBytes    = (size_t)kSize * kSize * 4;
+        constexpr int      kPageSize      = 2048;
+        constexpr int      kSlotsPerRow   = kPageSize / kSize;
+        constexpr int      kSlotsPerPage  = kSlotsPerRow * kSlotsPerRow;
+        constexpr size_t   kMaxPages      = 4;          // 1024 previews, 64 MiB of textures
+        constexpr int      kUploadsPerFrame = 16;
+        constexpr uint32_t kMaxJobs       = 2;
+
+        enum class Kind { None, Image, Mesh, Map };
+
+        std::string LowerExtension(const std::filesystem::path& p)
+        {
+            std::string ext = p.extension().string();
+            for (char& c : ext) c = (char)std::tolower((unsigned char)c);
+            return ext;
+        }
+
+        Kind KindOf(const std::string& ext)
+        {
+            if (ext == ".png" || ext == ".bmp" || ext == ".tga") return Kind::Image;
+            if (ext == ".obj")    return Kind::Mesh;
+            if (ext == ".acemap") return Kind::Map;
+            return Kind::None;
+        }
+
+        // Scaled to fit, centred on a transparent square
+        bool FitImage(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+        {
+            Image src;
+            if (!DecodeImage(data, size, src)) return false;
+            const float scale = (float)kSize / (float)std::max(src.Width, src.Height);
+            const uint32_t w = std::max(1u, (uint32_t)std::lround(src.Width * scale));
+            const uint32_t h = std::max(1u, (uint32_t)std::lround(src.Height * scale));
+            Image fit;
+            ResizeImage(src, w, h, fit);
+            out.assign(kPixelBytes, 0);
+            const uint32_t x0 = (kSize - w) / 2, y0 = (kSize - h) / 2;
+            for (uint32_t y = 0; y < h; ++y)
+                std::memcpy(&out[((y0 + y) * kSize + x0) * 4], &fit.Rgba[(size_t)y * w * 4], (size_t)w * 4);
+            return true;
+        }
+
+        void SkipSpace(const char*& p, const char* end)
+        {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        }
+
+        // Wavefront .obj: positions and faces only, seen from above at an angle,
+        // flat shaded, rendered at twice the size and filtered down
+        bool RenderObj(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+        {
+            std::vector<Vec3>     verts;
+            std::vector<uint32_t> tris;
+            std::vector<uint32_t> face;
+            const char* p   = reinterpret_cast<const char*>(data);
+            const char* end = p + size;
+            while (p < end) {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', (size_t)(end - p)));
+                if (!eol) eol = end;
+                if (eol - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+                    const char* q = p + 2;
+                    float xyz[3] = {};
+                    for (float& f : xyz) { SkipSpace(q, eol); q = std::from_chars(q, eol, f).ptr; }
+                    verts.push_back({xyz[0], xyz[1], xyz[2]});
+                } else if (eol - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+                    face.clear();
+                    const char* q = p + 2;
+                    for (;;) {
+                        SkipSpace(q, eol);
+                        long idx = 0;
+                        const auto r = std::from_chars(q, eol, idx);
+                        if (r.ec != std::errc()) break;
+                        q = r.ptr;
+                        while (q < eol && *q != ' ' && *q != '\t') ++q;         // "/vt/vn"
+                        idx = idx < 0 ? (long)verts.size() + idx : idx - 1;
+                        if (idx < 0 || idx >= (long)verts.size()) return false;
+                        face.push_back((uint32_t)idx);
+                    }
+                    for (size_t i = 2; i < face.size(); ++i) tris.insert(tris.end(), {face[0], face[i - 1], face[i]});
+                }
+                p = eol + 1;
+            }
+            if (tris.empty()) return false;
+
+            constexpr int   R = kSize * 2;
+            constexpr float kYaw = 0.7853982f, kPitch = 0.5235988f;        // 45 and 30 degrees
+            const float cy = std::cos(kYaw), sy = std::sin(kYaw), cp = std::cos(kPitch), sp = std::sin(kPitch);
+            Vec3 lo{ 1e30f, 1e30f, 1e30f }, hi{ -1e30f, -1e30f, -1e30f };
+            for (Vec3& v : verts) {
+                const float x = v.X * cy + v.Z * sy;
+                const float z = -v.X * sy + v.Z * cy;
+                v = { x, v.Y * cp - z * sp, v.Y * sp + z * cp };            // +Z towards the viewer
+                lo = { std::min(lo.X, v.X), std::min(lo.Y, v.Y), 0 };
+                hi = { std::max(hi.X, v.X), std::max(hi.Y, v.Y), 0 };
+            }
+            const float extent = std::max(hi.X - lo.X, hi.Y - lo.Y);
+            if (!(extent > 0) || !std::isfinite(extent)) return false;
+            const float scale = R * 0.9f / extent;
+            const float ox = R * 0.5f - (lo.X + hi.X) * 0.5f * scale, oy = R * 0.5f + (lo.Y + hi.Y) * 0.5f * scale;
+
+            std::vector<float>   depth((size_t)R * R, -1e30f);
+            std::vector<uint8_t> colour((size_t)R * R * 4, 0);
+            const Vec3 light = Vec3{ -0.4f, 0.7f, 0.6f } * (1.0f / std::sqrt(0.16f + 0.49f + 0.36f));
+            for (size_t t = 0; t < tris.size(); t += 3) {
+                const Vec3& a = verts[tris[t]];
+                const Vec3& b = verts[tris[t + 1]];
+                const Vec3& c = verts[tris[t + 2]];
+                const Vec3 e1 = b - a, e2 = c - a;
+                Vec3 n{ e1.Y * e2.Z - e1.Z * e2.Y, e1.Z * e2.X - e1.X * e2.Z, e1.X * e2.Y - e1.Y * e2.X };
+                const float len = std::sqrt(n.X * n.X + n.Y * n.Y + n.Z * n.Z);
+                if (!(len > 0)) continue;
+                const float lit = 0.3f + 0.7f * std::fabs((n.X * light.X + n.Y * light.Y + n.Z * light.Z) / len);
+
+                const float ax = ox + a.X * scale, ay = oy - a.Y * scale;
+                const float bx = ox + b.X * scale, by = oy - b.Y * scale;
+                const float cx = ox + c.X * scale, cyy = oy - c.Y * scale;
+                const float area = (bx - ax) * (cyy - ay) - (by - ay) * (cx - ax);
+                if (std::fabs(area) < 1e-8f) continue;
+                const int x0 = std::max(0, (int)std::floor(std::min({ax, bx, cx})));
+                const int x1 = std::min(R - 1, (int)std::ceil(std::max({ax, bx, cx})));
+                const int y0 = std::max(0, (int)std::floor(std::min({ay, by, cyy})));
+                const int y1 = std::min(R - 1, (int)std::ceil(std::max({ay, by, cyy})));
+                const uint8_t shade[4] = { (uint8_t)(170 * lit), (uint8_t)(185 * lit), (uint8_t)(205 * lit), 255 };
+                for (int y = y0; y <= y1; ++y)
+                    for (int x = x0; x <= x1; ++x) {
+                        const float px = x + 0.5f, py = y + 0.5f;
+                        const float w0 = ((bx - px) * (cyy - py) - (by - py) * (cx - px)) / area;
+                        const float w1 = ((cx - px) * (ay - py) - (cyy - py) * (ax - px)) / area;
+                        const float w2 = 1.0f - w0 - w1;
+                        if (w0 < 0 || w1 < 0 || w2 < 0) continue;
+                        const float z = w0 * a.Z + w1 * b.Z + w2 * c.Z;
+                        float& d = depth[(size_t)y * R + x];
+                        if (z <= d) continue;
+                        d = z;
+                        std::memcpy(&colour[((size_t)y * R + x) * 4], shade, 4);
+                    }
+            }
+            Image big{ R, R, std::move(colour) }, small;
+            ResizeImage(big, kSize, kSize, small);
+            out = std::move(small.Rgba);
+            return true;
+        }
+
+        // Entity positions seen from above: the two axes with the largest
+        // spread, static meshes highlighted
+        bool PlotMap(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+        {
+            World world;
+            if (!LoadMap(world, data, size)) return false;
+            std::vector<std::pair<Vec3, bool>> points;
+            world.Each<TransformComponent>([&](Entity e, TransformComponent& t) {
+                points.push_back({ t.Position, world.Has<StaticMeshComponent>(e) });
+            });
+
+            out.assign(kPixelBytes, 0);
+            auto fill = [&](int x0, int y0, int x1, int y1, std::array<uint8_t, 4> c) {
+                for (int y = std::max(0, y0); y < std::min(kSize, y1); ++y)
+                    for (int x = std::max(0, x0); x < std::min(kSize, x1); ++x)
+                        std::memcpy(&out[((size_t)y * kSize + x) * 4], c.data(), 4);
+            };
+            fill(0, 0, kSize, kSize, { 28, 32, 38, 255 });
+            for (int i = 16; i < kSize; i += 16) {
+                fill(i, 0, i + 1, kSize, { 40, 46, 54, 255 });
+                fill(0, i, kSize, i + 1, { 40, 46, 54, 255 });
+            }
+            if (points.empty()) return true;
+
+            float lo[3] = { 1e30f, 1e30f, 1e30f }, hi[3] = { -1e30f, -1e30f, -1e30f };
+            for (const auto& [pos, mesh] : points) {
+                const float v[3] = { pos.X, pos.Y, pos.Z };
+                for (int i = 0; i < 3; ++i) { lo[i] = std::min(lo[i], v[i]); hi[i] = std::max(hi[i], v[i]); }
+            }
+            int drop = 0;                       // axis with the least spread
+            for (int i = 1; i < 3; ++i) if (hi[i] - lo[i] < hi[drop] - lo[drop]) drop = i;
+            const int u = drop == 0 ? 1 : 0, v = drop == 2 ? 1 : 2;
+            const float extent = std::max({ hi[u] - lo[u], hi[v] - lo[v], 1e-3f });
+            const float margin = 10.0f, scale = (kSize - 2 * margin) / extent;
+            for (const auto& [pos, mesh] : points) {
+                const float c[3] = { pos.X, pos.Y, pos.Z };
+                if (!std::isfinite(c[u]) || !std::isfinite(c[v])) continue;
+                const int x = (int)(kSize * 0.5f + (c[u] - (lo[u] + hi[u]) * 0.5f) * scale);
+                const int y = (int)(kSize * 0.5f - (c[v] - (lo[v] + hi[v]) * 0.5f) * scale);
+                fill(x - 2, y - 2, x + 3, y + 3, mesh ? std::array<uint8_t, 4>{ 90, 180, 255, 255 }
+                                                      : std::array<uint8_t, 4>{ 220, 220, 220, 255 });
+            }
+            return true;
+        }
+
+        bool Generate(Kind kind, const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+        {
+            // A malformed file fails its preview, not the worker
+            try {
+                switch (kind) {
+                    case Kind::Image: return FitImage(data, size, out);
+                    case Kind::Mesh:  return RenderObj(data, size, out);
+                    case Kind::Map:   return PlotMap(data, size, out);
+                    default:          return false;
+                }
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+
+    ThumbnailCache::~ThumbnailCache()
+    {
+        if (Stopped) return;
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();
+        }
+        JobSystem::Get().Wait(JobsDone);
+    }
+
+    bool ThumbnailCache::Supports(const std::filesystem::path& path)
+    {
+        return KindOf(LowerExtension(path)) != Kind::None;
+    }
+
+    void ThumbnailCache::SetCacheDir(const std::filesystem::path& dir)
+    {
+        if (dir == Dir) return;
+        Dir = dir;
+        uint32_t gen;
+        {
+            std::lock_guard lock(Mutex);
+            Disk.reset();
+            gen = ++DiskGen;
+        }
+        if (dir.empty()) return;
+        // Open() indexes every entry already there: keep it off the main thread
+        JobSystem::Get().Run([this, dir, gen] {
+            auto ddc = std::make_shared<DerivedDataCache>();
+            if (!ddc->Open(dir)) {
+                ACE_LOG_WARN("Thumbnails", "cannot open derived-data cache %s", dir.string().c_str());
+                return;
+            }
+            std::lock_guard lock(Mutex);
+            if (gen == DiskGen) Disk = std::move(ddc);
+        }, &JobsDone);
+    }
+
+    bool ThumbnailCache::Draw(ImDrawList* dl, const std::filesystem::path& path, const ImVec2& p0, const ImVec2& p1)
+    {
+        auto [it, added] = Entries.try_emplace(path.native());
+        Entry& e = it->second;
+        e.LastDrawn = Frame;
+        if (added) {
+            e.Gen = ++NextGen;
+            const uint64_t hash = Lookup ? Lookup(path) : 0;
+            {
+                std::lock_guard lock(Mutex);
+                Queue.push_back({ it->first, e.Gen, hash });
+            }
+            Dispatch();
+            return false;
+        }
+        if (e.Slot < 0) return false;
+
+        Slots[(size_t)e.Slot].LastDrawn = Frame;
+        const int local = e.Slot % kSlotsPerPage;
+        // Half a texel in from the slot edge so filtering never reads a neighbour
+        const float x = (float)(local % kSlotsPerRow * kSize), y = (float)(local / kSlotsPerRow * kSize);
+        const ImVec2 uv0((x + 0.5f) / kPageSize, (y + 0.5f) / kPageSize);
+        const ImVec2 uv1((x + kSize - 0.5f) / kPageSize, (y + kSize - 0.5f) / kPageSize);
+        dl->AddImage((ImTextureID)Pages[(size_t)(e.Slot / kSlotsPerPage)], p0, p1, uv0, uv1);
+        return true;
+    }
+
+    void ThumbnailCache::Invalidate(const std::filesystem::path& path)
+    {
+        const auto it = Entries.find(path.native());
+        if (it == Entries.end()) return;
+        FreeSlot(it->second);
+        Entries.erase(it);          // its request and result no longer match anything
+    }
+
+    void ThumbnailCache::Clear()
+    {
+        for (Slot& s : Slots) s.Owner = nullptr;
+        Entries.clear();
+        Uploads.clear();
+        Failed.clear();
+        std::lock_guard lock(Mutex);
+        Queue.clear();
+    }
+
+    void ThumbnailCache::Update()
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<Result> done;
+        {
+            std::lock_guard lock(Mutex);
+            // Cells that were not drawn last frame scrolled away (or their
+            // folder closed): forget them, Draw() asks again if they return
+            std::erase_if(Queue, [&](const Request& r) {
+                const auto it = Entries.find(r.Path);
+                if (it == Entries.end() || it->second.Gen != r.Gen) return true;
+                if (it->second.LastDrawn == Frame) return false;
+                Entries.erase(it);
+                return true;
+            });
+            done.swap(Done);
+        }
+
+        for (Result& r : done) {
+            const auto it = Entries.find(r.Path);
+            if (it == Entries.end() || it->second.Gen != r.Gen) continue;
+            if (r.Pixels.size() != kPixelBytes) {
+                // The entry stays while drawn, so no retry every frame
+                ++Counters.Failures;
+                Failed.emplace_back(std::move(r.Path), r.Gen);
+                continue;
+            }
+            ++(r.FromDisk ? Counters.DiskHits : Counters.Generated);
+            Uploads.push_back(std::move(r));
+        }
+
+        // Bounded uploads per frame; previews whose cell has gone are dropped
+        // and come back from the disk cache
+        int budget = kUploadsPerFrame;
+        size_t kept = 0;
+        for (size_t i = 0; i < Uploads.size(); ++i) {
+            Result& r = Uploads[i];
+            const auto it = Entries.find(r.Path);
+            if (it == Entries.end() || it->second.Gen != r.Gen) continue;
+            Entry& e = it->second;
+            if (e.LastDrawn != Frame) { Entries.erase(it); continue; }
+            if (budget > 0) {
+                if (const int slot = AllocateSlot(); slot >= 0) {
+                    Upload(slot, r.Pixels.data());
+                    Slots[(size_t)slot] = { &it->first, Frame };
+                    e.Slot = slot;
+                    --budget;
+                    continue;
+                }
+            }
+            if (kept != i) Uploads[kept] = std::move(r);
+            ++kept;
+        }
+        Uploads.resize(kept);
+
+        // Failed entries have no request or upload left to expire them: drop
+        // them once undrawn like the rest, so the map does not only grow
+        std::erase_if(Failed, [&](const std::pair<Key, uint32_t>& f) {
+            const auto it = Entries.find(f.first);
+            if (it == Entries.end() || it->second.Gen != f.second) return true;
+            if (it->second.LastDrawn == Frame) return false;
+            Entries.erase(it);
+            return true;
+        });
+
+        ++Frame;
+        Dispatch();
+    }
+
+    void ThumbnailCache::Shutdown()
+    {
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();
+        }
+        JobSystem::Get().Wait(JobsDone);
+        Stopped = true;
+        Clear();
+        Slots.clear();
+        if (!Pages.empty()) glDeleteTextures((GLsizei)Pages.size(), Pages.data());
+        Pages.clear();
+        std::lock_guard lock(Mutex);
+        Disk.reset();
+    }
+
+    ThumbnailStats ThumbnailCache::GetStats() const
+    {
+        ThumbnailStats s = Counters;
+        s.Entries = Entries.size();
+        s.Resident = (size_t)std::count_if(Slots.begin(), Slots.end(), [](const Slot& sl) { return sl.Owner != nullptr; });
+        s.Pages = Pages.size();
+        std::lock_guard lock(Mutex);
+        s.Queued = Queue.size();
+        return s;
+    }
+
+    void ThumbnailCache::Dispatch()
+    {
+        std::lock_guard lock(Mutex);
+        const uint32_t maxJobs = std::min(kMaxJobs, std::max(1u, JobSystem::Get().NumWorkers()));
+        while (Jobs < maxJobs && Jobs < Queue.size()) {
+            ++Jobs;
+            JobSystem::Get().Run([this] { WorkJob(); }, &JobsDone);
+        }
+    }
+
+    // Worker side: newest request first until the queue is empty
+    void ThumbnailCache::WorkJob()
+    {
+        for (;;) {
+            Request req;
+            std::shared_ptr<DerivedDataCache> disk;
+            {
+                std::lock_guard lock(Mutex);
+                if (Queue.empty()) { --Jobs; return; }
+                req = std::move(Queue.back());
+                Queue.pop_back();
+                disk = Disk;
+            }
+
+            ACE_PROFILE_SCOPE("Thumbnail");
+            Result res;
+            res.Path = std::move(req.Path);
+            res.Gen = req.Gen;
+            const std::filesystem::path path(res.Path);
+            const std::string ext = LowerExtension(path);
+            auto keyOf = [&](uint64_t hash) { return DdcKeyBuilder("Thumbnail", kThumbnailVersion).Add(hash).Add(ext).Finish(); };
+
+            if (disk && req.Hash && disk->Get(keyOf(req.Hash), res.Pixels) && res.Pixels.size() == kPixelBytes) {
+                res.FromDisk = true;
+            } else {
+                res.Pixels.clear();
+                MappedFile file;
+                if (file.Open(path)) {
+                    const uint64_t hash = Hash64(file.Data(), file.Size());
+                    const DdcKey key = keyOf(hash);
+                    if (disk && hash != req.Hash && disk->Get(key, res.Pixels) && res.Pixels.size() == kPixelBytes) {
+                        res.FromDisk = true;
+                    } else if (Generate(KindOf(ext), file.Data(), file.Size(), res.Pixels)) {
+                        if (disk) disk->Put(key, res.Pixels);
+                    } else {
+                        res.Pixels.clear();
+                    }
+                }
+            }
+
+            std::lock_guard lock(Mutex);
+            Done.push_back(std::move(res));
+        }
+    }
+
+    // A free slot, else a new page, else the least recently drawn slot that
+    // was not on screen last frame; -1 if every slot is in use
+    int ThumbnailCache::AllocateSlot()
+    {
+        int oldest = -1;
+        for (int i = 0; i < (int)Slots.size(); ++i) {
+            const Slot& s = Slots[(size_t)i];
+            if (!s.Owner) return i;
+            if (s.LastDrawn != Frame && (oldest < 0 || s.LastDrawn < Slots[(size_t)oldest].LastDrawn)) oldest = i;
+        }
+        if (Pages.size() < kMaxPages) {
+            GLuint tex = 0;
+            glGenTextures(1, &tex);
+            if (tex) {
+                GLint prev = 0;
+                glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev);
+                glBindTexture(GL_TEXTURE_2D, tex);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kPageSize, kPageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                glBindTexture(GL_TEXTURE_2D, (GLuint)prev);
+                Pages.push_back(tex);
+                Slots.resize(Slots.size() + kSlotsPerPage);
+                return (int)(Slots.size() - kSlotsPerPage);
+            }
+        }
+        if (oldest < 0) return -1;
+        const auto it = Entries.find(*Slots[(size_t)oldest].Owner);
+        Slots[(size_t)oldest].Owner = nullptr;
+        Entries.erase(it);
+        ++Counters.Evictions;
+        return oldest;
+    }
+
+    void ThumbnailCache::FreeSlot(Entry& e)
+    {
+        if (e.Slot >= 0) Slots[(size_t)e.Slot].Owner = nullptr;
+        e.Slot = -1;
+    }
+
+    void ThumbnailCache::Upload(int slot, const uint8_t* pixels)
+    {
+        const int local = slot % kSlotsPerPage;
+        GLint prev = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev);
+        glBindTexture(GL_TEXTURE_2D, Pages[(size_t)(slot / kSlotsPerPage)]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, local % kSlotsPerRow * kSize, local / kSlotsPerRow * kSize,
+                        kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glBindTexture(GL_TEXTURE_2D, (GLuint)prev);
+        ++Counters.Uploads;
+    }
+}
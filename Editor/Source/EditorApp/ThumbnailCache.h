@@ -0,0 +1,138 @@
+﻿#pragma once
+#include "Runtime/Asset/DerivedDataCache.h"
+#include "Runtime/Core/JobSystem.h"
+#include "imgui.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ace::editor
+{
+    struct ThumbnailStats {
+        size_t   Entries = 0;           // known paths: resident, pending or failed
+        size_t   Resident = 0;          // in the atlas
+        size_t   Queued = 0;
+        size_t   Pages = 0;             // atlas textures
+        uint64_t Generated = 0;         // built from the source file
+        uint64_t DiskHits = 0;          // read back from the derived-data cache
+        uint64_t Failures = 0;
+        uint64_t Uploads = 0;
+        uint64_t Evictions = 0;
+    };
+
+    // Preview images for the content browser grid.
+    //
+    // Draw() is called for visible cells only. A path seen for the first
+    // time is queued, newest first, for a worker that reads the 128x128
+    // preview from the derived-data cache (keyed by the file's content hash)
+    // or renders it from the file: images are decoded and scaled, .obj meshes
+    // rasterized, maps plotted from above. Requests for cells that scrolled
+    // away before a worker got to them are dropped at the next Update().
+    //
+    // Finished previews are copied into 2048x2048 atlas pages, a bounded
+    // number per frame; when the atlas is full the least recently drawn slot
+    // that was not on screen last frame is reused. Evicted previews come back
+    // from the disk cache when their cell scrolls into view again.
+    //
+    // Main thread only, with the GL context current, except for the workers.
+    class ThumbnailCache {
+    public:
+        static constexpr int kSize = 128;                   // preview edge, pixels
+
+        ThumbnailCache() = default;
+        ~ThumbnailCache();
+        ThumbnailCache(const ThumbnailCache&) = delete;
+        ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+        // By extension: .png, .bmp, .tga, .obj and .acemap
+        static bool Supports(const std::filesystem::path& path);
+
+        // Content hash of a file if already known (e.g. from the asset
+        // registry), else 0 and the worker hashes it. Called from Draw() the
+        // first time a path is seen.
+        using HashLookup = std::function<uint64_t(const std::filesystem::path& path)>;
+        void SetHashLookup(HashLookup fn) { Lookup = std::move(fn); }
+        // Derived-data cache directory, opened on a worker; empty = none.
+        // Previews already generated are kept.
+        void SetCacheDir(const std::filesystem::path& dir);
+        const std::filesystem::path& CacheDir() const { return Dir; }
+
+        // Draws the preview of 'path' over [p0, p1], requesting it on first
+        // use. False while it is pending or when there is none; the caller
+        // then draws its placeholder.
+        bool Draw(ImDrawList* dl, const std::filesystem::path& path, const ImVec2& p0, const ImVec2& p1);
+
+        // The file changed: regenerate on next draw
+        void Invalidate(const std::filesystem::path& path);
+        void Clear();
+
+        // Once per frame before drawing: drops stale requests, starts
+        // workers and uploads finished previews
+        void Update();
+        // Waits for the workers and deletes the atlas; call while the GL
+        // context and the job system are still up
+        void Shutdown();
+
+        ThumbnailStats GetStats() const;
+
+    private:
+        using Key = std::filesystem::path::string_type;
+
+        struct Entry {
+            uint32_t Gen = 0;           // matches its request and result
+            int      Slot = -1;         // atlas slot once uploaded; stays -1 if generation failed
+            uint64_t LastDrawn = 0;     // frame
+        };
+
+        struct Request {
+            Key                   Path;
+            uint32_t              Gen = 0;
+            uint64_t              Hash = 0;
+        };
+
+        struct Result {
+            Key                   Path;
+            uint32_t              Gen = 0;
+            std::vector<uint8_t>  Pixels;       // kSize^2 RGBA; empty = failed
+            bool                  FromDisk = false;
+        };
+
+        struct Slot {
+            const Key* Owner = nullptr; // key in Entries; null = free
+            uint64_t   LastDrawn = 0;
+        };
+
+        void Dispatch();
+        void WorkJob();
+        int  AllocateSlot();
+        void FreeSlot(Entry& e);
+        void Upload(int slot, const uint8_t* pixels);
+
+        std::unordered_map<Key, Entry> Entries;
+        std::vector<Slot>       Slots;
+        std::vector<uint32_t>   Pages;              // GL texture names
+        std::vector<Result>     Uploads;            // waiting for an atlas slot
+        std::vector<std::pair<Key, uint32_t>> Failed;  // entries (key, Gen) with no preview
+        HashLookup              Lookup;
+        std::filesystem::path   Dir;
+        uint64_t                Frame = 1;
+        uint32_t                NextGen = 0;
+        ThumbnailStats          Counters;
+        bool                    Stopped = false;    // Shutdown() ran; the job system may be gone
+
+        // Shared with the workers
+        mutable std::mutex      Mutex;
+        std::vector<Request>    Queue;              // back = newest = next
+        std::vector<Result>     Done;
+        std::shared_ptr<DerivedDataCache> Disk;
+        uint32_t                DiskGen = 0;        // bumped by SetCacheDir; stale opens are dropped
+        uint32_t                Jobs = 0;
+        JobCounter              JobsDone;
+    };
+}
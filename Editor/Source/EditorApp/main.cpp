@@ -24,11 +24,19 @@
 #include <cstdarg>
 #include <ctime>
 #include <thread>
+#include <atomic>
 
 #include "EditorSettingsPanel.h"
 #include "EditorCodegen.h"
+#include "Cooker.h"
 #include "UI/Themes/ThemeManager.h"
 #include "EditorPreferences.h"
+#include "ThumbnailCache.h"
+#include "DirectoryModel.h"
+#include "FolderTree.h"
+#include "FileOperations.h"
+#include "SelectionSet.h"
+#include "TextMerge.h"
 #include "TextEditor.h"
 
 #include <GLFW/glfw3.h>
@@ -54,6 +62,22 @@
 #endif
 
 #include "Runtime/Project/Project.h"
+#include "Runtime/Asset/AssetManager.h"
+#include "Runtime/Asset/AssetRegistry.h"
+#include "Runtime/Asset/SearchIndex.h"
+#include "Runtime/Blueprint/BlueprintCompiler.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/Memory.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/IO/FileWatcher.h"
+#include "Runtime/IO/PakFile.h"
+#include "Runtime/IO/VFS.h"
+#include "Runtime/World/World.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/MapJson.h"
+#include "Runtime/World/MapBinary.h"
+#include "Runtime/World/SpatialIndex.h"
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
@@ -196,6 +220,7 @@ struct BuildRuntime {
     bool        CancelRequested = false;
     float       Progress        = 0.0f;      // 0..1
     std::string Step;                        // "Preparing", "Generating", "Compiling", ...
+    std::shared_ptr<ace::cook::CookProgress> Cook;   // set while ACECook runs in-process
 };
 
 // ---------- Editor State ----------
@@ -233,10 +258,21 @@ struct Panels {
     bool ProjectSettings = false;
 };
 
-struct ItemRect {
-    std::filesystem::path path;
-    ImVec2 min{}, max{};
-    bool isDir = false;
+// Cached directory listing for the grid, or the search results under Dir
+// while a filter is typed. Rebuilt when the folder or filter changes, when
+// the search index changes, or on Refresh; file watcher events inside Dir
+// are applied to the listing in place.
+struct ContentListing {
+    std::filesystem::path Dir;
+    std::string Filter;
+    bool     Searched     = false;          // from the search index, not a directory listing
+    bool     Fuzzy        = false;
+    bool     InText       = false;
+    uint64_t SearchRev    = 0;
+    size_t   SearchTotal  = 0;              // matches, of which Model holds the best
+    bool     Valid        = false;
+    bool     Bound        = false;          // the selection mirrors Model's rows
+    ace::editor::DirectoryModel Model;
 };
 
 struct ContentBrowserState {
@@ -244,7 +280,7 @@ struct ContentBrowserState {
     std::filesystem::path Current;      // absolute
 
     // Selection
-    std::vector<std::filesystem::path> Selection; // multi
+    ace::editor::SelectionSet Selection;           // multi; rows of Listing.Model
     int AnchorIndex = -1;                          // for Shift range
 
     // Clipboard (copy)
@@ -253,12 +289,16 @@ struct ContentBrowserState {
     // Grid view
     float ThumbnailSize = 96.0f;        // square icon size
     float Padding       = 12.0f;        // item padding
-    std::string Filter;                 // substring filter (case-sensitive for now)
+    std::string Filter;                 // search text; matches files anywhere below Current
+    bool SearchFuzzy = true;            // also match names by their characters in order
+    bool SearchText  = false;           // also match inside .json/.aceasset/.blueprint
 
     // Marquee selection
     bool DragSelecting = false;
     ImVec2 DragStart{}, DragCur{};
-    std::vector<ItemRect> ItemRects;    // per-frame, for marquee hit-test
+
+    ContentListing Listing;
+    ace::editor::FolderTree Tree;       // read in the background, kept current by the file watcher
 
     // Creation / rename / delete popups
     bool ShowNewFolder       = false;
@@ -282,6 +322,10 @@ struct ContentBrowserState {
     float TreeWidth = 260.0f; // left sidebar width
     bool  TreeResizing = false;
 
+    // Breadcrumb buttons (label, target folder) for CrumbsFor; rebuilt when Current changes
+    std::vector<std::pair<std::string, std::filesystem::path>> Crumbs;
+    std::filesystem::path CrumbsFor;
+
     // Persisted
     std::filesystem::path LastFolder;
 
@@ -389,65 +433,45 @@ struct EditorTab {
     bp::UI    BpUI;
     bool      BPLoaded = false;
     bool      BPDirty  = false;
-};
+    std::string BPStatus;               // last Compile: results or the error
+    bool      BPStatusOk = false;
 
+    // Set when the file changed on disk and could not be taken in: deleted,
+    // or a blueprint with unsaved edits
+    bool ChangedOnDisk = false;
 
-// ---------- Editor World / Map types (minimal) ----------
-
-struct EVec3 { float x=0, y=0, z=0; };
-static inline EVec3 EV3(float x=0, float y=0, float z=0){ return EVec3{x,y,z}; }
-
-struct ETransform {
-    EVec3 position = EV3(0,0,0);
-    EVec3 rotation = EV3(0,0,0);
-    EVec3 scale    = EV3(1,1,1);
+    // Hot reload
+    std::string DiskText;       // the file as last loaded or saved; merge base for text tabs
+    uint64_t    ReloadSeq = 0;  // bumped per queued reload and per save; stale reads are dropped
+    size_t      Conflicts = 0;  // conflict blocks the last merge left in Buffer
 };
 
-enum class EComponentType { StaticMesh };
 
-struct EStaticMeshComponent {
-    std::filesystem::path Mesh;     // e.g. /Game/Props/SM_Crate.aceasset
-    std::filesystem::path Material; // optional
+struct AllocStats {
+    uint64_t Frame = 0;
+    uint64_t BlueprintEditor = 0;
+    uint64_t ContentGrid = 0;
+    uint64_t ContentTree = 0;       // folder tree and breadcrumbs
+    size_t   FrameArenaBytes = 0;
 };
 
-struct EComponent {
-    EComponentType Type = EComponentType::StaticMesh;
-    // Only one concrete type for now:
-    EStaticMeshComponent StaticMesh;
+// Per-scope totals for the frame shown in the Profiler panel
+struct ProfileScopeStat {
+    const char* Name = nullptr;
+    uint32_t    Calls = 0;
+    double      TotalNs = 0.0;
+    double      MaxNs = 0.0;
 };
 
-struct EEntity {
-    int                Id = 0;
-    std::string        Name = "Entity";
-    ETransform         Xf;
-    std::vector<EComponent> Components;
-    // (Future: Children / Parent for hierarchy)
+struct ProfilerView {
+    bool     Paused = false;
+    bool     FollowLatest = true;
+    uint64_t SelectedFrame = 0;                 // Profiler::Frame::Index
+    std::vector<ProfileScopeStat> Stats;        // reused every frame
+    std::vector<int>              RowDepth;     // deepest scope per thread
+    std::string                   LastCapture;
 };
 
-struct EWorld {
-    std::vector<EEntity> Entities;
-    int NextId = 1;
-};
-
-// JSON helpers
-static inline json ToJson(const EVec3& v){ return json::array({v.x, v.y, v.z}); }
-static inline EVec3 FromJsonVec3(const json& j){
-    EVec3 v{};
-    if (j.is_array() && j.size()>=3){ v.x=float(j[0]); v.y=float(j[1]); v.z=float(j[2]); }
-    return v;
-}
-static inline json ToJson(const ETransform& t){
-    return json{ {"Pos", ToJson(t.position)}, {"Rot", ToJson(t.rotation)}, {"Scale", ToJson(t.scale)} };
-}
-static inline ETransform FromJsonTransform(const json& j){
-    ETransform t{};
-    if (j.contains("Pos"))   t.position = FromJsonVec3(j["Pos"]);
-    if (j.contains("Rot"))   t.rotation = FromJsonVec3(j["Rot"]);
-    if (j.contains("Scale")) t.scale    = FromJsonVec3(j["Scale"]);
-    return t;
-}
-
-
 struct EditorState {
     std::optional<ace::Project> Project;
     std::filesystem::path       ProjectFile;
@@ -483,8 +507,48 @@ struct EditorState {
     // -------- NEW: Map / World authoring --------
     std::filesystem::path OpenMapPath;  // absolute path to .acemap
     bool                  MapDirty = false;
-    EWorld                EditorWorld;  // in-editor world data
-    int                   SelectedEntity = -1; // index into EditorWorld.Entities, or -1 if none
+    bool                  MapChangedOnDisk = false;    // changed while MapDirty, or unreadable: not reloaded
+    std::filesystem::file_time_type MapWriteTime;      // of our last load or save, to skip our own writes
+    uint64_t              MapReloadSeq = 0;            // bumped per queued reload, load and save
+    ace::World            EditorWorld;  // in-editor world data
+    int                   NextEntityId = 1;    // next persistent IdComponent value
+    ace::Entity           SelectedEntity;      // null if none
+    ace::SpatialIndex     EditorSpatial;       // entity bounds for picking/culling
+    std::filesystem::path MountedContent;      // Content dir currently mounted at /Game
+
+    // Assets the open map references, held so they stay resident and are
+    // reloaded when their files change. Created once the job system is up.
+    std::unique_ptr<ace::AssetManager>                WorldAssets;
+    std::unordered_map<std::string, ace::AssetHandle> WorldRefs;   // virtual path -> handle
+    bool                                              WorldRefsDirty = true;
+
+    // Disk changes under the open project, consumed once per frame by ProcessFileChanges
+    ace::FileWatcher               Watcher;
+    std::filesystem::path          WatchedRoot;
+    std::vector<ace::FileChange>   FileChanges;
+
+    // Content browser previews (GPU atlas + Intermediate/DerivedDataCache)
+    ace::editor::ThumbnailCache Thumbs;
+    ace::editor::FileOperationQueue FileOps;    // content browser copies, moves and deletes
+
+    // Content browser search. Built on a worker and swapped in; file changes
+    // seen meanwhile are replayed on the new index.
+    ace::SearchIndex              Search;
+    std::filesystem::path         SearchContent;      // Content dir Search describes
+    bool                          SearchBuildRunning = false;
+    std::vector<ace::FileChange>  SearchPending;
+
+    // Asset registry of /Game. Built on a worker (snapshot + incremental
+    // scan) and swapped in; editor writes are rescanned on the main thread.
+    ace::AssetRegistry    Assets;
+    std::filesystem::path AssetsContent;       // Content dir Assets describes
+    bool                  AssetScanRunning = false;
+    uint64_t              AssetsSavedRev = 0;  // Assets.Revision() last written to the snapshot
+
+    // Heap allocations (operator new calls) on the main thread: Allocs
+    // accumulates during the frame, LastAllocs is what the Profiler shows.
+    AllocStats Allocs, LastAllocs;
+    ProfilerView Prof;
 };
 
 
@@ -499,91 +563,218 @@ static std::optional<std::filesystem::path> SaveAcemapDialog(
 
     // ---------- Map I/O & World ops ----------
 
-static void ClearWorld(EditorState& S){
-    S.EditorWorld = EWorld{};
-    S.SelectedEntity = -1;
-    S.MapDirty = false;
+// Keeps /Game mounted on the open project's Content folder
+static void SyncContentMount(EditorState& S){
+    const auto root = S.Project ? S.Project->ContentDir() : std::filesystem::path{};
+    if (root == S.MountedContent) return;
+    S.MountedContent = root;
+    if (S.Project) S.Project->MountContent();
+    else           ace::VFS::Get().Unmount(ace::Project::kContentMount);
 }
 
-static int WorldAddEntity(EWorld& W, const std::string& name){
-    EEntity e; e.Id = W.NextId++; e.Name = name;
-    W.Entities.push_back(std::move(e));
-    return (int)W.Entities.size()-1;
+// The VFS caches lookups; call after the editor changes files under Content
+static void InvalidateVfs(const std::filesystem::path& native){
+    if (auto v = ace::VFS::Get().ToVirtual(native)) ace::VFS::Get().Invalidate(*v);
 }
 
-static json ToJson(const EComponent& c){
-    json j;
-    switch (c.Type){
-        case EComponentType::StaticMesh:
-            j["Type"] = "StaticMesh";
-            j["Mesh"] = c.StaticMesh.Mesh.generic_string();
-            if (!c.StaticMesh.Material.empty())
-                j["Material"] = c.StaticMesh.Material.generic_string();
-            break;
+// Virtual paths the editor wrote, moved or deleted; rescanned by UpdateAssetRegistry
+static std::vector<std::string> g_ChangedAssetPaths;
+
+// For files the editor itself changed: drops VFS lookups and queues a registry rescan
+static void NotifyContentChanged(const std::filesystem::path& native){
+    if (auto v = ace::VFS::Get().ToVirtual(native)) {
+        ace::VFS::Get().Invalidate(*v);
+        g_ChangedAssetPaths.push_back(std::move(*v));
+    }
+}
+
+// Files and folders the content browser moved; their referrers are fixed up
+// by UpdateAssetRegistry before the moved paths are rescanned
+static std::vector<ace::AssetRename> g_MovedAssetPaths;
+
+static void NotifyContentMoved(const std::filesystem::path& from, const std::filesystem::path& to){
+    auto f = ace::VFS::Get().ToVirtual(from);
+    auto t = ace::VFS::Get().ToVirtual(to);
+    if (f && t) g_MovedAssetPaths.push_back({std::move(*f), std::move(*t)});
+}
+
+// Re-keys moved assets in the registry, keeping their GUIDs, then rewrites
+// each referrer once for the whole batch
+static void FixupMovedReferences(EditorState& S){
+    ACE_PROFILE_FUNCTION();
+    std::vector<std::string> moved;
+    S.Assets.Rename(g_MovedAssetPaths, &moved);
+    std::vector<std::string_view> referrers;
+    S.Assets.Dependencies().GetReferencers(moved, referrers);
+    std::vector<std::filesystem::path> files, changed;
+    for (const auto r : referrers)
+        if (auto native = ace::VFS::Get().ToNative(r); !native.empty()) files.push_back(std::move(native));
+    const bool ok = ace::RewriteAssetReferences(files, g_MovedAssetPaths, changed);
+    for (const auto& f : changed) NotifyContentChanged(f);
+    if (!moved.empty())
+        Logf("Moved %zu asset(s); updated references in %zu of %zu referrer(s)%s",
+             moved.size(), changed.size(), files.size(), ok ? "" : " (some failed, see log)");
+    g_MovedAssetPaths.clear();
+}
+
+static std::filesystem::path AssetSnapshotPath(const ace::Project& p){
+    return p.IntermediateDir() / "AssetRegistry.bin";
+}
+
+static void SaveAssetSnapshot(EditorState& S){
+    if (!S.Project || S.AssetScanRunning || S.AssetsContent.empty() || S.Assets.Revision() == S.AssetsSavedRev) return;
+    if (S.Assets.SaveSnapshot(AssetSnapshotPath(*S.Project))) S.AssetsSavedRev = S.Assets.Revision();
+}
+
+// Loads the snapshot and validates it against /Game on a worker when the
+// project changes; applies queued editor changes otherwise.
+static void UpdateAssetRegistry(EditorState& S){
+    ACE_PROFILE_FUNCTION();
+    if (S.AssetScanRunning) return;
+    const auto content = S.Project ? S.Project->ContentDir() : std::filesystem::path{};
+    if (content != S.AssetsContent) {
+        SaveAssetSnapshot(S);
+        S.AssetsContent = content;
+        S.Assets.Clear();
+        S.AssetsSavedRev = S.Assets.Revision();
+        g_ChangedAssetPaths.clear();
+        g_MovedAssetPaths.clear();
+        if (!S.Project) return;
+
+        S.AssetScanRunning = true;
+        const auto snapshot = AssetSnapshotPath(*S.Project);
+        ace::JobSystem::Get().Run([&S, snapshot, content]{
+            auto reg = std::make_shared<ace::AssetRegistry>();
+            const bool warm = reg->LoadSnapshot(snapshot);
+            const ace::AssetScanStats st = reg->Scan(ace::Project::kContentMount);
+            // Skip the write if /Game was remounted for another project meanwhile
+            bool saved = false;
+            if (ace::VFS::Get().ToNative(ace::Project::kContentMount) == content)
+                saved = (!warm || st.Added || st.Updated || st.Removed) ? reg->SaveSnapshot(snapshot) : true;
+            ace::JobSystem::Get().RunOnMainThread([&S, reg, st, warm, saved, content]{
+                S.AssetScanRunning = false;
+                if (S.AssetsContent != content) return;   // project changed; the next frame rescans
+                S.Assets = std::move(*reg);
+                if (saved) S.AssetsSavedRev = S.Assets.Revision();
+                Logf("Asset registry: %zu assets (%s snapshot; %zu unchanged, %zu added, %zu updated, %zu removed) in %.1f ms",
+                     S.Assets.Count(), warm ? "from" : "no", st.Unchanged, st.Added, st.Updated, st.Removed, st.Seconds * 1000.0);
+            });
+        });
+        return;
     }
-    return j;
+    if (!g_MovedAssetPaths.empty()) FixupMovedReferences(S);
+    if (g_ChangedAssetPaths.empty()) return;
+
+    S.Assets.Scan(g_ChangedAssetPaths);     // one pass for the whole batch
+    g_ChangedAssetPaths.clear();
 }
-static EComponent FromJsonComponent(const json& j){
-    EComponent c;
-    std::string t = j.value("Type", "StaticMesh");
-    if (t == "StaticMesh"){
-        c.Type = EComponentType::StaticMesh;
-        if (j.contains("Mesh"))     c.StaticMesh.Mesh     = j["Mesh"].get<std::string>();
-        if (j.contains("Material")) c.StaticMesh.Material = j["Material"].get<std::string>();
+
+// Previews are cached per project, in its derived-data cache
+static void UpdateThumbnails(EditorState& S){
+    const auto dir = S.Project ? S.Project->DerivedDataDir() : std::filesystem::path{};
+    if (dir != S.Thumbs.CacheDir()) {
+        S.Thumbs.Clear();
+        S.Thumbs.SetCacheDir(dir);
     }
-    return c;
+    S.Thumbs.Update();
 }
 
-static json ToJson(const EEntity& e){
-    json j;
-    j["Id"] = e.Id;
-    j["Name"] = e.Name;
-    j["Transform"] = ToJson(e.Xf);
-    j["Components"] = json::array();
-    for (auto& c : e.Components) j["Components"].push_back(ToJson(c));
-    return j;
-}
-static EEntity FromJsonEntity(const json& j){
-    EEntity e;
-    e.Id   = j.value("Id", 0);
-    e.Name = j.value("Name", std::string("Entity"));
-    if (j.contains("Transform")) e.Xf = FromJsonTransform(j["Transform"]);
-    if (j.contains("Components")){
-        for (auto& jc : j["Components"]) e.Components.push_back(FromJsonComponent(jc));
+// (Re)builds the search index in the background when the project changes or
+// enough files were removed that the index should be compacted
+static void UpdateSearchIndex(EditorState& S){
+    ACE_PROFILE_FUNCTION();
+    if (S.SearchBuildRunning) return;
+    const auto content = S.Project ? S.Project->ContentDir() : std::filesystem::path{};
+    if (content == S.SearchContent && !S.Search.NeedsRebuild()) return;
+    if (content != S.SearchContent) {
+        S.Search.Clear();
+        S.SearchContent = content;
     }
+    S.SearchPending.clear();
+    if (content.empty()) return;
+
+    S.SearchBuildRunning = true;
+    ace::JobSystem::Get().Run([&S, content]{
+        auto index = std::make_shared<ace::SearchIndex>();
+        index->Build(content);
+        ace::JobSystem::Get().RunOnMainThread([&S, index, content]{
+            S.SearchBuildRunning = false;
+            if (S.SearchContent != content) return;     // project changed; the next frame rebuilds
+            S.Search = std::move(*index);
+            S.Search.Apply(S.SearchPending);
+            S.SearchPending.clear();
+            const auto st = S.Search.GetStats();
+            Logf("Search index: %zu files (%zu with text) in %.1f ms", st.Files, st.ContentFiles, st.BuildSeconds * 1000.0);
+        });
+    });
+}
+
+static void RebuildSpatialIndex(EditorState& S){
+    ACE_PROFILE_SCOPE("RebuildSpatialIndex");
+    std::vector<std::pair<ace::Entity, ace::AABB>> items;
+    items.reserve(S.EditorWorld.Count());
+    S.EditorWorld.Each<ace::TransformComponent>([&](ace::Entity e, ace::TransformComponent& t){
+        items.push_back({e, ace::EntityBounds(t)});
+    });
+    S.EditorSpatial.Build(items);
+}
+
+static void ClearWorld(EditorState& S){
+    S.EditorWorld.Clear();
+    S.EditorSpatial.Clear();
+    S.NextEntityId = 1;
+    S.SelectedEntity = {};
+    S.MapDirty = false;
+    S.MapChangedOnDisk = false;
+    ++S.MapReloadSeq;
+    S.WorldRefsDirty = true;
+}
+
+static ace::Entity WorldAddEntity(EditorState& S, const std::string& name){
+    ace::Entity e = S.EditorWorld.Create(ace::IdComponent{S.NextEntityId++}, ace::NameComponent{name}, ace::TransformComponent{});
+    S.EditorSpatial.Insert(e, ace::EntityBounds(ace::TransformComponent{}));
     return e;
 }
 
-static bool SaveMapToFile(const EditorState& S, const std::filesystem::path& path){
-    json root;
-    root["Type"] = "Map";
-    root["Version"] = 1;
-    root["Entities"] = json::array();
-    for (auto& e : S.EditorWorld.Entities) root["Entities"].push_back(ToJson(e));
-    std::error_code ec; std::filesystem::create_directories(path.parent_path(), ec);
-    std::ofstream out(path, std::ios::binary | std::ios::trunc);
-    if (!out) return false;
-    out << root.dump(2);
-    return true;
+// The open map's file as we last wrote or read it; later reads of our own
+// saves are skipped by hot reload
+static void MapFileSynced(EditorState& S){
+    std::error_code ec;
+    S.MapWriteTime = std::filesystem::last_write_time(S.OpenMapPath, ec);
+    S.MapChangedOnDisk = false;
+    ++S.MapReloadSeq;
+}
+
+// Maps are saved as binary .acemap; JSON is only written by "Export Map as JSON"
+static bool SaveMapToFile(EditorState& S, const std::filesystem::path& path){
+    const bool ok = ace::SaveMapBinary(S.EditorWorld, path);
+    NotifyContentChanged(path);
+    if (ok && path == S.OpenMapPath) MapFileSynced(S);
+    return ok;
+}
+
+// Either format; chosen by the file's header magic. Safe on a worker.
+static bool ReadMapFile(const std::filesystem::path& path, ace::World& W, int& maxId){
+    if (auto v = ace::VFS::Get().ToVirtual(path)) {
+        ace::VfsFile file;
+        return ace::VFS::Get().Open(*v, file) && ace::LoadMap(W, file.Data(), file.Size(), &maxId);
+    }
+    return ace::LoadMap(W, path, &maxId);
 }
 
 static bool LoadMapFromFile(EditorState& S, const std::filesystem::path& path){
-    std::ifstream in(path, std::ios::binary);
-    if (!in) return false;
-    json j; in >> j;
-    EWorld W{};
-    auto body = j.contains("Entities") ? j["Entities"] : json::array();
+    ace::World W;
     int maxId = 0;
-    for (auto& je : body){
-        auto e = FromJsonEntity(je);
-        maxId = std::max(maxId, e.Id);
-        W.Entities.push_back(std::move(e));
-    }
-    W.NextId = std::max(1, maxId+1);
+    if (!ReadMapFile(path, W, maxId)) return false;
     S.EditorWorld = std::move(W);
-    S.SelectedEntity = S.EditorWorld.Entities.empty() ? -1 : 0;
+    RebuildSpatialIndex(S);
+    S.NextEntityId = std::max(1, maxId+1);
+    S.SelectedEntity = {};
+    S.EditorWorld.ForEachEntity([&](ace::Entity e){ if (!S.SelectedEntity) S.SelectedEntity = e; });
     S.OpenMapPath = path;
     S.MapDirty = false;
+    S.WorldRefsDirty = true;
+    MapFileSynced(S);
     return true;
 }
 
@@ -591,8 +782,7 @@ static bool LoadMapFromFile(EditorState& S, const std::filesystem::path& path){
 static void NewEmptyMap(EditorState& S){
     ClearWorld(S);
     // Seed with one default entity so there is something to select
-    int idx = WorldAddEntity(S.EditorWorld, "EmptyActor");
-    S.EditorWorld.Entities[idx].Xf.position = EV3(0,0,0);
+    WorldAddEntity(S, "EmptyActor");
     S.OpenMapPath.clear();
     S.MapDirty = true;
 }
@@ -604,6 +794,7 @@ static bool SaveMap(EditorState& S){
         if (!SaveMapToFile(S, *p)) return false;
         S.OpenMapPath = *p;
         S.MapDirty = false;
+        MapFileSynced(S);
         return true;
     } else {
         if (!SaveMapToFile(S, S.OpenMapPath)) return false;
@@ -620,9 +811,18 @@ static bool SaveMapAs(EditorState& S){
     if (!SaveMapToFile(S, *p)) return false;
     S.OpenMapPath = *p;
     S.MapDirty = false;
+    MapFileSynced(S);
     return true;
 }
 
+static bool ExportMapJson(EditorState& S){
+    auto suggest = S.OpenMapPath.empty() ? (S.Project ? S.Project->ContentDir() : std::filesystem::path{}) : S.OpenMapPath.parent_path();
+    std::string name = S.OpenMapPath.empty() ? std::string("NewMap.json.acemap") : S.OpenMapPath.stem().string() + ".json.acemap";
+    auto p = SaveAcemapDialog(suggest, name.c_str());
+    if (!p) return false;
+    return ace::SaveMapJson(S.EditorWorld, *p);
+}
+
 static bool OpenMap(EditorState& S){
     auto sel = OpenAcemapDialog();
     if (!sel) return false;
@@ -713,7 +913,7 @@ static void RevealInExplorer(const std::filesystem::path&) {}
 #endif
 
 static bool IsMapFile(const std::filesystem::path& p){
-    return ToLower(p.extension().string()) == ".acemap";
+    return ace::AssetTypeFromPath(p) == ace::AssetType::Map;
 }
 
 #ifdef _WIN32
@@ -787,108 +987,6 @@ static std::filesystem::path MakeUniqueChildDirectory(const std::filesystem::pat
     return parent / (baseName + " (copy)");
 }
 
-// Unique sibling filename (keeps extension): "Name.ext" -> "Name - Copy.ext" / "Name - Copy (2).ext"
-static std::filesystem::path UniqueSibling(const std::filesystem::path& parent, const std::string& base) {
-    std::filesystem::path candidate = parent / base;
-    if (!std::filesystem::exists(candidate)) return candidate;
-    // Split name/ext
-    std::filesystem::path stem = std::filesystem::path(base).stem();
-    std::filesystem::path ext  = std::filesystem::path(base).extension();
-    auto name = stem.string();
-    auto extension = ext.string();
-    // Try "Name - Copy.ext", then (2..999)
-    std::string first = name + " - Copy" + extension;
-    if (!std::filesystem::exists(parent / first)) return parent / first;
-    for (int i=2;i<1000;++i) {
-        std::string variant = name + " - Copy (" + std::to_string(i) + ")" + extension;
-        if (!std::filesystem::exists(parent / variant)) return parent / variant;
-    }
-    return parent / (name + " - Copy (999)" + extension);
-}
-
-// Robust "move into folder" with copy fallback (handles cross-volume moves, in-use files, etc.)
-static bool MoveEntryToDir(const std::filesystem::path& src,
-                           const std::filesystem::path& dstDir,
-                           std::string& outErr)
-{
-    outErr.clear();
-    Logf("MoveEntryToDir: src='%s' -> dstDir='%s'",
-         src.string().c_str(), dstDir.string().c_str());
-
-    std::error_code ec;
-    if (!std::filesystem::exists(src)) {
-        outErr = "Source does not exist.";
-        Logf("MoveEntryToDir: FAIL (src missing)");
-        return false;
-    }
-
-    if (!std::filesystem::exists(dstDir)) {
-        std::filesystem::create_directories(dstDir, ec);
-        if (ec) { outErr = "Failed to create destination directory.";
-                  Logf("MoveEntryToDir: FAIL create dstDir: %s", ec.message().c_str());
-                  return false; }
-    }
-
-    const auto dest = UniqueSibling(dstDir, src.filename().string());
-    Logf("MoveEntryToDir: UniqueSibling -> '%s'", dest.string().c_str());
-
-    // Try fast rename
-    ec.clear();
-    std::filesystem::rename(src, dest, ec);
-    if (!ec) {
-        Logf("MoveEntryToDir: rename OK");
-        return true;
-    }
-    Logf("MoveEntryToDir: rename failed -> %s. Falling back to copy+delete.", ec.message().c_str());
-
-    if (std::filesystem::is_directory(src)) {
-        // copy tree
-        ec.clear();
-        std::filesystem::create_directories(dest, ec);
-        if (ec) { outErr = "Failed to create destination."; Logf("MoveEntryToDir: FAIL create dest: %s", ec.message().c_str()); return false; }
-
-        std::error_code it_ec;
-        for (std::filesystem::recursive_directory_iterator it(src, it_ec), end; !it_ec && it != end; ++it) {
-            const auto& e = *it;
-            std::error_code rel_ec;
-            auto rel = std::filesystem::relative(e.path(), src, rel_ec);
-            if (rel_ec) { outErr = "Relpath failed during copy."; Logf("MoveEntryToDir: FAIL relpath: %s", rel_ec.message().c_str()); return false; }
-            auto d = dest / rel;
-
-            if (e.is_directory()) {
-                std::filesystem::create_directories(d, ec);
-                if (ec) { outErr = "Failed to make subdir during copy."; Logf("MoveEntryToDir: FAIL mkdir subdir: %s", ec.message().c_str()); return false; }
-            } else if (e.is_regular_file()) {
-                std::filesystem::create_directories(d.parent_path(), ec);
-                if (ec) { outErr = "Failed to create parent for file copy."; Logf("MoveEntryToDir: FAIL create parent: %s", ec.message().c_str()); return false; }
-                ec.clear();
-                std::filesystem::copy_file(e.path(), d, std::filesystem::copy_options::overwrite_existing, ec);
-                if (ec) { outErr = "Failed to copy file."; Logf("MoveEntryToDir: FAIL copy file '%s' -> '%s': %s",
-                                                                e.path().string().c_str(), d.string().c_str(), ec.message().c_str()); return false; }
-            }
-        }
-        ec.clear();
-        std::filesystem::remove_all(src, ec);
-        if (ec) { outErr = "Copied, but failed to delete source directory."; Logf("MoveEntryToDir: FAIL remove_all src: %s", ec.message().c_str()); return false; }
-        Logf("MoveEntryToDir: directory copy+delete OK");
-        return true;
-    } else {
-        // copy single file
-        std::filesystem::create_directories(dest.parent_path(), ec);
-        if (ec) { outErr = "Failed to create destination parent directory."; Logf("MoveEntryToDir: FAIL create parent: %s", ec.message().c_str()); return false; }
-        ec.clear();
-        std::filesystem::copy_file(src, dest, std::filesystem::copy_options::none, ec);
-        if (ec) { outErr = "Failed to copy file."; Logf("MoveEntryToDir: FAIL copy file '%s' -> '%s': %s",
-                                                        src.string().c_str(), dest.string().c_str(), ec.message().c_str()); return false; }
-        ec.clear();
-        std::filesystem::remove(src, ec);
-        if (ec) { outErr = "Copied, but failed to delete source file."; Logf("MoveEntryToDir: FAIL remove src: %s", ec.message().c_str()); return false; }
-        Logf("MoveEntryToDir: file copy+delete OK");
-        return true;
-    }
-}
-
-
 static bool WriteAceproj(const std::filesystem::path& aceprojPath, const std::string& name, const std::string& version) {
     json j{{"Name", name},{"EngineVersion", version},{"Modules", json::array()},{"Plugins", json::array()}};
     std::ofstream out(aceprojPath);
@@ -945,30 +1043,13 @@ static std::filesystem::path LogFilePath() {
     return AppDataDir() / "ace_editor.log";
 }
 
+// Editor log line; formatting and file I/O happen on the logger's writer thread
 static void Logf(const char* fmt, ...) {
 #if ACE_ENABLE_LOG
-    char msg[2048];
+    if (!ace::Log::IsEnabled(ace::LogLevel::Info, "Editor")) return;
     va_list args; va_start(args, fmt);
-    vsnprintf(msg, sizeof(msg), fmt, args);
+    ace::Log::WriteV(ace::LogLevel::Info, "Editor", fmt, args);
     va_end(args);
-
-    std::time_t t = std::time(nullptr);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
-    char ts[64];
-    std::strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", &tm);
-
-    std::string line = std::string("[") + ts + "] " + msg + "\n";
-    std::fputs(line.c_str(), stdout);
-#ifdef _WIN32
-    OutputDebugStringA(line.c_str());
-#endif
-    std::ofstream out(LogFilePath(), std::ios::binary | std::ios::app);
-    if (out) out.write(line.data(), (std::streamsize)line.size());
 #endif
 }
 
@@ -1097,10 +1178,15 @@ static bool IsSubPathOf(const std::filesystem::path& base, const std::filesystem
 }
 
 static void EnsureContentRoot(EditorState& S) {
-    if (!S.Project) { S.CB.Root.clear(); S.CB.Current.clear(); return; }
+    if (!S.Project) {
+        S.CB.Root.clear(); S.CB.Current.clear();
+        if (!S.CB.Tree.Root().empty()) S.CB.Tree.SetRoot({});
+        return;
+    }
     const auto root = S.Project->ContentDir(); // abs
     if (S.CB.Root != root || S.CB.Root.empty()) {
         S.CB.Root = root;
+        S.CB.Tree.SetRoot(root);
         // use persisted last folder if still inside Content
         if (!S.CB.LastFolder.empty() && IsSubPathOf(root, S.CB.LastFolder) && std::filesystem::exists(S.CB.LastFolder))
             S.CB.Current = S.CB.LastFolder;
@@ -1108,7 +1194,8 @@ static void EnsureContentRoot(EditorState& S) {
             S.CB.Current = root;
 
         // Clear transient UI state
-        S.CB.Selection.clear();
+        S.CB.Selection.SetRoot(root);
+        S.CB.Listing.Bound = false;
         S.CB.Error.clear();
         S.CB.Filter.clear();
 
@@ -1137,29 +1224,65 @@ static bool IsValidName(const std::string& name) {
     if (name == "." || name == "..") return false;
     return true;
 }
-static std::string TruncMiddle(const std::string& s, int maxChars) {
-    if ((int)s.size() <= maxChars) return s;
-    if (maxChars <= 3) return s.substr(0, maxChars);
-    int keep = (maxChars - 3) / 2;
-    return s.substr(0, keep) + "..." + s.substr(s.size()-keep);
+// 's' shortened to maxChars with "..." in the middle, into a caller buffer
+static void TruncMiddle(std::string_view s, int maxChars, char* out, size_t outSize) {
+    if ((int)s.size() <= maxChars) { std::snprintf(out, outSize, "%.*s", (int)s.size(), s.data()); return; }
+    if (maxChars <= 3)             { std::snprintf(out, outSize, "%.*s", maxChars, s.data()); return; }
+    const int keep = (maxChars - 3) / 2;
+    std::snprintf(out, outSize, "%.*s...%.*s", keep, s.data(), keep, s.data() + s.size() - keep);
 }
 
-static void SelectClear(ContentBrowserState& CB) { CB.Selection.clear(); }
-static bool IsSelected(const ContentBrowserState& CB, const std::filesystem::path& p) {
-    auto s = CanonicalStr(p);
-    for (auto& e : CB.Selection) if (CanonicalStr(e) == s) return true;
-    return false;
+static void SelectClear(ContentBrowserState& CB) {
+    if (!CB.Selection.Empty()) CB.Selection.Clear();
 }
-static void SelectAdd(ContentBrowserState& CB, const std::filesystem::path& p) {
-    if (!IsSelected(CB, p)) CB.Selection.push_back(p);
-}
-static void SelectRemove(ContentBrowserState& CB, const std::filesystem::path& p) {
-    auto s = CanonicalStr(p);
-    CB.Selection.erase(std::remove_if(CB.Selection.begin(), CB.Selection.end(),
-        [&](const std::filesystem::path& x){ return CanonicalStr(x) == s; }), CB.Selection.end());
+static void SelectSet(ContentBrowserState& CB, int row) {
+    CB.Selection.Clear(); CB.Selection.Select((size_t)row);
 }
 static void SelectSet(ContentBrowserState& CB, const std::filesystem::path& p) {
-    CB.Selection.clear(); CB.Selection.push_back(p);
+    CB.Selection.Clear(); CB.Selection.Select(p);
+}
+
+// Brings CB.Listing up to date. Free when nothing changed: no syscalls and no
+// heap allocations (disk changes arrive through ProcessFileChanges). With a
+// filter, lists the best matches below the current folder from 'search'
+// (null while it is being built: the current folder is filtered instead).
+static void UpdateContentListing(ContentBrowserState& CB, const ace::SearchIndex* search, bool force) {
+    auto& L = CB.Listing;
+    const bool searched = search && !CB.Filter.empty();
+    bool stale = force || !L.Valid || L.Dir.native() != CB.Current.native() || L.Filter != CB.Filter || L.Searched != searched;
+    if (searched)
+        stale = stale || L.Fuzzy != CB.SearchFuzzy || L.InText != CB.SearchText || L.SearchRev != search->Revision();
+    if (stale) {
+        if (force) InvalidateVfs(CB.Current);
+        CB.Selection.Unbind();
+        L.Dir = CB.Current;
+        L.Filter = CB.Filter;
+        L.Searched = searched;
+        L.Fuzzy = CB.SearchFuzzy;
+        L.InText = CB.SearchText;
+        L.SearchRev = searched ? search->Revision() : 0;
+        L.SearchTotal = 0;
+        L.Valid = true;
+        if (searched) {
+            const std::string folder = CB.Current.lexically_normal().lexically_relative(search->Root()).generic_string();
+            std::vector<ace::SearchHit> hits;
+            ace::SearchQuery q;
+            q.Text = CB.Filter;
+            q.Folder = folder == "." ? std::string_view{} : std::string_view(folder);
+            q.Fuzzy = CB.SearchFuzzy;
+            q.Content = CB.SearchText;
+            q.MaxResults = 2000;
+            L.SearchTotal = search->Search(q, hits);
+            L.Model.Assign(search->Root(), hits);
+        } else {
+            L.Model.List(CB.Current, CB.Filter);
+        }
+        L.Bound = false;
+    }
+    if (!L.Bound) {
+        CB.Selection.Bind(L.Model);
+        L.Bound = true;
+    }
 }
 
 // ---------- Editors: Text & Blueprint ----------
@@ -1181,10 +1304,12 @@ static bool IsTextLike(const std::filesystem::path& p) {
     return exts.count(ext) > 0;
 }
 static bool IsBlueprintFile(const std::filesystem::path& p) {
-    return ToLower(p.extension().string()) == ".blueprint";
+    return ace::AssetTypeFromPath(p) == ace::AssetType::Blueprint;
 }
 
 static bool LoadFileToString(const std::filesystem::path& p, std::string& out) {
+    // Content files go through the VFS (cached lookups, packaged fallback)
+    if (auto v = ace::VFS::Get().ToVirtual(p)) return ace::VFS::Get().ReadText(*v, out);
     std::ifstream in(p, std::ios::binary);
     if (!in) return false;
     in.seekg(0, std::ios::end);
@@ -1200,6 +1325,8 @@ static bool SaveStringToFile(const std::filesystem::path& p, const std::string&
     std::ofstream out(p, std::ios::binary | std::ios::trunc);
     if (!out) return false;
     out.write(content.data(), (std::streamsize)content.size());
+    out.close();
+    NotifyContentChanged(p);
     return true;
 }
 
@@ -1220,13 +1347,17 @@ static void EnsureDefaultGraph(bp::Graph& g)
     add.outputs.push_back({g.NewId(), "Result", bp::PinKind::Output, bp::ValueType::Float});
 
     g.nodes.push_back(n1); g.nodes.push_back(n2); g.nodes.push_back(add);
+
+    // Const 2 + Const 3 -> Add
+    g.links.push_back({g.NewId(), n1.id, n1.outputs[0].id, add.id, add.inputs[0].id});
+    g.links.push_back({g.NewId(), n2.id, n2.outputs[0].id, add.id, add.inputs[1].id});
 }
 
-static bool LoadBlueprint(const std::filesystem::path& path, bp::Graph& g)
+// Pure parsing, so hot reload can run it on a worker
+static void ParseBlueprint(const std::string& txt, bp::Graph& g)
 {
     g = bp::Graph{};
-    std::string txt;
-    if (!LoadFileToString(path, txt) || txt.empty()) { EnsureDefaultGraph(g); return true; }
+    if (txt.empty()) { EnsureDefaultGraph(g); return; }
     try {
         auto j = json::parse(txt);
         // Optional wrapper
@@ -1275,9 +1406,18 @@ static bool LoadBlueprint(const std::filesystem::path& path, bp::Graph& g)
     } catch (...) {
         EnsureDefaultGraph(g);
     }
+}
+// 'text' receives the file as read, for hot reload
+static bool LoadBlueprint(const std::filesystem::path& path, bp::Graph& g, std::string* text = nullptr)
+{
+    std::string txt;
+    if (!LoadFileToString(path, txt)) txt.clear();
+    ParseBlueprint(txt, g);
+    if (text) *text = std::move(txt);
     return true;
 }
-static bool SaveBlueprint(const std::filesystem::path& path, const bp::Graph& g)
+// 'written' receives the file as saved
+static bool SaveBlueprint(const std::filesystem::path& path, const bp::Graph& g, std::string* written = nullptr)
 {
     json gj;
     gj["nextId"] = g.nextId;
@@ -1301,9 +1441,13 @@ static bool SaveBlueprint(const std::filesystem::path& path, const bp::Graph& g)
     root["Type"] = "Blueprint";
     root["Name"] = path.stem().string();
     root["Graph"] = gj;
+    std::string txt = root.dump(2);
     std::ofstream out(path, std::ios::binary | std::ios::trunc);
     if (!out) return false;
-    out << root.dump(2);
+    out << txt;
+    out.close();
+    NotifyContentChanged(path);
+    if (written) *written = std::move(txt);
     return true;
 }
 
@@ -1325,8 +1469,10 @@ static void OpenTextTab(EditorState& S, const std::filesystem::path& p) {
     t.Dirty = false;
     t.ReadOnly = false;
 
-    if (std::filesystem::exists(p)) {
+    const auto vpath = ace::VFS::Get().ToVirtual(p);
+    if (vpath ? ace::VFS::Get().Exists(*vpath) : std::filesystem::exists(p)) {
         if (!LoadFileToString(p, t.Buffer)) t.Buffer.clear();
+        t.DiskText = t.Buffer;
     } else {
         t.Buffer.clear();
         t.Dirty = true; // unsaved
@@ -1352,7 +1498,7 @@ static void OpenBlueprintTab(EditorState& S, const std::filesystem::path& p)
     t.Type    = EditorTabType::Blueprint;
     t.Path    = p;
     t.Title   = p.filename().string();
-    t.BPLoaded = LoadBlueprint(p, t.BPGraph);
+    t.BPLoaded = LoadBlueprint(p, t.BPGraph, &t.DiskText);
     t.BPDirty  = false;
 
     S.Tabs.push_back(std::move(t));
@@ -1362,6 +1508,289 @@ static void OpenBlueprintTab(EditorState& S, const std::filesystem::path& p)
          S.ActiveTab, (int)S.Tabs.size(), (int)S.Tabs.back().BPLoaded, p.string().c_str());
 }
 
+static void SaveTab(EditorTab& tab) {
+    if (tab.Type == EditorTabType::Text) {
+        if (tab.Code) tab.Buffer = tab.Code->GetText();
+        if (!SaveStringToFile(tab.Path, tab.Buffer)) return;
+        tab.DiskText = tab.Buffer;
+        tab.Dirty = false;
+    } else {
+        if (!SaveBlueprint(tab.Path, tab.BPGraph, &tab.DiskText)) return;
+        tab.BPDirty = false;
+    }
+    tab.ChangedOnDisk = false;
+    tab.Conflicts = 0;
+    ++tab.ReloadSeq;    // a reload read before the save is stale
+}
+
+// --- Hot reload ---
+//
+// ProcessFileChanges passes each frame's changes to QueueHotReload. Open
+// tabs showing a changed file and the open map are re-read (and parsed)
+// on a worker; the whole batch is then applied at once from
+// PumpMainThread, between frames. Clean tabs and maps are replaced, dirty
+// text tabs get a three-way merge, dirty blueprints and maps are flagged.
+// Assets the map references go through AssetManager::Reload(). Only
+// changed files are read, so the cost follows the change.
+
+struct HotReloadTab {
+    std::filesystem::path Path;
+    uint64_t              Seq = 0;        // EditorTab::ReloadSeq when queued
+    bool                  Blueprint = false;
+    bool                  Found = false;  // false: deleted or unreadable
+    std::string           Text;
+    bp::Graph             Graph;          // parsed from Text for blueprints
+};
+
+struct HotReloadBatch {
+    std::vector<HotReloadTab>   Tabs;
+    std::filesystem::path       Map;      // empty: the map did not change
+    uint64_t                    MapSeq = 0;
+    std::unique_ptr<ace::World> World;    // null: unreadable
+    int                         MapMaxId = 0;
+};
+
+// TextEditor::GetText() drops '\r' and ends every line, the last one
+// included, with '\n'. Dirty buffers come from it, so the other two sides
+// of a merge are brought to the same form.
+static std::string AsEditorText(std::string_view text) {
+    std::string out;
+    out.reserve(text.size() + 1);
+    for (char c : text) if (c != '\r') out += c;
+    out += '\n';
+    return out;
+}
+
+// Shows tab.Buffer in the code view, keeping the cursor line
+static void RefreshCodeView(EditorTab& tab) {
+    if (!tab.Code) return;      // built from Buffer when first drawn
+    auto cursor = tab.Code->GetCursorPosition();
+    std::string_view text = tab.Buffer;
+    if (tab.Dirty && !text.empty() && text.back() == '\n') text.remove_suffix(1);     // GetText() adds it back
+    tab.Code->SetText(std::string(text));
+    cursor.mLine = std::min(cursor.mLine, tab.Code->GetTotalLines() - 1);
+    tab.Code->SetCursorPosition(cursor);
+}
+
+static void ApplyHotReload(EditorState& S, HotReloadBatch& batch) {
+    ACE_PROFILE_FUNCTION();
+    for (auto& item : batch.Tabs) {
+        auto it = std::find_if(S.Tabs.begin(), S.Tabs.end(), [&](const EditorTab& t){
+            return t.ReloadSeq == item.Seq && t.Path == item.Path;
+        });
+        if (it == S.Tabs.end()) continue;   // closed, saved or changed again since
+        EditorTab& tab = *it;
+        if (!item.Found) { tab.ChangedOnDisk = true; continue; }
+        if (item.Text == tab.DiskText) continue;    // e.g. our own save
+
+        if (tab.Type == EditorTabType::Blueprint) {
+            if (tab.BPDirty) { tab.ChangedOnDisk = true; continue; }    // edited while it loaded
+            tab.BPGraph = std::move(item.Graph);
+            tab.BPLoaded = true;
+            tab.BPStatus.clear();                   // compiled from the old graph
+            Logf("Reloaded '%s' (changed on disk)", tab.Path.string().c_str());
+        } else if (!tab.Dirty) {
+            tab.Buffer = item.Text;
+            RefreshCodeView(tab);
+            Logf("Reloaded '%s' (changed on disk)", tab.Path.string().c_str());
+        } else {
+            std::string merged;
+            tab.Conflicts = ace::editor::MergeText(AsEditorText(tab.DiskText), tab.Buffer, AsEditorText(item.Text), merged);
+            tab.Buffer = std::move(merged);
+            RefreshCodeView(tab);
+            Logf("Merged disk changes into '%s': %zu conflict(s)", tab.Path.string().c_str(), tab.Conflicts);
+        }
+        tab.DiskText = std::move(item.Text);
+        tab.ChangedOnDisk = false;
+    }
+
+    if (batch.Map.empty() || batch.MapSeq != S.MapReloadSeq || batch.Map != S.OpenMapPath) return;
+    if (!batch.World || S.MapDirty) {
+        S.MapChangedOnDisk = true;      // unreadable, or edited while it loaded
+        return;
+    }
+    // Keep the selection on the same actor
+    const auto* selId = S.EditorWorld.IsAlive(S.SelectedEntity) ? S.EditorWorld.TryGet<ace::IdComponent>(S.SelectedEntity) : nullptr;
+    const int keep = selId ? selId->Id : -1;
+    S.EditorWorld = std::move(*batch.World);
+    RebuildSpatialIndex(S);
+    S.NextEntityId = std::max(1, batch.MapMaxId + 1);
+    S.SelectedEntity = {};
+    S.EditorWorld.Each<ace::IdComponent>([&](ace::Entity e, ace::IdComponent& id){ if (id.Id == keep) S.SelectedEntity = e; });
+    S.WorldRefsDirty = true;
+    MapFileSynced(S);
+    Logf("Reloaded map '%s' (changed on disk, %zu entities)", S.OpenMapPath.string().c_str(), S.EditorWorld.Count());
+}
+
+static void QueueHotReload(EditorState& S, const std::vector<ace::FileChange>& changes) {
+    ACE_PROFILE_FUNCTION();
+    const auto changed = [&](const std::filesystem::path& p) {
+        for (const auto& c : changes) {
+            const bool tree = c.Kind == ace::FileChangeKind::Rescan || (c.IsDir && c.Kind == ace::FileChangeKind::Removed);
+            if (tree ? IsSubPathOf(c.Path, p) : !c.IsDir && c.Path == p) return true;
+        }
+        return false;
+    };
+
+    auto batch = std::make_shared<HotReloadBatch>();
+    for (auto& tab : S.Tabs) {
+        if (!changed(tab.Path)) continue;
+        const bool blueprint = tab.Type == EditorTabType::Blueprint;
+        if (blueprint && tab.BPDirty) { tab.ChangedOnDisk = true; continue; }     // graphs are not merged
+        HotReloadTab t;
+        t.Path = tab.Path;
+        t.Seq = ++tab.ReloadSeq;
+        t.Blueprint = blueprint;
+        batch->Tabs.push_back(std::move(t));
+    }
+    if (!S.OpenMapPath.empty() && changed(S.OpenMapPath)) {
+        std::error_code ec;
+        const auto written = std::filesystem::last_write_time(S.OpenMapPath, ec);
+        if (ec || S.MapDirty) {
+            S.MapChangedOnDisk = true;
+        } else if (written != S.MapWriteTime) {      // else our own save
+            batch->Map = S.OpenMapPath;
+            batch->MapSeq = ++S.MapReloadSeq;
+        }
+    }
+    if (batch->Tabs.empty() && batch->Map.empty()) return;
+
+    ace::JobSystem::Get().Run([&S, batch] {
+        ACE_PROFILE_SCOPE("HotReload");
+        for (auto& t : batch->Tabs) {
+            t.Found = LoadFileToString(t.Path, t.Text);
+            if (t.Found && t.Blueprint) ParseBlueprint(t.Text, t.Graph);
+        }
+        if (!batch->Map.empty()) {
+            auto world = std::make_unique<ace::World>();
+            if (ReadMapFile(batch->Map, *world, batch->MapMaxId)) batch->World = std::move(world);
+        }
+        ace::JobSystem::Get().RunOnMainThread([&S, batch] { ApplyHotReload(S, *batch); });
+    });
+}
+
+// Keeps a handle on every asset the open map references, so WorldAssets
+// keeps them loaded and reloads them when their files change
+static void UpdateWorldAssets(EditorState& S) {
+    if (!S.WorldAssets) return;
+    ACE_PROFILE_FUNCTION();
+    if (S.WorldRefsDirty) {
+        S.WorldRefsDirty = false;
+        std::unordered_map<std::string, ace::AssetHandle> refs;
+        auto keep = [&](const ace::StaticMeshComponent& sm){
+            for (const std::string* ref : {&sm.Mesh, &sm.Material}) {
+                if (ref->empty()) continue;
+                std::string p = ace::VFS::Normalize(*ref);
+                if (refs.count(p)) continue;
+                auto it = S.WorldRefs.find(p);
+                ace::AssetHandle h = it != S.WorldRefs.end() ? std::move(it->second)
+                                                             : S.WorldAssets->Load(p, ace::AssetPriority::Low);
+                refs.emplace(std::move(p), std::move(h));
+            }
+        };
+        S.EditorWorld.Each<ace::StaticMeshComponent>([&](ace::Entity, ace::StaticMeshComponent& sm){ keep(sm); });
+        S.EditorWorld.Each<ace::ExtraStaticMeshComponent>([&](ace::Entity, ace::ExtraStaticMeshComponent& extra){
+            for (const auto& sm : extra.Meshes) keep(sm);
+        });
+        S.WorldRefs.swap(refs);     // handles no longer referenced are released here
+    }
+    S.WorldAssets->Update(1.0);
+}
+
+// Keeps the watcher on the open project's Content and Source folders
+static void SyncFileWatcher(EditorState& S) {
+    const auto root = S.Project ? S.Project->GetInfo().RootDir : std::filesystem::path{};
+    if (root == S.WatchedRoot) return;
+    S.WatchedRoot = root;
+    S.Watcher.UnwatchAll();
+    if (!S.Project) return;
+    const bool content = S.Watcher.Watch(S.Project->ContentDir()) != 0;
+    S.Watcher.Watch(S.Project->SourceDir());
+    Logf("File watcher: %s%s", content ? "watching Content" : "Content folder missing",
+         S.Watcher.IsPolling() ? " (polling)" : "");
+}
+
+// Routes one frame's worth of watcher batches to everything that caches disk state
+static void ProcessFileChanges(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
+    auto& changes = S.FileChanges;
+    changes.clear();
+    if (!S.Watcher.Poll(changes)) return;
+
+    auto& CB = S.CB;
+    bool rescanAssets = false;
+    for (const auto& c : changes) {
+        const bool rescan = c.Kind == ace::FileChangeKind::Rescan;
+        const auto parent = c.Path.parent_path();
+
+        // VFS lookups and the asset registry
+        if (auto v = ace::VFS::Get().ToVirtual(c.Path)) {
+            ace::VFS::Get().Invalidate(*v);
+            if (rescan) rescanAssets = true;
+            else        g_ChangedAssetPaths.push_back(std::move(*v));
+        }
+
+        // Grid listing and folder tree
+        auto& L = CB.Listing;
+        if (L.Valid && parent == L.Dir && !rescan) {
+            CB.Selection.Unbind();          // its rows are about to move
+            L.Bound = false;
+            if (!L.Model.Apply(c)) L.Valid = false;
+        } else if (rescan || parent == L.Dir || c.Path == L.Dir) {
+            L.Valid = false;
+        }
+        CB.Tree.Apply(c);
+
+        // Previews
+        if (rescan)         S.Thumbs.Clear();
+        else if (!c.IsDir)  S.Thumbs.Invalidate(c.Path);
+    }
+    // Open tabs and the map, then the assets the map uses (resident ones only)
+    QueueHotReload(S, changes);
+    if (S.WorldAssets) {
+        if (rescanAssets) S.WorldAssets->ReloadAll();
+        else              S.WorldAssets->Reload(g_ChangedAssetPaths);
+    }
+
+    // Lost events: rebuild the registry from its snapshot in the background
+    if (rescanAssets) { S.AssetsContent.clear(); g_ChangedAssetPaths.clear(); }
+
+    // Search index: patched in place; lost events rebuild it in the background
+    if (rescanAssets) {
+        S.SearchContent.clear();
+    } else {
+        S.Search.Apply(changes);
+        if (S.SearchBuildRunning) S.SearchPending.insert(S.SearchPending.end(), changes.begin(), changes.end());
+    }
+}
+
+// Takes in the copies, moves and deletes that finished this frame. The
+// moves of a batch reach UpdateAssetRegistry together, so each referrer is
+// rewritten once for the whole batch.
+static void UpdateFileOperations(EditorState& S) {
+    static std::vector<ace::editor::FileOpResult> finished;
+    finished.clear();
+    S.FileOps.Update(finished);
+    for (const auto& r : finished) {
+        for (const auto& [from, to] : r.Moved) {
+            NotifyContentChanged(from);
+            NotifyContentChanged(to);
+            NotifyContentMoved(from, to);
+        }
+        for (const auto& p : r.Created) NotifyContentChanged(p);
+        for (const auto& p : r.Removed) NotifyContentChanged(p);
+        if (r.Kind != ace::editor::FileOpKind::Copy) SelectClear(S.CB);
+
+        Logf("File operation %llu: %s, %zu moved, %zu created, %zu removed%s%s",
+             (unsigned long long)r.Id,
+             r.State == ace::editor::FileOpState::Done ? "done" :
+             r.State == ace::editor::FileOpState::Cancelled ? "cancelled" : "failed",
+             r.Moved.size(), r.Created.size(), r.Removed.size(),
+             r.Error.empty() ? "" : ": ", r.Error.c_str());
+        if (!r.Error.empty()) S.CB.Error = r.Error;
+    }
+}
+
 static void OpenFileInEditor(EditorState& S, const std::filesystem::path& p) {
     S.P.Editors = true; // ensure Editors panel is visible next frame
     Logf("OpenFileInEditor: '%s' ext='%s'", p.string().c_str(), p.extension().string().c_str());
@@ -1429,15 +1858,17 @@ static void DrawBlueprintEditor(EditorTab& tab)
         dl->AddLine(ImVec2(origin.x, origin.y + y),
                     ImVec2(origin.x + size.x, origin.y + y), IM_COL32(40,40,40,255));
 
-    // Precompute node rects and pin positions
+    // Precompute node rects and pin positions (frame arena: valid for this frame only)
     struct NodeDraw {
         bp::Node* n;
         ImVec2    pos;      // top-left in screen space
         ImVec2    size;
-        std::vector<ImVec2> inPinPos;
-        std::vector<ImVec2> outPinPos;
+        ImVec2*   inPinPos;
+        ImVec2*   outPinPos;
     };
-    std::vector<NodeDraw> draws; draws.reserve(g.nodes.size());
+    auto& frame = ace::mem::FrameArena();
+    NodeDraw* draws = frame.NewArray<NodeDraw>(g.nodes.size());
+    size_t drawCount = 0;
 
     auto calcNodeSize = [](const bp::Node& n)->ImVec2{
         int rows = (int)std::max(n.inputs.size(), n.outputs.size());
@@ -1448,16 +1879,15 @@ static void DrawBlueprintEditor(EditorTab& tab)
     };
 
     for (auto& n : g.nodes) {
-        NodeDraw nd; nd.n = &n;
+        NodeDraw& nd = draws[drawCount++]; nd.n = &n;
         nd.size = calcNodeSize(n);
         nd.pos  = ScreenFromCanvas(n.pos, origin, ui.pan);
         // pins
-        nd.inPinPos.resize(n.inputs.size());
-        nd.outPinPos.resize(n.outputs.size());
+        nd.inPinPos  = frame.NewArray<ImVec2>(n.inputs.size());
+        nd.outPinPos = frame.NewArray<ImVec2>(n.outputs.size());
         float y0 = nd.pos.y + 36.0f;
         for (size_t i=0;i<n.inputs.size(); ++i)  nd.inPinPos[i]  = ImVec2(nd.pos.x,               y0 + i*22.0f);
         for (size_t i=0;i<n.outputs.size(); ++i) nd.outPinPos[i] = ImVec2(nd.pos.x + nd.size.x,   y0 + i*22.0f);
-        draws.push_back(std::move(nd));
     }
 
     // Links (behind nodes)
@@ -1467,7 +1897,8 @@ static void DrawBlueprintEditor(EditorTab& tab)
         if (!nA || !nB) continue;
 
         ImVec2 from = ImVec2(0,0), to = ImVec2(0,0);
-        for (auto& nd : draws) {
+        for (size_t d=0; d<drawCount; ++d) {
+            auto& nd = draws[d];
             if (nd.n->id == l.fromNode) {
                 for (size_t i=0;i<nd.n->outputs.size(); ++i)
                     if (nd.n->outputs[i].id == l.fromPin) from = nd.outPinPos[i];
@@ -1492,7 +1923,7 @@ static void DrawBlueprintEditor(EditorTab& tab)
         return false;
     };
 
-    for (size_t i=0;i<draws.size(); ++i) {
+    for (size_t i=0;i<drawCount; ++i) {
         auto& nd = draws[i];
         auto* n  = nd.n;
 
@@ -1519,6 +1950,7 @@ static void DrawBlueprintEditor(EditorTab& tab)
         if (nodeActive && ImGui::IsMouseDragging(ImGuiMouseButton_Left) && !ui.linking) {
             n->pos += ImGui::GetIO().MouseDelta;   // move in canvas space (1:1 with screen delta)
             tab.BPDirty = true;
+            tab.BPStatus.clear();
         }
 
         // Pins + linking
@@ -1561,7 +1993,7 @@ static void DrawBlueprintEditor(EditorTab& tab)
                             if (e.fromNode==l.fromNode && e.fromPin==l.fromPin &&
                                 e.toNode==l.toNode && e.toPin==l.toPin) { dup = true; break; }
                         }
-                        if (!dup) { g.links.push_back(l); tab.BPDirty = true; }
+                        if (!dup) { g.links.push_back(l); tab.BPDirty = true; tab.BPStatus.clear(); }
                         ui.linking = false;
                     } else {
                         // Same side: restart from this pin
@@ -1595,9 +2027,7 @@ static void DrawBlueprintEditor(EditorTab& tab)
 
     // Bring dragged/selected node to front (simple re-order)
     if (nodeToFront >= 0) {
-        auto n = g.nodes[nodeToFront];
-        g.nodes.erase(g.nodes.begin() + nodeToFront);
-        g.nodes.push_back(n);
+        std::rotate(g.nodes.begin() + nodeToFront, g.nodes.begin() + nodeToFront + 1, g.nodes.end());
     }
 
     // While linking, draw preview line
@@ -1624,6 +2054,7 @@ static void DrawBlueprintEditor(EditorTab& tab)
                 [&](const bp::Node& n){ return n.id==nid; }), g.nodes.end());
             ui.selectedNode = 0;
             tab.BPDirty = true;
+            tab.BPStatus.clear();
         }
     }
 
@@ -1633,9 +2064,48 @@ static void DrawBlueprintEditor(EditorTab& tab)
 
 
 
+// Compiles the open graph to bytecode and runs it once, for the toolbar
+static void CompileBlueprintTab(EditorTab& tab)
+{
+    const auto& g = tab.BPGraph;
+    ace::BlueprintGraph graph;
+    graph.Nodes.reserve(g.nodes.size());
+    for (const auto& n : g.nodes) {
+        auto& c = graph.Nodes.emplace_back();
+        c.Id = n.id;
+        c.Title = n.title;
+        for (const auto& p : n.inputs)  c.Inputs.push_back(p.id);
+        for (const auto& p : n.outputs) c.Outputs.push_back(p.id);
+    }
+    for (const auto& l : g.links) graph.Links.push_back({l.fromNode, l.fromPin, l.toNode, l.toPin});
+
+    ace::BlueprintProgram program;
+    std::string error;
+    ace::BlueprintVM vm;
+    tab.BPStatusOk = ace::CompileBlueprint(graph, program, error) && vm.Load(program);
+    if (!tab.BPStatusOk) {
+        tab.BPStatus = error.empty() ? "Invalid bytecode" : error;
+        Logf("Blueprint compile failed (%s): %s", tab.Path.string().c_str(), tab.BPStatus.c_str());
+        return;
+    }
+    vm.Run();
+
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "OK: %zu instruction(s), %u register(s)",
+                  program.Instructions() - 1, program.NumRegisters);
+    tab.BPStatus = buf;
+    for (const auto& r : program.Results) {
+        const bp::Node* n = g.FindNode(r.Node);
+        std::snprintf(buf, sizeof(buf), ", %s = %g", n ? n->title.c_str() : "?", vm.Value(r.Register));
+        tab.BPStatus += buf;
+    }
+    Logf("Blueprint compiled (%s): %s", tab.Path.string().c_str(), tab.BPStatus.c_str());
+}
+
 // --- Editors panel (tabs) ---
 
 static void DrawPanel_Editors(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (!S.P.Editors) return;
 
     // ---------------- Focus/visibility control (fixes popup blocking) ----------------
@@ -1675,39 +2145,42 @@ static void DrawPanel_Editors(EditorState& S) {
         EditorTab& tab = S.Tabs[S.ActiveTab];
 
         if (tab.Type == EditorTabType::Text) {
-            if (ImGui::Button("Save (Ctrl+S)")) {
-                if (tab.Code) tab.Buffer = tab.Code->GetText();
-                if (SaveStringToFile(tab.Path, tab.Buffer)) tab.Dirty = false;
-            }
+            if (ImGui::Button("Save (Ctrl+S)")) SaveTab(tab);
             ImGui::SameLine();
             if (ImGui::Button("Reload")) {
                 std::string tmp;
                 if (LoadFileToString(tab.Path, tmp)) {
-                    tab.Buffer = std::move(tmp);
+                    tab.Buffer = tab.DiskText = std::move(tmp);
                     if (tab.Code) tab.Code->SetText(tab.Buffer);
-                    tab.Dirty = false;
+                    tab.Dirty = tab.ChangedOnDisk = false;
+                    tab.Conflicts = 0;
+                    ++tab.ReloadSeq;
                 }
             }
         } else { // Blueprint
-            if (ImGui::Button("Save (Ctrl+S)")) {
-                if (SaveBlueprint(tab.Path, tab.BPGraph)) tab.BPDirty = false;
-            }
+            if (ImGui::Button("Save (Ctrl+S)")) SaveTab(tab);
             ImGui::SameLine();
             if (ImGui::Button("Revert")) {
-                LoadBlueprint(tab.Path, tab.BPGraph); tab.BPDirty = false;
+                LoadBlueprint(tab.Path, tab.BPGraph, &tab.DiskText); tab.BPDirty = tab.ChangedOnDisk = false;
+                tab.BPStatus.clear();
+                ++tab.ReloadSeq;
             }
             ImGui::SameLine();
-            if (ImGui::Button("Compile")) {
-                bool ok = true;
-                for (auto& l : tab.BPGraph.links) {
-                    ok &= (tab.BPGraph.FindPin(l.fromNode, l.fromPin) != nullptr) &&
-                          (tab.BPGraph.FindPin(l.toNode,   l.toPin)   != nullptr);
-                }
+            if (ImGui::Button("Compile")) CompileBlueprintTab(tab);
+            if (!tab.BPStatus.empty()) {
                 ImGui::SameLine();
-                ImGui::TextColored(ok ? ImVec4(0.5f,1,0.5f,1) : ImVec4(1,0.5f,0.5f,1),
-                                   ok ? "OK" : "Broken links");
+                ImGui::TextColored(tab.BPStatusOk ? ImVec4(0.5f,1,0.5f,1) : ImVec4(1,0.5f,0.5f,1),
+                                   "%s", tab.BPStatus.c_str());
             }
         }
+        if (tab.ChangedOnDisk) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1,0.6f,0.2f,1), "Changed on disk");
+        }
+        if (tab.Conflicts) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1,0.6f,0.2f,1), "%zu merge conflict(s): see <<<<<<< markers", tab.Conflicts);
+        }
         ImGui::SameLine();
         ImGui::TextDisabled("|");
         ImGui::SameLine();
@@ -1730,15 +2203,7 @@ static void DrawPanel_Editors(EditorState& S) {
 
         // Ctrl+S: Save
         if (io.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_S, false)) {
-            if (S.ActiveTab >= 0 && S.ActiveTab < tab_count) {
-                EditorTab& tab = S.Tabs[S.ActiveTab];
-                if (tab.Type == EditorTabType::Text) {
-                    if (tab.Code) tab.Buffer = tab.Code->GetText();
-                    if (SaveStringToFile(tab.Path, tab.Buffer)) tab.Dirty = false;
-                } else {
-                    if (SaveBlueprint(tab.Path, tab.BPGraph)) tab.BPDirty = false;
-                }
-            }
+            if (S.ActiveTab >= 0 && S.ActiveTab < tab_count) SaveTab(S.Tabs[S.ActiveTab]);
         }
 
         // Ctrl+W: Close current tab
@@ -1812,6 +2277,7 @@ static void DrawPanel_Editors(EditorState& S) {
                         tab.Dirty = true;
                     }
                 } else {
+                    ace::mem::AllocCounterScope bpAllocs(S.Allocs.BlueprintEditor);
                     DrawBlueprintEditor(tab);
                 }
 
@@ -1841,76 +2307,101 @@ static void DrawPanel_Editors(EditorState& S) {
 
 
 
+// Queues a move of the paths in an ACE_PATHS payload into 'dir'
+static void DropMove(EditorState& S, const ImGuiPayload* pld, const std::filesystem::path& dir, const char* where) {
+    std::vector<std::filesystem::path> sources;
+    std::string_view all(static_cast<const char*>(pld->Data), (size_t)pld->DataSize);
+    while (!all.empty()) {
+        const size_t eol = std::min(all.find('\n'), all.size());
+        if (eol > 0) sources.emplace_back(all.substr(0, eol));
+        all.remove_prefix(std::min(eol + 1, all.size()));
+    }
+    if (sources.empty()) return;
+    Logf("Drop onto %s '%s': moving %zu item(s)", where, dir.string().c_str(), sources.size());
+    S.CB.Error.clear();
+    S.FileOps.Move(std::move(sources), dir);
+    SelectClear(S.CB);
+}
+
+// One row per queued, running or finished copy/move/delete, above the grid
+static void DrawFileOperations(EditorState& S) {
+    using ace::editor::FileOpState;
+    static std::vector<ace::editor::FileOpProgress> ops;
+    S.FileOps.GetProgress(ops);
+    if (ops.empty()) return;
+
+    for (const auto& op : ops) {
+        ImGui::PushID((int)op.Id);
+        const bool active = op.State == FileOpState::Queued || op.State == FileOpState::Running;
+        float fraction = 0.0f;
+        char overlay[96];
+        if (op.BytesTotal > 0) {
+            fraction = (float)((double)op.BytesDone / (double)op.BytesTotal);
+            std::snprintf(overlay, sizeof(overlay), "%.1f of %.1f MB, %u/%u files",
+                          op.BytesDone / 1048576.0, op.BytesTotal / 1048576.0, op.ItemsDone, op.ItemsTotal);
+        } else {
+            if (op.ItemsTotal > 0) fraction = (float)op.ItemsDone / (float)op.ItemsTotal;
+            std::snprintf(overlay, sizeof(overlay), "%u/%u items", op.ItemsDone, op.ItemsTotal);
+        }
+        if (op.State == FileOpState::Queued)         std::snprintf(overlay, sizeof(overlay), "Queued");
+        else if (op.State == FileOpState::Done)      fraction = 1.0f;
+
+        ImGui::TextUnformatted(op.Label.c_str());
+        ImGui::SameLine();
+        ImGui::ProgressBar(fraction, ImVec2(260.0f, 0.0f), overlay);
+        ImGui::SameLine();
+        if (active) {
+            if (ImGui::SmallButton("Cancel")) S.FileOps.Cancel(op.Id);
+        } else {
+            if (op.State == FileOpState::Cancelled)   ImGui::TextDisabled("Cancelled");
+            else if (op.State == FileOpState::Failed) ImGui::TextColored(ImVec4(1,0.3f,0.3f,1), "Failed");
+            else                                      ImGui::TextDisabled("Done");
+            if (op.CanUndo) {
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Undo")) S.FileOps.Undo(op.Id);
+            }
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Dismiss")) S.FileOps.Dismiss(op.Id);
+        }
+        if (!op.Error.empty()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1,0.3f,0.3f,1), "%s", op.Error.c_str());
+        }
+        ImGui::PopID();
+    }
+    ImGui::Separator();
+}
+
 // --- Folder tree (left sidebar inside Content Browser)
 
-static bool DrawFolderTreeNode(const std::filesystem::path& p,
+// Draws from CB.Tree only: no file system calls, and nodes not yet read are
+// asked for as they come into view
+static bool DrawFolderTreeNode(EditorState& S,
+                               ace::editor::FolderTree::NodeId id,
                                const std::filesystem::path& current,
                                std::filesystem::path& outClicked)
 {
+    auto& T = S.CB.Tree;
+    T.Touch(id);
+    const std::filesystem::path& p = T.Path(id);
     ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanFullWidth;
-    if (PathsEqual(p, current)) flags |= ImGuiTreeNodeFlags_Selected;
-
-    // Detect children
-    bool hasChildren = false;
-    std::error_code ec;
-    for (auto it = std::filesystem::directory_iterator(p, ec);
-         !ec && it != std::filesystem::directory_iterator(); ++it)
-    {
-        if (it->is_directory()) { hasChildren = true; break; }
-    }
+    if (p.native() == current.native()) flags |= ImGuiTreeNodeFlags_Selected;   // both built from CB.Root: lexical is enough
 
+    const bool hasChildren = T.MayHaveChildren(id);
     if (!hasChildren) flags |= ImGuiTreeNodeFlags_Leaf;
 
-    const std::string label = p.filename().string();
-    bool open = ImGui::TreeNodeEx(label.c_str(), flags);
+    bool open = ImGui::TreeNodeEx(T.Name(id).c_str(), flags);
     if (ImGui::IsItemClicked()) outClicked = p;
 
-    // Accept drops onto tree nodes (move/copy into that folder)
+    // Accept drops onto tree nodes (move into that folder)
     if (ImGui::BeginDragDropTarget()) {
-        if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) {
-            const char* data = static_cast<const char*>(pld->Data);
-            std::string all(data, data + pld->DataSize);
-            std::stringstream ss(all);
-            std::string line;
-            bool anyErr = false;
-            size_t moved = 0;
-
-            Logf("Drop onto TREE folder '%s' payloadSize=%d",
-                 p.string().c_str(), (int)pld->DataSize);
-
-            while (std::getline(ss, line)) {
-                if (line.empty()) continue;
-                std::filesystem::path src(line);
-                std::string err;
-                Logf("  Move request: '%s' -> '%s'", src.string().c_str(), p.string().c_str());
-                if (!MoveEntryToDir(src, p, err)) {
-                    anyErr = true;
-                    Logf("  Move FAILED: %s", err.c_str());
-                } else {
-                    ++moved;
-                    Logf("  Move OK");
-                }
-            }
-            Logf("Drop onto TREE folder '%s' done. moved=%zu, anyErr=%d", p.string().c_str(), moved, (int)anyErr);
-        }
+        if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) DropMove(S, pld, p, "TREE folder");
         ImGui::EndDragDropTarget();
     }
 
     if (open) {
-        if (hasChildren) {
-            std::vector<std::filesystem::path> kids;
-            for (auto it = std::filesystem::directory_iterator(p, ec);
-                 !ec && it != std::filesystem::directory_iterator(); ++it)
-            {
-                if (it->is_directory()) kids.push_back(it->path());
-            }
-            std::sort(kids.begin(), kids.end(),
-                      [](const auto& a, const auto& b){ return a.filename().string() < b.filename().string(); });
-
-            for (auto& c : kids) {
-                DrawFolderTreeNode(c, current, outClicked);
-            }
-        }
+        // The tree only changes in Update() and Apply(), never while drawing
+        for (const auto c : T.Children(id)) DrawFolderTreeNode(S, c, current, outClicked);
         ImGui::TreePop();
     }
     return open;
@@ -1918,19 +2409,30 @@ static bool DrawFolderTreeNode(const std::filesystem::path& p,
 
 static void Breadcrumbs(EditorState& S) {
     auto& CB = S.CB;
-    std::error_code ec_rel;
-    auto rel = std::filesystem::relative(CB.Current, CB.Root, ec_rel);
-    ImGui::TextDisabled("Content");
-    std::filesystem::path walk = CB.Root;
-    if (!rel.empty() && !ec_rel) {
-        for (auto& part : rel) {
-            ImGui::SameLine(); ImGui::TextDisabled(">");
-            ImGui::SameLine();
-            if (ImGui::SmallButton(part.string().c_str())) {
-                walk /= part; CB.Current = walk; SelectClear(CB);
+    // Lexical: Current is always built from Root. Only rebuilt on navigation,
+    // so drawing the bar does not allocate.
+    if (CB.CrumbsFor.native() != CB.Current.native()) {
+        CB.Crumbs.clear();
+        auto rel = CB.Current.lexically_relative(CB.Root);
+        std::filesystem::path walk = CB.Root;
+        if (!rel.empty() && rel != ".") {
+            for (auto& part : rel) {
+                walk /= part;
+                CB.Crumbs.emplace_back(part.string(), walk);
             }
         }
+        CB.CrumbsFor = CB.Current;
+    }
+    ImGui::TextDisabled("Content");
+    size_t clicked = CB.Crumbs.size();
+    for (size_t i = 0; i < CB.Crumbs.size(); ++i) {
+        ImGui::SameLine(); ImGui::TextDisabled(">");
+        ImGui::SameLine();
+        ImGui::PushID((int)i);
+        if (ImGui::SmallButton(CB.Crumbs[i].first.c_str())) clicked = i;
+        ImGui::PopID();
     }
+    if (clicked < CB.Crumbs.size()) { CB.Current = CB.Crumbs[clicked].second; SelectClear(CB); }
 }
 
 static void DrawItemIcon(ImDrawList* dl, const ImVec2& p0, const ImVec2& p1, bool isDir, bool selected) {
@@ -1965,7 +2467,7 @@ static std::string MakeAssetJson(const std::string& type, const std::string& nam
 
 static bool CreateAssetFile(const std::filesystem::path& folder, const std::string& baseName, const std::string& type, std::filesystem::path& outPath) {
     std::string file = baseName + ".aceasset";
-    auto p = UniqueSibling(folder, file);
+    auto p = ace::editor::UniqueSibling(folder, file);
     std::string content = MakeAssetJson(type, std::filesystem::path(p).stem().string());
     if (!SaveStringToFile(p, content)) return false;
     outPath = p;
@@ -2016,7 +2518,7 @@ static bool CreateItemFromTemplate(const CBTemplateDesc& T,
 
     // Final file path (unique within folder)
     const std::string fileName = baseName + T.Ext;
-    std::filesystem::path dest = UniqueSibling(folder, fileName);
+    std::filesystem::path dest = ace::editor::UniqueSibling(folder, fileName);
 
     // Create content based on template
     if (std::strcmp(T.Id, "blueprint.graph") == 0) {
@@ -2137,14 +2639,14 @@ static void DrawNewItemDialog(EditorState& S)
 
                 if (std::strcmp(tid, "blueprint.graph") == 0) {
                     // .blueprint with a default graph
-                    auto path = UniqueSibling(CB.NewItemTargetFolder, base + std::string(".blueprint"));
+                    auto path = ace::editor::UniqueSibling(CB.NewItemTargetFolder, base + std::string(".blueprint"));
                     bp::Graph g; EnsureDefaultGraph(g);
                     ok = SaveBlueprint(path, g);
                     if (ok) created = path;
 
                 } else if (std::strcmp(tid, "asset.gamemode") == 0) {
                     // Emit .gamemode, not .aceasset
-                    auto path = UniqueSibling(CB.NewItemTargetFolder, base + std::string(".gamemode"));
+                    auto path = ace::editor::UniqueSibling(CB.NewItemTargetFolder, base + std::string(".gamemode"));
                     const std::string content =
                         "{\n"
                         "  \"type\": \"GameMode\",\n"
@@ -2156,7 +2658,7 @@ static void DrawNewItemDialog(EditorState& S)
 
                 } else if (std::strcmp(tid, "asset.data") == 0) {
                     // Emit .asset, not .aceasset
-                    auto path = UniqueSibling(CB.NewItemTargetFolder, base + std::string(".asset"));
+                    auto path = ace::editor::UniqueSibling(CB.NewItemTargetFolder, base + std::string(".asset"));
                     const std::string content =
                         "{\n"
                         "  \"type\": \"DataAsset\",\n"
@@ -2168,7 +2670,7 @@ static void DrawNewItemDialog(EditorState& S)
 
                 } else {
                     // Fallback: plain text file
-                    auto path = UniqueSibling(CB.NewItemTargetFolder, base + std::string(".txt"));
+                    auto path = ace::editor::UniqueSibling(CB.NewItemTargetFolder, base + std::string(".txt"));
                     ok = SaveStringToFile(path, "");
                     if (ok) created = path;
                 }
@@ -2304,7 +2806,7 @@ static bool DoCreateNewItem(EditorState& S,
 
     // Prefer a unique sibling to avoid hard errors if the name already exists
     if (std::filesystem::exists(dest)) {
-        dest = UniqueSibling(targetFolder, finalName);
+        dest = ace::editor::UniqueSibling(targetFolder, finalName);
     }
 
     // Write file
@@ -2366,6 +2868,54 @@ static std::filesystem::path ProjectSourceDir(const EditorState& S)
     return std::filesystem::weakly_canonical(S.ProjectFile.parent_path() / "Source");
 }
 
+// Brings every <Header>.generated.h under /Source up to date (incremental).
+// Runs on the shared job pool; results are logged back on the main thread.
+static void RegenerateReflection(const EditorState& S)
+{
+    static std::atomic<bool> s_Running{false};
+    auto srcRoot = ProjectSourceDir(S);
+    if (srcRoot.empty()) { Logf("HeaderTool: no project loaded"); return; }
+    if (s_Running.exchange(true)) { Logf("HeaderTool: already running"); return; }
+
+    auto intermediate = S.ProjectFile.parent_path() / "Intermediate";
+    ace::JobSystem::Get().Run([srcRoot, intermediate] {
+        ACE_PROFILE_SCOPE("HeaderTool");
+        auto messages = std::make_shared<std::vector<std::string>>();
+        RunHeaderTool(srcRoot, intermediate, *messages);
+        ace::JobSystem::Get().RunOnMainThread([messages] {
+            for (const auto& m : *messages) Logf("%s", m.c_str());
+            s_Running = false;
+        });
+    });
+}
+
+// Packs Content/ into Paks/Content.acepak on the job pool, then remounts /Game
+static void PackageContent(EditorState& S)
+{
+    static std::atomic<bool> s_Running{false};
+    if (!S.Project) { Logf("Package: no project loaded"); return; }
+    if (s_Running.exchange(true)) { Logf("Package: already running"); return; }
+
+    // Release the old archive first; Windows cannot replace a mapped file
+    ace::VFS::Get().Unmount(ace::Project::kContentMount);
+    ace::VFS::Get().MountDirectory(ace::Project::kContentMount, S.Project->ContentDir());
+
+    const auto content = S.Project->ContentDir();
+    const auto pak = S.Project->PaksDir() / "Content.acepak";
+    Logf("Package: writing %s", pak.string().c_str());
+    ace::JobSystem::Get().Run([&S, content, pak] {
+        ace::PakWriteStats st;
+        const bool ok = ace::WritePak(pak, ace::CollectPakInputs(content), &st);
+        ace::JobSystem::Get().RunOnMainThread([&S, ok, st, pak] {
+            if (ok) Logf("Package: %zu files (%zu unique), %.1f MiB -> %.1f MiB in %.2f s",
+                         st.Files, st.Blobs, st.RawBytes / 1048576.0, st.PackedBytes / 1048576.0, st.Seconds);
+            else    Logf("Package: failed to write %s", pak.string().c_str());
+            if (S.Project) S.Project->MountContent();
+            s_Running = false;
+        });
+    });
+}
+
 static bool IsValidCppIdentifier(const std::string& name)
 {
     if (name.empty()) return false;
@@ -2476,6 +3026,7 @@ static bool DoCreateNewCppClass(EditorState& S,
     if (!SaveStringToFile(headerAbs, h)) { Logf("CppWizard: failed to write header"); return false; }
     if (!SaveStringToFile(sourceAbs, c)) { Logf("CppWizard: failed to write source"); return false; }
     WriteGeneratedStubIfMissing(headerAbs);
+    RegenerateReflection(S);
     OpenFileInEditor(S, headerAbs);
 
     Logf("CppWizard: created '%s' and '%s'", headerAbs.string().c_str(), sourceAbs.string().c_str());
@@ -2492,6 +3043,7 @@ static bool DoCreateNewCppClass(EditorState& S,
 
 
 static void DrawPanel_ContentBrowser(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (!ImGui::Begin("Content Browser")) { ImGui::End(); return; }
 
     if (!S.Project) {
@@ -2519,20 +3071,16 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
     // Left: folder tree with resizable border
     ImGui::BeginChild("CB.Tree", ImVec2(CB.TreeWidth, 0), true);
     {
+        ace::mem::AllocCounterScope treeAllocs(S.Allocs.ContentTree);
         // Root node
         std::filesystem::path clicked;
         ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, 14.0f);
         ImGui::SetNextItemOpen(true, ImGuiCond_Once);
         if (ImGui::TreeNodeEx("Content", ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanFullWidth)) {
-            std::error_code ec;
-            std::vector<std::filesystem::path> roots;
-            for (auto it = std::filesystem::directory_iterator(CB.Root, ec);
-                 !ec && it != std::filesystem::directory_iterator(); ++it) {
-                if (it->is_directory()) roots.push_back(it->path());
+            if (const auto root = CB.Tree.RootNode(); root != ace::editor::FolderTree::kNone) {
+                CB.Tree.Touch(root);
+                for (const auto c : CB.Tree.Children(root)) DrawFolderTreeNode(S, c, CB.Current, clicked);
             }
-            std::sort(roots.begin(), roots.end(),
-                      [](const auto& a, const auto& b){ return a.filename().string() < b.filename().string(); });
-            for (auto& r : roots) DrawFolderTreeNode(r, CB.Current, clicked);
             ImGui::TreePop();
         }
         ImGui::PopStyleVar();
@@ -2555,7 +3103,10 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
     ImGui::BeginChild("CB.Right", ImVec2(0, 0), true);
 
     // Top bar
-    Breadcrumbs(S);
+    {
+        ace::mem::AllocCounterScope crumbAllocs(S.Allocs.ContentTree);
+        Breadcrumbs(S);
+    }
     ImGui::Separator();
 
     // Controls row
@@ -2563,7 +3114,11 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
         if (!CB.Current.empty() && !PathsEqual(CB.Current, CB.Root)) { CB.Current = CB.Current.parent_path(); SelectClear(CB); }
     }
     ImGui::SameLine();
-    if (ImGui::Button("Refresh")) { /* no cache yet */ }
+    bool refreshListing = false;
+    if (ImGui::Button("Refresh")) {
+        refreshListing = true;
+        CB.Tree.Apply({ace::FileChangeKind::Rescan, true, CB.Current});
+    }
 #ifdef _WIN32
     ImGui::SameLine();
     if (ImGui::Button("Reveal")) { RevealInExplorer(CB.Current); }
@@ -2573,21 +3128,31 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
     ImGui::TextUnformatted("Thumbnail Size");
     ImGui::SameLine();
     ImGui::SetNextItemWidth(180.0f);
-    if (ImGui::SliderFloat("##thumb", &CB.ThumbnailSize, 48.0f, 192.0f, "%.0f")) {
-        SaveSettings(S);
-    }
+    ImGui::SliderFloat("##thumb", &CB.ThumbnailSize, 48.0f, 192.0f, "%.0f");
+    if (ImGui::IsItemDeactivatedAfterEdit()) SaveSettings(S);   // once per drag, not per frame
 
     ImGui::SameLine(); ImGui::TextDisabled("|");
     ImGui::SameLine();
     {
         char tmp[256]{}; std::snprintf(tmp, sizeof(tmp), "%s", CB.Filter.c_str());
         ImGui::SetNextItemWidth(220.f);
-        if (ImGui::InputTextWithHint("##filter", "Filter (substring)", tmp, IM_ARRAYSIZE(tmp))) {
+        if (ImGui::InputTextWithHint("##filter", "Search this folder and below", tmp, IM_ARRAYSIZE(tmp))) {
             CB.Filter = tmp;
         }
+        ImGui::SameLine(); ImGui::Checkbox("Fuzzy", &CB.SearchFuzzy);
+        ImGui::SameLine(); ImGui::Checkbox("Text", &CB.SearchText);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Also search inside .json, .aceasset and .blueprint files");
+        if (!CB.Filter.empty()) {
+            ImGui::SameLine();
+            const auto& L = CB.Listing;
+            if (!L.Searched)                             ImGui::TextDisabled("(indexing: this folder only)");
+            else if (L.SearchTotal > L.Model.Count())    ImGui::TextDisabled("%zu of %zu results", L.Model.Count(), L.SearchTotal);
+            else                                         ImGui::TextDisabled("%zu results", L.SearchTotal);
+        }
     }
 
     ImGui::Separator();
+    DrawFileOperations(S);
 
     // Scroll area
     ImVec2 avail = ImGui::GetContentRegionAvail();
@@ -2595,36 +3160,7 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
 
         // Accept drops on the blank area to move INTO current folder
         if (ImGui::BeginDragDropTarget()) {
-            if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) {
-                const char* data = static_cast<const char*>(pld->Data);
-                std::string all(data, data + pld->DataSize);
-                std::stringstream ss(all);
-                std::string line;
-                bool anyErr = false;
-                size_t moved = 0;
-
-                Logf("Drop onto BLANK (current='%s') payloadSize=%d",
-                     CB.Current.string().c_str(), (int)pld->DataSize);
-
-                while (std::getline(ss, line)) {
-                    if (line.empty()) continue;
-                    std::filesystem::path src(line);
-                    std::string err;
-                    Logf("  Move request: '%s' -> '%s'", src.string().c_str(), CB.Current.string().c_str());
-                    if (!MoveEntryToDir(src, CB.Current, err)) {
-                        anyErr = true;
-                        if (!err.empty()) CB.Error = err;
-                        Logf("  Move FAILED: %s", err.c_str());
-                    } else {
-                        ++moved;
-                        Logf("  Move OK");
-                    }
-                }
-                if (!anyErr) CB.Error.clear();
-                SelectClear(CB);
-                Logf("Drop onto BLANK (current='%s') done. moved=%zu, anyErr=%d",
-                     CB.Current.string().c_str(), moved, (int)anyErr);
-            }
+            if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) DropMove(S, pld, CB.Current, "BLANK");
             ImGui::EndDragDropTarget();
         }
 
@@ -2635,8 +3171,8 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
 
             // Enter -> open first selection (dir navigates, file opens in Editors panel)
             if (ImGui::IsKeyPressed(ImGuiKey_Enter, false)) {
-                if (!CB.Selection.empty()) {
-                    auto p = CB.Selection.front();
+                if (!CB.Selection.Empty()) {
+                    auto p = CB.Selection.First();
                     std::error_code ec;
                     if (std::filesystem::is_directory(p, ec)) {
                         CB.Current = p; SelectClear(CB);
@@ -2652,47 +3188,27 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
                 if (!PathsEqual(CB.Current, CB.Root)) { CB.Current = CB.Current.parent_path(); SelectClear(CB); }
             }
             // F2 -> rename (single)
-            if (ImGui::IsKeyPressed(ImGuiKey_F2, false) && CB.Selection.size() == 1) {
-                CB.TargetPath = CB.Selection.front();
+            if (ImGui::IsKeyPressed(ImGuiKey_F2, false) && CB.Selection.Count() == 1) {
+                CB.TargetPath = CB.Selection.First();
                 std::snprintf(CB.RenameBuf, sizeof(CB.RenameBuf), "%s", CB.TargetPath.filename().string().c_str());
                 CB.ShowRename = true;
             }
             // Delete -> delete selection (multi allowed)
-            if (ImGui::IsKeyPressed(ImGuiKey_Delete, false) && !CB.Selection.empty()) {
-                CB.DeleteList = CB.Selection;
+            if (ImGui::IsKeyPressed(ImGuiKey_Delete, false) && !CB.Selection.Empty()) {
+                CB.DeleteList = CB.Selection.Paths();
                 CB.ShowDeleteConfirm = true;
             }
-            // Ctrl+A -> select all
+            // Ctrl+A -> select all (the listing: the folder, or the search results)
             if (ctrl && ImGui::IsKeyPressed(ImGuiKey_A, false)) {
-                SelectClear(CB);
-                std::error_code ec;
-                for (std::filesystem::directory_iterator it(CB.Current, ec);
-                     !ec && it != std::filesystem::directory_iterator(); ++it) {
-                    if (it->is_directory(ec) || it->is_regular_file(ec)) SelectAdd(CB, it->path());
-                }
+                CB.Selection.SelectAll();
             }
             // Ctrl+C -> copy to clipboard
             if (ctrl && ImGui::IsKeyPressed(ImGuiKey_C, false)) {
-                CB.Clipboard = CB.Selection;
+                CB.Clipboard = CB.Selection.Paths();
             }
-            // Ctrl+V -> paste (duplicate into current)
+            // Ctrl+V -> paste (duplicate into current), in the background
             if (ctrl && ImGui::IsKeyPressed(ImGuiKey_V, false) && !CB.Clipboard.empty()) {
-                for (auto& src : CB.Clipboard) {
-                    auto destDir = CB.Current;
-                    auto baseName = src.filename().string();
-                    auto dest = UniqueSibling(destDir, baseName);
-                    std::error_code ec;
-                    if (std::filesystem::is_directory(src, ec)) {
-                        std::filesystem::create_directories(dest, ec);
-                        CopyDirectoryContents(src, dest);
-                    } else {
-                        std::filesystem::create_directories(dest.parent_path(), ec);
-                        std::filesystem::copy_file(src, dest, std::filesystem::copy_options::none, ec);
-                        if (ec) { dest = UniqueSibling(destDir, baseName);
-                            std::filesystem::copy_file(src, dest, std::filesystem::copy_options::none, ec);
-                        }
-                    }
-                }
+                S.FileOps.Copy(CB.Clipboard, CB.Current);
             }
         }
 
@@ -2719,43 +3235,34 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
             ImGui::EndPopup();
         }
 
-        // Gather entries (folders first, then files)
-        struct Entry { std::filesystem::directory_entry de; bool isDir; };
-        std::vector<Entry> entries;
-        {
-            std::vector<std::filesystem::directory_entry> dirs, files;
-            std::error_code ec;
-            for (std::filesystem::directory_iterator it(CB.Current, ec);
-                 !ec && it != std::filesystem::directory_iterator(); ++it)
-            {
-                const auto& de = *it;
-                const bool isDir  = de.is_directory(ec);
-                const bool isFile = de.is_regular_file(ec);
-                if (!isDir && !isFile) continue;
-                const std::string name = de.path().filename().string();
-                if (!CB.Filter.empty() && name.find(CB.Filter) == std::string::npos) continue;
-                if (isDir) dirs.push_back(de); else files.push_back(de);
-            }
-            auto byName = [](const auto& a, const auto& b){ return a.path().filename().string() < b.path().filename().string(); };
-            std::sort(dirs.begin(),  dirs.end(),  byName);
-            std::sort(files.begin(), files.end(), byName);
-            entries.reserve(dirs.size() + files.size());
-            for (auto& d : dirs)  entries.push_back({d, true});
-            for (auto& f : files) entries.push_back({f, false});
-        }
-
-        // if selection anchor invalid, fix it
-        if (CB.AnchorIndex >= (int)entries.size()) CB.AnchorIndex = -1;
+        ace::mem::AllocCounterScope gridAllocs(S.Allocs.ContentGrid);
 
-        // Cell geometry
-        CB.ItemRects.clear();
+        // Cell geometry: fixed-pitch rows, so only the visible ones are submitted
         const float cellSide = CB.ThumbnailSize + CB.Padding * 2.0f; // square
-        const ImGuiStyle& style = ImGui::GetStyle();
-        const float windowVisibleX2 = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
+        const ImVec2 spacing(10.0f, 16.0f);
+        const float itemHeight = std::max(cellSide, CB.Padding + CB.ThumbnailSize + 4.0f + ImGui::GetTextLineHeight());
+        const ImVec2 pitch(cellSide + spacing.x, itemHeight + spacing.y);
+        const int   columns = std::max(1, (int)((ImGui::GetContentRegionAvail().x + spacing.x) / pitch.x));
+        const float labelAvail = cellSide - CB.Padding*2.0f;
+        const int   labelChars = std::max(6, (int)((labelAvail / ImGui::GetFontSize()) * 1.9f));
+
+        // Entries (folders first, then files, or search results), cached across frames
+        const bool searchReady = !S.Search.Root().empty() && S.SearchContent == CB.Root;
+        UpdateContentListing(CB, searchReady ? &S.Search : nullptr, refreshListing);
+        const auto& model = CB.Listing.Model;
+
+        // if selection anchor invalid, fix it
+        if (CB.AnchorIndex >= (int)model.Count()) CB.AnchorIndex = -1;
 
-        auto drawItem = [&](int idx, const Entry& e)
+        // Only visible cells get here; their paths are built once and kept by the model
+        auto drawItem = [&](int idx)
         {
-            ImGui::PushID(e.de.path().string().c_str());
+            const std::filesystem::path& path = model.Path(idx);
+            const std::string_view key = model.Key(idx);
+            const std::string_view name = model.Name(idx);
+            const bool isDir = model.IsDir(idx);
+            const bool isSelected = CB.Selection.IsSelected(idx);
+            ImGui::PushID(key.data(), key.data() + key.size());
             ImGui::BeginGroup();
 
             // Reserve the cell and catch clicks
@@ -2766,48 +3273,44 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
             const bool rightClicked  = ImGui::IsItemClicked(ImGuiMouseButton_Right);
             const bool doubleClicked = hovered && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left);
             ImVec2 cellMin = ImGui::GetItemRectMin();
-            ImVec2 cellMax = ImGui::GetItemRectMax();
-
-            // Store rect for marquee
-            CB.ItemRects.push_back({e.de.path(), cellMin, cellMax, e.isDir});
 
             // RIGHT-CLICK: select (if needed) and open item popup on THIS cell
             if (rightClicked) {
                 ImGuiIO& io = ImGui::GetIO();
-                if (!io.KeyCtrl && !IsSelected(CB, e.de.path())) {
-                    SelectSet(CB, e.de.path());
+                if (!io.KeyCtrl && !isSelected) {
+                    SelectSet(CB, idx);
                     CB.AnchorIndex = idx;
                 }
             }
             if (ImGui::BeginPopupContextItem()) {
-                if (ImGui::MenuItem(e.isDir ? "Open" : "Open (default)")) {
-                    if (e.isDir) { CB.Current = e.de.path(); SelectClear(CB); }
-                    else         { Logf("Editor: request open (context default) '%s'", e.de.path().string().c_str()); S.P.Editors = true; OpenFileInEditor(S, e.de.path()); }
+                if (ImGui::MenuItem(isDir ? "Open" : "Open (default)")) {
+                    if (isDir) { CB.Current = path; SelectClear(CB); }
+                    else         { Logf("Editor: request open (context default) '%s'", path.string().c_str()); S.P.Editors = true; OpenFileInEditor(S, path); }
                 }
-                if (!e.isDir && ImGui::MenuItem("Open in Editor")) {
-                    Logf("Editor: request open (context explicit) '%s'", e.de.path().string().c_str());
+                if (!isDir && ImGui::MenuItem("Open in Editor")) {
+                    Logf("Editor: request open (context explicit) '%s'", path.string().c_str());
                     S.P.Editors = true;
-                    OpenFileInEditor(S, e.de.path());
+                    OpenFileInEditor(S, path);
                 }
-                bool single = (CB.Selection.size() == 1);
+                bool single = (CB.Selection.Count() == 1);
                 if (ImGui::MenuItem("Rename", nullptr, false, single)) {
-                    CB.TargetPath = CB.Selection.front();
+                    CB.TargetPath = CB.Selection.First();
                     std::snprintf(CB.RenameBuf, sizeof(CB.RenameBuf), "%s",
                                   CB.TargetPath.filename().string().c_str());
                     CB.ShowRename = true;
                 }
-                if (ImGui::MenuItem("Delete", nullptr, false, !CB.Selection.empty())) {
-                    CB.DeleteList = CB.Selection; CB.ShowDeleteConfirm = true;
+                if (ImGui::MenuItem("Delete", nullptr, false, !CB.Selection.Empty())) {
+                    CB.DeleteList = CB.Selection.Paths(); CB.ShowDeleteConfirm = true;
                 }
 #ifdef _WIN32
                 if (single && ImGui::MenuItem("Reveal in Explorer")) {
-                    RevealInExplorer(CB.Selection.front());
+                    RevealInExplorer(CB.Selection.First());
                 }
 #endif
                 // Add → (only for folders makes sense, but we show here too for convenience)
                 if (ImGui::BeginMenu("Add")) {
                     // If right-click was on a folder, we can route asset creation there; otherwise use CB.Current
-                    std::filesystem::path targetFolder = e.isDir ? e.de.path() : CB.Current;
+                    std::filesystem::path targetFolder = isDir ? path : CB.Current;
                     if (ImGui::MenuItem("Blueprint (.blueprint)")) { OpenNewItemDialog(S, "blueprint.graph", targetFolder); }
                     if (ImGui::MenuItem("GameMode (.gamemode)"))   { OpenNewItemDialog(S, "asset.gamemode",  targetFolder); }
                     if (ImGui::MenuItem("Data Asset (.asset)"))    { OpenNewItemDialog(S, "asset.data",      targetFolder); }
@@ -2824,21 +3327,23 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
                 ImGui::EndPopup();
             }
 
-            // Icon
+            // Icon: the preview once it is ready, else the placeholder
             ImVec2 icon0 = cellMin + ImVec2(CB.Padding, CB.Padding);
             ImVec2 icon1 = icon0   + ImVec2(CB.ThumbnailSize, CB.ThumbnailSize);
-            const bool selected = IsSelected(CB, e.de.path());
-            DrawItemIcon(ImGui::GetWindowDrawList(), icon0, icon1, e.isDir, selected);
+            ImDrawList* dl = ImGui::GetWindowDrawList();
+            if (!isDir && ace::editor::ThumbnailCache::Supports(path) && S.Thumbs.Draw(dl, path, icon0, icon1)) {
+                if (isSelected) dl->AddRect(icon0 - ImVec2(3, 3), icon1 + ImVec2(3, 3), IM_COL32(240,170,0,255), 6.0f, 0, 3.0f);
+            } else {
+                DrawItemIcon(dl, icon0, icon1, isDir, isSelected);
+            }
 
             // Label
-            const std::string rawName = e.de.path().filename().string();
-            const float labelAvail = cellSide - CB.Padding*2.0f;
-            int approxMaxChars = (int)((labelAvail / ImGui::GetFontSize()) * 1.9f);
-            std::string label = TruncMiddle(rawName, std::max(6, approxMaxChars));
-            ImVec2 textPos = cellMin + ImVec2((cellSide - ImGui::CalcTextSize(label.c_str()).x) * 0.5f,
+            char label[256];
+            TruncMiddle(name, labelChars, label, sizeof(label));
+            ImVec2 textPos = cellMin + ImVec2((cellSide - ImGui::CalcTextSize(label).x) * 0.5f,
                                               CB.Padding + CB.ThumbnailSize + 4.0f);
             ImGui::SetCursorScreenPos(textPos);
-            ImGui::TextUnformatted(label.c_str());
+            ImGui::TextUnformatted(label);
 
             // Selection / open behavior
             if (leftClicked) {
@@ -2846,72 +3351,46 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
                 bool ctrl  = io.KeyCtrl;
                 bool shift = io.KeyShift;
 
-                if (shift && !entries.empty()) {
+                if (shift && model.Count()) {
                     if (CB.AnchorIndex < 0) CB.AnchorIndex = idx;
-                    int a = std::min(CB.AnchorIndex, idx);
-                    int b = std::max(CB.AnchorIndex, idx);
                     SelectClear(CB);
-                    for (int i=a;i<=b;++i) SelectAdd(CB, entries[i].de.path());
+                    CB.Selection.SelectRange(CB.AnchorIndex, idx);
                 } else if (ctrl) {
-                    if (IsSelected(CB, e.de.path())) SelectRemove(CB, e.de.path());
-                    else SelectAdd(CB, e.de.path());
+                    if (isSelected) CB.Selection.Deselect(idx);
+                    else CB.Selection.Select(idx);
                     CB.AnchorIndex = idx;
                 } else {
-                    SelectSet(CB, e.de.path());
+                    SelectSet(CB, idx);
                     CB.AnchorIndex = idx;
                 }
             }
             if (doubleClicked) {
-                if (e.isDir) { CB.Current = e.de.path(); SelectClear(CB); }
-                else         { Logf("Editor: request open (double-click) '%s'", e.de.path().string().c_str()); S.P.Editors = true; OpenFileInEditor(S, e.de.path()); }
+                if (isDir) { CB.Current = path; SelectClear(CB); }
+                else         { Logf("Editor: request open (double-click) '%s'", path.string().c_str()); S.P.Editors = true; OpenFileInEditor(S, path); }
             }
 
             // Drag source
             if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_SourceAllowNullID)) {
-                std::string payload;
-                size_t count = 0;
-                if (IsSelected(CB, e.de.path()) && !CB.Selection.empty()) {
-                    for (auto& p : CB.Selection) { payload += p.string(); payload.push_back('\n'); ++count; }
+                // Built on the first frame of the drag only: a large selection is many paths
+                const size_t count = isSelected ? CB.Selection.Count() : 1;
+                if (!ImGui::GetDragDropPayload()) {
+                    std::string payload;
+                    if (isSelected) {
+                        for (const auto& p : CB.Selection.Paths()) { payload += p.string(); payload.push_back('\n'); }
+                    } else {
+                        payload += path.string(); payload.push_back('\n');
+                    }
+                    ImGui::SetDragDropPayload("ACE_PATHS", payload.data(), payload.size(), ImGuiCond_Once);
                 } else {
-                    payload += e.de.path().string(); payload.push_back('\n'); count = 1;
+                    ImGui::SetDragDropPayload("ACE_PATHS", nullptr, 0, ImGuiCond_Once);
                 }
-                ImGui::SetDragDropPayload("ACE_PATHS", payload.data(), (int)payload.size());
-                if (count == 1) ImGui::TextUnformatted(e.de.path().filename().string().c_str());
+                if (count == 1) ImGui::TextUnformatted(name.data(), name.data() + name.size());
                 else ImGui::Text("%zu items", count);
                 ImGui::EndDragDropSource();
             }
             // Drop target (folders accept drops -> move into folder)
-            if (e.isDir && ImGui::BeginDragDropTarget()) {
-                if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) {
-                    const char* data = static_cast<const char*>(pld->Data);
-                    std::string all(data, data + pld->DataSize);
-                    std::stringstream ss(all);
-                    std::string line;
-                    bool anyErr = false;
-                    size_t moved = 0;
-
-                    Logf("Drop onto GRID folder '%s' payloadSize=%d",
-                         e.de.path().string().c_str(), (int)pld->DataSize);
-
-                    while (std::getline(ss, line)) {
-                        if (line.empty()) continue;
-                        std::filesystem::path src(line);
-                        std::string err;
-                        Logf("  Move request: '%s' -> '%s'", src.string().c_str(), e.de.path().string().c_str());
-                        if (!MoveEntryToDir(src, e.de.path(), err)) {
-                            anyErr = true;
-                            if (!err.empty()) S.CB.Error = err;
-                            Logf("  Move FAILED: %s", err.c_str());
-                        } else {
-                            ++moved;
-                            Logf("  Move OK");
-                        }
-                    }
-                    if (!anyErr) S.CB.Error.clear();
-                    SelectClear(S.CB);
-                    Logf("Drop onto GRID folder '%s' done. moved=%zu, anyErr=%d",
-                         e.de.path().string().c_str(), moved, (int)anyErr);
-                }
+            if (isDir && ImGui::BeginDragDropTarget()) {
+                if (const ImGuiPayload* pld = ImGui::AcceptDragDropPayload("ACE_PATHS")) DropMove(S, pld, path, "GRID folder");
                 ImGui::EndDragDropTarget();
             }
 
@@ -2919,16 +3398,23 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
             ImGui::PopID();
         };
 
-        // Flow layout
-        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(10, 16));
-        for (int i = 0; i < (int)entries.size(); ++i) {
-            drawItem(i, entries[i]);
-            float lastX = ImGui::GetItemRectMax().x;
-            float nextX = lastX + style.ItemSpacing.x + CB.ThumbnailSize + CB.Padding*2.0f;
-            if (i + 1 < (int)entries.size() && nextX < windowVisibleX2)
-                ImGui::SameLine();
+        // Grid: one clipper item per row, each row advancing the cursor by pitch.y
+        const int count = (int)model.Count();
+        const int rows  = (count + columns - 1) / columns;
+        const ImVec2 gridOrigin = ImGui::GetCursorScreenPos();
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, pitch.y);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                for (int col = 0; col < columns && row * columns + col < count; ++col) {
+                    ImGui::SetCursorScreenPos(gridOrigin + ImVec2(col * pitch.x, row * pitch.y));
+                    drawItem(row * columns + col);
+                }
+                ImGui::SetCursorScreenPos(gridOrigin + ImVec2(0.0f, row * pitch.y));
+                ImGui::Dummy(ImVec2(columns * pitch.x - spacing.x, pitch.y - ImGui::GetStyle().ItemSpacing.y));
+            }
         }
-        ImGui::PopStyleVar();
+        clipper.End();
 
         // Marquee selection (click-drag blank area)
         if (!ImGui::IsAnyItemHovered() && ImGui::IsWindowHovered() &&
@@ -2947,10 +3433,15 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
                 auto* dl2 = ImGui::GetWindowDrawList();
                 dl2->AddRectFilled(min, max, IM_COL32(100, 150, 240, 40));
                 dl2->AddRect(min, max, IM_COL32(100, 150, 240, 180), 0.0f, 0, 2.0f);
-                for (auto& r : CB.ItemRects) {
-                    bool overlap = !(r.max.x < min.x || r.min.x > max.x || r.max.y < min.y || r.min.y > max.y);
-                    if (overlap) SelectAdd(CB, r.path);
-                }
+                // Cells under the rectangle, from the grid geometry: rows that
+                // were clipped away are selected too
+                const int c0 = std::max(0, (int)std::ceil((min.x - gridOrigin.x - cellSide) / pitch.x));
+                const int c1 = std::min(columns - 1, (int)std::floor((max.x - gridOrigin.x) / pitch.x));
+                const int r0 = std::max(0, (int)std::ceil((min.y - gridOrigin.y - cellSide) / pitch.y));
+                const int r1 = std::min(rows - 1, (int)std::floor((max.y - gridOrigin.y) / pitch.y));
+                for (int r = r0; r <= r1; ++r)
+                    if (c0 <= c1 && r * columns + c0 < count)
+                        CB.Selection.SelectRange(r * columns + c0, std::min(r * columns + c1, count - 1));
             } else {
                 CB.DragSelecting = false;
             }
@@ -3022,15 +3513,40 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
             ImGui::EndPopup();
         }
 
+        // ----- Delete confirmation -----
+        if (CB.ShowDeleteConfirm) { ImGui::OpenPopup("Delete?"); CB.ShowDeleteConfirm = false; }
+        if (ImGui::BeginPopupModal("Delete?", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            if (CB.DeleteList.size() == 1)
+                ImGui::Text("Delete '%s'?", CB.DeleteList.front().filename().string().c_str());
+            else
+                ImGui::Text("Delete %zu items?", CB.DeleteList.size());
+            ImGui::TextDisabled("Folders are deleted with everything in them. This can't be undone.");
+            ImGui::Spacing();
+            const bool del = ImGui::Button("Delete"); ImGui::SameLine();
+            const bool cancel = ImGui::Button("Cancel") || ImGui::IsKeyPressed(ImGuiKey_Escape, false);
+            if (del && !CB.DeleteList.empty()) {
+                Logf("Delete: %zu item(s) in '%s'", CB.DeleteList.size(), CB.Current.string().c_str());
+                CB.Error.clear();
+                S.FileOps.Delete(std::move(CB.DeleteList));
+            }
+            if (del || cancel) {
+                CB.DeleteList.clear();
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::EndPopup();
+        }
+
         ImGui::EndChild();
     }
 
     ImGui::EndChild(); // right
     ImGui::EndChild(); // split
 
-    // Persist last folder (per session)
-    S.CB.LastFolder = S.CB.Current;
-    SaveSettings(S);
+    // Persist last folder (per session) when it changes
+    if (S.CB.LastFolder.native() != S.CB.Current.native()) {
+        S.CB.LastFolder = S.CB.Current;
+        SaveSettings(S);
+    }
 
     ImGui::End();
 }
@@ -3044,6 +3560,7 @@ static void DrawPanel_ContentBrowser(EditorState& S) {
 // ----- Other Panels -----
 
 static void DrawPanel_Viewport(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (ImGui::Begin("Viewport")) {
         ImGui::TextUnformatted("Game Viewport (stub)");
         if (!S.OpenMapPath.empty()) {
@@ -3052,6 +3569,12 @@ static void DrawPanel_Viewport(EditorState& S) {
         } else {
             ImGui::TextUnformatted("Open Map: (none)");
         }
+        ImGui::Text("Spatial index: %zu entities, tree height %d", S.EditorSpatial.Count(), S.EditorSpatial.Height());
+        if (S.WorldAssets) {
+            const ace::AssetManagerStats st = S.WorldAssets->GetStats();
+            ImGui::Text("Referenced assets: %zu (%zu loaded, %.1f MB), %llu hot reloads", S.WorldRefs.size(), st.Loaded,
+                        st.Bytes / (1024.0 * 1024.0), (unsigned long long)st.Reloads);
+        }
         ImGui::Separator();
         ImGui::BulletText("This build shows a stub view. Next steps: grid, picking, gizmo.");
         ImGui::Dummy(ImVec2(0, 400));
@@ -3061,6 +3584,7 @@ static void DrawPanel_Viewport(EditorState& S) {
 
 
 static void DrawPanel_WorldOutliner(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (!ImGui::Begin("World Outliner")) { ImGui::End(); return; }
 
     if (!S.Project) {
@@ -3072,6 +3596,10 @@ static void DrawPanel_WorldOutliner(EditorState& S) {
     ImGui::TextUnformatted("World");
     ImGui::SameLine();
     if (S.MapDirty) ImGui::TextColored(ImVec4(1,0.6f,0.2f,1), "*");
+    if (S.MapChangedOnDisk) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1,0.6f,0.2f,1), "Changed on disk");
+    }
     ImGui::Separator();
 
     // Buttons
@@ -3085,48 +3613,53 @@ static void DrawPanel_WorldOutliner(EditorState& S) {
 
     ImGui::Separator();
     if (ImGui::Button("+ Add Empty Actor")) {
-        int idx = WorldAddEntity(S.EditorWorld, "EmptyActor");
-        S.SelectedEntity = idx;
+        S.SelectedEntity = WorldAddEntity(S, "EmptyActor");
         S.MapDirty = true;
     }
     ImGui::SameLine();
-    if (ImGui::Button("- Delete") && S.SelectedEntity >= 0 && S.SelectedEntity < (int)S.EditorWorld.Entities.size()) {
-        S.EditorWorld.Entities.erase(S.EditorWorld.Entities.begin() + S.SelectedEntity);
-        if (S.SelectedEntity >= (int)S.EditorWorld.Entities.size()) S.SelectedEntity = (int)S.EditorWorld.Entities.size()-1;
-        S.MapDirty = true;
+    if (ImGui::Button("- Delete") && S.EditorWorld.IsAlive(S.SelectedEntity)) {
+        S.EditorSpatial.Remove(S.SelectedEntity);
+        S.EditorWorld.Destroy(S.SelectedEntity);
+        S.SelectedEntity = {};
+        S.MapDirty = S.WorldRefsDirty = true;
     }
 
     ImGui::Separator();
 
-    // List entities
-    for (int i=0;i<(int)S.EditorWorld.Entities.size();++i){
-        auto& e = S.EditorWorld.Entities[i];
+    // List entities (slot order, stable while editing)
+    S.EditorWorld.ForEachEntity([&](ace::Entity e){
+        const auto* id   = S.EditorWorld.TryGet<ace::IdComponent>(e);
+        const auto* name = S.EditorWorld.TryGet<ace::NameComponent>(e);
+        const int   eid  = id ? id->Id : (int)e.Index;
         ImGuiTreeNodeFlags f = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth;
-        if (i == S.SelectedEntity) f |= ImGuiTreeNodeFlags_Selected;
-        bool open = ImGui::TreeNodeEx((void*)(intptr_t)e.Id, f, "%s##%d", e.Name.c_str(), e.Id);
+        if (e == S.SelectedEntity) f |= ImGuiTreeNodeFlags_Selected;
+        bool open = ImGui::TreeNodeEx((void*)(intptr_t)eid, f, "%s##%d", name ? name->Name.c_str() : "Entity", eid);
         (void)open;
-        if (ImGui::IsItemClicked()) S.SelectedEntity = i;
-    }
+        if (ImGui::IsItemClicked()) S.SelectedEntity = e;
+    });
 
     ImGui::End();
 }
 
 
 static void DrawPanel_Inspector(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (!ImGui::Begin("Inspector")) { ImGui::End(); return; }
 
-    if (S.SelectedEntity < 0 || S.SelectedEntity >= (int)S.EditorWorld.Entities.size()){
+    if (!S.EditorWorld.IsAlive(S.SelectedEntity)){
         ImGui::TextUnformatted("Selected Actor: (none)");
         ImGui::End(); return;
     }
 
-    EEntity& e = S.EditorWorld.Entities[S.SelectedEntity];
+    ace::World& W = S.EditorWorld;
+    const ace::Entity e = S.SelectedEntity;
 
     // Name
     {
-        char nameBuf[256]; std::snprintf(nameBuf, sizeof(nameBuf), "%s", e.Name.c_str());
+        auto& name = W.TryGet<ace::NameComponent>(e) ? W.Get<ace::NameComponent>(e) : W.Add<ace::NameComponent>(e);
+        char nameBuf[256]; std::snprintf(nameBuf, sizeof(nameBuf), "%s", name.Name.c_str());
         if (ImGui::InputText("Name", nameBuf, IM_ARRAYSIZE(nameBuf))) {
-            e.Name = nameBuf;
+            name.Name = nameBuf;
             S.MapDirty = true;
         }
     }
@@ -3134,14 +3667,20 @@ static void DrawPanel_Inspector(EditorState& S) {
 
     // Transform
     ImGui::TextUnformatted("Transform");
-    float pos[3] = { e.Xf.position.x, e.Xf.position.y, e.Xf.position.z };
-    float rot[3] = { e.Xf.rotation.x, e.Xf.rotation.y, e.Xf.rotation.z };
-    float scl[3] = { e.Xf.scale.x,    e.Xf.scale.y,    e.Xf.scale.z    };
-
-    if (ImGui::DragFloat3("Position", pos, 0.1f)) { e.Xf.position = EV3(pos[0],pos[1],pos[2]); S.MapDirty = true; }
-    if (ImGui::DragFloat3("Rotation", rot, 0.5f)) { e.Xf.rotation = EV3(rot[0],rot[1],rot[2]); S.MapDirty = true; }
+    auto& xf = W.TryGet<ace::TransformComponent>(e) ? W.Get<ace::TransformComponent>(e) : W.Add<ace::TransformComponent>(e);
+    float pos[3] = { xf.Position.X, xf.Position.Y, xf.Position.Z };
+    float rot[3] = { xf.Rotation.X, xf.Rotation.Y, xf.Rotation.Z };
+    float scl[3] = { xf.Scale.X,    xf.Scale.Y,    xf.Scale.Z    };
+
+    bool moved = false;
+    if (ImGui::DragFloat3("Position", pos, 0.1f)) { xf.Position = ace::Vec3(pos[0],pos[1],pos[2]); moved = true; }
+    if (ImGui::DragFloat3("Rotation", rot, 0.5f)) { xf.Rotation = ace::Vec3(rot[0],rot[1],rot[2]); moved = true; }
     if (ImGui::DragFloat3("Scale",    scl, 0.01f)) {
-        e.Xf.scale = EV3(std::max(0.0001f,scl[0]), std::max(0.0001f,scl[1]), std::max(0.0001f,scl[2]));
+        xf.Scale = ace::Vec3(std::max(0.0001f,scl[0]), std::max(0.0001f,scl[1]), std::max(0.0001f,scl[2]));
+        moved = true;
+    }
+    if (moved) {
+        S.EditorSpatial.Update(e, ace::EntityBounds(xf));
         S.MapDirty = true;
     }
 
@@ -3149,36 +3688,59 @@ static void DrawPanel_Inspector(EditorState& S) {
 
     // Components
     ImGui::TextUnformatted("Components");
+    // The first StaticMesh is the entity's StaticMeshComponent, any further
+    // ones go to its ExtraStaticMeshComponent
     if (ImGui::Button("+ Static Mesh Component")) {
-        EComponent c; c.Type = EComponentType::StaticMesh;
-        e.Components.push_back(std::move(c));
+        if (!W.Has<ace::StaticMeshComponent>(e)) W.Add<ace::StaticMeshComponent>(e);
+        else if (auto* extra = W.TryGet<ace::ExtraStaticMeshComponent>(e)) extra->Meshes.emplace_back();
+        else W.Add<ace::ExtraStaticMeshComponent>(e).Meshes.emplace_back();
         S.MapDirty = true;
     }
     ImGui::Spacing();
 
-    for (int i=0;i<(int)e.Components.size(); ++i){
-        auto& c = e.Components[i];
-        if (c.Type == EComponentType::StaticMesh){
-            if (ImGui::TreeNodeEx((void*)(intptr_t)(1000 + i), ImGuiTreeNodeFlags_DefaultOpen, "StaticMeshComponent #%d", i)){
-                char meshBuf[512] = {}; std::snprintf(meshBuf, sizeof(meshBuf), "%s", c.StaticMesh.Mesh.generic_string().c_str());
-                char matBuf [512] = {}; std::snprintf(matBuf,  sizeof(matBuf),  "%s", c.StaticMesh.Material.generic_string().c_str());
-                if (ImGui::InputText("Mesh", meshBuf, IM_ARRAYSIZE(meshBuf))) {
-                    c.StaticMesh.Mesh = std::filesystem::path(meshBuf);
-                    S.MapDirty = true;
-                }
-                if (ImGui::InputText("Material", matBuf, IM_ARRAYSIZE(matBuf))) {
-                    c.StaticMesh.Material = std::filesystem::path(matBuf);
-                    S.MapDirty = true;
-                }
-                if (ImGui::Button("Remove Component")) {
-                    e.Components.erase(e.Components.begin()+i);
-                    S.MapDirty = true;
-                    ImGui::TreePop();
-                    break;
-                }
-                ImGui::TreePop();
+    // Returns true if "Remove Component" was pressed
+    auto drawMesh = [&](ace::StaticMeshComponent& sm, int i) {
+        bool remove = false;
+        if (ImGui::TreeNodeEx((void*)(intptr_t)(1000 + i), ImGuiTreeNodeFlags_DefaultOpen, "StaticMeshComponent #%d", i)){
+            char meshBuf[512] = {}; std::snprintf(meshBuf, sizeof(meshBuf), "%s", sm.Mesh.c_str());
+            char matBuf [512] = {}; std::snprintf(matBuf,  sizeof(matBuf),  "%s", sm.Material.c_str());
+            if (ImGui::InputText("Mesh", meshBuf, IM_ARRAYSIZE(meshBuf))) {
+                sm.Mesh = std::filesystem::path(meshBuf).generic_string();
+                S.MapDirty = S.WorldRefsDirty = true;
+            }
+            if (ImGui::InputText("Material", matBuf, IM_ARRAYSIZE(matBuf))) {
+                sm.Material = std::filesystem::path(matBuf).generic_string();
+                S.MapDirty = S.WorldRefsDirty = true;
+            }
+            // Dangling references, once the registry for this project is in
+            if (!S.AssetScanRunning && !S.AssetsContent.empty()) {
+                for (const std::string* ref : {&sm.Mesh, &sm.Material})
+                    if (!ref->empty() && !S.Assets.Find(ace::VFS::Normalize(*ref)))
+                        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.3f, 1.0f), "Missing asset: %s", ref->c_str());
             }
+            remove = ImGui::Button("Remove Component");
+            ImGui::TreePop();
+        }
+        return remove;
+    };
+
+    int removed = -1;
+    if (auto* sm = W.TryGet<ace::StaticMeshComponent>(e))
+        if (drawMesh(*sm, 0)) removed = 0;
+    if (auto* extra = W.TryGet<ace::ExtraStaticMeshComponent>(e))
+        for (int i = 0; i < (int)extra->Meshes.size(); ++i)
+            if (drawMesh(extra->Meshes[i], i + 1)) removed = i + 1;
+    if (removed >= 0) {
+        // Later meshes move up one place, keeping file order
+        auto* extra = W.TryGet<ace::ExtraStaticMeshComponent>(e);
+        if (extra && !extra->Meshes.empty()) {
+            if (removed == 0) W.Get<ace::StaticMeshComponent>(e) = std::move(extra->Meshes.front());
+            extra->Meshes.erase(extra->Meshes.begin() + std::max(removed - 1, 0));
+            if (extra->Meshes.empty()) W.Remove<ace::ExtraStaticMeshComponent>(e);
+        } else {
+            W.Remove<ace::StaticMeshComponent>(e);
         }
+        S.MapDirty = S.WorldRefsDirty = true;
     }
 
     ImGui::End();
@@ -3186,6 +3748,7 @@ static void DrawPanel_Inspector(EditorState& S) {
 
 
 static void DrawPanel_Console(EditorState&) {
+    ACE_PROFILE_FUNCTION();
     if (ImGui::Begin("Console")) {
         ImGui::TextWrapped("Welcome to ACE Editor.");
         ImGui::Separator();
@@ -3195,14 +3758,212 @@ static void DrawPanel_Console(EditorState&) {
     }
     ImGui::End();
 }
-static void DrawPanel_Profiler(EditorState&) {
+static std::filesystem::path ProfileCapturePath(const EditorState& S) {
+    char stamp[32];
+    std::time_t t = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&t));
+    const auto dir = S.Project ? S.Project->IntermediateDir() / "Profiling" : AppDataDir() / "Profiling";
+    return dir / (std::string("Trace-") + stamp + ".json");
+}
+
+static ImU32 ProfileScopeColor(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* p = name; *p; ++p) h = (h ^ (unsigned char)*p) * 16777619u;
+    return ImColor::HSV((h % 360) / 360.0f, 0.45f, 0.75f);
+}
+
+// Totals per scope name for one frame; names are literals, so pointer
+// equality catches almost every match before strcmp is needed
+static void CollectScopeStats(const ace::Profiler::Frame& f, std::vector<ProfileScopeStat>& out) {
+    out.clear();
+    for (const ace::ProfileEvent& ev : f.Events) {
+        if (ev.Type != ace::ProfileEvent::Scope) continue;
+        ProfileScopeStat* st = nullptr;
+        for (auto& s : out) if (s.Name == ev.Name || std::strcmp(s.Name, ev.Name) == 0) { st = &s; break; }
+        if (!st) { out.push_back({ev.Name}); st = &out.back(); }
+        const double ns = ace::Profiler::DurationNs(ev.Start, ev.End);
+        st->Calls++;
+        st->TotalNs += ns;
+        st->MaxNs = std::max(st->MaxNs, ns);
+    }
+    std::sort(out.begin(), out.end(), [](const ProfileScopeStat& a, const ProfileScopeStat& b){ return a.TotalNs > b.TotalNs; });
+}
+
+// One row per thread, one lane per nesting level, spanning the whole frame
+static void DrawProfileTimeline(ProfilerView& V, const ace::Profiler::Frame& f) {
+    V.RowDepth.assign(ace::Profiler::ThreadCount(), -1);
+    for (const ace::ProfileEvent& ev : f.Events)
+        if (ev.Type == ace::ProfileEvent::Scope && ev.Thread < V.RowDepth.size())
+            V.RowDepth[ev.Thread] = std::max(V.RowDepth[ev.Thread], (int)ev.Depth);
+
+    const float laneH = ImGui::GetTextLineHeight() + 2.0f;
+    const float labelW = 90.0f;
+    float height = 0.0f;
+    for (int d : V.RowDepth) if (d >= 0) height += (d + 1) * laneH + 4.0f;
+    if (height <= 0.0f) { ImGui::TextDisabled("No scopes recorded in this frame"); return; }
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = std::max(50.0f, ImGui::GetContentRegionAvail().x - labelW);
+    ImGui::InvisibleButton("##timeline", ImVec2(labelW + width, height));
+    const bool hovered = ImGui::IsItemHovered();
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    const double frameNs = std::max(1.0, ace::Profiler::DurationNs(f.Start, f.End));
+    const float x0 = origin.x + labelW;
+    auto toX = [&](int64_t ticks) {
+        const double t = std::clamp(ace::Profiler::DurationNs(f.Start, ticks) / frameNs, 0.0, 1.0);
+        return x0 + (float)(t * width);
+    };
+
+    float* rowY = ace::mem::FrameArena().NewArray<float>(V.RowDepth.size());
+    float y = origin.y;
+    for (size_t t = 0; t < V.RowDepth.size(); ++t) {
+        if (V.RowDepth[t] < 0) continue;
+        rowY[t] = y;
+        dl->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_TextDisabled), ace::Profiler::ThreadName((uint16_t)t).c_str());
+        y += (V.RowDepth[t] + 1) * laneH + 4.0f;
+        dl->AddLine(ImVec2(origin.x, y - 2.0f), ImVec2(x0 + width, y - 2.0f), ImGui::GetColorU32(ImGuiCol_Separator));
+    }
+
+    const ace::ProfileEvent* hot = nullptr;
+    for (const ace::ProfileEvent& ev : f.Events) {
+        if (ev.Type != ace::ProfileEvent::Scope || ev.Thread >= V.RowDepth.size()) continue;
+        const float a = toX(ev.Start), b = std::max(toX(ev.End), a + 1.0f);
+        const float top = rowY[ev.Thread] + ev.Depth * laneH;
+        const ImVec2 pmin(a, top), pmax(b, top + laneH - 1.0f);
+        dl->AddRectFilled(pmin, pmax, ProfileScopeColor(ev.Name));
+        if (b - a > 30.0f) {
+            dl->PushClipRect(pmin, pmax, true);
+            dl->AddText(ImVec2(a + 2.0f, top), IM_COL32(20, 20, 20, 255), ev.Name);
+            dl->PopClipRect();
+        }
+        if (hovered && mouse.x >= pmin.x && mouse.x < pmax.x && mouse.y >= pmin.y && mouse.y < pmax.y) hot = &ev;
+    }
+    if (hot) {
+        ImGui::BeginTooltip();
+        ImGui::Text("%s", hot->Name);
+        ImGui::Text("%.3f ms  (%s)", ace::Profiler::DurationNs(hot->Start, hot->End) / 1e6,
+                    ace::Profiler::ThreadName(hot->Thread).c_str());
+        ImGui::EndTooltip();
+    }
+}
+
+static void DrawPanel_Profiler(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
+    ProfilerView& V = S.Prof;
     if (ImGui::Begin("Profiler")) {
-        ImGui::TextUnformatted("Profiler (stub)"); ImGui::Separator();
-        ImGui::BulletText("Frame time graph"); ImGui::BulletText("CPU/GPU scopes"); ImGui::BulletText("Counters");
+#if ACE_ENABLE_PROFILER
+        if (ImGui::Button(V.Paused ? "Resume" : "Pause")) {
+            V.Paused = !V.Paused;
+            ace::Profiler::SetEnabled(!V.Paused);
+        }
+        ImGui::SameLine();
+        if (!ace::Profiler::IsCapturing()) {
+            if (ImGui::Button("Start Capture")) ace::Profiler::BeginCapture();
+        } else if (ImGui::Button("Stop && Save Capture")) {
+            const auto path = ProfileCapturePath(S);
+            if (ace::Profiler::EndCapture(path)) { V.LastCapture = path.string(); Logf("Profiler capture saved: %s", V.LastCapture.c_str()); }
+            else Logf("Profiler capture failed: %s", path.string().c_str());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Latest")) V.FollowLatest = true;
+        if (!V.LastCapture.empty()) { ImGui::SameLine(); ImGui::TextDisabled("Last: %s", V.LastCapture.c_str()); }
+        if (uint64_t dropped = ace::Profiler::DroppedEvents())
+            ImGui::TextColored(ImVec4(0.9f,0.6f,0.3f,1), "%llu events dropped (buffers full)", (unsigned long long)dropped);
+
+        const size_t count = ace::Profiler::FrameCount();
+        if (count == 0) {
+            ImGui::TextDisabled("No frames recorded yet");
+        } else {
+            // --- Frame time graph; click a bar to inspect that frame ---
+            float ms[ace::Profiler::kHistoryFrames];
+            float maxMs = 0.0f, sumMs = 0.0f;
+            size_t selected = count - 1;
+            for (size_t i = 0; i < count; ++i) {
+                const auto& f = ace::Profiler::GetFrame(i);
+                ms[i] = (float)(ace::Profiler::DurationNs(f.Start, f.End) / 1e6);
+                maxMs = std::max(maxMs, ms[i]);
+                sumMs += ms[i];
+                if (!V.FollowLatest && f.Index == V.SelectedFrame) selected = i;
+            }
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "avg %.2f ms  max %.2f ms", sumMs / count, maxMs);
+            ImGui::PlotHistogram("##frametimes", ms, (int)count, 0, overlay, 0.0f, std::max(maxMs, 16.7f) * 1.1f,
+                                 ImVec2(-1.0f, 70.0f));
+            if (ImGui::IsItemClicked()) {
+                const float rel = (ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x) / std::max(1.0f, ImGui::GetItemRectSize().x);
+                selected = std::min(count - 1, (size_t)std::max(0.0f, rel * count));
+                V.FollowLatest = false;
+                V.SelectedFrame = ace::Profiler::GetFrame(selected).Index;
+            }
+
+            const auto& frame = ace::Profiler::GetFrame(selected);
+            ImGui::SeparatorText("Timeline");
+            ImGui::Text("Frame %llu: %.3f ms, %zu events%s", (unsigned long long)frame.Index, ms[selected],
+                        frame.Events.size(), V.FollowLatest ? "" : " (selected)");
+            DrawProfileTimeline(V, frame);
+
+            ImGui::SeparatorText("Scopes");
+            CollectScopeStats(frame, V.Stats);
+            if (ImGui::BeginTable("##scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV |
+                                                 ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchProp,
+                                  ImVec2(0.0f, 200.0f))) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+                ImGui::TableSetupColumn("Calls");
+                ImGui::TableSetupColumn("Total ms");
+                ImGui::TableSetupColumn("Avg us");
+                ImGui::TableSetupColumn("Max us");
+                ImGui::TableHeadersRow();
+                for (const auto& st : V.Stats) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(st.Name);
+                    ImGui::TableNextColumn(); ImGui::Text("%u", st.Calls);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.TotalNs / 1e6);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", st.TotalNs / st.Calls / 1e3);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", st.MaxNs / 1e3);
+                }
+                ImGui::EndTable();
+            }
+        }
+#else
+        ImGui::TextDisabled("Built without ACE_ENABLE_PROFILER");
+#endif
+
+        ImGui::SeparatorText("Heap allocations (main thread, last frame)");
+        if (!ace::mem::IsTrackingHeap()) {
+            ImGui::TextDisabled("Built without ACE_TRACK_ALLOCATIONS");
+        } else {
+            const auto& A = S.LastAllocs;
+            ImGui::Text("Frame:            %llu", (unsigned long long)A.Frame);
+            ImGui::Text("Blueprint editor: %llu", (unsigned long long)A.BlueprintEditor);
+            ImGui::Text("Content grid:     %llu", (unsigned long long)A.ContentGrid);
+            ImGui::Text("Folder tree:      %llu", (unsigned long long)A.ContentTree);
+            ImGui::Text("Total (all threads): %llu", (unsigned long long)ace::mem::TotalAllocCount());
+        }
+        ImGui::Text("Frame arena: %.1f KiB used / %.1f KiB",
+                    S.LastAllocs.FrameArenaBytes / 1024.0, ace::mem::FrameArena().Capacity() / 1024.0);
+
+        ImGui::SeparatorText("Thumbnails");
+        const auto T = S.Thumbs.GetStats();
+        ImGui::Text("Resident: %zu in %zu page(s), %zu queued, %zu known", T.Resident, T.Pages, T.Queued, T.Entries);
+        ImGui::Text("Generated: %llu  Disk hits: %llu  Failed: %llu", (unsigned long long)T.Generated,
+                    (unsigned long long)T.DiskHits, (unsigned long long)T.Failures);
+        ImGui::Text("Uploads: %llu  Evictions: %llu", (unsigned long long)T.Uploads, (unsigned long long)T.Evictions);
+
+        ImGui::SeparatorText("Search index");
+        const auto X = S.Search.GetStats();
+        ImGui::Text("Files: %zu (%zu with text), %zu removed%s", X.Files, X.ContentFiles, X.Dead,
+                    S.SearchBuildRunning ? ", rebuilding" : "");
+        ImGui::Text("Trigrams: %zu  Postings: %.1f MiB  Paths: %.1f MiB", X.Trigrams,
+                    X.PostingBytes / (1024.0 * 1024.0), X.PathBytes / (1024.0 * 1024.0));
+        ImGui::Text("Last build: %.1f ms", X.BuildSeconds * 1000.0);
     }
     ImGui::End();
 }
 static void DrawPanel_BuildOutput(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (ImGui::Begin("Build Output", &S.P.BuildOutput)) {
         // --- Current selection summary ---
         ImGui::TextDisabled("Selection:");
@@ -3226,6 +3987,13 @@ static void DrawPanel_BuildOutput(EditorState& S) {
         if (S.Build.IsRunning) {
             const char* step = (S.Build.Step.empty() ? "Running..." : S.Build.Step.c_str());
             ImGui::TextColored(ImVec4(0.9f,0.9f,0.4f,1), "Status: %s", step);
+            if (S.Build.Cook) {
+                const size_t done = S.Build.Cook->Done, total = S.Build.Cook->Total;
+                S.Build.Progress = total ? (float)done / (float)total : 0.0f;
+                ImGui::SameLine();
+                if (total) ImGui::TextDisabled("(%zu / %zu assets)", done, total);
+                else       ImGui::TextDisabled("(scanning content)");
+            }
 
             // Progress (fill the width)
             ImGui::ProgressBar(std::clamp(S.Build.Progress, 0.0f, 1.0f), ImVec2(-1.0f, 0.0f));
@@ -3271,6 +4039,7 @@ static void DrawPanel_BuildOutput(EditorState& S) {
 
 
 static void DrawPanel_PlayControls(EditorState&) {
+    ACE_PROFILE_FUNCTION();
     if (ImGui::Begin("Play Controls")) {
         if (ImGui::Button("Play")){} ImGui::SameLine();
         if (ImGui::Button("Pause")){} ImGui::SameLine();
@@ -3335,8 +4104,11 @@ static void DrawDockspace(EditorState&) {}
 
 // EditorUI_Menus.cpp (excerpt) — drop-in replacement for DrawMenus
 
+// Build cooks /Game with ACECook in-process (after regenerating reflection code);
+// Rebuild ignores the cook manifest, Clean deletes Cooked/<Platform>.
 static void StartBuild(EditorState& S, bool bRebuild, bool bClean) {
-    // In the future, spawn your real build process here.
+    if (S.Build.IsRunning) return;
+    if (!S.Project) { Logf("Build: no project loaded"); return; }
     S.Build.IsRunning = true;
     S.Build.CancelRequested = false;
     S.Build.Progress = 0.0f;
@@ -3346,18 +4118,52 @@ static void StartBuild(EditorState& S, bool bRebuild, bool bClean) {
     Logf("Build started: Config=%s, Target=%s, Platform=%s, Rebuild=%d, Clean=%d, Jobs=%d, Extra='%s'",
          ToStr(S.BuildSel.Config), ToStr(S.BuildSel.Target), ToStr(S.BuildSel.Platform),
          (int)bRebuild, (int)bClean, S.BuildSel.ParallelJobs, S.BuildSel.ExtraArgs.c_str());
+
+    if (!bClean) RegenerateReflection(S);
+    auto opt = ace::cook::MakeOptions(*S.Project, ToStr(S.BuildSel.Platform));
+    opt.Force = bRebuild;
+    auto progress = std::make_shared<ace::cook::CookProgress>();
+    opt.Progress = progress.get();
+    S.Build.Cook = progress;
+    ace::JobSystem::Get().Run([&S, opt, progress, bClean] {
+        auto st = std::make_shared<ace::cook::CookStats>();
+        const bool ok = bClean ? ace::cook::Clean(opt) : ace::cook::Cook(opt, *st);
+        ace::JobSystem::Get().RunOnMainThread([&S, st, ok, bClean, out = opt.OutputDir] {
+            for (const auto& m : st->Messages) Logf("%s", m.c_str());
+            if (bClean) {
+                Logf("Clean: %s %s", ok ? "removed" : "failed to remove", out.string().c_str());
+            } else {
+                auto& t = st->Timings;
+                std::sort(t.begin(), t.end(), [](const auto& a, const auto& b) { return a.Ms > b.Ms; });
+                for (size_t i = 0; i < t.size() && i < 5; ++i) Logf("Cook: %8.2f ms  %s", t[i].Ms, t[i].Path.c_str());
+                Logf("Cook: %zu assets, %zu unchanged, %zu cooked, %zu from DDC, %zu copied, %zu removed, %zu error(s) in %.2f s%s",
+                     st->Assets, st->Unchanged, st->Cooked, st->CacheHits, st->Copied, st->Removed, st->Errors,
+                     st->Seconds, st->Canceled ? " (canceled)" : "");
+            }
+            S.Build.IsRunning = false;
+            S.Build.Cook.reset();
+            S.Build.Progress = 1.0f;
+            S.Build.Step = st->Canceled ? "Canceled" : (ok ? "Succeeded" : "Failed");
+        });
+    });
 }
 
 static void CancelBuild(EditorState& S) {
     if (!S.Build.IsRunning) return;
     S.Build.CancelRequested = true;
-    S.Build.IsRunning = false;
-    S.Build.Step = "Canceled";
+    if (S.Build.Cook) S.Build.Cook->Cancel = true;   // finishes the assets in flight
+    S.Build.Step = "Canceling...";
     Logf("Build canceled by user.");
 }
 
 
 static void DrawMenus(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
+    // Build shortcuts shown in the Build menu; work whether or not it is open
+    if (S.Project && !S.Build.IsRunning) {
+        if      (ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_B)) StartBuild(S, /*rebuild=*/true,  /*clean=*/false);
+        else if (ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiKey_B))                  StartBuild(S, /*rebuild=*/false, /*clean=*/false);
+    }
     if (!ImGui::BeginMainMenuBar()) return;
 
     // --- File ---
@@ -3415,6 +4221,9 @@ static void DrawMenus(EditorState& S) {
         }
         if (ImGui::MenuItem("Save Map", "Ctrl+S", false, hasProj)) { SaveMap(S); }
         if (ImGui::MenuItem("Save Map As...", nullptr, false, hasProj)) { SaveMapAs(S); }
+        if (ImGui::MenuItem("Export Map as JSON...", nullptr, false, hasProj)) {
+            if (ExportMapJson(S)) Logf("Map exported as JSON");
+        }
 
         ImGui::Separator();
         ImGui::MenuItem("Exit");
@@ -3471,10 +4280,13 @@ static void DrawMenus(EditorState& S) {
         static BuildPlatform sPlat    = BuildPlatform::Windows;
         const bool hasProj = S.Project.has_value();
 
-        if (ImGui::MenuItem("Build Project", "Ctrl+B", false, hasProj)) { S.P.BuildOutput = true; /* hook StartBuild here */ }
-        if (ImGui::MenuItem("Rebuild Project", "Ctrl+Shift+B", false, hasProj)) { S.P.BuildOutput = true; }
-        if (ImGui::MenuItem("Clean Project", nullptr, false, hasProj)) { S.P.BuildOutput = true; }
-        if (ImGui::MenuItem("Cancel Build", nullptr, false, false)) { /* CancelBuild */ }
+        const bool canBuild = hasProj && !S.Build.IsRunning;
+        if (ImGui::MenuItem("Build Project", "Ctrl+B", false, canBuild)) { StartBuild(S, /*rebuild=*/false, /*clean=*/false); }
+        if (ImGui::MenuItem("Rebuild Project", "Ctrl+Shift+B", false, canBuild)) { StartBuild(S, /*rebuild=*/true, /*clean=*/false); }
+        if (ImGui::MenuItem("Clean Project", nullptr, false, canBuild)) { StartBuild(S, /*rebuild=*/false, /*clean=*/true); }
+        if (ImGui::MenuItem("Cancel Build", nullptr, false, S.Build.IsRunning)) { CancelBuild(S); }
+        if (ImGui::MenuItem("Generate Reflection Code", nullptr, false, hasProj)) { RegenerateReflection(S); }
+        if (ImGui::MenuItem("Package Content (.acepak)", nullptr, false, hasProj)) { S.P.BuildOutput = true; PackageContent(S); }
 
         ImGui::SeparatorText("Configuration");
         if (ImGui::MenuItem("Debug",        nullptr, sCfg==BuildConfig::Debug, hasProj))        sCfg = BuildConfig::Debug;
@@ -3531,6 +4343,7 @@ static void DrawMenus(EditorState& S) {
 
 
 static void DrawPanels(EditorState& S) {
+    ACE_PROFILE_FUNCTION();
     if (S.P.Viewport)        DrawPanel_Viewport(S);
     if (S.P.WorldOutliner)   DrawPanel_WorldOutliner(S);
     if (S.P.Inspector)       DrawPanel_Inspector(S);
@@ -3555,6 +4368,9 @@ static void DrawPanels(EditorState& S) {
 // ---------- Main ----------
 
 int main(int argc, char** argv) {
+    ace::Log::Startup(LogFilePath());
+    ACE_PROFILE_THREAD("Main");
+    ace::JobSystem::Startup();             // binds the pool's main thread to this one
     EditorState S{}; LoadSettings(S);
     if (auto arg = ParseProjectArg(argc, argv)) {
         S.ProjectFile = *arg; S.Project = ace::Project::Load(S.ProjectFile);
@@ -3562,9 +4378,9 @@ int main(int argc, char** argv) {
         if (!S.Project) std::printf("[ACEEditor] Failed to load project: %s\n", S.ProjectFile.string().c_str());
     }
 
-    if (!glfwInit()) return 1;
+    if (!glfwInit()) { ace::JobSystem::Shutdown(); ace::Log::Shutdown(); return 1; }
     GLFWwindow* window = glfwCreateWindow(1600, 900, "ACE Editor", nullptr, nullptr);
-    if (!window) { glfwTerminate(); return 2; }
+    if (!window) { glfwTerminate(); ace::JobSystem::Shutdown(); ace::Log::Shutdown(); return 2; }
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1);
 
@@ -3604,8 +4420,47 @@ int main(int argc, char** argv) {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL2_Init();
 
+    S.WorldAssets = std::make_unique<ace::AssetManager>();
+    // Copies instead of mappings: on Windows a mapped file cannot be
+    // overwritten, which would block the very saves hot reload is for
+    for (ace::AssetType t : {ace::AssetType::Unknown, ace::AssetType::Texture, ace::AssetType::Mesh, ace::AssetType::Audio,
+                             ace::AssetType::Shader, ace::AssetType::Text, ace::AssetType::Source})
+        S.WorldAssets->SetLoader(t, [](std::string_view, ace::VfsFile& file) -> std::unique_ptr<ace::Asset> {
+            ace::VfsFile copy;
+            copy.Assign(std::vector<uint8_t>(file.Data(), file.Data() + file.Size()));
+            return std::make_unique<ace::RawAsset>(std::move(copy));
+        });
+    S.WorldAssets->SetReloadCallback([](const std::vector<std::string>& paths) {
+        Logf("Reloaded %zu asset(s) used by the map", paths.size());
+    });
+    // Registry hashes spare the thumbnail workers reading files they already have previews for
+    S.Thumbs.SetHashLookup([&S](const std::filesystem::path& p) -> uint64_t {
+        const auto v = ace::VFS::Get().ToVirtual(p);
+        const ace::AssetData* a = v ? S.Assets.Find(*v) : nullptr;
+        return a ? a->ContentHash : 0;
+    });
+
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        ace::mem::FrameArena().Reset();
+        const uint64_t frameAllocStart = ace::mem::ThreadAllocCount();
+
+        {
+            ACE_PROFILE_SCOPE("PollEvents");
+            glfwPollEvents();
+        }
+        SyncContentMount(S);
+        SyncFileWatcher(S);
+        ProcessFileChanges(S);
+        UpdateFileOperations(S);
+        UpdateAssetRegistry(S);
+        UpdateSearchIndex(S);
+        UpdateThumbnails(S);
+        S.CB.Tree.Update();
+        UpdateWorldAssets(S);
+        {
+            ACE_PROFILE_SCOPE("PumpMainThread");
+            ace::JobSystem::Get().PumpMainThread(2.0); // completions from background jobs
+        }
         ImGui_ImplOpenGL2_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -3620,21 +4475,45 @@ int main(int argc, char** argv) {
 
         ace::editor::DrawEditorPreferences(S);
 
-        ImGui::Render();
-        int w, h; glfwGetFramebufferSize(window, &w, &h);
-        glViewport(0, 0, w, h);
-        glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
-        if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
-            GLFWwindow* backup_ctx = glfwGetCurrentContext();
-            ImGui::UpdatePlatformWindows();
-            ImGui::RenderPlatformWindowsDefault();
-            glfwMakeContextCurrent(backup_ctx);
+        {
+            ACE_PROFILE_SCOPE("Render");
+            ImGui::Render();
+            int w, h; glfwGetFramebufferSize(window, &w, &h);
+            glViewport(0, 0, w, h);
+            glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+            if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+                GLFWwindow* backup_ctx = glfwGetCurrentContext();
+                ImGui::UpdatePlatformWindows();
+                ImGui::RenderPlatformWindowsDefault();
+                glfwMakeContextCurrent(backup_ctx);
+            }
+        }
+        {
+            ACE_PROFILE_SCOPE("SwapBuffers"); // includes the vsync wait
+            glfwSwapBuffers(window);
         }
-        glfwSwapBuffers(window);
+
+        S.Allocs.Frame = ace::mem::ThreadAllocCount() - frameAllocStart;
+        S.Allocs.FrameArenaBytes = ace::mem::FrameArena().BytesUsed();
+        S.LastAllocs = S.Allocs;
+        S.Allocs = {};
+        ACE_PROFILE_COUNTER("Heap allocs/frame", S.LastAllocs.Frame);
+        ACE_PROFILE_COUNTER("Entities", S.EditorWorld.Count());
+        // Paused keeps the history frozen for inspection
+        if (!S.Prof.Paused) ACE_PROFILE_FRAME();
     }
 
+    S.Thumbs.Shutdown();
+    S.CB.Tree.Shutdown();
+    S.FileOps.Shutdown();
+    S.WorldRefs.clear();
+    S.WorldAssets.reset();
+    ace::JobSystem::Shutdown();
+    SaveAssetSnapshot(S);
+    ace::Log::Shutdown();
+
     ImGui_ImplOpenGL2_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
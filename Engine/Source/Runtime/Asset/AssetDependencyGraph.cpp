@@ -0,0 +1,276 @@
+﻿#include "Runtime/Asset/AssetDependencyGraph.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace ace {
+    namespace {
+        using Edge = std::pair<uint32_t, uint32_t>;     // (target, source)
+
+        // Sorted insert/erase of one id, for the short outgoing lists in Rename()
+        void InsertSorted(std::vector<uint32_t>& v, uint32_t id)
+        {
+            const auto it = std::lower_bound(v.begin(), v.end(), id);
+            if (it == v.end() || *it != id) v.insert(it, id);
+        }
+
+        bool EraseSorted(std::vector<uint32_t>& v, uint32_t id)
+        {
+            const auto it = std::lower_bound(v.begin(), v.end(), id);
+            if (it == v.end() || *it != id) return false;
+            v.erase(it);
+            return true;
+        }
+    }
+
+    void AssetDependencyGraph::Clear()
+    {
+        Paths.clear();
+        Nodes.clear();
+        Free.clear();
+        Ids.clear();
+        Marks.clear();
+        Edges = 0;
+    }
+
+    AssetDependencyGraph::NodeId AssetDependencyGraph::Find(std::string_view path) const
+    {
+        const auto it = Ids.find(path);
+        return it != Ids.end() ? it->second : kNone;
+    }
+
+    AssetDependencyGraph::NodeId AssetDependencyGraph::Intern(std::string_view path)
+    {
+        if (const NodeId id = Find(path); id != kNone) return id;
+        NodeId id;
+        if (!Free.empty()) {
+            id = Free.back();
+            Free.pop_back();
+            Paths[id] = path;
+        } else {
+            id = (NodeId)Nodes.size();
+            Paths.emplace_back(path);
+            Nodes.emplace_back();
+        }
+        Ids.emplace(Paths[id], id);
+        return id;
+    }
+
+    void AssetDependencyGraph::Reclaim(std::vector<NodeId>& ids)
+    {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        for (NodeId id : ids) {
+            const Node& n = Nodes[id];
+            if (!n.Asset && n.In.empty() && n.Out.empty()) Release(id);
+        }
+    }
+
+    // 'id' must have no edges; its lists keep their capacity for reuse
+    void AssetDependencyGraph::Release(NodeId id)
+    {
+        Ids.erase(Paths[id]);
+        Paths[id] = std::string();
+        Nodes[id].Asset = false;
+        Free.push_back(id);
+    }
+
+    uint32_t AssetDependencyGraph::NextMark() const
+    {
+        Marks.resize(Nodes.size(), 0);
+        if (++Mark == 0) {
+            std::fill(Marks.begin(), Marks.end(), 0);
+            Mark = 1;
+        }
+        return Mark;
+    }
+
+    void AssetDependencyGraph::Apply(const std::vector<Update>& updates)
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<Edge> added, removed;
+        std::vector<NodeId> refs, dead;                     // dead: may have lost their last use
+        for (const Update& u : updates) {
+            const NodeId src = Intern(u.Path);
+            if (!u.References) dead.push_back(src);
+            refs.clear();
+            if (u.References)
+                for (const auto& r : *u.References)
+                    if (const NodeId id = Intern(r); id != src) refs.push_back(id);
+            std::sort(refs.begin(), refs.end());
+            refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
+
+            Node& n = Nodes[src];
+            n.Asset = u.References != nullptr;
+            auto ri = refs.begin();
+            auto oi = n.Out.begin();
+            while (ri != refs.end() || oi != n.Out.end()) {
+                if (oi == n.Out.end() || (ri != refs.end() && *ri < *oi)) added.push_back({*ri++, src});
+                else if (ri == refs.end() || *oi < *ri)                     removed.push_back({*oi++, src});
+                else { ++ri; ++oi; }
+            }
+            Edges = Edges + refs.size() - n.Out.size();
+            n.Out.swap(refs);
+        }
+        if (added.empty() && removed.empty()) { Reclaim(dead); return; }
+
+        // An edge added by one update and dropped by a later one for the same
+        // path (or the reverse) cancels out
+        std::sort(added.begin(), added.end());
+        std::sort(removed.begin(), removed.end());
+        std::vector<Edge> add, del;
+        std::set_difference(added.begin(), added.end(), removed.begin(), removed.end(), std::back_inserter(add));
+        std::set_difference(removed.begin(), removed.end(), added.begin(), added.end(), std::back_inserter(del));
+        add.erase(std::unique(add.begin(), add.end()), add.end());
+        del.erase(std::unique(del.begin(), del.end()), del.end());
+
+        // One merge per touched target: In = (In - del) + add
+        std::vector<NodeId> merged, sources;
+        size_t a = 0, d = 0;
+        while (a < add.size() || d < del.size()) {
+            const NodeId t = d == del.size() ? add[a].first
+                           : a == add.size() ? del[d].first
+                           : std::min(add[a].first, del[d].first);
+            std::vector<NodeId>& in = Nodes[t].In;
+            if (d < del.size() && del[d].first == t) {
+                dead.push_back(t);
+                sources.clear();
+                for (; d < del.size() && del[d].first == t; ++d) sources.push_back(del[d].second);
+                merged.clear();
+                std::set_difference(in.begin(), in.end(), sources.begin(), sources.end(), std::back_inserter(merged));
+                in.swap(merged);
+            }
+            if (a < add.size() && add[a].first == t) {
+                sources.clear();
+                for (; a < add.size() && add[a].first == t; ++a) sources.push_back(add[a].second);
+                merged.clear();
+                std::set_union(in.begin(), in.end(), sources.begin(), sources.end(), std::back_inserter(merged));
+                in.swap(merged);
+            }
+        }
+        Reclaim(dead);
+    }
+
+    void AssetDependencyGraph::Rename(std::string_view from, std::string_view to)
+    {
+        const NodeId id = Find(from);
+        if (id == kNone || from == to) return;
+
+        if (const NodeId old = Find(to); old != kNone) {
+            Node& o = Nodes[old];
+            if (o.Asset) {
+                for (NodeId t : o.Out) EraseSorted(Nodes[t].In, old);
+                Edges -= o.Out.size();
+                o.Out.clear();
+                o.Asset = false;
+            }
+            // Referrers of the old node now point at 'id'
+            std::vector<NodeId> moved;
+            for (NodeId r : o.In) {
+                EraseSorted(Nodes[r].Out, old);
+                if (r == id) { --Edges; continue; }             // would be a self-reference
+                if (std::binary_search(Nodes[r].Out.begin(), Nodes[r].Out.end(), id)) { --Edges; continue; }
+                InsertSorted(Nodes[r].Out, id);
+                moved.push_back(r);
+            }
+            std::vector<NodeId>& in = Nodes[id].In;
+            std::vector<NodeId> merged;
+            merged.reserve(in.size() + moved.size());
+            std::set_union(in.begin(), in.end(), moved.begin(), moved.end(), std::back_inserter(merged));
+            in.swap(merged);
+            o.In.clear();
+            Release(old);
+        }
+
+        Ids.erase(from);
+        Paths[id] = to;
+        Ids.emplace(Paths[id], id);
+    }
+
+    bool AssetDependencyGraph::IsAsset(std::string_view path) const
+    {
+        const NodeId id = Find(path);
+        return id != kNone && Nodes[id].Asset;
+    }
+
+    void AssetDependencyGraph::GetReferences(std::string_view path, std::vector<std::string_view>& out) const
+    {
+        if (const NodeId id = Find(path); id != kNone)
+            for (NodeId t : Nodes[id].Out) out.push_back(Paths[t]);
+    }
+
+    void AssetDependencyGraph::GetReferencers(std::string_view path, std::vector<std::string_view>& out) const
+    {
+        if (const NodeId id = Find(path); id != kNone)
+            for (NodeId r : Nodes[id].In) out.push_back(Paths[r]);
+    }
+
+    void AssetDependencyGraph::GetReferencers(const std::vector<std::string>& paths, std::vector<std::string_view>& out) const
+    {
+        const uint32_t mark = NextMark();
+        for (const auto& p : paths) {
+            const NodeId id = Find(p);
+            if (id == kNone) continue;
+            for (NodeId r : Nodes[id].In)
+                if (Marks[r] != mark) { Marks[r] = mark; out.push_back(Paths[r]); }
+        }
+    }
+
+    void AssetDependencyGraph::GetAffected(std::string_view changed, std::vector<std::string_view>& out) const
+    {
+        GetAffected(std::vector<std::string>{std::string(changed)}, out);
+    }
+
+    void AssetDependencyGraph::GetAffected(const std::vector<std::string>& changed, std::vector<std::string_view>& out) const
+    {
+        ACE_PROFILE_FUNCTION();
+        // Depth-first along referrer edges; reversed post-order puts every
+        // asset before its referrers
+        const uint32_t mark = NextMark();
+        std::vector<std::pair<NodeId, uint32_t>> stack;     // node, next referrer
+        const size_t first = out.size();
+        for (const auto& p : changed) {
+            const NodeId start = Find(p);
+            if (start == kNone || Marks[start] == mark) continue;
+            Marks[start] = mark;
+            stack.push_back({start, 0});
+            while (!stack.empty()) {
+                const NodeId n = stack.back().first;
+                const std::vector<NodeId>& in = Nodes[n].In;
+                if (stack.back().second < in.size()) {
+                    const NodeId r = in[stack.back().second++];
+                    if (Marks[r] != mark) { Marks[r] = mark; stack.push_back({r, 0}); }
+                } else {
+                    out.push_back(Paths[n]);
+                    stack.pop_back();
+                }
+            }
+        }
+        std::reverse(out.begin() + (ptrdiff_t)first, out.end());
+    }
+
+    bool AssetDependencyGraph::Validate() const
+    {
+        size_t outEdges = 0, inEdges = 0;
+        for (NodeId n = 0; n < (NodeId)Nodes.size(); ++n) {
+            const Node& node = Nodes[n];
+            if (!std::is_sorted(node.Out.begin(), node.Out.end()) || !std::is_sorted(node.In.begin(), node.In.end()))
+                return false;
+            if (std::adjacent_find(node.Out.begin(), node.Out.end()) != node.Out.end() ||
+                std::adjacent_find(node.In.begin(), node.In.end()) != node.In.end())
+                return false;
+            for (NodeId t : node.Out)
+                if (t == n || !std::binary_search(Nodes[t].In.begin(), Nodes[t].In.end(), n)) return false;
+            for (NodeId r : node.In)
+                if (!std::binary_search(Nodes[r].Out.begin(), Nodes[r].Out.end(), n)) return false;
+            outEdges += node.Out.size();
+            inEdges += node.In.size();
+        }
+        for (const auto& [path, id] : Ids)
+            if (id >= Nodes.size() || Paths[id] != path) return false;
+        for (NodeId id : Free)
+            if (id >= Nodes.size() || !Nodes[id].In.empty() || !Nodes[id].Out.empty() || Ids.contains(Paths[id])) return false;
+        return outEdges == Edges && inEdges == Edges && Ids.size() + Free.size() == Nodes.size();
+    }
+}
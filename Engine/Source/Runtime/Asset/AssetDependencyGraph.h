@@ -0,0 +1,86 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    // Who references what, in both directions, keyed by virtual path. A
+    // referenced path that is not (yet) an asset still gets a node, so its
+    // referrers are found once it appears. A node that is neither an asset
+    // nor referenced is freed and its id reused, so the graph stays the size
+    // of what is live.
+    //
+    // Each node keeps its outgoing edges and its referrers as sorted id
+    // lists. Apply() replaces the outgoing edges of any number of assets and
+    // then patches each touched target's referrer list in one merge, so a
+    // batch costs O(edges changed + referrers of the touched targets), not
+    // one insertion per edge. Queries cost O(result).
+    //
+    // Owned and kept current by AssetRegistry. Not thread-safe: queries use
+    // per-node scratch marks.
+    class AssetDependencyGraph {
+    public:
+        struct Update {
+            std::string_view                Path;
+            const std::vector<std::string>* References = nullptr;   // null = asset removed
+        };
+
+        void Clear();
+        void Apply(const std::vector<Update>& updates);
+        // The node keeps its edges under the new path. If 'to' already had
+        // referrers (a missing reference being fixed by the move), they are
+        // merged in; if 'to' was an asset, its outgoing edges are dropped.
+        void Rename(std::string_view from, std::string_view to);
+
+        bool   IsAsset(std::string_view path) const;
+        size_t NodeCount() const { return Ids.size(); }
+        size_t EdgeCount() const { return Edges; }
+
+        // Direct neighbours, in no particular order. Views stay valid until
+        // the next change.
+        void GetReferences(std::string_view path, std::vector<std::string_view>& out) const;
+        void GetReferencers(std::string_view path, std::vector<std::string_view>& out) const;
+        // Direct referrers of several assets, each once
+        void GetReferencers(const std::vector<std::string>& paths, std::vector<std::string_view>& out) const;
+
+        // Everything to reload or recook when 'changed' change: those assets
+        // plus all their transitive referrers, each once, ordered so that an
+        // asset comes after everything it references (members of a cycle in
+        // any order). Paths that are not in the graph are skipped.
+        void GetAffected(const std::vector<std::string>& changed, std::vector<std::string_view>& out) const;
+        void GetAffected(std::string_view changed, std::vector<std::string_view>& out) const;
+
+        // Debug check that both edge directions agree; O(edges)
+        bool Validate() const;
+
+    private:
+        using NodeId = uint32_t;
+        static constexpr NodeId kNone = ~0u;
+
+        struct Node {
+            std::vector<NodeId> Out;        // sorted
+            std::vector<NodeId> In;         // sorted
+            bool                Asset = false;
+        };
+
+        NodeId Find(std::string_view path) const;
+        NodeId Intern(std::string_view path);
+        // Frees each of 'ids' that is no longer an asset and has no edges
+        void Reclaim(std::vector<NodeId>& ids);
+        void Release(NodeId id);
+        uint32_t NextMark() const;
+
+        std::deque<std::string> Paths;                          // by NodeId; a deque so views stay put
+        std::vector<Node>       Nodes;
+        std::vector<NodeId>     Free;                           // released ids, reused by Intern()
+        std::unordered_map<std::string_view, NodeId> Ids;       // views into Paths
+        size_t                  Edges = 0;
+
+        mutable std::vector<uint32_t> Marks;                    // == Mark: visited by the current query
+        mutable uint32_t              Mark = 0;
+    };
+}
@@ -0,0 +1,525 @@
+﻿#include "Runtime/Asset/AssetManager.h"
+#include "Runtime/Asset/CookedAsset.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/World/MapBinary.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace ace {
+    struct AssetHandle::Entry {
+        std::string                 Path;
+        AssetType                   Type = AssetType::Unknown;
+        AssetLoadState              State = AssetLoadState::Loading;
+        AssetPriority               Priority = AssetPriority::Normal;
+        uint64_t                    Seq = 0;            // FIFO order within a priority
+        uint32_t                    Refs = 0;           // handles plus pending callbacks
+        std::unique_ptr<Asset>      Data;
+        size_t                      Bytes = 0;
+        std::vector<AssetLoadedFn>  Callbacks;          // waiting for the load
+        std::list<Entry*>::iterator LruIt;
+        bool                        InLru = false;
+        uint32_t                    ReloadBatch = 0;    // Reload() in progress; holds a reference
+        bool                        Requeue = false;    // the file changed while a job read it
+    };
+
+    namespace {
+        // Rough heap footprint of a parsed document
+        size_t EstimateJson(const nlohmann::json& j)
+        {
+            size_t n = sizeof(nlohmann::json);
+            if (j.is_string()) {
+                n += j.get_ref<const std::string&>().capacity();
+            } else if (j.is_object()) {
+                for (auto it = j.begin(); it != j.end(); ++it)
+                    n += 64 + it.key().capacity() + EstimateJson(it.value());
+            } else if (j.is_array()) {
+                for (const auto& v : j) n += EstimateJson(v);
+            }
+            return n;
+        }
+
+        size_t EstimateWorld(const World& world)
+        {
+            size_t n = world.Count() * 16;
+            for (const auto& a : world.GetArchetypes()) n += a->Chunks().size() * Archetype::kChunkBytes;
+            return n;
+        }
+
+        std::unique_ptr<Asset> LoadMapAsset(std::string_view, VfsFile& file)
+        {
+            auto a = std::make_unique<MapAsset>();
+            if (!LoadMap(a->Map, file.Data(), file.Size())) return nullptr;
+            a->Bytes = EstimateWorld(a->Map);
+            return a;
+        }
+
+        std::unique_ptr<Asset> LoadJsonAsset(std::string_view path, VfsFile& file)
+        {
+            auto a = std::make_unique<JsonAsset>();
+            if (IsCookedAsset(file.Data(), file.Size())) {
+                if (!ReadCookedAsset(file.Data(), file.Size(), a->Type, a->Guid, a->Json)) return nullptr;
+            } else {
+                const std::string_view text = file.Text();
+                a->Json = nlohmann::json::parse(text.begin(), text.end(), nullptr, false);
+                if (!a->Json.is_object()) return nullptr;
+                a->Type = AssetTypeFromPath(path);
+                if (auto it = a->Json.find("Type"); it != a->Json.end() && it->is_string())
+                    if (const AssetType t = AssetTypeFromName(it->get_ref<const std::string&>()); t != AssetType::Unknown)
+                        a->Type = t;
+                if (auto it = a->Json.find("Guid"); it != a->Json.end() && it->is_string())
+                    AssetGuid::FromString(it->get_ref<const std::string&>(), a->Guid);
+            }
+            a->Bytes = EstimateJson(a->Json);
+            return a;
+        }
+
+        std::unique_ptr<Asset> LoadRawAsset(std::string_view, VfsFile& file)
+        {
+            return std::make_unique<RawAsset>(std::move(file));
+        }
+
+        AssetLoader DefaultLoader(AssetType type)
+        {
+            switch (type) {
+            case AssetType::Map:
+                return LoadMapAsset;
+            case AssetType::Blueprint:
+            case AssetType::GameMode:
+            case AssetType::Material:
+            case AssetType::DataAsset:
+                return LoadJsonAsset;
+            default:
+                return LoadRawAsset;
+            }
+        }
+
+        // Big worlds take a while to free; keep that off the game thread
+        void DestroyAsync(std::unique_ptr<Asset> data)
+        {
+            if (!data) return;
+            Asset* raw = data.release();
+            JobSystem::Get().Run([raw] { delete raw; });
+        }
+
+    }
+
+    // ---- AssetHandle ----
+
+    AssetHandle::AssetHandle(AssetManager* manager, Entry* entry) : Manager(manager), E(entry)
+    {
+        Manager->AddRef(E);
+    }
+
+    AssetHandle::AssetHandle(const AssetHandle& other) : Manager(other.Manager), E(other.E)
+    {
+        if (E) Manager->AddRef(E);
+    }
+
+    AssetHandle::AssetHandle(AssetHandle&& other) noexcept : Manager(other.Manager), E(other.E)
+    {
+        other.Manager = nullptr;
+        other.E = nullptr;
+    }
+
+    AssetHandle& AssetHandle::operator=(const AssetHandle& other)
+    {
+        if (this != &other) {
+            if (other.E) other.Manager->AddRef(other.E);
+            Reset();
+            Manager = other.Manager;
+            E = other.E;
+        }
+        return *this;
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            Manager = std::exchange(other.Manager, nullptr);
+            E = std::exchange(other.E, nullptr);
+        }
+        return *this;
+    }
+
+    AssetHandle::~AssetHandle()
+    {
+        Reset();
+    }
+
+    void AssetHandle::Reset()
+    {
+        if (E) Manager->Release(E);
+        Manager = nullptr;
+        E = nullptr;
+    }
+
+    const std::string& AssetHandle::Path() const
+    {
+        static const std::string kEmpty;
+        return E ? E->Path : kEmpty;
+    }
+
+    AssetLoadState AssetHandle::State() const
+    {
+        return E ? E->State : AssetLoadState::Failed;
+    }
+
+    const Asset* AssetHandle::Get() const
+    {
+        return E && E->State == AssetLoadState::Loaded ? E->Data.get() : nullptr;
+    }
+
+    // ---- AssetManager ----
+
+    AssetManager::AssetManager(VFS* vfs) : Vfs(vfs ? vfs : &VFS::Get())
+    {
+        MaxInFlight = std::max(2u, JobSystem::Get().NumWorkers());
+        for (size_t t = 0; t < kAssetTypeCount; ++t) Loaders[t] = DefaultLoader((AssetType)t);
+    }
+
+    AssetManager::~AssetManager()
+    {
+        {
+            std::lock_guard lock(Mutex);
+            Queue.clear();                  // loader jobs stop after their current asset
+        }
+        JobSystem::Get().Wait(JobsDone);
+    }
+
+    void AssetManager::SetLoader(AssetType type, AssetLoader loader)
+    {
+        if ((size_t)type >= kAssetTypeCount) return;
+        std::lock_guard lock(Mutex);
+        Loaders[(size_t)type] = loader ? std::move(loader) : DefaultLoader(type);
+    }
+
+    AssetManager::QueueKey AssetManager::KeyOf(const Entry* e)
+    {
+        return {-(int)e->Priority, e->Seq, const_cast<Entry*>(e)};
+    }
+
+    AssetHandle AssetManager::Load(std::string_view path, AssetPriority priority, AssetLoadedFn done)
+    {
+        const std::string p = VFS::Normalize(path);
+        Entry* e;
+        if (auto it = Entries.find(p); it != Entries.end()) {
+            e = it->second.get();
+            if (e->State == AssetLoadState::Loading && priority > e->Priority) {
+                std::lock_guard lock(Mutex);
+                if (Queue.erase(KeyOf(e))) {        // else a job has it already
+                    e->Priority = priority;
+                    Queue.insert(KeyOf(e));
+                }
+            }
+        } else {
+            auto entry = std::make_unique<Entry>();
+            entry->Path = p;
+            entry->Type = AssetTypeFromPath(std::string_view(p));
+            entry->Priority = priority;
+            entry->Seq = NextSeq++;
+            e = entry.get();
+            Entries.emplace(e->Path, std::move(entry));
+            ++Pending;
+            {
+                std::lock_guard lock(Mutex);
+                Queue.insert(KeyOf(e));
+            }
+            Dispatch();
+        }
+
+        AssetHandle handle(this, e);
+        if (done) {
+            AddRef(e);      // dropped after the callback ran
+            if (e->State == AssetLoadState::Loading) e->Callbacks.push_back(std::move(done));
+            else                                     Callbacks.push_back({e, std::move(done)});
+        }
+        return handle;
+    }
+
+    AssetHandle AssetManager::Find(std::string_view path)
+    {
+        const auto it = Entries.find(VFS::Normalize(path));
+        return it != Entries.end() ? AssetHandle(this, it->second.get()) : AssetHandle();
+    }
+
+    size_t AssetManager::Reload(const std::vector<std::string>& paths)
+    {
+        std::vector<Entry*> entries;
+        for (const auto& p : paths)
+            if (const auto it = Entries.find(VFS::Normalize(p)); it != Entries.end()) entries.push_back(it->second.get());
+        return ReloadEntries(entries);
+    }
+
+    size_t AssetManager::ReloadAll()
+    {
+        std::vector<Entry*> entries;
+        entries.reserve(Entries.size());
+        for (const auto& [path, e] : Entries) entries.push_back(e.get());
+        return ReloadEntries(entries);
+    }
+
+    size_t AssetManager::ReloadEntries(const std::vector<Entry*>& entries)
+    {
+        if (entries.empty()) return 0;
+        uint32_t batch = NextBatch++;
+        if (!batch) batch = NextBatch++;        // 0 marks a first load
+        size_t batched = 0, retried = 0;
+        for (Entry* e : entries) {
+            {
+                std::lock_guard lock(Mutex);
+                if (e->State == AssetLoadState::Loading || e->ReloadBatch) {
+                    // Still queued: it reads the new file anyway
+                    if (!Queue.count(KeyOf(e))) e->Requeue = true;
+                    continue;
+                }
+                e->Seq = NextSeq++;
+                if (e->State == AssetLoadState::Failed) e->State = AssetLoadState::Loading;    // held, so try again
+                else                                     e->ReloadBatch = batch;
+                Queue.insert(KeyOf(e));
+            }
+            ++Pending;
+            if (e->ReloadBatch) {
+                AddRef(e);      // dropped once the batch is swapped in
+                ++batched;
+            } else {
+                ++retried;
+            }
+        }
+        if (batched) Batches[batch].Size = batched;
+        if (batched || retried) Dispatch();
+        return batched + retried;
+    }
+
+    void AssetManager::AddRef(Entry* e)
+    {
+        if (e->Refs++ == 0 && e->InLru) {
+            Lru.erase(e->LruIt);
+            e->InLru = false;
+        }
+    }
+
+    void AssetManager::Release(Entry* e)
+    {
+        if (--e->Refs != 0) return;
+        switch (e->State) {
+        case AssetLoadState::Loading: {
+            // Cancel it if no job has picked it up; otherwise Publish() decides
+            bool canceled;
+            {
+                std::lock_guard lock(Mutex);
+                canceled = Queue.erase(KeyOf(e)) != 0;
+            }
+            if (canceled) {
+                --Pending;
+                Erase(e);
+            }
+            break;
+        }
+        case AssetLoadState::Loaded:
+            Lru.push_front(e);
+            e->LruIt = Lru.begin();
+            e->InLru = true;
+            break;
+        case AssetLoadState::Failed:
+            Erase(e);
+            break;
+        }
+    }
+
+    void AssetManager::Erase(Entry* e)
+    {
+        if (e->State == AssetLoadState::Loaded) {
+            Bytes -= e->Bytes;
+            --Resident;
+        }
+        DestroyAsync(std::move(e->Data));
+        Entries.erase(Entries.find(e->Path));
+    }
+
+    void AssetManager::Dispatch()
+    {
+        std::lock_guard lock(Mutex);
+        while (Jobs < MaxInFlight && Jobs < Queue.size()) {
+            ++Jobs;
+            JobSystem::Get().Run([this] { LoadJob(); }, &JobsDone);
+        }
+    }
+
+    // Worker side: takes the most urgent request until the queue is empty
+    void AssetManager::LoadJob()
+    {
+        for (;;) {
+            Entry* e;
+            std::string path;
+            AssetLoader loader;
+            uint32_t batch;
+            {
+                std::lock_guard lock(Mutex);
+                if (Queue.empty()) { --Jobs; return; }
+                e = std::get<2>(*Queue.begin());
+                Queue.erase(Queue.begin());
+                path = e->Path;
+                loader = Loaders[(size_t)e->Type];
+                batch = e->ReloadBatch;
+            }
+
+            ACE_PROFILE_SCOPE("AssetManager::LoadJob");
+            std::unique_ptr<Asset> data;
+            VfsFile file;
+            if (Vfs->Open(path, file)) data = loader(path, file);
+            std::lock_guard lock(Mutex);
+            Done.push_back({e, std::move(data), batch});
+        }
+    }
+
+    void AssetManager::Publish(Completion& c)
+    {
+        Entry* e = c.E;
+        if (e->Requeue) {
+            // What the job read may predate the change: read it again
+            e->Requeue = false;
+            {
+                std::lock_guard lock(Mutex);
+                Queue.insert(KeyOf(e));
+            }
+            Dispatch();
+            return;
+        }
+        --Pending;
+        if (c.Batch) {
+            PublishReload(c);
+            return;
+        }
+        if (c.Data) {
+            e->Data = std::move(c.Data);
+            e->Bytes = e->Data->MemorySize();
+            e->State = AssetLoadState::Loaded;
+            Bytes += e->Bytes;
+            ++Resident;
+            ++Counters.Loads;
+        } else {
+            e->State = AssetLoadState::Failed;
+            ++Counters.Failures;
+            ACE_LOG_WARN("Assets", "%s: load failed", e->Path.c_str());
+        }
+        for (auto& fn : e->Callbacks) Callbacks.push_back({e, std::move(fn)});
+        e->Callbacks.clear();
+
+        // Nobody waited for it: cache it, or forget the failure
+        if (e->Refs == 0) {
+            ++e->Refs;
+            Release(e);
+        }
+    }
+
+    // Swaps the batch in once its last asset arrives
+    void AssetManager::PublishReload(Completion& c)
+    {
+        const auto it = Batches.find(c.Batch);
+        ReloadBatch& batch = it->second;
+        batch.Ready.push_back(std::move(c));
+        if (batch.Ready.size() < batch.Size) return;
+
+        for (auto& r : batch.Ready) {
+            Entry* e = r.E;
+            e->ReloadBatch = 0;
+            if (r.Data) {
+                Bytes -= e->Bytes;
+                DestroyAsync(std::move(e->Data));
+                e->Data = std::move(r.Data);
+                e->Bytes = e->Data->MemorySize();
+                Bytes += e->Bytes;
+                ++Counters.Reloads;
+                Reloaded.push_back(e->Path);
+            } else {
+                ++Counters.Failures;
+                ACE_LOG_WARN("Assets", "%s: reload failed, keeping the loaded version", e->Path.c_str());
+            }
+            Release(e);
+        }
+        Batches.erase(it);
+    }
+
+    void AssetManager::Evict()
+    {
+        while (Bytes > Budget && !Lru.empty()) {
+            Entry* e = Lru.back();
+            Lru.pop_back();
+            e->InLru = false;
+            ++Counters.Evictions;
+            Erase(e);
+        }
+    }
+
+    void AssetManager::Update(double budgetMs)
+    {
+        ACE_PROFILE_FUNCTION();
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto elapsedMs = [&] {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        };
+
+        // Publishing is a few pointer moves per load, so all of it happens now
+        std::vector<Completion> done;
+        {
+            std::lock_guard lock(Mutex);
+            done.swap(Done);
+        }
+        for (auto& c : done) Publish(c);
+        if (!Reloaded.empty()) {
+            std::vector<std::string> paths;
+            paths.swap(Reloaded);
+            if (OnReloaded) OnReloaded(paths);
+        }
+
+        // Callbacks are the caller's code: run them until the budget is
+        // spent (at least one per frame) and keep the rest for later
+        std::vector<std::pair<Entry*, AssetLoadedFn>> due;
+        due.swap(Callbacks);
+        size_t ran = 0;
+        for (; ran < due.size(); ++ran) {
+            if (ran && elapsedMs() > budgetMs) break;
+            auto& [e, fn] = due[ran];
+            {
+                const AssetHandle handle(this, e);
+                fn(handle);
+            }
+            Release(e);
+        }
+        if (ran < due.size())
+            Callbacks.insert(Callbacks.begin(), std::make_move_iterator(due.begin() + (ptrdiff_t)ran),
+                             std::make_move_iterator(due.end()));
+
+        Evict();
+        Counters.LastUpdateMs = elapsedMs();
+    }
+
+    void AssetManager::Flush()
+    {
+        ACE_PROFILE_FUNCTION();
+        while (Pending || !Callbacks.empty()) {
+            JobSystem::Get().Wait(JobsDone);
+            Update(std::numeric_limits<double>::infinity());
+        }
+    }
+
+    AssetManagerStats AssetManager::GetStats() const
+    {
+        AssetManagerStats s = Counters;
+        {
+            std::lock_guard lock(Mutex);
+            s.Queued = Queue.size();
+        }
+        s.Loaded = Resident;
+        s.Cached = Lru.size();
+        s.InFlight = Pending - s.Queued;
+        s.Bytes = Bytes;
+        s.Budget = Budget;
+        return s;
+    }
+}
@@ -0,0 +1,241 @@
+﻿#pragma once
+#include "Runtime/Asset/AssetRegistry.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/IO/VFS.h"
+#include "Runtime/World/World.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace ace {
+    class AssetManager;
+
+    // Decoded, in-memory form of an asset, built on a worker by the loader
+    // registered for its type. Read-only once loaded.
+    class Asset {
+    public:
+        virtual ~Asset() = default;
+        // Bytes held, for the memory budget; an estimate is fine
+        virtual size_t MemorySize() const = 0;
+    };
+
+    // Anything without a decoder (textures, meshes, audio, ...): the file
+    // bytes, usually a mapping of the loose file
+    class RawAsset final : public Asset {
+    public:
+        explicit RawAsset(VfsFile&& file) : File(std::move(file)) {}
+        const uint8_t* Data() const { return File.Data(); }
+        size_t         Size() const { return File.Size(); }
+        size_t         MemorySize() const override { return File.Size(); }
+
+    private:
+        VfsFile File;
+    };
+
+    // Blueprints, game modes, materials and data assets, loose or cooked
+    class JsonAsset final : public Asset {
+    public:
+        AssetType      Type = AssetType::Unknown;
+        AssetGuid      Guid;                    // from the cooked header or "Guid"; may be unset
+        nlohmann::json Json;
+        size_t         Bytes = 0;
+        size_t         MemorySize() const override { return Bytes; }
+    };
+
+    class MapAsset final : public Asset {
+    public:
+        World  Map;
+        size_t Bytes = 0;
+        size_t MemorySize() const override { return Bytes; }
+    };
+
+    enum class AssetPriority : uint8_t { Low, Normal, High, Critical };
+
+    enum class AssetLoadState : uint8_t {
+        Loading,        // queued or on a worker
+        Loaded,
+        Failed,         // missing, unreadable or rejected by the loader
+    };
+
+    // Reference to a managed asset. Copies share one reference count; while
+    // any handle exists the asset is not evicted, and dropping the last one
+    // before the load starts cancels it. Handles belong to the game thread
+    // and must not outlive their manager; the Asset itself may be read from
+    // any thread while a handle is held, until an Update() that swaps in a
+    // reloaded version of it.
+    class AssetHandle {
+    public:
+        AssetHandle() = default;
+        AssetHandle(const AssetHandle& other);
+        AssetHandle(AssetHandle&& other) noexcept;
+        AssetHandle& operator=(const AssetHandle& other);
+        AssetHandle& operator=(AssetHandle&& other) noexcept;
+        ~AssetHandle();
+
+        explicit operator bool() const { return E != nullptr; }
+        const std::string& Path() const;
+        AssetLoadState     State() const;
+        bool               IsLoaded() const { return E && State() == AssetLoadState::Loaded; }
+        const Asset*       Get() const;
+        // Null until loaded or if the asset is of another kind
+        template<class T> const T* Get() const { return dynamic_cast<const T*>(Get()); }
+
+        void Reset();
+
+    private:
+        friend class AssetManager;
+        struct Entry;
+        AssetHandle(AssetManager* manager, Entry* entry);
+
+        AssetManager* Manager = nullptr;
+        Entry*        E = nullptr;
+    };
+
+    // Called on the game thread, from AssetManager::Update(), when a load
+    // finishes; check handle.State() for failure
+    using AssetLoadedFn = std::function<void(const AssetHandle& handle)>;
+    // Called from Update() once per Reload() batch, after all of it was
+    // swapped in, with the paths that now hold new data
+    using AssetReloadedFn = std::function<void(const std::vector<std::string>& paths)>;
+    // Runs on a worker. Returns null to fail the load.
+    using AssetLoader = std::function<std::unique_ptr<Asset>(std::string_view path, VfsFile& file)>;
+
+    struct AssetManagerStats {
+        size_t   Loaded = 0;            // resident, referenced or not
+        size_t   Cached = 0;            // resident with no handle: first to go
+        size_t   Queued = 0;
+        size_t   InFlight = 0;
+        uint64_t Bytes = 0;             // MemorySize() of everything resident
+        uint64_t Budget = 0;
+        uint64_t Loads = 0;
+        uint64_t Failures = 0;
+        uint64_t Reloads = 0;
+        uint64_t Evictions = 0;
+        double   LastUpdateMs = 0.0;    // game-thread time of the last Update()
+    };
+
+    // Asynchronous asset loading for the runtime.
+    //
+    // Load() returns a handle at once and queues the request by priority,
+    // then FIFO. Up to MaxInFlight loader jobs drain the queue on the job
+    // system, each taking the most urgent request, opening it through the
+    // VFS and decoding it, so a Critical request made while a level streams
+    // in overtakes everything still queued. Update() publishes finished
+    // loads, runs callbacks within a time budget (the rest wait for the next
+    // frame) and evicts unreferenced assets, least recently released first,
+    // until resident memory fits the budget. Evicted assets are destroyed on
+    // a worker. Referenced assets are never evicted, so the budget can be
+    // exceeded while they are held.
+    //
+    // Reload() re-reads assets whose files changed. Only resident ones are
+    // touched, so the cost follows the change, not the project. The new
+    // versions load on workers like any request; Update() swaps in a whole
+    // batch together once its last asset is decoded, so handles never see
+    // a mix of old and new assets that were changed together. A version
+    // that fails to load keeps the old data.
+    //
+    // Everything but the loaders runs on the game thread.
+    class AssetManager {
+    public:
+        explicit AssetManager(VFS* vfs = nullptr);     // null = VFS::Get()
+        ~AssetManager();                                // waits for loads in flight
+        AssetManager(const AssetManager&) = delete;
+        AssetManager& operator=(const AssetManager&) = delete;
+
+        // Built-in loaders: MapAsset for maps, JsonAsset for JSON asset
+        // types, RawAsset for the rest. Replace per type; an empty function
+        // restores the default.
+        void SetLoader(AssetType type, AssetLoader loader);
+        void SetMemoryBudget(uint64_t bytes) { Budget = bytes; }
+        void SetMaxInFlight(uint32_t n) { MaxInFlight = n ? n : 1; }
+
+        // Requests 'path' (virtual). Already resident or pending assets are
+        // shared; a higher priority moves a queued request up. 'done' runs
+        // from a later Update(), even if the asset is already loaded, and
+        // keeps the request alive until then.
+        AssetHandle Load(std::string_view path, AssetPriority priority = AssetPriority::Normal, AssetLoadedFn done = {});
+        // Existing entry only; never starts a load
+        AssetHandle Find(std::string_view path);
+
+        // The files behind 'paths' (virtual) changed: reloads those that are
+        // resident as one batch, and restarts loads in flight so they do not
+        // publish the old file. Returns the number of assets reloaded.
+        size_t Reload(const std::vector<std::string>& paths);
+        // Everything resident, e.g. after the watcher lost events
+        size_t ReloadAll();
+        void   SetReloadCallback(AssetReloadedFn fn) { OnReloaded = std::move(fn); }
+
+        // Once per frame on the game thread
+        void Update(double budgetMs = 2.0);
+        // Blocks until nothing is queued or in flight, then publishes
+        // everything (tools, tests, loading screens)
+        void Flush();
+
+        AssetManagerStats GetStats() const;
+
+    private:
+        friend class AssetHandle;
+        using Entry = AssetHandle::Entry;
+
+        struct Completion {
+            Entry*                 E = nullptr;
+            std::unique_ptr<Asset> Data;
+            uint32_t               Batch = 0;   // Reload() batch; 0 = first load
+        };
+
+        struct ReloadBatch {
+            size_t                  Size = 0;
+            std::vector<Completion> Ready;      // swapped in once all Size are here
+        };
+
+        // Highest priority first, then oldest
+        using QueueKey = std::tuple<int, uint64_t, Entry*>;
+        static QueueKey KeyOf(const Entry* e);
+
+        void AddRef(Entry* e);
+        void Release(Entry* e);
+        void Erase(Entry* e);
+        void Dispatch();
+        void LoadJob();
+        size_t ReloadEntries(const std::vector<Entry*>& entries);
+        void Publish(Completion& c);
+        void PublishReload(Completion& c);
+        void Evict();
+
+        VFS*              Vfs = nullptr;
+        uint64_t          Budget = 512ull << 20;
+        uint32_t          MaxInFlight = 0;
+        uint64_t          Bytes = 0;
+        uint64_t          NextSeq = 0;
+        uint32_t          NextBatch = 1;
+        size_t            Pending = 0;          // requests and reloads not yet published
+        size_t            Resident = 0;
+        AssetManagerStats Counters;
+
+        std::unordered_map<std::string_view, std::unique_ptr<Entry>> Entries;    // views into Entry::Path
+        std::list<Entry*> Lru;                  // resident, unreferenced; front = most recent
+        std::vector<std::pair<Entry*, AssetLoadedFn>> Callbacks;   // due; each holds a reference
+        std::unordered_map<uint32_t, ReloadBatch> Batches;
+        std::vector<std::string> Reloaded;      // for OnReloaded at the end of Update()
+        AssetReloadedFn   OnReloaded;
+
+        // Shared with the loader jobs
+        mutable std::mutex Mutex;
+        std::set<QueueKey> Queue;               // not yet picked up
+        std::vector<Completion> Done;
+        std::array<AssetLoader, kAssetTypeCount> Loaders;
+        uint32_t           Jobs = 0;            // loader jobs running
+        JobCounter         JobsDone;
+    };
+}
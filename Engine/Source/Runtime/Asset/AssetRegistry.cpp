@@ -0,0 +1,754 @@
+﻿#include "Runtime/Asset/AssetRegistry.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/Core/StringTable.h"
+#include "Runtime/IO/VFS.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/MapBinary.h"
+#include "Runtime/World/World.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+
+namespace ace {
+    static_assert(std::endian::native == std::endian::little, "asset registry snapshots are little-endian only");
+
+    namespace {
+        // ---- snapshot format ----
+        //
+        //   SnapshotHeader
+        //   SnapshotRecord[AssetCount]
+        //   uint32 list[ListCount]      string indices: each record's tags, then its references
+        //   string table                (see StringTable), 8-byte aligned
+
+        constexpr char     kSnapshotMagic[8] = {'A','C','E','A','R','E','G','\x1A'};
+        // Bump when parsing rules change, so old snapshots are rescanned
+        constexpr uint32_t kSnapshotVersion  = 1;
+
+        struct SnapshotHeader {
+            char     Magic[8];
+            uint32_t Version;
+            uint32_t AssetCount;
+            uint32_t ListCount;
+            uint32_t StringCount;
+            uint64_t StringsOffset;
+            uint64_t FileSize;
+        };
+
+        struct SnapshotRecord {
+            uint64_t GuidHi, GuidLo;
+            uint64_t Size;
+            int64_t  ModifiedTime;
+            uint64_t ContentHash;
+            uint32_t Path;              // string index
+            uint32_t FirstList;
+            uint32_t TagCount;
+            uint32_t RefCount;
+            uint32_t Type;
+            uint32_t Reserved;
+        };
+
+        static_assert(sizeof(SnapshotHeader) == 40 && sizeof(SnapshotRecord) == 64);
+
+        struct ExtensionType { const char* Ext; AssetType Type; };
+        constexpr ExtensionType kExtensions[] = {
+            {".acemap", AssetType::Map},      {".blueprint", AssetType::Blueprint},
+            {".gamemode", AssetType::GameMode},
+            {".aceasset", AssetType::DataAsset}, {".asset", AssetType::DataAsset},
+            {".png", AssetType::Texture}, {".jpg", AssetType::Texture}, {".jpeg", AssetType::Texture},
+            {".tga", AssetType::Texture}, {".bmp", AssetType::Texture}, {".dds", AssetType::Texture},
+            {".hdr", AssetType::Texture},
+            {".obj", AssetType::Mesh}, {".fbx", AssetType::Mesh}, {".gltf", AssetType::Mesh}, {".glb", AssetType::Mesh},
+            {".wav", AssetType::Audio}, {".ogg", AssetType::Audio}, {".mp3", AssetType::Audio}, {".flac", AssetType::Audio},
+            {".glsl", AssetType::Shader}, {".vert", AssetType::Shader}, {".frag", AssetType::Shader},
+            {".geom", AssetType::Shader}, {".comp", AssetType::Shader}, {".hlsl", AssetType::Shader},
+            {".txt", AssetType::Text}, {".md", AssetType::Text}, {".json", AssetType::Text}, {".ini", AssetType::Text},
+            {".cfg", AssetType::Text}, {".csv", AssetType::Text}, {".xml", AssetType::Text},
+            {".h", AssetType::Source}, {".hpp", AssetType::Source}, {".hh", AssetType::Source}, {".c", AssetType::Source},
+            {".cpp", AssetType::Source}, {".cc", AssetType::Source}, {".cxx", AssetType::Source},
+        };
+
+        constexpr const char* kTypeNames[kAssetTypeCount] = {
+            "Unknown", "Map", "Blueprint", "GameMode", "Material", "DataAsset",
+            "Texture", "Mesh", "Audio", "Shader", "Text", "Source",
+        };
+
+        bool EqualsNoCase(std::string_view a, std::string_view b)
+        {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                char x = a[i], y = b[i];
+                if (x >= 'A' && x <= 'Z') x = (char)(x - 'A' + 'a');
+                if (y >= 'A' && y <= 'Z') y = (char)(y - 'A' + 'a');
+                if (x != y) return false;
+            }
+            return true;
+        }
+
+        // True if 'path' is 'folder' or lies below it ('folder' normalized)
+        bool UnderFolder(std::string_view path, std::string_view folder)
+        {
+            if (folder == "/") return true;
+            if (path.size() < folder.size() || path.compare(0, folder.size(), folder) != 0) return false;
+            return path.size() == folder.size() || path[folder.size()] == '/';
+        }
+
+        // ---- parsing ----
+
+        // Any string value naming something under the asset's own mount is a reference
+        void CollectJsonReferences(const nlohmann::json& j, std::string_view mountPrefix, std::vector<std::string>& out)
+        {
+            if (j.is_string()) {
+                const auto& s = j.get_ref<const std::string&>();
+                if (s.size() > mountPrefix.size() && s.compare(0, mountPrefix.size(), mountPrefix) == 0)
+                    out.push_back(VFS::Normalize(s));
+            } else if (j.is_structured()) {
+                for (const auto& v : j) CollectJsonReferences(v, mountPrefix, out);
+            }
+        }
+
+        void ParseJsonAsset(const VfsFile& file, AssetData& a, std::string_view mountPrefix, AssetGuid& declaredGuid)
+        {
+            const char* text = reinterpret_cast<const char*>(file.Data());
+            const nlohmann::json j = nlohmann::json::parse(text, text + file.Size(), nullptr, false);
+            if (!j.is_object()) return;
+
+            if (a.Type == AssetType::DataAsset) {
+                if (auto it = j.find("Type"); it != j.end() && it->is_string()) {
+                    const AssetType t = AssetTypeFromName(it->get_ref<const std::string&>());
+                    if (t != AssetType::Unknown) a.Type = t;
+                }
+            }
+            if (auto it = j.find("Guid"); it != j.end() && it->is_string())
+                AssetGuid::FromString(it->get_ref<const std::string&>(), declaredGuid);
+            if (auto it = j.find("Tags"); it != j.end() && it->is_array()) {
+                for (const auto& t : *it)
+                    if (t.is_string() && !t.get_ref<const std::string&>().empty()) a.Tags.push_back(t.get<std::string>());
+            }
+            CollectJsonReferences(j, mountPrefix, a.References);
+        }
+
+        void ParseBinaryMap(const VfsFile& file, AssetData& a)
+        {
+            MapBinaryView view;
+            if (!view.Open(file.Data(), file.Size())) return;
+            for (uint32_t i = 0; i < view.EntityCount(); ++i) {
+                view.ForEachComponent(i, [&](MapComponentKind kind, const uint8_t* payload, uint32_t size) {
+                    if (kind != MapComponentKind::StaticMesh || size < 2 * sizeof(uint32_t)) return;
+                    uint32_t ids[2];
+                    std::memcpy(ids, payload, sizeof(ids));
+                    for (uint32_t id : ids)
+                        if (std::string_view s = view.String(id); !s.empty()) a.References.push_back(VFS::Normalize(s));
+                });
+            }
+        }
+
+        // Fills everything but Guid, Path and ModifiedTime
+        void ParseAsset(const VfsFile& file, AssetData& a, AssetGuid& declaredGuid)
+        {
+            a.Size = file.Size();
+            a.ContentHash = Hash64(file.Data(), file.Size());
+            a.Type = AssetTypeFromPath(std::string_view(a.Path));
+            a.Tags.clear();
+            a.References.clear();
+
+            // "/Game/Maps/A.acemap" -> "/Game/"
+            const std::string_view mountPrefix = std::string_view(a.Path).substr(0, a.Path.find('/', 1) + 1);
+            switch (a.Type) {
+            case AssetType::Map:
+                if (DetectMapFormat(file.Data(), file.Size()) == MapFileFormat::Binary) ParseBinaryMap(file, a);
+                else ParseJsonAsset(file, a, mountPrefix, declaredGuid);
+                break;
+            case AssetType::Blueprint:
+            case AssetType::GameMode:
+            case AssetType::DataAsset:
+                ParseJsonAsset(file, a, mountPrefix, declaredGuid);
+                break;
+            default:
+                break;
+            }
+
+            std::sort(a.References.begin(), a.References.end());
+            a.References.erase(std::unique(a.References.begin(), a.References.end()), a.References.end());
+            if (auto self = std::find(a.References.begin(), a.References.end(), a.Path); self != a.References.end())
+                a.References.erase(self);
+        }
+    }
+
+    // ---- AssetType / AssetGuid ----
+
+    const char* AssetTypeName(AssetType type)
+    {
+        return (size_t)type < kAssetTypeCount ? kTypeNames[(size_t)type] : "Unknown";
+    }
+
+    AssetType AssetTypeFromName(std::string_view name)
+    {
+        for (size_t i = 1; i < kAssetTypeCount; ++i)
+            if (EqualsNoCase(name, kTypeNames[i])) return (AssetType)i;
+        return AssetType::Unknown;
+    }
+
+    AssetType AssetTypeFromPath(std::string_view path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        const std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+        const size_t dot = name.find_last_of('.');
+        if (dot == std::string_view::npos || dot == 0) return AssetType::Unknown;
+        const std::string_view ext = name.substr(dot);
+        for (const auto& e : kExtensions)
+            if (EqualsNoCase(ext, e.Ext)) return e.Type;
+        return AssetType::Unknown;
+    }
+
+    AssetType AssetTypeFromPath(const std::filesystem::path& path)
+    {
+        const std::u8string ext = path.extension().u8string();
+        return AssetTypeFromPath(std::string_view(reinterpret_cast<const char*>(ext.data()), ext.size()));
+    }
+
+    AssetGuid AssetGuid::Generate()
+    {
+        thread_local std::mt19937_64 rng = [] {
+            std::random_device rd;
+            std::seed_seq seq{rd(), rd(), rd(), rd(),
+                              (unsigned)std::chrono::high_resolution_clock::now().time_since_epoch().count()};
+            return std::mt19937_64(seq);
+        }();
+        AssetGuid g;
+        do { g.Hi = rng(); g.Lo = rng(); } while (!g.IsValid());
+        return g;
+    }
+
+    std::string AssetGuid::ToString() const
+    {
+        return HashToHex(Hi) + HashToHex(Lo);
+    }
+
+    bool AssetGuid::FromString(std::string_view s, AssetGuid& out)
+    {
+        // Also takes the dashed/braced "{8-4-4-4-12}" form
+        char hex[32];
+        size_t n = 0;
+        for (char c : s) {
+            if (c == '-' || c == '{' || c == '}') continue;
+            if (n == sizeof(hex)) return false;
+            hex[n++] = c;
+        }
+        AssetGuid g;
+        if (n != sizeof(hex) || !HashFromHex({hex, 16}, g.Hi) || !HashFromHex({hex + 16, 16}, g.Lo) || !g.IsValid())
+            return false;
+        out = g;
+        return true;
+    }
+
+    // ---- AssetRegistry ----
+
+    void AssetRegistry::Clear()
+    {
+        Assets.clear();
+        Graph.Clear();
+        RebuildIndex();
+        ++Rev;
+    }
+
+    AssetScanStats AssetRegistry::Scan(std::string_view root)
+    {
+        return Scan(std::vector<std::string>{std::string(root)});
+    }
+
+    AssetScanStats AssetRegistry::Scan(const std::vector<std::string>& roots)
+    {
+        ACE_PROFILE_FUNCTION();
+        const auto t0 = std::chrono::steady_clock::now();
+        AssetScanStats stats;
+        VFS& vfs = Vfs ? *Vfs : VFS::Get();
+
+        // Shortest first, so a root inside an already kept one is dropped
+        std::vector<std::string> scopes;
+        scopes.reserve(roots.size());
+        for (const auto& r : roots) scopes.push_back(VFS::Normalize(r));
+        std::sort(scopes.begin(), scopes.end(), [](const std::string& a, const std::string& b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+        std::unordered_set<std::string_view> scopeSet;
+        const auto inScope = [&](std::string_view path) {
+            if (scopeSet.count("/")) return true;
+            for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+                if (scopeSet.count(path.substr(0, slash))) return true;
+                if (slash == std::string_view::npos) return false;
+            }
+        };
+        std::vector<std::string_view> kept;
+        for (const auto& s : scopes) {
+            if (inScope(s)) continue;
+            scopeSet.insert(s);
+            kept.push_back(s);
+        }
+
+        // 1) What is there now: one listing per folder, no file is opened
+        struct Found { std::string Path; uint64_t Size; int64_t Time; };
+        std::vector<Found> found;
+        std::vector<std::string> dirs;
+        std::vector<VfsEntry> list;
+        for (const std::string_view scope : kept) {
+            VfsEntry e;
+            if (!vfs.Stat(scope, e)) continue;
+            if (!e.IsDir) { found.push_back({std::string(scope), e.Size, e.ModifiedTime}); continue; }
+            dirs.emplace_back(scope);
+            while (!dirs.empty()) {
+                const std::string dir = std::move(dirs.back());
+                dirs.pop_back();
+                list.clear();
+                vfs.List(dir, list);
+                for (auto& c : list) {
+                    std::string p = dir == "/" ? "/" + c.Name : dir + "/" + c.Name;
+                    if (c.IsDir) dirs.push_back(std::move(p));
+                    else         found.push_back({std::move(p), c.Size, c.ModifiedTime});
+                }
+            }
+        }
+        stats.Files = found.size();
+
+        // 2) Compare with the registry; only changed or new files are opened
+        std::vector<uint8_t> seen(Assets.size(), 0);
+        struct Work { size_t Found; uint32_t Old; AssetData Data; AssetGuid Declared; bool Ok = false; };
+        std::vector<Work> work;
+        for (size_t i = 0; i < found.size(); ++i) {
+            const auto it = PathIndex.find(found[i].Path);
+            const uint32_t old = it != PathIndex.end() ? it->second : ~0u;
+            if (old != ~0u) {
+                seen[old] = 1;
+                const AssetData& a = Assets[old];
+                if (a.Size == found[i].Size && a.ModifiedTime == found[i].Time) { ++stats.Unchanged; continue; }
+            }
+            work.push_back({i, old, {}, {}, false});
+        }
+
+        JobSystem::Get().ParallelFor(work.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                Work& w = work[i];
+                VfsFile file;
+                if (!vfs.Open(found[w.Found].Path, file)) continue;    // vanished since the listing
+                w.Data.Path = found[w.Found].Path;
+                w.Data.ModifiedTime = found[w.Found].Time;
+                ParseAsset(file, w.Data, w.Declared);
+                w.Ok = true;
+            }
+        }, 8);
+
+        // 3) GUIDs: declared in the file, else kept from the same path, else
+        // inherited from a vanished asset with identical contents (a rename
+        // or move), else new
+        std::unordered_multimap<uint64_t, uint32_t> vanished;
+        for (uint32_t i = 0; i < (uint32_t)Assets.size(); ++i) {
+            if (!seen[i] && inScope(Assets[i].Path)) {
+                vanished.emplace(Assets[i].ContentHash, i);
+                ++stats.Removed;
+            }
+        }
+        for (Work& w : work) {
+            if (!w.Ok) continue;
+            if (w.Declared.IsValid()) {
+                w.Data.Guid = w.Declared;
+            } else if (w.Old != ~0u) {
+                w.Data.Guid = Assets[w.Old].Guid;
+            } else {
+                const auto [lo, hi] = vanished.equal_range(w.Data.ContentHash);
+                for (auto it = lo; it != hi; ++it) {
+                    if (Assets[it->second].Size == w.Data.Size && Assets[it->second].Type == w.Data.Type) {
+                        w.Data.Guid = Assets[it->second].Guid;
+                        vanished.erase(it);
+                        break;
+                    }
+                }
+                if (!w.Data.Guid.IsValid()) w.Data.Guid = AssetGuid::Generate();
+            }
+            ++(w.Old != ~0u ? stats.Updated : stats.Added);
+        }
+        // A changed file that failed to open is dropped as well
+        for (const Work& w : work)
+            if (!w.Ok && w.Old != ~0u) { seen[w.Old] = 0; ++stats.Removed; }
+
+        if (stats.Added || stats.Updated || stats.Removed) {
+            std::vector<AssetDependencyGraph::Update> updates;
+            for (uint32_t i = 0; i < (uint32_t)Assets.size(); ++i)
+                if (!seen[i] && inScope(Assets[i].Path)) updates.push_back({Assets[i].Path, nullptr});
+            for (const Work& w : work)
+                if (w.Ok) updates.push_back({w.Data.Path, &w.Data.References});
+            Graph.Apply(updates);
+
+            std::vector<uint8_t> replaced(Assets.size(), 0);
+            for (const Work& w : work)
+                if (w.Old != ~0u) replaced[w.Old] = 1;
+
+            std::vector<AssetData> next;
+            next.reserve(Assets.size() + stats.Added);
+            for (size_t i = 0; i < Assets.size(); ++i) {
+                const bool keep = !inScope(Assets[i].Path) || (seen[i] && !replaced[i]);
+                if (keep) next.push_back(std::move(Assets[i]));
+            }
+            for (Work& w : work)
+                if (w.Ok) next.push_back(std::move(w.Data));
+            Assets = std::move(next);
+            RebuildIndex();
+            ++Rev;
+        }
+
+        stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return stats;
+    }
+
+    void AssetRegistry::RebuildIndex()
+    {
+        ACE_PROFILE_FUNCTION();
+        ByPath.resize(Assets.size());
+        for (uint32_t i = 0; i < (uint32_t)Assets.size(); ++i) ByPath[i] = i;
+        std::sort(ByPath.begin(), ByPath.end(), [&](uint32_t a, uint32_t b) { return Assets[a].Path < Assets[b].Path; });
+
+        PathIndex.clear();
+        GuidIndex.clear();
+        TagIndex.clear();
+        PathIndex.reserve(Assets.size());
+        GuidIndex.reserve(Assets.size());
+        for (auto& v : TypeIndex) v.clear();
+
+        for (uint32_t i : ByPath) {
+            const AssetData& a = Assets[i];
+            PathIndex.emplace(a.Path, i);
+            if (!GuidIndex.emplace(a.Guid, i).second)
+                ACE_LOG_WARN("Assets", "%s has the same GUID as %s (copied file?)",
+                             a.Path.c_str(), Assets[GuidIndex[a.Guid]].Path.c_str());
+            TypeIndex[(size_t)a.Type].push_back(i);
+            for (const auto& t : a.Tags) {
+                auto& list = TagIndex[t];
+                if (list.empty() || list.back() != i) list.push_back(i);
+            }
+        }
+    }
+
+    const AssetData* AssetRegistry::Find(std::string_view path) const
+    {
+        const auto it = PathIndex.find(path);
+        return it != PathIndex.end() ? &Assets[it->second] : nullptr;
+    }
+
+    const AssetData* AssetRegistry::Find(const AssetGuid& guid) const
+    {
+        const auto it = GuidIndex.find(guid);
+        return it != GuidIndex.end() ? &Assets[it->second] : nullptr;
+    }
+
+    void AssetRegistry::Query(const AssetQuery& q, std::vector<const AssetData*>& out) const
+    {
+        std::string folder;
+        if (!q.PathPrefix.empty()) folder = VFS::Normalize(q.PathPrefix);
+
+        // Walk the most selective index, filter by the rest
+        const std::vector<uint32_t>* candidates = &ByPath;
+        size_t first = 0, last = ByPath.size();
+        if (!q.Tag.empty()) {
+            const auto it = TagIndex.find(q.Tag);
+            if (it == TagIndex.end()) return;
+            candidates = &it->second;
+            last = candidates->size();
+        } else if (q.Type != AssetType::Unknown) {
+            candidates = &TypeIndex[(size_t)q.Type];
+            last = candidates->size();
+        } else if (!folder.empty() && folder != "/") {
+            // Paths under "/A/B" sort in one run starting at "/A/B/"
+            const std::string start = folder + '/';
+            const auto lo = std::lower_bound(ByPath.begin(), ByPath.end(), start,
+                                             [&](uint32_t i, const std::string& s) { return Assets[i].Path < s; });
+            first = (size_t)(lo - ByPath.begin());
+            last = first;
+            while (last < ByPath.size() && Assets[ByPath[last]].Path.compare(0, start.size(), start) == 0) ++last;
+        }
+
+        for (size_t k = first; k < last; ++k) {
+            const AssetData& a = Assets[(*candidates)[k]];
+            if (q.Type != AssetType::Unknown && a.Type != q.Type) continue;
+            if (!folder.empty() && (a.Path == folder || !UnderFolder(a.Path, folder))) continue;
+            if (!q.Tag.empty() && std::find(a.Tags.begin(), a.Tags.end(), q.Tag) == a.Tags.end()) continue;
+            out.push_back(&a);
+        }
+    }
+
+    // ---- snapshot ----
+
+    bool AssetRegistry::SaveSnapshot(const std::filesystem::path& path) const
+    {
+        ACE_PROFILE_FUNCTION();
+        StringTable strings;
+        std::vector<SnapshotRecord> records(Assets.size());
+        std::vector<uint32_t> lists;
+        for (size_t i = 0; i < Assets.size(); ++i) {
+            const AssetData& a = Assets[i];
+            SnapshotRecord& r = records[i];
+            r = SnapshotRecord{};
+            r.GuidHi = a.Guid.Hi;
+            r.GuidLo = a.Guid.Lo;
+            r.Size = a.Size;
+            r.ModifiedTime = a.ModifiedTime;
+            r.ContentHash = a.ContentHash;
+            r.Path = strings.Intern(a.Path);
+            r.FirstList = (uint32_t)lists.size();
+            r.TagCount = (uint32_t)a.Tags.size();
+            r.RefCount = (uint32_t)a.References.size();
+            r.Type = (uint32_t)a.Type;
+            for (const auto& t : a.Tags)       lists.push_back(strings.Intern(t));
+            for (const auto& s : a.References) lists.push_back(strings.Intern(s));
+        }
+
+        SnapshotHeader h{};
+        std::memcpy(h.Magic, kSnapshotMagic, sizeof(h.Magic));
+        h.Version = kSnapshotVersion;
+        h.AssetCount = (uint32_t)records.size();
+        h.ListCount = (uint32_t)lists.size();
+        h.StringCount = strings.Count();
+        const uint64_t listsOffset = sizeof(h) + records.size() * sizeof(SnapshotRecord);
+        h.StringsOffset = (listsOffset + lists.size() * sizeof(uint32_t) + 7) & ~uint64_t(7);
+        h.FileSize = h.StringsOffset + strings.ByteSize();
+
+        std::vector<uint8_t> bytes(h.FileSize, 0);
+        std::memcpy(bytes.data(), &h, sizeof(h));
+        if (!records.empty()) std::memcpy(bytes.data() + sizeof(h), records.data(), records.size() * sizeof(SnapshotRecord));
+        if (!lists.empty())   std::memcpy(bytes.data() + listsOffset, lists.data(), lists.size() * sizeof(uint32_t));
+        strings.Write(bytes, h.StringsOffset);
+        return WriteFileAtomic(path, bytes.data(), bytes.size());
+    }
+
+    bool AssetRegistry::LoadSnapshot(const std::filesystem::path& path)
+    {
+        ACE_PROFILE_FUNCTION();
+        Assets.clear();
+        Graph.Clear();
+        RebuildIndex();
+        ++Rev;
+
+        MappedFile file;
+        if (!file.Open(path) || file.Size() < sizeof(SnapshotHeader)) return false;
+        const uint8_t* base = file.Data();
+        const uint64_t size = file.Size();
+        const auto* h = reinterpret_cast<const SnapshotHeader*>(base);
+        if (std::memcmp(h->Magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) return false;
+        if (h->Version != kSnapshotVersion || h->FileSize != size || h->StringCount == 0) return false;
+
+        const uint64_t listsOffset = sizeof(SnapshotHeader) + uint64_t(h->AssetCount) * sizeof(SnapshotRecord);
+        if (!InRange(sizeof(SnapshotHeader), listsOffset - sizeof(SnapshotHeader), size)) return false;
+        if (!InRange(listsOffset, uint64_t(h->ListCount) * sizeof(uint32_t), size)) return false;
+        if (h->StringsOffset < listsOffset + uint64_t(h->ListCount) * sizeof(uint32_t) || h->StringsOffset % 8) return false;
+        const uint64_t offsetBytes = (uint64_t(h->StringCount) + 1) * sizeof(uint32_t);
+        if (!InRange(h->StringsOffset, offsetBytes, size)) return false;
+
+        const auto* offsets = reinterpret_cast<const uint32_t*>(base + h->StringsOffset);
+        const char* chars = reinterpret_cast<const char*>(base + h->StringsOffset + offsetBytes);
+        const uint64_t charCount = size - h->StringsOffset - offsetBytes;
+        for (uint32_t i = 0; i < h->StringCount; ++i)
+            if (offsets[i] > offsets[i + 1]) return false;
+        if (offsets[0] != 0 || offsets[h->StringCount] > charCount) return false;
+        auto str = [&](uint32_t i) { return std::string(chars + offsets[i], offsets[i + 1] - offsets[i]); };
+
+        const auto* records = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader));
+        const auto* lists = reinterpret_cast<const uint32_t*>(base + listsOffset);
+        for (uint32_t i = 0; i < h->ListCount; ++i)
+            if (lists[i] >= h->StringCount) return false;
+
+        std::vector<AssetData> assets(h->AssetCount);
+        for (uint32_t i = 0; i < h->AssetCount; ++i) {
+            const SnapshotRecord& r = records[i];
+            if (r.Path >= h->StringCount || r.Type >= kAssetTypeCount) return false;
+            if (uint64_t(r.FirstList) + r.TagCount + r.RefCount > h->ListCount) return false;
+            AssetData& a = assets[i];
+            a.Guid = AssetGuid{r.GuidHi, r.GuidLo};
+            a.Path = str(r.Path);
+            a.Type = (AssetType)r.Type;
+            a.Size = r.Size;
+            a.ModifiedTime = r.ModifiedTime;
+            a.ContentHash = r.ContentHash;
+            a.Tags.reserve(r.TagCount);
+            a.References.reserve(r.RefCount);
+            const uint32_t* l = lists + r.FirstList;
+            for (uint32_t k = 0; k < r.TagCount; ++k) a.Tags.push_back(str(l[k]));
+            for (uint32_t k = 0; k < r.RefCount; ++k) a.References.push_back(str(l[r.TagCount + k]));
+        }
+
+        Assets = std::move(assets);
+        RebuildIndex();
+        std::vector<AssetDependencyGraph::Update> updates;
+        updates.reserve(Assets.size());
+        for (const AssetData& a : Assets) updates.push_back({a.Path, &a.References});
+        Graph.Apply(updates);
+        return true;
+    }
+
+    // ---- moves ----
+
+    void AssetRegistry::Rename(const std::vector<AssetRename>& renames, std::vector<std::string>* moved)
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<std::pair<uint32_t, std::string>> targets;     // record, new path
+        for (const AssetRename& r : renames) {
+            const std::string from = VFS::Normalize(r.From);
+            const std::string to = VFS::Normalize(r.To);
+            if (from == to) continue;
+            if (const auto it = PathIndex.find(from); it != PathIndex.end()) {
+                targets.push_back({it->second, to});
+                continue;
+            }
+            // A folder: its records are one run of ByPath
+            const std::string start = from + '/';
+            auto k = std::lower_bound(ByPath.begin(), ByPath.end(), start,
+                                      [&](uint32_t i, const std::string& s) { return Assets[i].Path < s; });
+            for (; k != ByPath.end() && Assets[*k].Path.compare(0, start.size(), start) == 0; ++k)
+                targets.push_back({*k, to + Assets[*k].Path.substr(from.size())});
+        }
+        if (targets.empty()) return;
+
+        // A record already at a destination was overwritten by the move;
+        // Graph.Rename() merges its node into the moved one
+        std::vector<uint8_t> drop(Assets.size(), 0);
+        for (const auto& [i, path] : targets)
+            if (const auto it = PathIndex.find(path); it != PathIndex.end()) drop[it->second] = 1;
+        for (auto& [i, path] : targets) {
+            drop[i] = 0;
+            Graph.Rename(Assets[i].Path, path);
+            if (moved) moved->push_back(path);
+            Assets[i].Path = std::move(path);
+        }
+        std::vector<AssetData> next;
+        next.reserve(Assets.size());
+        for (uint32_t i = 0; i < (uint32_t)Assets.size(); ++i)
+            if (!drop[i]) next.push_back(std::move(Assets[i]));
+        Assets = std::move(next);
+        RebuildIndex();
+        ++Rev;
+    }
+
+    namespace {
+        using RenameMap = std::unordered_map<std::string_view, std::string_view>;
+
+        // New path for 'path' if it or one of its folders was moved
+        bool MapRenamed(const RenameMap& renames, std::string_view path, std::string& out)
+        {
+            size_t end = path.size();
+            while (end != 0 && end != std::string_view::npos) {
+                if (const auto it = renames.find(path.substr(0, end)); it != renames.end()) {
+                    out.assign(it->second);
+                    out.append(path.substr(end));
+                    return true;
+                }
+                end = path.rfind('/', end - 1);
+            }
+            return false;
+        }
+
+        // Replaces the string values that name moved assets and copies every
+        // other byte through, so hand-authored layout, key order and escapes
+        // survive. 'text' must already be valid JSON.
+        bool RewriteJsonText(std::string_view text, const RenameMap& renames, std::vector<uint8_t>& out)
+        {
+            bool changed = false;
+            size_t copied = 0;
+            std::string decoded, to;
+            for (size_t i = 0; i < text.size(); ++i) {
+                if (text[i] != '"') continue;
+                const size_t open = i;
+                bool escaped = false;
+                for (++i; i < text.size() && text[i] != '"'; ++i)
+                    if (text[i] == '\\') { escaped = true; ++i; }
+                if (i >= text.size()) break;
+                // Object keys are not references
+                size_t next = i + 1;
+                while (next < text.size() && (text[next] == ' ' || text[next] == '\t' || text[next] == '\n' || text[next] == '\r')) ++next;
+                if (next < text.size() && text[next] == ':') continue;
+
+                const std::string_view quoted = text.substr(open, i + 1 - open);
+                std::string_view value = quoted.substr(1, quoted.size() - 2);
+                if (escaped) {
+                    const nlohmann::json v = nlohmann::json::parse(quoted, nullptr, false);
+                    if (!v.is_string()) continue;
+                    decoded = v.get<std::string>();
+                    value = decoded;
+                }
+                if (value.empty() || value[0] != '/' || !MapRenamed(renames, VFS::Normalize(value), to)) continue;
+                const std::string encoded = nlohmann::json(to).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+                out.insert(out.end(), text.begin() + copied, text.begin() + open);
+                out.insert(out.end(), encoded.begin(), encoded.end());
+                copied = i + 1;
+                changed = true;
+            }
+            if (changed) out.insert(out.end(), text.begin() + copied, text.end());
+            return changed;
+        }
+
+        bool RewriteFile(const std::filesystem::path& native, const RenameMap& renames, bool& changed)
+        {
+            changed = false;
+            std::vector<uint8_t> bytes;
+            {
+                std::ifstream in(native, std::ios::binary);
+                if (!in) return false;
+                bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+
+            std::vector<uint8_t> out;
+            if (DetectMapFormat(bytes.data(), bytes.size()) == MapFileFormat::Binary) {
+                World world;
+                if (!LoadMapBinary(world, bytes.data(), bytes.size())) return false;
+                std::string to;
+                auto fixup = [&](StaticMeshComponent& c) {
+                    for (std::string* s : {&c.Mesh, &c.Material})
+                        if (!s->empty() && MapRenamed(renames, VFS::Normalize(*s), to)) { *s = std::move(to); changed = true; }
+                };
+                world.Each<StaticMeshComponent>([&](Entity, StaticMeshComponent& c) { fixup(c); });
+                world.Each<ExtraStaticMeshComponent>([&](Entity, ExtraStaticMeshComponent& c) {
+                    for (auto& sm : c.Meshes) fixup(sm);
+                });
+                if (changed) WriteMapBinary(world, out);
+            } else {
+                const std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+                if (!nlohmann::json::accept(text)) return false;
+                changed = RewriteJsonText(text, renames, out);
+            }
+            return !changed || WriteFileAtomic(native, out.data(), out.size());
+        }
+    }
+
+    bool RewriteAssetReferences(const std::vector<std::filesystem::path>& files, const std::vector<AssetRename>& renames,
+                                std::vector<std::filesystem::path>& changed)
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<std::pair<std::string, std::string>> normalized;
+        normalized.reserve(renames.size());
+        for (const AssetRename& r : renames) normalized.push_back({VFS::Normalize(r.From), VFS::Normalize(r.To)});
+        RenameMap map;
+        for (const auto& [from, to] : normalized) map[from] = to;
+
+        std::vector<uint8_t> ok(files.size(), 0), wrote(files.size(), 0);
+        JobSystem::Get().ParallelFor(files.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                bool c = false;
+                ok[i] = RewriteFile(files[i], map, c);
+                wrote[i] = c;
+            }
+        }, 4);
+
+        bool all = true;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!ok[i]) { all = false; ACE_LOG_WARN("Assets", "%s: cannot update references", files[i].string().c_str()); }
+            else if (wrote[i]) changed.push_back(files[i]);
+        }
+        return all;
+    }
+}
@@ -0,0 +1,160 @@
+﻿#pragma once
+#include "Runtime/Asset/AssetDependencyGraph.h"
+#include "Runtime/Core/Hash.h"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    class VFS;
+
+    enum class AssetType : uint8_t {
+        Unknown,
+        Map,            // .acemap
+        Blueprint,      // .blueprint, or .aceasset with "Type":"Blueprint"
+        GameMode,       // .gamemode, or .aceasset with "Type":"GameMode"
+        Material,       // .aceasset with "Type":"Material"
+        DataAsset,      // other .aceasset / .asset
+        Texture,
+        Mesh,
+        Audio,
+        Shader,
+        Text,
+        Source,
+        Count
+    };
+
+    inline constexpr size_t kAssetTypeCount = (size_t)AssetType::Count;
+
+    const char* AssetTypeName(AssetType type);
+    AssetType   AssetTypeFromName(std::string_view name);          // "Map" -> Map; Unknown otherwise
+    // By extension only (case-insensitive); ".aceasset" is DataAsset until its
+    // "Type" field has been read
+    AssetType   AssetTypeFromPath(const std::filesystem::path& path);
+    AssetType   AssetTypeFromPath(std::string_view path);
+
+    // 128-bit asset id. Assigned once and kept across edits, renames and moves.
+    struct AssetGuid {
+        uint64_t Hi = 0, Lo = 0;
+
+        bool IsValid() const { return Hi | Lo; }
+        bool operator==(const AssetGuid&) const = default;
+
+        static AssetGuid Generate();
+        std::string      ToString() const;                          // 32 hex digits
+        static bool      FromString(std::string_view s, AssetGuid& out);
+    };
+
+    struct AssetData {
+        AssetGuid   Guid;
+        std::string Path;                       // virtual, e.g. "/Game/Maps/Start.acemap"
+        AssetType   Type = AssetType::Unknown;
+        uint64_t    Size = 0;
+        int64_t     ModifiedTime = 0;           // VfsEntry::ModifiedTime at scan time
+        uint64_t    ContentHash = 0;            // Hash64 of the bytes
+        std::vector<std::string> Tags;          // JSON "Tags"
+        std::vector<std::string> References;    // sorted, unique virtual paths this asset uses
+    };
+
+    // Every filter that is set must match
+    struct AssetQuery {
+        AssetType        Type = AssetType::Unknown;     // Unknown = any
+        std::string_view Tag;                           // empty = any
+        std::string_view PathPrefix;                    // folder, e.g. "/Game/Maps"; empty = any
+    };
+
+    // Old and new virtual path of a moved file or folder
+    struct AssetRename {
+        std::string From;
+        std::string To;
+    };
+
+    struct AssetScanStats {
+        size_t Files = 0;           // files seen under the scanned root
+        size_t Unchanged = 0;       // size and mtime matched: not opened
+        size_t Added = 0;
+        size_t Updated = 0;
+        size_t Removed = 0;
+        double Seconds = 0.0;
+    };
+
+    // Database of the assets under a VFS folder (normally /Game): type, size,
+    // content hash, tags and outgoing references, indexed by path, GUID, type
+    // and tag.
+    //
+    // Scan() stats every file but only opens the ones whose size or mtime
+    // differ from the registry, parsing those in parallel on the job system.
+    // Loading a snapshot first makes reopening a large project cost one
+    // directory walk. Not thread-safe: build on one thread, then hand over.
+    class AssetRegistry {
+    public:
+        // Reconciles everything at or below 'root' (a folder or a single file)
+        // with the VFS; records outside 'root' are untouched.
+        AssetScanStats Scan(std::string_view root);
+        // Same for several roots in one pass, e.g. a batch of file-change
+        // events; roots inside other roots are folded in.
+        AssetScanStats Scan(const std::vector<std::string>& roots);
+        void Clear();
+
+        // Re-keys the records of files that were renamed or moved on disk
+        // (a From folder moves everything below it), keeping their GUIDs and
+        // dependency edges even when a later Scan() finds the content
+        // changed. Call before that Scan(). Appends each moved record's new
+        // path to 'moved'.
+        void Rename(const std::vector<AssetRename>& renames, std::vector<std::string>* moved = nullptr);
+
+        // File system Scan() reads from; null (the default) is VFS::Get().
+        // Tools that must not see the editor's mounts pass their own.
+        void SetVfs(VFS* vfs) { Vfs = vfs; }
+
+        // Compact binary snapshot. Load replaces the registry; on failure
+        // (missing, corrupt, other version) the registry is left empty.
+        bool SaveSnapshot(const std::filesystem::path& path) const;
+        bool LoadSnapshot(const std::filesystem::path& path);
+
+        size_t           Count() const { return Assets.size(); }
+        const AssetData& At(size_t i) const { return Assets[i]; }
+        const AssetData* Find(std::string_view path) const;
+        const AssetData* Find(const AssetGuid& guid) const;
+        // Appends matches in path order
+        void Query(const AssetQuery& q, std::vector<const AssetData*>& out) const;
+
+        // Reverse references, kept current by Scan(), Rename() and LoadSnapshot()
+        const AssetDependencyGraph& Dependencies() const { return Graph; }
+
+        // Bumped whenever the contents change, for callers caching results
+        uint64_t Revision() const { return Rev; }
+
+    private:
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+        };
+
+        void RebuildIndex();
+
+        std::vector<AssetData> Assets;
+        uint64_t               Rev = 0;
+        VFS*                   Vfs = nullptr;
+        AssetDependencyGraph   Graph;
+
+        // Indices into Assets; rebuilt after every change
+        std::vector<uint32_t> ByPath;                                       // sorted by Path
+        std::unordered_map<std::string_view, uint32_t> PathIndex;           // views into Assets[i].Path
+        std::unordered_map<AssetGuid, uint32_t, Hash128> GuidIndex;
+        std::array<std::vector<uint32_t>, kAssetTypeCount> TypeIndex;       // path order
+        std::unordered_map<std::string, std::vector<uint32_t>, StringHash, std::equal_to<>> TagIndex;
+    };
+
+    // Points the references in 'files' (native paths of referrers of moved
+    // assets) at the new locations: JSON string values and binary-map mesh
+    // and material paths. Files are processed in parallel and written only
+    // if something changed; those are appended to 'changed'. False if any
+    // file could not be read, parsed or written.
+    bool RewriteAssetReferences(const std::vector<std::filesystem::path>& files, const std::vector<AssetRename>& renames,
+                                std::vector<std::filesystem::path>& changed);
+}
@@ -0,0 +1,50 @@
+﻿#include "Runtime/Asset/CookedAsset.h"
+#include "Runtime/Core/Hash.h"
+#include <bit>
+#include <cstring>
+
+namespace ace {
+    static_assert(std::endian::native == std::endian::little, "cooked assets are little-endian only");
+    static_assert(sizeof(CookedAssetHeader) == 48);
+
+    bool IsCookedAsset(const uint8_t* data, size_t size)
+    {
+        return size >= sizeof(CookedAssetHeader) && std::memcmp(data, kCookedAssetMagic, sizeof(kCookedAssetMagic)) == 0;
+    }
+
+    void WriteCookedAsset(AssetType type, const AssetGuid& guid, const nlohmann::json& j, std::vector<uint8_t>& out)
+    {
+        const std::vector<uint8_t> payload = nlohmann::json::to_cbor(j);
+
+        CookedAssetHeader h{};
+        std::memcpy(h.Magic, kCookedAssetMagic, sizeof(h.Magic));
+        h.Version     = kCookedAssetVersion;
+        h.Type        = (uint32_t)type;
+        h.GuidHi      = guid.Hi;
+        h.GuidLo      = guid.Lo;
+        h.PayloadSize = payload.size();
+        h.PayloadHash = Hash64(payload.data(), payload.size());
+
+        out.resize(sizeof(h) + payload.size());
+        std::memcpy(out.data(), &h, sizeof(h));
+        if (!payload.empty()) std::memcpy(out.data() + sizeof(h), payload.data(), payload.size());
+    }
+
+    bool ReadCookedAsset(const uint8_t* data, size_t size, AssetType& type, AssetGuid& guid, nlohmann::json& out)
+    {
+        if (!IsCookedAsset(data, size)) return false;
+        CookedAssetHeader h;
+        std::memcpy(&h, data, sizeof(h));
+        const uint8_t* payload = data + sizeof(h);
+        if (h.Version != kCookedAssetVersion || h.Type >= kAssetTypeCount || h.PayloadSize != size - sizeof(h) ||
+            Hash64(payload, (size_t)h.PayloadSize) != h.PayloadHash)
+            return false;
+
+        nlohmann::json j = nlohmann::json::from_cbor(payload, payload + h.PayloadSize, true, false);
+        if (j.is_discarded()) return false;
+        type = (AssetType)h.Type;
+        guid = { h.GuidHi, h.GuidLo };
+        out  = std::move(j);
+        return true;
+    }
+}
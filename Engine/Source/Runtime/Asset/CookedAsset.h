@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "Runtime/Asset/AssetRegistry.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace ace {
+    // Cooked JSON asset (blueprints, game modes, materials, data assets), as
+    // written by ACECook under the asset's original name (little-endian):
+    //
+    //   CookedAssetHeader
+    //   payload           CBOR encoding of the asset's JSON, editor-only
+    //                     fields (graph layout, id counters) removed
+    //
+    // Maps cook to the binary .acemap format instead (see MapBinary.h).
+
+    inline constexpr char     kCookedAssetMagic[8] = {'A','C','E','C','O','O','K','\x1A'};
+    inline constexpr uint32_t kCookedAssetVersion  = 1;
+
+    struct CookedAssetHeader {
+        char     Magic[8];
+        uint32_t Version;
+        uint32_t Type;              // AssetType
+        uint64_t GuidHi;
+        uint64_t GuidLo;
+        uint64_t PayloadSize;
+        uint64_t PayloadHash;       // Hash64 of the payload
+    };
+
+    bool IsCookedAsset(const uint8_t* data, size_t size);
+
+    void WriteCookedAsset(AssetType type, const AssetGuid& guid, const nlohmann::json& j, std::vector<uint8_t>& out);
+    // Validates the header and payload hash; false on anything unexpected
+    bool ReadCookedAsset(const uint8_t* data, size_t size, AssetType& type, AssetGuid& guid, nlohmann::json& out);
+}
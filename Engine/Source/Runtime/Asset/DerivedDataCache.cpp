@@ -0,0 +1,372 @@
+﻿#include "Runtime/Asset/DerivedDataCache.h"
+#include "Runtime/Asset/AssetRegistry.h"
+#include "Runtime/Core/Compression.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+namespace ace {
+    static_assert(std::endian::native == std::endian::little, ".ddc is little-endian only");
+    static_assert(sizeof(DdcFileHeader) == 48);
+
+    namespace {
+        constexpr uint64_t kSeedHi = 0x243F6A8885A308D3ull;
+        constexpr uint64_t kSeedLo = 0x13198A2E03707344ull;
+
+        using FileTime = std::filesystem::file_time_type;
+
+        int64_t Now() { return (int64_t)FileTime::clock::now().time_since_epoch().count(); }
+
+        int64_t Ticks(std::chrono::minutes m)
+        {
+            return (int64_t)std::chrono::duration_cast<FileTime::duration>(m).count();
+        }
+
+        // Hits rewrite the mtime at most this often; temp files older than
+        // kStaleTemp were left behind by a crashed writer
+        const int64_t kTouchInterval = Ticks(std::chrono::minutes(10));
+        const int64_t kStaleTemp     = Ticks(std::chrono::minutes(60));
+
+        uint32_t BlockLength(uint64_t rawSize, uint32_t block)
+        {
+            return (uint32_t)std::min<uint64_t>(kDdcBlockSize, rawSize - uint64_t(block) * kDdcBlockSize);
+        }
+
+        bool Decode(const uint8_t* data, size_t size, const DdcKey& key, std::vector<uint8_t>& out)
+        {
+            if (size < sizeof(DdcFileHeader)) return false;
+            DdcFileHeader h;
+            std::memcpy(&h, data, sizeof(h));
+            if (std::memcmp(h.Magic, kDdcMagic, sizeof(kDdcMagic)) != 0 || h.Version != kDdcVersion ||
+                h.KeyHi != key.Hi || h.KeyLo != key.Lo || h.RawSize > kLzMaxRawSize ||
+                h.BlockCount != LzBlockCount(h.RawSize, kDdcBlockSize))
+                return false;
+
+            const uint64_t tableEnd = sizeof(h) + uint64_t(h.BlockCount) * sizeof(uint32_t);
+            if (tableEnd > size) return false;
+            std::vector<uint32_t> sizes(h.BlockCount);
+            std::vector<uint64_t> offsets(h.BlockCount);
+            std::memcpy(sizes.data(), data + sizeof(h), sizes.size() * sizeof(uint32_t));
+            uint64_t pos = tableEnd;
+            for (uint32_t b = 0; b < h.BlockCount; ++b) {
+                const uint32_t len = sizes[b] & ~kDdcBlockStored;
+                if ((sizes[b] & kDdcBlockStored) ? len != BlockLength(h.RawSize, b) : len > LzCompressBound(kDdcBlockSize))
+                    return false;
+                offsets[b] = pos;
+                pos += len;
+            }
+            if (pos != size) return false;
+
+            out.resize(h.RawSize);
+            auto decodeRange = [&](size_t begin, size_t end) {
+                bool ok = true;
+                for (size_t b = begin; b < end && ok; ++b) {
+                    const uint8_t* src = data + offsets[b];
+                    const uint32_t len = sizes[b] & ~kDdcBlockStored;
+                    const uint32_t raw = BlockLength(h.RawSize, (uint32_t)b);
+                    uint8_t* dst = out.data() + b * kDdcBlockSize;
+                    if (sizes[b] & kDdcBlockStored) std::memcpy(dst, src, raw);
+                    else ok = LzDecompress(src, len, dst, raw);
+                }
+                return ok;
+            };
+            if (h.BlockCount > 1 && !JobSystem::Get().IsWorkerThread()) {
+                std::atomic<bool> failed{false};
+                JobSystem::Get().ParallelFor(h.BlockCount, [&](size_t b, size_t e) {
+                    if (!decodeRange(b, e)) failed = true;
+                }, 1);
+                if (failed) return false;
+            } else if (!decodeRange(0, h.BlockCount)) {
+                return false;
+            }
+            return Hash64(out.data(), out.size()) == h.RawHash;
+        }
+
+        void Encode(const DdcKey& key, const uint8_t* src, size_t size, std::vector<uint8_t>& file)
+        {
+            const uint32_t count = (uint32_t)LzBlockCount(size, kDdcBlockSize);
+            std::vector<std::vector<uint8_t>> blocks(count);
+            std::vector<uint32_t> sizes(count);
+            auto encodeRange = [&](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    const uint32_t raw = BlockLength(size, (uint32_t)b);
+                    const uint8_t* in = src + b * kDdcBlockSize;
+                    auto& out = blocks[b];
+                    // Capacity below the raw size: only keep real savings
+                    out.resize(raw);
+                    const size_t n = raw > 1 ? LzCompress(in, raw, out.data(), raw - 1) : 0;
+                    if (n) { out.resize(n); sizes[b] = (uint32_t)n; }
+                    else   { std::memcpy(out.data(), in, raw); sizes[b] = raw | kDdcBlockStored; }
+                }
+            };
+            // On a worker the caller is already parallel across entries
+            if (count > 1 && !JobSystem::Get().IsWorkerThread()) JobSystem::Get().ParallelFor(count, encodeRange, 1);
+            else           encodeRange(0, count);
+
+            DdcFileHeader h{};
+            std::memcpy(h.Magic, kDdcMagic, sizeof(h.Magic));
+            h.Version    = kDdcVersion;
+            h.BlockCount = count;
+            h.RawSize    = size;
+            h.RawHash    = Hash64(src, size);
+            h.KeyHi      = key.Hi;
+            h.KeyLo      = key.Lo;
+
+            size_t total = sizeof(h) + count * sizeof(uint32_t);
+            for (const auto& b : blocks) total += b.size();
+            file.resize(total);
+            uint8_t* p = file.data();
+            std::memcpy(p, &h, sizeof(h));                       p += sizeof(h);
+            std::memcpy(p, sizes.data(), count * sizeof(uint32_t)); p += count * sizeof(uint32_t);
+            for (const auto& b : blocks) { std::memcpy(p, b.data(), b.size()); p += b.size(); }
+        }
+    }
+
+    // ---- DdcKey ----
+
+    std::string DdcKey::ToString() const
+    {
+        return HashToHex(Hi) + HashToHex(Lo);
+    }
+
+    bool DdcKey::FromString(std::string_view s, DdcKey& out)
+    {
+        return s.size() == 32 && HashFromHex(s.substr(0, 16), out.Hi) && HashFromHex(s.substr(16), out.Lo);
+    }
+
+    DdcKeyBuilder::DdcKeyBuilder(std::string_view processor, uint32_t version)
+    {
+        Key.Hi = kSeedHi;
+        Key.Lo = kSeedLo;
+        Add(processor);
+        Add((uint64_t)version);
+    }
+
+    DdcKeyBuilder& DdcKeyBuilder::Add(const void* data, size_t size)
+    {
+        // Hash64 mixes the length in, so part boundaries are part of the key
+        Key.Hi = Hash64(data, size, Key.Hi);
+        Key.Lo = Hash64(data, size, Key.Lo ^ kSeedHi);
+        return *this;
+    }
+
+    // ---- DerivedDataCache ----
+
+    bool DerivedDataCache::Open(const std::filesystem::path& dir, uint64_t maxBytes)
+    {
+        ACE_PROFILE_FUNCTION();
+        Close();
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (!std::filesystem::is_directory(dir, ec)) return false;
+
+        const int64_t now = Now();
+        std::unordered_map<DdcKey, Entry, Hash128> entries;
+        uint64_t total = 0;
+        // Iterators advance with increment(ec): a range-for would throw on an
+        // entry that vanishes or cannot be read mid-scan
+        std::error_code dec, sec;
+        for (std::filesystem::directory_iterator sit(dir, dec), end; !dec && sit != end; sit.increment(dec)) {
+            const auto& shard = *sit;
+            if (shard.path().filename().native().size() != 2 || !shard.is_directory(ec)) continue;
+            for (std::filesystem::directory_iterator fit(shard.path(), sec); !sec && fit != end; fit.increment(sec)) {
+                const auto& f = *fit;
+                const auto& p = f.path();
+                const int64_t mtime = (int64_t)f.last_write_time(ec).time_since_epoch().count();
+                if (p.extension() == ".tmp") {
+                    if (now - mtime > kStaleTemp) std::filesystem::remove(p, ec);
+                    continue;
+                }
+                DdcKey key;
+                if (p.extension() != ".ddc" || !DdcKey::FromString(p.stem().string(), key)) continue;
+                const uint64_t size = f.file_size(ec);
+                if (ec) continue;
+                entries[key] = { size, mtime, mtime };
+                total += size;
+            }
+        }
+
+        {
+            std::lock_guard lock(Mutex);
+            Root     = dir;
+            MaxBytes = maxBytes;
+            TempSalt = AssetGuid::Generate().Lo;
+            Entries  = std::move(entries);
+            Total    = total;
+            Stats    = {};
+        }
+        ACE_LOG_INFO("DDC", "%s: %zu entries, %.1f MB", dir.string().c_str(), EntryCount(), total / (1024.0 * 1024.0));
+        if (total > maxBytes) Trim();
+        return true;
+    }
+
+    void DerivedDataCache::Close()
+    {
+        std::lock_guard lock(Mutex);
+        Root.clear();
+        Entries.clear();
+        Total = 0;
+    }
+
+    std::filesystem::path DerivedDataCache::EntryPath(const std::filesystem::path& root, const DdcKey& key)
+    {
+        const std::string name = key.ToString();
+        return root / name.substr(0, 2) / (name + ".ddc");
+    }
+
+    bool DerivedDataCache::Get(const DdcKey& key, std::vector<uint8_t>& out)
+    {
+        ACE_PROFILE_FUNCTION();
+        const auto root = Directory();
+        if (root.empty()) return false;
+        const auto path = EntryPath(root, key);
+
+        // The file, not the index, decides: another process may have added or
+        // evicted the entry since Open()
+        MappedFile file;
+        const bool found = file.Open(path);
+        const uint64_t size = file.Size();
+        const bool ok = found && Decode(file.Data(), size, key, out);
+        file.Close();
+
+        std::error_code ec;
+        if (!ok) {
+            if (found) {
+                ACE_LOG_WARN("DDC", "Deleting corrupt entry %s", path.string().c_str());
+                std::filesystem::remove(path, ec);
+            }
+            out.clear();
+            std::lock_guard lock(Mutex);
+            if (auto it = Entries.find(key); it != Entries.end()) { Total -= it->second.Size; Entries.erase(it); }
+            ++Stats.Misses;
+            if (found) ++Stats.Corrupt;
+            return false;
+        }
+
+        const int64_t now = Now();
+        bool touch;
+        {
+            std::lock_guard lock(Mutex);
+            auto [it, inserted] = Entries.try_emplace(key);
+            Entry& e = it->second;
+            if (!inserted) Total -= e.Size;
+            e.Size    = size;
+            e.LastUse = now;
+            Total    += size;
+            touch = now - e.DiskStamp > kTouchInterval;
+            if (touch) e.DiskStamp = now;
+            ++Stats.Hits;
+            Stats.BytesRead += out.size();
+        }
+        if (touch) std::filesystem::last_write_time(path, FileTime(FileTime::duration(now)), ec);
+        return true;
+    }
+
+    bool DerivedDataCache::Put(const DdcKey& key, const void* data, size_t size)
+    {
+        ACE_PROFILE_FUNCTION();
+        if (!key.IsValid() || size > kLzMaxRawSize) return false;
+        std::filesystem::path path;
+        uint64_t salt;
+        {
+            std::lock_guard lock(Mutex);
+            if (Root.empty()) return false;
+            path = EntryPath(Root, key);
+            salt = TempSalt;
+        }
+
+        std::vector<uint8_t> file;
+        Encode(key, static_cast<const uint8_t*>(data), size, file);
+
+        // Unique per writer, so concurrent puts of one key never share a temp file
+        auto tmp = path;
+        tmp += "." + HashToHex(salt + TempCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+        std::error_code ec;
+        // Windows refuses to replace a file that is open; same key, same bytes
+        if (!WriteFileAtomic(path, file.data(), file.size(), tmp) && !std::filesystem::exists(path, ec)) return false;
+
+        const int64_t now = Now();
+        bool over;
+        {
+            std::lock_guard lock(Mutex);
+            auto [it, inserted] = Entries.try_emplace(key);
+            if (!inserted) Total -= it->second.Size;
+            it->second = { file.size(), now, now };
+            Total += file.size();
+            ++Stats.Puts;
+            Stats.BytesWritten += file.size();
+            over = Total > MaxBytes;
+        }
+        if (over) Trim();
+        return true;
+    }
+
+    bool DerivedDataCache::Contains(const DdcKey& key) const
+    {
+        std::error_code ec;
+        const auto root = Directory();
+        return !root.empty() && std::filesystem::exists(EntryPath(root, key), ec);
+    }
+
+    bool DerivedDataCache::GetOrBuild(const DdcKey& key, std::vector<uint8_t>& out,
+                                      const std::function<bool(std::vector<uint8_t>&)>& build)
+    {
+        if (Get(key, out)) return true;
+        out.clear();
+        if (!build(out)) return false;
+        Put(key, out);
+        return true;
+    }
+
+    void DerivedDataCache::Trim(uint64_t target)
+    {
+        ACE_PROFILE_FUNCTION();
+        std::vector<std::filesystem::path> victims;
+        {
+            std::lock_guard lock(Mutex);
+            if (target == ~0ull) target = MaxBytes / 10 * 9;
+            if (Total <= target) return;
+
+            std::vector<std::pair<int64_t, DdcKey>> order;
+            order.reserve(Entries.size());
+            for (const auto& [key, e] : Entries) order.emplace_back(e.LastUse, key);
+            std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (const auto& [use, key] : order) {
+                if (Total <= target) break;
+                auto it = Entries.find(key);
+                Total -= it->second.Size;
+                Entries.erase(it);
+                victims.push_back(EntryPath(Root, key));
+                ++Stats.Evictions;
+            }
+        }
+        // Outside the lock; a reader that still has one open just misses next time
+        std::error_code ec;
+        for (const auto& p : victims) std::filesystem::remove(p, ec);
+    }
+
+    uint64_t DerivedDataCache::TotalBytes() const
+    {
+        std::lock_guard lock(Mutex);
+        return Total;
+    }
+
+    size_t DerivedDataCache::EntryCount() const
+    {
+        std::lock_guard lock(Mutex);
+        return Entries.size();
+    }
+
+    DdcStats DerivedDataCache::GetStats() const
+    {
+        std::lock_guard lock(Mutex);
+        return Stats;
+    }
+}
@@ -0,0 +1,148 @@
+﻿#pragma once
+#include "Runtime/Core/Hash.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    // 128-bit key of a derived-data entry. Build it with DdcKeyBuilder from
+    // everything the output depends on; equal keys must mean equal outputs.
+    struct DdcKey {
+        uint64_t Hi = 0, Lo = 0;
+
+        bool IsValid() const { return Hi | Lo; }
+        bool operator==(const DdcKey&) const = default;
+        std::string ToString() const;                   // 32 hex digits, also the file name
+        static bool FromString(std::string_view s, DdcKey& out);
+    };
+
+    // Hashes a processor id and version plus any number of inputs, e.g.
+    //   DdcKeyBuilder("MapBinary", 1).Add(sourceBytes, size).Add(settingsJson).Finish()
+    // Every Add() also hashes the part's length, so the split between parts
+    // matters. Bump the version whenever the processor's output changes.
+    class DdcKeyBuilder {
+    public:
+        DdcKeyBuilder(std::string_view processor, uint32_t version);
+
+        DdcKeyBuilder& Add(const void* data, size_t size);
+        DdcKeyBuilder& Add(std::string_view s) { return Add(s.data(), s.size()); }
+        DdcKeyBuilder& Add(uint64_t v) { return Add(&v, sizeof(v)); }
+
+        DdcKey Finish() const { return Key; }
+
+    private:
+        DdcKey Key;
+    };
+
+    // .ddc entry file (little-endian):
+    //
+    //   DdcFileHeader
+    //   uint32 BlockSizes[BlockCount]     bytes on disk; kDdcBlockStored set = raw
+    //   block data                        kDdcBlockSize raw bytes per block (the
+    //                                     last one fewer), LZ-compressed on its own
+    inline constexpr char     kDdcMagic[8]    = {'A','C','E','D','D','C','\0','\x1A'};
+    inline constexpr uint32_t kDdcVersion     = 1;
+    inline constexpr uint32_t kDdcBlockSize   = 256 * 1024;
+    inline constexpr uint32_t kDdcBlockStored = 0x80000000u;
+
+    struct DdcFileHeader {
+        char     Magic[8];
+        uint32_t Version;
+        uint32_t BlockCount;
+        uint64_t RawSize;
+        uint64_t RawHash;           // Hash64 of the raw bytes, checked on every read
+        uint64_t KeyHi;
+        uint64_t KeyLo;
+    };
+
+    struct DdcStats {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        uint64_t Puts = 0;
+        uint64_t Evictions = 0;
+        uint64_t Corrupt = 0;       // entries that failed validation and were deleted
+        uint64_t BytesRead = 0;     // raw bytes returned by hits
+        uint64_t BytesWritten = 0;  // bytes written to disk by puts
+    };
+
+    // Local content-addressed cache for the output of import and cook steps.
+    //
+    // Entries live in <dir>/<first two hex digits>/<key>.ddc and are written
+    // to a temporary file and renamed into place, so readers, including other
+    // processes sharing the directory, never see a partial entry. An entry is
+    // immutable once published: a second Put of the same key only refreshes it.
+    //
+    // Least-recently-used entries are deleted once the total size passes
+    // MaxBytes. Recency is the file's mtime, refreshed on hits (at most every
+    // few minutes per entry), so it carries over between runs.
+    //
+    // Thread-safe: processors call Get/Put from jobs.
+    class DerivedDataCache {
+    public:
+        static constexpr uint64_t kDefaultMaxBytes = 8ull << 30;
+
+        DerivedDataCache() = default;
+        ~DerivedDataCache() = default;
+        DerivedDataCache(const DerivedDataCache&) = delete;
+        DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+        // Creates 'dir' if needed, indexes the entries already there and trims
+        // to 'maxBytes'. False if the directory cannot be created.
+        bool Open(const std::filesystem::path& dir, uint64_t maxBytes = kDefaultMaxBytes);
+        void Close();
+        bool IsOpen() const { std::lock_guard lock(Mutex); return !Root.empty(); }
+        std::filesystem::path Directory() const { std::lock_guard lock(Mutex); return Root; }
+
+        // Decompressed and verified contents; false on a miss. Corrupt entries
+        // are deleted and count as misses.
+        bool Get(const DdcKey& key, std::vector<uint8_t>& out);
+        // False if the cache is closed, the write fails, or 'size' is over
+        // kLzMaxRawSize (such outputs are not cached)
+        bool Put(const DdcKey& key, const void* data, size_t size);
+        bool Put(const DdcKey& key, const std::vector<uint8_t>& data) { return Put(key, data.data(), data.size()); }
+        // Cheap existence check (no read, no recency update)
+        bool Contains(const DdcKey& key) const;
+
+        // Get(), or on a miss run 'build' and Put() what it produced. False
+        // only if 'build' fails; a failed Put still returns the built data.
+        bool GetOrBuild(const DdcKey& key, std::vector<uint8_t>& out,
+                        const std::function<bool(std::vector<uint8_t>&)>& build);
+
+        // Evicts least-recently-used entries until the cache fits in 'target'
+        // bytes (default: 90% of MaxBytes, so puts don't trim one by one)
+        void Trim(uint64_t target = ~0ull);
+
+        uint64_t TotalBytes() const;
+        size_t   EntryCount() const;
+        DdcStats GetStats() const;
+
+    private:
+        struct Entry {
+            uint64_t Size = 0;          // bytes on disk
+            int64_t  LastUse = 0;       // file_time_type ticks
+            int64_t  DiskStamp = 0;     // mtime as last written to the file
+        };
+
+        static std::filesystem::path EntryPath(const std::filesystem::path& root, const DdcKey& key);
+        void Track(const DdcKey& key, uint64_t size, int64_t stamp, bool written);
+
+        std::atomic<uint64_t> TempCounter{0};
+
+        // Open/Close may race with jobs still calling Get/Put, so even Root
+        // is only read under the lock (callers take a copy)
+        mutable std::mutex Mutex;       // guards everything below
+        std::filesystem::path Root;
+        uint64_t           MaxBytes = kDefaultMaxBytes;
+        uint64_t           TempSalt = 0;
+        std::unordered_map<DdcKey, Entry, Hash128> Entries;
+        uint64_t           Total = 0;
+        DdcStats           Stats;
+    };
+}
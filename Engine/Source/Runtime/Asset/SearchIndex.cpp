@@ -0,0 +1,590 @@
+﻿#include "Runtime/Asset/SearchIndex.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+
+namespace ace {
+    namespace {
+        constexpr uint32_t kTrigramCount = 1u << 18;
+        constexpr uint32_t kBlock        = 128;         // postings per skip entry
+        constexpr size_t   kContentBatch = 256;         // files read in parallel per step
+        constexpr uint8_t  kAlive   = 1;
+        constexpr uint8_t  kDir     = 2;
+        constexpr uint8_t  kContent = 4;
+
+        // Score tiers: any substring match ranks above any fuzzy one, and
+        // both above matches found only in a file's text
+        constexpr int32_t  kSubstringScore = 10000;
+        constexpr int32_t  kContentScore   = 1;
+
+        // 64 character classes: exact for letters (any case) and digits,
+        // shared for the rest; verification sorts out collisions
+        constexpr std::array<uint8_t, 256> MakeFold()
+        {
+            std::array<uint8_t, 256> f{};
+            for (int c = 0; c < 256; ++c) {
+                uint8_t v = 47;                                         // other printable ASCII
+                if (c >= 'a' && c <= 'z')      v = (uint8_t)(1 + c - 'a');
+                else if (c >= 'A' && c <= 'Z') v = (uint8_t)(1 + c - 'A');
+                else if (c >= '0' && c <= '9') v = (uint8_t)(27 + c - '0');
+                else if (c == '/' || c == '\\') v = 37;
+                else if (c == '.') v = 38;
+                else if (c == '_') v = 39;
+                else if (c == '-') v = 40;
+                else if (c == '"') v = 41;
+                else if (c == ':') v = 42;
+                else if (c == ',') v = 43;
+                else if (c == '{' || c == '}') v = 44;
+                else if (c == '[' || c == ']') v = 45;
+                else if (c == '(' || c == ')') v = 46;
+                else if (c >= 0x80) v = (uint8_t)(48 + (c & 15));     // UTF-8 bytes
+                else if (c <= ' ' || c == 0x7F) v = 0;                  // whitespace and control
+                f[c] = v;
+            }
+            return f;
+        }
+        constexpr std::array<uint8_t, 256> kFold = MakeFold();
+
+        inline char Lower(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; }
+
+        inline uint32_t Trigram(const uint8_t* p)
+        {
+            return (uint32_t)kFold[p[0]] << 12 | (uint32_t)kFold[p[1]] << 6 | kFold[p[2]];
+        }
+
+        uint64_t MaskOf(std::string_view s)
+        {
+            uint64_t m = 0;
+            for (const char c : s) m |= 1ull << kFold[(uint8_t)c];
+            return m;
+        }
+
+        // Appends the distinct trigrams of 'text'; 'seen' is a kTrigramCount-bit
+        // scratch set, all clear on entry and on return
+        void ExtractTrigrams(const uint8_t* text, size_t size, std::vector<uint64_t>& seen, std::vector<uint32_t>& out)
+        {
+            const size_t first = out.size();
+            for (size_t i = 0; i + 3 <= size; ++i) {
+                const uint32_t t = Trigram(text + i);
+                uint64_t& w = seen[t >> 6];
+                const uint64_t bit = 1ull << (t & 63);
+                if (w & bit) continue;
+                w |= bit;
+                out.push_back(t);
+            }
+            for (size_t i = first; i < out.size(); ++i) seen[out[i] >> 6] = 0;
+        }
+
+        void WriteVarint(std::vector<uint8_t>& out, uint32_t v)
+        {
+            while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+            out.push_back((uint8_t)v);
+        }
+
+        inline uint32_t ReadVarint(const uint8_t*& p)
+        {
+            uint32_t v = 0;
+            for (int shift = 0;; shift += 7) {
+                const uint8_t b = *p++;
+                v |= (uint32_t)(b & 0x7F) << shift;
+                if (!(b & 0x80)) return v;
+            }
+        }
+
+        // Case-insensitive find; 'needle' is already lower case
+        size_t FindFolded(std::string_view hay, std::string_view needle, size_t from = 0)
+        {
+            if (needle.size() > hay.size()) return std::string_view::npos;
+            const char first = needle[0];
+            // OR-ing 0x20 lowers 'A'-'Z' and maps no other byte onto 'a'-'z'
+            const char fold = (first >= 'a' && first <= 'z') ? 0x20 : 0;
+            const size_t last = hay.size() - needle.size();
+            for (size_t i = from; i <= last; ++i) {
+                if ((char)(hay[i] | fold) != first) continue;
+                size_t k = 1;
+                while (k < needle.size() && Lower(hay[i + k]) == needle[k]) ++k;
+                if (k == needle.size()) return i;
+            }
+            return std::string_view::npos;
+        }
+
+        inline bool IsSeparator(char c) { return c == '/' || c == '_' || c == '-' || c == '.' || c == ' '; }
+
+        // Start of a word: after a separator or at a lower-to-upper case change
+        inline bool IsWordStart(std::string_view s, size_t i)
+        {
+            if (i == 0) return true;
+            const char p = s[i - 1], c = s[i];
+            return IsSeparator(p) || (p >= 'a' && p <= 'z' && c >= 'A' && c <= 'Z');
+        }
+
+        int32_t ScoreSubstring(std::string_view path, size_t name, size_t at, size_t len)
+        {
+            int32_t s = kSubstringScore;
+            if (at >= name) s += 400;                                   // in the file name
+            if (at == name) s += 300;                                   // name prefix
+            const size_t dot = path.rfind('.');
+            const size_t stemEnd = dot != std::string_view::npos && dot > name ? dot : path.size();
+            if (at == name && at + len == stemEnd) s += 300;            // whole name
+            if (IsWordStart(path, at)) s += 100;
+            return s - (int32_t)std::min<size_t>(path.size(), 1000) / 4;
+        }
+
+        // Query characters in order within a file name ('folded' is its lower
+        // case copy), taken as late as possible; 0 if they do not all appear
+        int32_t ScoreFuzzy(std::string_view name, std::string_view folded, std::string_view needle)
+        {
+            int32_t s = 1;
+            size_t  q = needle.size();
+            size_t  prev = name.size();
+            for (size_t i = name.size(); i-- > 0 && q > 0;) {
+                if (folded[i] != needle[q - 1]) continue;
+                --q;
+                s += 16;
+                if (IsWordStart(name, i)) s += 24;
+                if (i + 1 == prev) s += 20;                             // consecutive
+                else if (prev < name.size()) s -= (int32_t)std::min<size_t>(prev - i - 1, 30);
+                prev = i;
+            }
+            if (q > 0) return 0;
+            return std::clamp<int32_t>(s - (int32_t)prev, kContentScore + 1, kSubstringScore - 1);
+        }
+
+        // A path within 'folder' (relative, no trailing '/'); empty = any
+        inline bool InFolder(std::string_view path, std::string_view folder)
+        {
+            return folder.empty() ||
+                   (path.size() > folder.size() && path.compare(0, folder.size(), folder) == 0 && path[folder.size()] == '/');
+        }
+
+        struct Found {
+            std::string Rel;
+            bool        IsDir = false;
+        };
+
+        // Everything below 'dir', relative paths prefixed with 'rel'
+        void Walk(const std::filesystem::path& dir, std::string_view rel, std::vector<Found>& out)
+        {
+            const size_t skip = dir.generic_string().size() + 1;
+            std::string prefix(rel);
+            if (!prefix.empty()) prefix += '/';
+            std::error_code ec;
+            const auto opts = std::filesystem::directory_options::skip_permission_denied;
+            for (std::filesystem::recursive_directory_iterator it(dir, opts, ec), end; !ec && it != end; it.increment(ec)) {
+                const bool isDir = it->is_directory(ec);
+                if (!isDir && !it->is_regular_file(ec)) continue;
+                std::string full = it->path().generic_string();
+                if (full.size() <= skip) continue;
+                out.push_back({prefix + full.substr(skip), isDir});
+            }
+        }
+    }
+
+    void SearchIndex::Clear()
+    {
+        Docs.clear();
+        Masks.clear();
+        NameMasks.clear();
+        Paths.clear();
+        Folded.clear();
+        ByPath.clear();
+        Lists.clear();
+        PathTrigrams.assign(kTrigramCount, 0);
+        ContentTrigrams.assign(kTrigramCount, 0);
+        RootDir.clear();
+        Dead = 0;
+        ContentFiles = 0;
+        ++Rev;
+    }
+
+    void SearchIndex::Build(const std::filesystem::path& root)
+    {
+        Build(root, Settings{});
+    }
+
+    void SearchIndex::Build(const std::filesystem::path& root, const Settings& settings)
+    {
+        ACE_PROFILE_FUNCTION();
+        const auto t0 = std::chrono::steady_clock::now();
+        std::filesystem::path dir = root.lexically_normal();
+        if (!dir.has_filename()) dir = dir.parent_path();               // trailing separator
+        Clear();
+        Config = settings;
+        RootDir = std::move(dir);
+        AddTree(RootDir, {});
+        BuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    bool SearchIndex::WantsContent(std::string_view rel) const
+    {
+        if (!Config.IndexContent) return false;
+        const size_t dot = rel.rfind('.');
+        if (dot == std::string_view::npos || rel.find('/', dot) != std::string_view::npos) return false;
+        std::string ext(rel.substr(dot));
+        for (char& c : ext) c = Lower(c);
+        return ext == ".json" || ext == ".aceasset" || ext == ".blueprint";
+    }
+
+    void SearchIndex::AddTree(const std::filesystem::path& dir, std::string_view rel)
+    {
+        std::vector<Found> found;
+        if (!rel.empty()) found.push_back({std::string(rel), true});
+        Walk(dir, rel, found);
+        // Path order keeps each folder's files on consecutive ids
+        std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.Rel < b.Rel; });
+
+        std::vector<uint32_t> content;
+        for (const Found& f : found) {
+            if (ByPath.count(HashString(f.Rel))) continue;      // already seen in this batch of changes
+            const uint32_t id = AddDoc(f.Rel, f.IsDir);
+            if (id != ~0u && !f.IsDir && WantsContent(f.Rel)) content.push_back(id);
+        }
+
+        // Files are read in parallel a batch at a time; appending stays
+        // serial and in id order so every posting list remains sorted
+        std::vector<std::vector<uint32_t>> grams;
+        for (size_t b = 0; b < content.size(); b += kContentBatch) {
+            const size_t n = std::min(kContentBatch, content.size() - b);
+            grams.assign(n, {});
+            JobSystem::Get().ParallelFor(n, [&](size_t lo, size_t hi) {
+                std::vector<uint64_t> seen(kTrigramCount / 64, 0);
+                for (size_t i = lo; i < hi; ++i) {
+                    MappedFile file;
+                    if (!file.Open(RootDir / std::string(PathOf(Docs[content[b + i]])))) continue;
+                    if (file.Size() > Config.MaxContentBytes) continue;
+                    ExtractTrigrams(file.Data(), file.Size(), seen, grams[i]);
+                }
+            }, 4);
+            for (size_t i = 0; i < n; ++i) IndexContent(content[b + i], grams[i]);
+        }
+    }
+
+    uint32_t SearchIndex::AddDoc(std::string_view rel, bool isDir)
+    {
+        if (rel.empty() || rel.size() > UINT16_MAX || Paths.size() + rel.size() > UINT32_MAX) return ~0u;
+        const uint32_t id = (uint32_t)Docs.size();
+        Doc d;
+        d.PathOffset = (uint32_t)Paths.size();
+        d.PathLength = (uint16_t)rel.size();
+        const size_t slash = rel.rfind('/');
+        d.NameOffset = (uint16_t)(slash == std::string_view::npos ? 0 : slash + 1);
+        d.Flags = kAlive | (isDir ? kDir : 0);
+        Docs.push_back(d);
+        Masks.push_back(MaskOf(rel));
+        NameMasks.push_back(MaskOf(rel.substr(d.NameOffset)));
+        Paths.append(rel);
+        for (const char c : rel) Folded.push_back(Lower(c));
+        ByPath[HashString(rel)] = id;
+
+        // A path has few trigrams: sort out the repeats instead of using a bitset
+        std::array<uint32_t, 64> local;
+        std::vector<uint32_t> heap;
+        uint32_t* keys = local.data();
+        const size_t n = rel.size() >= 3 ? rel.size() - 2 : 0;
+        if (n > local.size()) { heap.resize(n); keys = heap.data(); }
+        for (size_t i = 0; i < n; ++i) keys[i] = Trigram((const uint8_t*)rel.data() + i);
+        std::sort(keys, keys + n);
+        const size_t unique = (size_t)(std::unique(keys, keys + n) - keys);
+        for (size_t i = 0; i < unique; ++i) Append(PathTrigrams, keys[i], id);
+        ++Rev;
+        return id;
+    }
+
+    void SearchIndex::IndexContent(uint32_t id, const std::vector<uint32_t>& trigrams)
+    {
+        if (trigrams.empty()) return;
+        for (const uint32_t t : trigrams) Append(ContentTrigrams, t, id);
+        Docs[id].Flags |= kContent;
+        ++ContentFiles;
+    }
+
+    void SearchIndex::Append(Table& table, uint32_t trigram, uint32_t id)
+    {
+        uint32_t& slot = table[trigram];
+        if (!slot) {
+            Lists.emplace_back();
+            slot = (uint32_t)Lists.size();
+        }
+        PostingList& l = Lists[slot - 1];
+        if (l.Count && id <= l.Last) return;
+        const uint32_t base = l.Count ? l.Last : 0;
+        if (l.Count % kBlock == 0) l.Skips.push_back({base, (uint32_t)l.Bytes.size()});
+        WriteVarint(l.Bytes, id - base);
+        l.Last = id;
+        ++l.Count;
+    }
+
+    const SearchIndex::PostingList* SearchIndex::Find(const Table& table, uint32_t trigram) const
+    {
+        const uint32_t slot = table.empty() ? 0 : table[trigram];
+        return slot ? &Lists[slot - 1] : nullptr;
+    }
+
+    void SearchIndex::Remove(std::string_view rel, bool withChildren)
+    {
+        const auto it = ByPath.find(HashString(rel));
+        if (it != ByPath.end()) {
+            Doc& d = Docs[it->second];
+            if (d.Flags & kDir) withChildren = true;
+            if (d.Flags & kContent) --ContentFiles;
+            d.Flags &= ~kAlive;
+            ByPath.erase(it);
+            ++Dead;
+            ++Rev;
+        }
+        if (!withChildren) return;
+        for (Doc& d : Docs) {
+            if (!(d.Flags & kAlive) || !InFolder(PathOf(d), rel)) continue;
+            if (d.Flags & kContent) --ContentFiles;
+            d.Flags &= ~kAlive;
+            ByPath.erase(HashString(PathOf(d)));
+            ++Dead;
+            ++Rev;
+        }
+    }
+
+    void SearchIndex::Apply(const std::vector<FileChange>& changes)
+    {
+        ACE_PROFILE_FUNCTION();
+        if (RootDir.empty()) return;
+        const std::string root = RootDir.generic_string() + '/';
+        std::vector<uint64_t> seen;
+        std::vector<uint32_t> grams;
+        for (const FileChange& c : changes) {
+            const std::string full = c.Path.lexically_normal().generic_string();
+            if (full.size() + 1 == root.size() && root.compare(0, full.size(), full) == 0) {
+                // The root itself: only a rescan means anything
+                if (c.Kind == FileChangeKind::Rescan) Build(RootDir, Config);
+                continue;
+            }
+            if (full.size() <= root.size() || full.compare(0, root.size(), root) != 0) continue;
+            const std::string_view rel = std::string_view(full).substr(root.size());
+
+            if (c.Kind == FileChangeKind::Removed || c.Kind == FileChangeKind::Rescan) {
+                Remove(rel, c.Kind == FileChangeKind::Rescan);
+                if (c.Kind == FileChangeKind::Removed) continue;
+            }
+            std::error_code ec;
+            const auto st = std::filesystem::status(c.Path, ec);
+            if (ec || !std::filesystem::exists(st)) { Remove(rel, false); continue; }
+
+            const bool known = ByPath.count(HashString(rel)) != 0;
+            if (std::filesystem::is_directory(st)) {
+                if (!known) AddTree(c.Path, rel);           // a new or moved-in folder arrives as one event
+                continue;
+            }
+            if (!std::filesystem::is_regular_file(st)) continue;
+            if (known) {
+                if (!WantsContent(rel)) continue;            // the path is all that is indexed
+                Remove(rel, false);
+            }
+            const uint32_t id = AddDoc(rel, false);
+            if (id == ~0u || !WantsContent(rel)) continue;
+            MappedFile file;
+            if (!file.Open(c.Path) || file.Size() > Config.MaxContentBytes) continue;
+            if (seen.empty()) seen.assign(kTrigramCount / 64, 0);
+            grams.clear();
+            ExtractTrigrams(file.Data(), file.Size(), seen, grams);
+            IndexContent(id, grams);
+        }
+    }
+
+    void SearchIndex::Intersect(const Table& table, const std::vector<uint32_t>& trigrams, std::vector<uint32_t>& out) const
+    {
+        out.clear();
+        std::vector<const PostingList*> lists;
+        for (const uint32_t t : trigrams) {
+            const PostingList* l = Find(table, t);
+            if (!l) return;
+            lists.push_back(l);
+        }
+        if (lists.empty()) return;
+        std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) { return a->Count < b->Count; });
+        lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+        // Decode the rarest list, then narrow it with each of the others
+        {
+            const PostingList& l = *lists[0];
+            out.reserve(l.Count);
+            const uint8_t* p = l.Bytes.data();
+            uint32_t cur = 0;
+            for (uint32_t i = 0; i < l.Count; ++i) { cur += ReadVarint(p); out.push_back(cur); }
+        }
+        for (size_t li = 1; li < lists.size() && !out.empty(); ++li) {
+            const PostingList& l = *lists[li];
+            const uint8_t* p = l.Bytes.data();
+            size_t   block = 0;
+            uint32_t index = 0;         // postings decoded so far
+            uint32_t cur = 0;           // last decoded id, or the base of the current block
+            int64_t  val = -1;          // last decoded id; -1 before the first
+            size_t   kept = 0;
+            for (const uint32_t id : out) {
+                if (val < (int64_t)id) {
+                    // Skip whole blocks that end before 'id'
+                    if (block + 1 < l.Skips.size() && l.Skips[block + 1].Base < id) {
+                        const auto it = std::partition_point(l.Skips.begin() + (ptrdiff_t)block + 1, l.Skips.end(),
+                                                             [id](const Skip& s) { return s.Base < id; });
+                        block = (size_t)(it - l.Skips.begin()) - 1;
+                        p = l.Bytes.data() + l.Skips[block].Offset;
+                        index = (uint32_t)block * kBlock;
+                        cur = l.Skips[block].Base;
+                        val = cur;
+                    }
+                    while (val < (int64_t)id && index < l.Count) {
+                        cur += ReadVarint(p);
+                        val = cur;
+                        ++index;
+                    }
+                    if (val < (int64_t)id) break;           // list exhausted
+                }
+                if (val == (int64_t)id) out[kept++] = id;
+            }
+            out.resize(kept);
+        }
+    }
+
+    size_t SearchIndex::Search(const SearchQuery& q, std::vector<SearchHit>& out) const
+    {
+        ACE_PROFILE_FUNCTION();
+        std::string needle(q.Text);
+        for (char& c : needle) c = Lower(c);
+        if (needle.empty() || Docs.empty() || q.MaxResults == 0) return 0;
+        std::string_view folder = q.Folder;
+        while (!folder.empty() && folder.back() == '/') folder.remove_suffix(1);
+        const uint64_t mask = MaskOf(needle);
+
+        using Match = std::pair<int32_t, uint32_t>;             // (score, doc)
+        auto check = [&](uint32_t id, std::vector<Match>& found) {
+            const Doc& d = Docs[id];
+            if (!(d.Flags & kAlive)) return;
+            const std::string_view path = PathOf(d);
+            if (!InFolder(path, folder)) return;
+            // A match in the file name beats one in the folders above it
+            const std::string_view lower = FoldedOf(d);
+            size_t at = lower.find(needle, d.NameOffset);
+            if (at == std::string_view::npos)
+                at = lower.substr(0, std::min(lower.size(), d.NameOffset + needle.size() - 1)).find(needle);
+            if (at != std::string_view::npos) found.push_back({ScoreSubstring(path, d.NameOffset, at, needle.size()), id});
+            else if (q.Fuzzy && (NameMasks[id] & mask) == mask)
+                if (const int32_t s = ScoreFuzzy(path.substr(d.NameOffset), lower.substr(d.NameOffset), needle)) found.push_back({s, id});
+        };
+
+        std::vector<uint32_t> trigrams, candidates;
+        for (size_t i = 0; i + 3 <= needle.size(); ++i) trigrams.push_back(Trigram((const uint8_t*)needle.data() + i));
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+        // Ids to check, ascending; null = every doc. Fuzzy matches have gaps
+        // and short queries have no trigram, so those test every file's mask.
+        const uint32_t* ids = nullptr;
+        size_t count = Docs.size();
+        if (Last.Rev == Rev && Last.Fuzzy == q.Fuzzy && Last.Folder == folder && needle.starts_with(Last.Needle)) {
+            ids = Last.Ids.data();
+            count = Last.Ids.size();
+        } else if (!q.Fuzzy && !trigrams.empty()) {
+            Intersect(PathTrigrams, trigrams, candidates);
+            ids = candidates.data();
+            count = candidates.size();
+        }
+
+        // Large scans are split across the job system; chunks are joined in
+        // order so the matches stay sorted by id
+        constexpr size_t kChunk = 16384;
+        std::vector<std::vector<Match>> parts((count + kChunk - 1) / kChunk);
+        JobSystem::Get().ParallelFor(parts.size(), [&](size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) {
+                const size_t end = std::min(count, (c + 1) * kChunk);
+                for (size_t i = c * kChunk; i < end; ++i) {
+                    const uint32_t id = ids ? ids[i] : (uint32_t)i;
+                    if ((Masks[id] & mask) == mask) check(id, parts[c]);
+                }
+            }
+        }, 1);
+        std::vector<Match> matches;
+        if (parts.size() == 1) matches = std::move(parts[0]);
+        else {
+            size_t n = 0;
+            for (const auto& p : parts) n += p.size();
+            matches.reserve(n);
+            for (const auto& p : parts) matches.insert(matches.end(), p.begin(), p.end());
+        }
+
+        Last.Needle = needle;
+        Last.Folder = folder;
+        Last.Fuzzy = q.Fuzzy;
+        Last.Rev = Rev;
+        Last.Ids.clear();
+        for (const auto& m : matches) Last.Ids.push_back(m.second);
+        size_t total = matches.size();
+
+        if (q.Content && !trigrams.empty()) {
+            Intersect(ContentTrigrams, trigrams, candidates);
+            // Files not already found by path, read a batch at a time in
+            // parallel until MaxResults are confirmed
+            std::vector<uint32_t> pending;
+            size_t m = 0;
+            for (const uint32_t id : candidates) {
+                while (m < matches.size() && matches[m].second < id) ++m;
+                if (m < matches.size() && matches[m].second == id) continue;
+                const Doc& d = Docs[id];
+                if ((d.Flags & kAlive) && InFolder(PathOf(d), folder)) pending.push_back(id);
+            }
+            std::vector<uint8_t> hit;
+            size_t confirmed = 0;
+            for (size_t b = 0; b < pending.size() && confirmed < q.MaxResults; b += kContentBatch) {
+                const size_t n = std::min(kContentBatch, pending.size() - b);
+                hit.assign(n, 0);
+                JobSystem::Get().ParallelFor(n, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; ++i) {
+                        MappedFile file;
+                        if (!file.Open(RootDir / std::string(PathOf(Docs[pending[b + i]])))) continue;
+                        hit[i] = FindFolded({(const char*)file.Data(), file.Size()}, needle) != std::string_view::npos;
+                    }
+                }, 8);
+                for (size_t i = 0; i < n && confirmed < q.MaxResults; ++i)
+                    if (hit[i]) { matches.push_back({kContentScore, pending[b + i]}); ++confirmed; }
+            }
+            total = matches.size();
+        }
+
+        const size_t n = std::min(matches.size(), q.MaxResults);
+        std::partial_sort(matches.begin(), matches.begin() + (ptrdiff_t)n, matches.end(),
+            [](const auto& a, const auto& b) {
+                return a.first != b.first ? a.first > b.first : a.second < b.second;   // ids are in path order per Build()
+            });
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; ++i) {
+            const Doc& d = Docs[matches[i].second];
+            SearchHit h;
+            h.Path = std::string(PathOf(d));
+            h.Score = matches[i].first;
+            h.IsDir = (d.Flags & kDir) != 0;
+            h.InContent = matches[i].first == kContentScore;
+            out.push_back(std::move(h));
+        }
+        return total;
+    }
+
+    bool SearchIndex::NeedsRebuild() const
+    {
+        return Dead > 1024 && Dead * 4 > Docs.size();
+    }
+
+    SearchIndexStats SearchIndex::GetStats() const
+    {
+        SearchIndexStats s;
+        s.Files = Count();
+        s.Dead = Dead;
+        s.ContentFiles = ContentFiles;
+        s.Trigrams = Lists.size();
+        for (const PostingList& l : Lists) s.PostingBytes += l.Bytes.size() + l.Skips.size() * sizeof(Skip);
+        s.PathBytes = Paths.size() + Folded.size();
+        s.BuildSeconds = BuildSeconds;
+        return s;
+    }
+}
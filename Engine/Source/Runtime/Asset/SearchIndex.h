@@ -0,0 +1,142 @@
+﻿#pragma once
+#include "Runtime/IO/FileWatcher.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    struct SearchQuery {
+        std::string_view Text;                  // case-insensitive
+        std::string_view Folder;                // relative to the root, e.g. "Maps"; empty = everywhere
+        bool             Fuzzy = false;         // also match file names holding the characters in order ("plctl" finds "PlayerControl")
+        bool             Content = false;       // also match inside indexed text files (3+ characters)
+        size_t           MaxResults = 1000;
+    };
+
+    struct SearchHit {
+        std::string Path;                       // relative to the root, '/'-separated
+        int32_t     Score = 0;                  // higher is better
+        bool        IsDir = false;
+        bool        InContent = false;          // matched the file's text, not its path
+    };
+
+    struct SearchIndexStats {
+        size_t Files = 0;                       // live files and folders
+        size_t Dead = 0;                        // removed since the last Build(), still in the postings
+        size_t ContentFiles = 0;
+        size_t Trigrams = 0;                    // distinct, paths and content
+        size_t PostingBytes = 0;
+        size_t PathBytes = 0;                   // both cases
+        double BuildSeconds = 0.0;
+    };
+
+    // Trigram index over the relative paths of every file and folder under a
+    // root, plus the text of .json, .aceasset and .blueprint files.
+    //
+    // Characters are case-folded into 64 classes, so a trigram is an 18-bit
+    // key into a table of posting lists. Lists hold ascending file ids as
+    // delta varints with a skip entry every 128 ids; Build() numbers files in
+    // path order, so the files of one folder share long runs of 1-byte
+    // deltas. A query intersects the lists of its trigrams, rarest first,
+    // and checks the survivors against the real text. Queries shorter than a
+    // trigram, and fuzzy ones, filter on a per-file 64-bit mask of the
+    // character classes present before checking. A query that extends the
+    // previous one only rechecks that one's matches.
+    //
+    // Apply() folds in file-watcher events: new files get new, higher ids
+    // and are appended; removed files are only marked dead. Once NeedsRebuild()
+    // the owner should Build() a fresh index (normally on a worker) to drop them.
+    //
+    // Not thread-safe: build on one thread, then hand over.
+    class SearchIndex {
+    public:
+        struct Settings {
+            bool     IndexContent = true;
+            uint64_t MaxContentBytes = 1u << 20;     // larger files are indexed by path only
+        };
+
+        void Build(const std::filesystem::path& root);
+        void Build(const std::filesystem::path& root, const Settings& settings);
+        void Clear();
+
+        // Updates the index for changes under the root; other paths are ignored
+        void Apply(const std::vector<FileChange>& changes);
+
+        // Appends up to q.MaxResults hits, best first, and returns the total
+        // number of matches. Content matches are confirmed by reading the
+        // file; once MaxResults of them are found the rest are not counted.
+        size_t Search(const SearchQuery& q, std::vector<SearchHit>& out) const;
+
+        const std::filesystem::path& Root() const { return RootDir; }
+        size_t           Count() const { return Docs.size() - Dead; }
+        bool             NeedsRebuild() const;
+        SearchIndexStats GetStats() const;
+
+        // Bumped whenever the contents change, for callers caching results
+        uint64_t Revision() const { return Rev; }
+
+    private:
+        struct Doc {
+            uint32_t PathOffset = 0;            // into Paths
+            uint16_t PathLength = 0;
+            uint16_t NameOffset = 0;            // file name within the path
+            uint8_t  Flags = 0;
+        };
+
+        // Path matches of the previous query. While the user types, each
+        // query extends the last one and only has to recheck these.
+        struct LastQuery {
+            std::string           Needle;
+            std::string           Folder;
+            bool                  Fuzzy = false;
+            uint64_t              Rev = ~0ull;
+            std::vector<uint32_t> Ids;
+        };
+
+        struct Skip {
+            uint32_t Base = 0;                  // id before the block; deltas start from it
+            uint32_t Offset = 0;                // into Bytes
+        };
+
+        struct PostingList {
+            std::vector<uint8_t> Bytes;
+            std::vector<Skip>    Skips;
+            uint32_t             Count = 0;
+            uint32_t             Last = 0;
+        };
+
+        using Table = std::vector<uint32_t>;    // trigram -> index into Lists + 1; 0 = empty
+
+        void AddTree(const std::filesystem::path& dir, std::string_view rel);
+        uint32_t AddDoc(std::string_view rel, bool isDir);
+        void IndexContent(uint32_t id, const std::vector<uint32_t>& trigrams);
+        void Remove(std::string_view rel, bool withChildren);
+        void Append(Table& table, uint32_t trigram, uint32_t id);
+        const PostingList* Find(const Table& table, uint32_t trigram) const;
+        void Intersect(const Table& table, const std::vector<uint32_t>& trigrams, std::vector<uint32_t>& out) const;
+        bool WantsContent(std::string_view rel) const;
+        std::string_view PathOf(const Doc& d) const { return {Paths.data() + d.PathOffset, d.PathLength}; }
+        std::string_view FoldedOf(const Doc& d) const { return {Folded.data() + d.PathOffset, d.PathLength}; }
+
+        std::filesystem::path          RootDir;
+        Settings                       Config;
+        std::vector<Doc>               Docs;
+        std::vector<uint64_t>          Masks;               // per doc: bit per character class in the path
+        std::vector<uint64_t>          NameMasks;           // same for the file name alone
+        std::string                    Paths;               // every path ever added, back to back
+        std::string                    Folded;              // Paths in lower case, same offsets
+        std::unordered_map<uint64_t, uint32_t> ByPath;      // HashString(path) -> live doc
+        std::vector<PostingList>       Lists;
+        Table                          PathTrigrams;
+        Table                          ContentTrigrams;
+        size_t                         Dead = 0;
+        size_t                         ContentFiles = 0;
+        double                         BuildSeconds = 0.0;
+        uint64_t                       Rev = 0;
+        mutable LastQuery              Last;
+    };
+}
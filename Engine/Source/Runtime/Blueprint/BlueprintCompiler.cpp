@@ -0,0 +1,229 @@
+﻿#include "Runtime/Blueprint/BlueprintCompiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace ace {
+    namespace {
+        char Fold(char c) { return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c; }
+
+        bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+        {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); ++i)
+                if (Fold(a[i]) != Fold(b[i])) return false;
+            return true;
+        }
+
+        std::string_view Trim(std::string_view s)
+        {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+            return s;
+        }
+
+        // What a node does, from its title
+        struct NodeKind {
+            bool        Constant = false;
+            float       Value = 0.0f;
+            BlueprintOp Op = BlueprintOp::Return;
+        };
+
+        bool ParseTitle(std::string_view title, NodeKind& out)
+        {
+            title = Trim(title);
+            // Type suffix: "Add (Float)"
+            if (!title.empty() && title.back() == ')') {
+                const size_t open = title.rfind('(');
+                if (open != std::string_view::npos) title = Trim(title.substr(0, open));
+            }
+
+            constexpr std::string_view kConst = "Const";
+            if (title.size() >= kConst.size() && EqualsIgnoreCase(title.substr(0, kConst.size()), kConst)) {
+                const std::string number(Trim(title.substr(kConst.size())));
+                if (number.empty()) return false;
+                char* end = nullptr;
+                out.Value = std::strtof(number.c_str(), &end);
+                out.Constant = true;
+                return end == number.c_str() + number.size();
+            }
+            for (uint16_t op = 1; op < (uint16_t)BlueprintOp::Count; ++op)
+                if (EqualsIgnoreCase(title, BlueprintOpName((BlueprintOp)op))) { out.Op = (BlueprintOp)op; return true; }
+            return false;
+        }
+
+        std::string Describe(const BlueprintGraph::Node& n)
+        {
+            return "node '" + n.Title + "' (id " + std::to_string(n.Id) + ")";
+        }
+
+        constexpr int kUnlinked = -1;
+
+        // 'key' of 'j' into 'out' if present; false if it has the wrong type
+        // (value() would throw, and cooking runs this inside jobs)
+        bool IntField(const nlohmann::json& j, const char* key, int& out)
+        {
+            const auto it = j.find(key);
+            if (it == j.end()) return true;
+            if (!it->is_number_integer()) return false;
+            out = it->get<int>();
+            return true;
+        }
+    }
+
+    bool BlueprintGraphFromJson(const nlohmann::json& j, BlueprintGraph& out, std::string* error)
+    {
+        out = {};
+        const nlohmann::json& g = j.is_object() && j.contains("Graph") ? j["Graph"] : j;
+        if (!g.is_object() || !g.contains("nodes") || !g["nodes"].is_array()) return false;
+
+        const auto fail = [&](const std::string& what) {
+            out = {};
+            if (error) *error = what + " has the wrong type";
+            return false;
+        };
+        auto pinIds = [](const nlohmann::json& jn, const char* key, std::vector<int>& ids) {
+            if (!jn.contains(key) || !jn[key].is_array()) return true;
+            for (const auto& jp : jn[key]) {
+                if (!jp.is_object()) continue;
+                if (!IntField(jp, "id", ids.emplace_back(0))) return false;
+            }
+            return true;
+        };
+        const nlohmann::json& nodes = g["nodes"];
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const nlohmann::json& jn = nodes[i];
+            if (!jn.is_object()) continue;
+            BlueprintGraph::Node& n = out.Nodes.emplace_back();
+            const auto title = jn.find("title");
+            if (title != jn.end() && !title->is_string()) return fail("title of node " + std::to_string(i));
+            if (title != jn.end()) n.Title = title->get<std::string>();
+            if (!IntField(jn, "id", n.Id) || !pinIds(jn, "inputs", n.Inputs) || !pinIds(jn, "outputs", n.Outputs))
+                return fail("an id of node " + std::to_string(i));
+        }
+        if (g.contains("links") && g["links"].is_array()) {
+            const nlohmann::json& links = g["links"];
+            for (size_t i = 0; i < links.size(); ++i) {
+                const nlohmann::json& jl = links[i];
+                if (!jl.is_object()) continue;
+                BlueprintGraph::Link& l = out.Links.emplace_back();
+                if (!IntField(jl, "fromNode", l.FromNode) || !IntField(jl, "fromPin", l.FromPin) ||
+                    !IntField(jl, "toNode", l.ToNode) || !IntField(jl, "toPin", l.ToPin))
+                    return fail("an id of link " + std::to_string(i));
+            }
+        }
+        return true;
+    }
+
+    bool CompileBlueprint(const BlueprintGraph& graph, BlueprintProgram& out, std::string& error)
+    {
+        out = {};
+        error.clear();
+        const auto& nodes = graph.Nodes;
+        const size_t count = nodes.size();
+
+        // Node kinds and pin lookups
+        std::vector<NodeKind> kinds(count);
+        std::unordered_map<int, size_t> nodeIndex;
+        std::unordered_map<int, std::pair<size_t, size_t>> inputPin;    // pin -> node, slot
+        std::unordered_map<int, size_t> outputPin;                      // pin -> node
+        std::vector<size_t> firstInput(count + 1, 0);                   // slot offsets per node
+        for (size_t i = 0; i < count; ++i) {
+            const auto& n = nodes[i];
+            if (!nodeIndex.emplace(n.Id, i).second) { error = "duplicate " + Describe(n); return false; }
+            if (!ParseTitle(n.Title, kinds[i])) { error = "unknown " + Describe(n); return false; }
+            const size_t inputs = kinds[i].Constant ? 0 : BlueprintOperandCount(kinds[i].Op);
+            if (n.Inputs.size() != inputs || n.Outputs.size() != 1) {
+                error = Describe(n) + " needs " + std::to_string(inputs) + " input(s) and 1 output";
+                return false;
+            }
+            for (size_t s = 0; s < n.Inputs.size(); ++s)
+                if (!inputPin.emplace(n.Inputs[s], std::make_pair(i, s)).second) { error = "duplicate pin in " + Describe(n); return false; }
+            if (!outputPin.emplace(n.Outputs[0], i).second) { error = "duplicate pin in " + Describe(n); return false; }
+            firstInput[i + 1] = firstInput[i] + inputs;
+        }
+
+        // What feeds each input slot
+        std::vector<int> source(firstInput[count], kUnlinked);         // node index
+        std::vector<uint32_t> readers(count, 0);
+        for (const auto& l : graph.Links) {
+            const auto from = outputPin.find(l.FromPin);
+            const auto to = inputPin.find(l.ToPin);
+            if (from == outputPin.end() || to == inputPin.end() ||
+                nodes[from->second].Id != l.FromNode || nodes[to->second.first].Id != l.ToNode) {
+                error = "link from pin " + std::to_string(l.FromPin) + " to pin " + std::to_string(l.ToPin) + " is broken";
+                return false;
+            }
+            int& slot = source[firstInput[to->second.first] + to->second.second];
+            if (slot != kUnlinked) { error = "two links into one input of " + Describe(nodes[to->second.first]); return false; }
+            slot = (int)from->second;
+            ++readers[from->second];
+        }
+
+        // Topological order (Kahn): sources in graph order, then each node once its inputs are placed
+        std::vector<uint32_t> waiting(count, 0);
+        std::vector<std::vector<size_t>> consumers(count);
+        for (size_t i = 0; i < count; ++i)
+            for (size_t s = firstInput[i]; s < firstInput[i + 1]; ++s)
+                if (source[s] != kUnlinked) { ++waiting[i]; consumers[source[s]].push_back(i); }
+        std::vector<size_t> order;
+        order.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            if (waiting[i] == 0) order.push_back(i);
+        for (size_t k = 0; k < order.size(); ++k)
+            for (const size_t c : consumers[order[k]])
+                if (--waiting[c] == 0) order.push_back(c);
+        if (order.size() != count) {
+            for (size_t i = 0; i < count; ++i)
+                if (waiting[i] != 0) { error = "cycle through " + Describe(nodes[i]); return false; }
+        }
+
+        // Constant registers, shared by equal values (bitwise, so -0 and NaNs stay distinct)
+        std::unordered_map<uint32_t, uint16_t> constants;
+        std::vector<uint32_t> reg(count, 0);
+        auto constant = [&](float v) {
+            uint32_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            const auto [it, added] = constants.emplace(bits, (uint16_t)out.Constants.size());
+            if (added) out.Constants.push_back(v);
+            return it->second;
+        };
+        for (size_t i = 0; i < count; ++i)
+            if (kinds[i].Constant) reg[i] = constant(kinds[i].Value);
+        uint16_t zero = 0;
+        if (std::find(source.begin(), source.end(), kUnlinked) != source.end()) zero = constant(0.0f);
+        if (out.Constants.size() > UINT16_MAX) { error = "too many constants"; return false; }
+
+        // One instruction per operation. A register is freed once its last
+        // reader has been emitted, before that reader's destination is
+        // picked: the VM reads operands before writing, so an instruction
+        // may overwrite its own input.
+        std::vector<uint32_t> pending = readers;
+        std::vector<uint32_t> freeRegs;
+        uint32_t next = (uint32_t)out.Constants.size();
+        for (const size_t i : order) {
+            if (kinds[i].Constant) continue;
+            const size_t at = out.Code.size();
+            out.Code.push_back((uint16_t)kinds[i].Op);
+            out.Code.push_back(0);                                          // destination, below
+            for (size_t s = firstInput[i]; s < firstInput[i + 1]; ++s) {
+                const int from = source[s];
+                out.Code.push_back(from == kUnlinked ? zero : (uint16_t)reg[from]);
+                if (from != kUnlinked && !kinds[from].Constant && --pending[from] == 0) freeRegs.push_back(reg[from]);
+            }
+            if (!freeRegs.empty()) { reg[i] = freeRegs.back(); freeRegs.pop_back(); }
+            else                   reg[i] = next++;
+            if (reg[i] > UINT16_MAX) { error = "graph needs more than 65536 registers"; return false; }
+            out.Code[at + 1] = (uint16_t)reg[i];
+        }
+        out.Code.push_back((uint16_t)BlueprintOp::Return);
+        out.NumRegisters = next;
+        out.NumNodes = (uint32_t)count;
+
+        for (size_t i = 0; i < count; ++i)
+            if (readers[i] == 0) out.Results.push_back({ nodes[i].Id, nodes[i].Outputs[0], (uint16_t)reg[i] });
+        return true;
+    }
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+#include "Runtime/Blueprint/BlueprintVM.h"
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace ace {
+    // What the compiler reads from a blueprint: nodes and links, no layout
+    struct BlueprintGraph {
+        struct Node {
+            int              Id = 0;
+            std::string      Title;             // picks the operation: "Const 2", "Add (Float)", ...
+            std::vector<int> Inputs;            // pin ids, in order
+            std::vector<int> Outputs;
+        };
+        struct Link {
+            int FromNode = 0, FromPin = 0;
+            int ToNode   = 0, ToPin   = 0;
+        };
+        std::vector<Node> Nodes;
+        std::vector<Link> Links;
+    };
+
+    // The "Graph" object of a blueprint, loose or cooked, or the whole asset
+    // holding it; false if there is no graph, or (with 'error' set) if a
+    // node, pin or link field has the wrong type. Never throws.
+    bool BlueprintGraphFromJson(const nlohmann::json& j, BlueprintGraph& out, std::string* error = nullptr);
+
+    // Compiles the data flow of 'graph' to bytecode for BlueprintVM.
+    //
+    // Nodes are ordered so each comes after the nodes feeding it (a cycle is
+    // an error). "Const <number>" nodes become constant registers, shared by
+    // equal values, as do unconnected inputs (0). Every other node is one
+    // instruction named by its title, e.g. "Add" or "Add (Float)"; see
+    // ACE_BLUEPRINT_OPS. Output pins get registers that are reused once
+    // their last reader has run, except results (outputs nothing reads),
+    // which keep theirs for the caller.
+    //
+    // False with a message naming the node on an unknown title, wrong pin
+    // counts, bad links or a cycle.
+    bool CompileBlueprint(const BlueprintGraph& graph, BlueprintProgram& out, std::string& error);
+}
@@ -0,0 +1,145 @@
+﻿#include "Runtime/Blueprint/BlueprintVM.h"
+#include <algorithm>
+#include <cmath>
+
+// Define as 0 to force the switch loop (e.g. to compare the two)
+#ifndef ACE_BLUEPRINT_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define ACE_BLUEPRINT_COMPUTED_GOTO 1
+#else
+#define ACE_BLUEPRINT_COMPUTED_GOTO 0
+#endif
+#endif
+
+namespace ace {
+    namespace {
+        constexpr uint32_t kOperands[] = {
+            #define ACE_BLUEPRINT_OP_OPERANDS(name, operands) operands,
+            ACE_BLUEPRINT_OPS(ACE_BLUEPRINT_OP_OPERANDS)
+            #undef ACE_BLUEPRINT_OP_OPERANDS
+        };
+        constexpr const char* kNames[] = {
+            #define ACE_BLUEPRINT_OP_NAME(name, operands) #name,
+            ACE_BLUEPRINT_OPS(ACE_BLUEPRINT_OP_NAME)
+            #undef ACE_BLUEPRINT_OP_NAME
+        };
+        static_assert(std::size(kOperands) == (size_t)BlueprintOp::Count);
+    }
+
+    uint32_t BlueprintOperandCount(BlueprintOp op)
+    {
+        return op < BlueprintOp::Count ? kOperands[(size_t)op] : 0;
+    }
+
+    const char* BlueprintOpName(BlueprintOp op)
+    {
+        return op < BlueprintOp::Count ? kNames[(size_t)op] : "?";
+    }
+
+    int BlueprintProgram::RegisterOf(int pin) const
+    {
+        for (const auto& r : Results)
+            if (r.Pin == pin) return r.Register;
+        return -1;
+    }
+
+    size_t BlueprintProgram::Instructions() const
+    {
+        size_t n = 0;
+        for (size_t pc = 0; pc < Code.size() && Code[pc] < (uint16_t)BlueprintOp::Count; pc += 2 + kOperands[Code[pc]]) {
+            ++n;
+            if (Code[pc] == (uint16_t)BlueprintOp::Return) break;
+        }
+        return n;
+    }
+
+    bool BlueprintVM::Load(const BlueprintProgram& program)
+    {
+        Program = nullptr;
+        Registers.clear();
+        const auto& code = program.Code;
+        if (program.Constants.size() > program.NumRegisters || program.NumRegisters > UINT16_MAX + 1u) return false;
+        for (const auto& r : program.Results)
+            if (r.Register >= program.NumRegisters) return false;
+
+        // Every instruction in bounds, writing a non-constant register, and
+        // the code ends in Return: Run() checks nothing
+        size_t pc = 0;
+        for (;;) {
+            if (pc >= code.size() || code[pc] >= (uint16_t)BlueprintOp::Count) return false;
+            const BlueprintOp op = (BlueprintOp)code[pc];
+            if (op == BlueprintOp::Return) break;
+            const size_t words = 2 + kOperands[code[pc]];
+            if (pc + words > code.size()) return false;
+            if (code[pc + 1] < program.Constants.size()) return false;
+            for (size_t i = 1; i < words; ++i)
+                if (code[pc + i] >= program.NumRegisters) return false;
+            pc += words;
+        }
+
+        Program = &program;
+        Registers.assign(std::max<size_t>(program.NumRegisters, 1), 0.0f);
+        std::copy(program.Constants.begin(), program.Constants.end(), Registers.begin());
+        return true;
+    }
+
+    float BlueprintVM::Result(int pin) const
+    {
+        const int reg = Program ? Program->RegisterOf(pin) : -1;
+        return reg < 0 ? 0.0f : Registers[reg];
+    }
+
+    void BlueprintVM::Run()
+    {
+        if (!Program) return;
+        const uint16_t* pc = Program->Code.data();
+        float* r = Registers.data();
+
+        // Each handler ends by jumping straight to the next one's label (one
+        // indirect branch per instruction, predicted per handler) instead of
+        // going back through a shared switch
+#if ACE_BLUEPRINT_COMPUTED_GOTO
+        static void* const kLabels[] = {
+            #define ACE_BLUEPRINT_OP_LABEL(name, operands) &&Op_##name,
+            ACE_BLUEPRINT_OPS(ACE_BLUEPRINT_OP_LABEL)
+            #undef ACE_BLUEPRINT_OP_LABEL
+        };
+        #define ACE_BP_OP(name) Op_##name:
+        #define ACE_BP_NEXT()   goto *kLabels[*pc]
+        ACE_BP_NEXT();
+#else
+        #define ACE_BP_OP(name) case (uint16_t)BlueprintOp::name:
+        #define ACE_BP_NEXT()   continue
+        for (;;) switch (*pc) {
+#endif
+        #define ACE_BP_UNARY(name, expr)  ACE_BP_OP(name) { const float a = r[pc[2]]; r[pc[1]] = (expr); pc += 3; ACE_BP_NEXT(); }
+        #define ACE_BP_BINARY(name, expr) ACE_BP_OP(name) { const float a = r[pc[2]], b = r[pc[3]]; r[pc[1]] = (expr); pc += 4; ACE_BP_NEXT(); }
+        #define ACE_BP_TERNARY(name, expr) \
+            ACE_BP_OP(name) { const float a = r[pc[2]], b = r[pc[3]], c = r[pc[4]]; r[pc[1]] = (expr); pc += 5; ACE_BP_NEXT(); }
+
+        ACE_BP_BINARY(Add,      a + b)
+        ACE_BP_BINARY(Subtract, a - b)
+        ACE_BP_BINARY(Multiply, a * b)
+        ACE_BP_BINARY(Divide,   a / b)
+        ACE_BP_BINARY(Min,      b < a ? b : a)
+        ACE_BP_BINARY(Max,      a < b ? b : a)
+        ACE_BP_UNARY(Negate,    -a)
+        ACE_BP_UNARY(Abs,       std::fabs(a))
+        ACE_BP_UNARY(Sqrt,      std::sqrt(a))
+        ACE_BP_UNARY(Sin,       std::sin(a))
+        ACE_BP_UNARY(Cos,       std::cos(a))
+        ACE_BP_TERNARY(Lerp,    a + (b - a) * c)
+        ACE_BP_TERNARY(Clamp,   a < b ? b : (c < a ? c : a))
+        ACE_BP_OP(Return) return;
+
+#if !ACE_BLUEPRINT_COMPUTED_GOTO
+        default: return;
+        }
+#endif
+        #undef ACE_BP_TERNARY
+        #undef ACE_BP_BINARY
+        #undef ACE_BP_UNARY
+        #undef ACE_BP_NEXT
+        #undef ACE_BP_OP
+    }
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ace {
+    // Blueprint bytecode: a flat array of 16-bit words. Each instruction is
+    // an opcode, a destination register and one word per operand register,
+    // so the VM decodes it with fixed offsets and no table lookups:
+    //
+    //   Add   dst a b          r[dst] = r[a] + r[b]
+    //   Lerp  dst a b t        r[dst] = r[a] + (r[b] - r[a]) * r[t]
+    //   Return                 ends the program
+    //
+    // Registers hold floats. The first Constants.size() registers are the
+    // constants, written once by Load() and never by the code.
+    //
+    // X(name, operands)
+    #define ACE_BLUEPRINT_OPS(X) \
+        X(Return,   0) \
+        X(Add,      2) \
+        X(Subtract, 2) \
+        X(Multiply, 2) \
+        X(Divide,   2) \
+        X(Min,      2) \
+        X(Max,      2) \
+        X(Negate,   1) \
+        X(Abs,      1) \
+        X(Sqrt,     1) \
+        X(Sin,      1) \
+        X(Cos,      1) \
+        X(Lerp,     3) \
+        X(Clamp,    3)
+
+    enum class BlueprintOp : uint16_t {
+        #define ACE_BLUEPRINT_OP_ENUM(name, operands) name,
+        ACE_BLUEPRINT_OPS(ACE_BLUEPRINT_OP_ENUM)
+        #undef ACE_BLUEPRINT_OP_ENUM
+        Count
+    };
+
+    // Operand registers read by 'op' (not counting the destination)
+    uint32_t BlueprintOperandCount(BlueprintOp op);
+    const char* BlueprintOpName(BlueprintOp op);
+
+    struct BlueprintProgram {
+        std::vector<uint16_t> Code;             // ends with Return
+        std::vector<float>    Constants;        // registers [0, Constants.size())
+        uint32_t              NumRegisters = 0;
+        uint32_t              NumNodes = 0;     // graph nodes compiled, constants included
+
+        // Output pins whose values are kept to the end: those nothing reads
+        struct Result {
+            int      Node = 0;
+            int      Pin = 0;
+            uint16_t Register = 0;
+        };
+        std::vector<Result>   Results;
+
+        // Register holding a result pin, or -1
+        int RegisterOf(int pin) const;
+        size_t Instructions() const;
+    };
+
+    // Runs a BlueprintProgram over its own register file. Dispatch uses
+    // computed goto where the compiler has it (GCC, Clang) and a switch
+    // otherwise.
+    class BlueprintVM {
+    public:
+        // Checks the code against the register count and copies the
+        // constants in; false (and nothing loaded) if the code is malformed.
+        // 'program' must outlive the VM or the next Load().
+        bool Load(const BlueprintProgram& program);
+        // Evaluates the whole program once
+        void Run();
+
+        float Value(uint16_t reg) const { return Registers[reg]; }
+        // A result pin's value, or 0 if the pin is not a result
+        float Result(int pin) const;
+
+    private:
+        const BlueprintProgram* Program = nullptr;
+        std::vector<float>      Registers;
+    };
+}
@@ -1,6 +1,6 @@
 ﻿#pragma once
 
-// --- Reflection-like no-op macros (future header tool will expand these) ---
+// --- Reflection markup (no-ops for the compiler; ACEHeaderTool reads them) ---
 #ifndef ACE_CLASS
 #define ACE_CLASS(...)
 #endif
@@ -29,6 +29,18 @@
 #define GENERATED_BODY(...)
 #endif
 
+// <Class>.generated.h (written by ACEHeaderTool) defines ACE_CURRENT_FILE_ID plus one
+// <FileId>_<Line>_GENERATED_BODY macro per reflected class, then points GENERATED_BODY
+// at ACE_GENERATED_BODY_FOR_LINE(). Include it last, right before the class.
+#define ACE_PP_CAT4_IMPL(a, b, c, d) a##b##c##d
+#define ACE_PP_CAT4(a, b, c, d)      ACE_PP_CAT4_IMPL(a, b, c, d)
+#define ACE_GENERATED_BODY_FOR_LINE() ACE_PP_CAT4(ACE_CURRENT_FILE_ID, _, __LINE__, _GENERATED_BODY)
+
+// Spelling used by the C++ Class Wizard; resolves to whatever GENERATED_BODY is at the use site.
+#ifndef ACE_GENERATED_BODY
+#define ACE_GENERATED_BODY(...) GENERATED_BODY(__VA_ARGS__)
+#endif
+
 // Optional, for places you want explicit "this class participates in reflection"
 #ifndef ACE_REFLECT
 #define ACE_REFLECT(...)
@@ -0,0 +1,155 @@
+﻿#include "Runtime/Core/Compression.h"
+#include <cstring>
+
+namespace ace {
+    namespace {
+        constexpr int    kHashLog      = 14;
+        constexpr size_t kMinMatch     = 4;
+        constexpr size_t kMaxOffset    = 65535;
+        constexpr size_t kLastLiterals = 5;    // the tail is always literals
+        constexpr size_t kMatchMargin  = 12;   // no match starts this close to the end
+
+        inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        inline uint32_t HashOf(uint32_t v) { return (v * 2654435761u) >> (32 - kHashLog); }
+
+        // Writes the 4-bit nibble overflow as 255-runs
+        inline bool PutLength(uint8_t*& op, uint8_t* oend, size_t len)
+        {
+            for (; len >= 255; len -= 255) {
+                if (op >= oend) return false;
+                *op++ = 255;
+            }
+            if (op >= oend) return false;
+            *op++ = (uint8_t)len;
+            return true;
+        }
+
+        inline bool GetLength(const uint8_t*& ip, const uint8_t* iend, size_t& len)
+        {
+            uint8_t b;
+            do {
+                if (ip >= iend) return false;
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+            return true;
+        }
+
+        bool EmitSequence(uint8_t*& op, uint8_t* oend, const uint8_t* lit, size_t litLen,
+                          size_t offset, size_t matchLen)
+        {
+            if (op >= oend) return false;
+            uint8_t* token = op++;
+            const size_t litNibble = litLen < 15 ? litLen : 15;
+            if (litLen >= 15 && !PutLength(op, oend, litLen - 15)) return false;
+            if ((size_t)(oend - op) < litLen) return false;
+            if (litLen) std::memcpy(op, lit, litLen);
+            op += litLen;
+
+            size_t matchNibble = 0;
+            if (matchLen) {
+                if (oend - op < 2) return false;
+                *op++ = (uint8_t)(offset & 0xFF);
+                *op++ = (uint8_t)(offset >> 8);
+                const size_t m = matchLen - kMinMatch;
+                matchNibble = m < 15 ? m : 15;
+                if (m >= 15 && !PutLength(op, oend, m - 15)) return false;
+            }
+            *token = (uint8_t)((litNibble << 4) | matchNibble);
+            return true;
+        }
+    }
+
+    size_t LzCompress(const void* srcData, size_t size, void* dstData, size_t capacity)
+    {
+        const uint8_t* src = static_cast<const uint8_t*>(srcData);
+        uint8_t* op   = static_cast<uint8_t*>(dstData);
+        uint8_t* oend = op + capacity;
+        const uint8_t* anchor = src;
+        const uint8_t* end    = src + size;
+
+        if (size > kMatchMargin) {
+            // Slots hold tableBase + (position in 'src'). Each call starts its
+            // base past everything earlier calls stored, so leftovers read as
+            // misses and the output depends only on the input; the table is
+            // cleared only when the base would wrap.
+            thread_local uint32_t table[size_t(1) << kHashLog];
+            thread_local uint32_t tableBase = 1;
+            if (size >= UINT32_MAX - tableBase) {
+                std::memset(table, 0, sizeof(table));
+                tableBase = 1;
+            }
+            const uint32_t base = tableBase;
+            tableBase += (uint32_t)size;
+
+            const uint8_t* mfLimit    = end - kMatchMargin;
+            const uint8_t* matchLimit = end - kLastLiterals;
+            const uint8_t* ip = src + 1;
+
+            while (ip < mfLimit) {
+                const uint32_t h = HashOf(Read32(ip));
+                const uint32_t slot = table[h];
+                const uint8_t* ref = slot >= base ? src + (slot - base) : ip;   // ip: a miss below
+                table[h] = base + (uint32_t)(ip - src);
+                if (ref >= ip || (size_t)(ip - ref) > kMaxOffset || Read32(ref) != Read32(ip)) {
+                    // Skip faster through data that does not compress
+                    ip += 1 + ((size_t)(ip - anchor) >> 6);
+                    continue;
+                }
+                while (ip > anchor && ref > src && ip[-1] == ref[-1]) { --ip; --ref; }
+
+                size_t len = kMinMatch;
+                while (ip + len < matchLimit && ip[len] == ref[len]) ++len;
+
+                if (!EmitSequence(op, oend, anchor, (size_t)(ip - anchor), (size_t)(ip - ref), len)) return 0;
+                ip += len;
+                anchor = ip;
+                if (ip < mfLimit) table[HashOf(Read32(ip - 2))] = base + (uint32_t)(ip - 2 - src);
+            }
+        }
+
+        if (!EmitSequence(op, oend, anchor, (size_t)(end - anchor), 0, 0)) return 0;
+        return (size_t)(op - static_cast<uint8_t*>(dstData));
+    }
+
+    bool LzDecompress(const void* srcData, size_t size, void* dstData, size_t rawSize)
+    {
+        const uint8_t* ip   = static_cast<const uint8_t*>(srcData);
+        const uint8_t* iend = ip + size;
+        uint8_t* dst  = static_cast<uint8_t*>(dstData);
+        uint8_t* op   = dst;
+        uint8_t* oend = dst + rawSize;
+
+        while (ip < iend) {
+            const uint8_t token = *ip++;
+
+            size_t litLen = token >> 4;
+            if (litLen == 15 && !GetLength(ip, iend, litLen)) return false;
+            if ((size_t)(iend - ip) < litLen || (size_t)(oend - op) < litLen) return false;
+            if (litLen) std::memcpy(op, ip, litLen);
+            op += litLen;
+            ip += litLen;
+            if (ip == iend) break;   // last sequence has no match
+
+            if (iend - ip < 2) return false;
+            const size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > (size_t)(op - dst)) return false;
+
+            size_t matchLen = token & 15;
+            if (matchLen == 15 && !GetLength(ip, iend, matchLen)) return false;
+            matchLen += kMinMatch;
+            if ((size_t)(oend - op) < matchLen) return false;
+
+            const uint8_t* ref = op - offset;
+            if (offset >= matchLen) {
+                std::memcpy(op, ref, matchLen);
+                op += matchLen;
+            } else {
+                // Overlapping copy repeats the last 'offset' bytes
+                for (size_t i = 0; i < matchLen; ++i) *op++ = ref[i];
+            }
+        }
+        return op == oend;
+    }
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ace {
+    // Self-contained LZ77 block codec in the LZ4 family: byte-aligned
+    // sequences of (literal run, 16-bit back-reference), no entropy stage.
+    // Decoding is a tight copy loop, fast enough to stay below sequential
+    // read speed; every read and write is bounds-checked, so corrupt input
+    // fails instead of overrunning.
+    //
+    // Each call is one independent block: no state carries between calls.
+
+    // Worst-case compressed size for 'size' input bytes
+    constexpr size_t LzCompressBound(size_t size) { return size + size / 255 + 16; }
+
+    // Largest payload a block container (pak blob, DDC entry) may hold.
+    // Writers refuse more; readers treat a larger declared size as corrupt
+    // rather than allocating it.
+    inline constexpr uint64_t kLzMaxRawSize = 4ull << 30;
+
+    // Blocks of 'blockSize' bytes covering 'rawSize', computed in 64 bits so
+    // a corrupt size cannot wrap onto a small stored count
+    constexpr uint64_t LzBlockCount(uint64_t rawSize, uint32_t blockSize)
+    {
+        return rawSize / blockSize + (rawSize % blockSize != 0);
+    }
+
+    // Returns the compressed size, or 0 if 'capacity' is too small. Callers
+    // that only want a win should pass capacity < size and store raw on 0.
+    size_t LzCompress(const void* src, size_t size, void* dst, size_t capacity);
+
+    // 'rawSize' must be the exact decompressed size; false on corrupt input.
+    bool LzDecompress(const void* src, size_t size, void* dst, size_t rawSize);
+}
@@ -0,0 +1,41 @@
+﻿#include "Runtime/Core/FileUtil.h"
+#include <fstream>
+#include <iterator>
+
+namespace ace {
+    bool WriteFileAtomic(const std::filesystem::path& path, const void* data, size_t size,
+                         const std::filesystem::path& tmp)
+    {
+        std::filesystem::path t = tmp;
+        if (t.empty()) { t = path; t += ".tmp"; }
+        std::error_code ec;
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+        {
+            std::ofstream out(t, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(static_cast<const char*>(data), (std::streamsize)size);
+            out.close();
+            if (!out) { std::filesystem::remove(t, ec); return false; }
+        }
+        return ReplaceFile(t, path);
+    }
+
+    bool ReplaceFile(const std::filesystem::path& tmp, const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (!ec) return true;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+
+    bool IsWithin(const std::filesystem::path& dir, const std::filesystem::path& path)
+    {
+        const std::filesystem::path d = dir.lexically_normal(), p = path.lexically_normal();
+        if (d.empty()) return false;
+        auto di = d.begin(), pi = p.begin();
+        for (; di != d.end() && pi != p.end() && *di == *pi; ++di, ++pi) {}
+        // A trailing separator leaves one empty last component
+        return di == d.end() || (di->empty() && std::next(di) == d.end());
+    }
+}
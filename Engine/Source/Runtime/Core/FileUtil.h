@@ -0,0 +1,25 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ace {
+    // Whether [offset, offset + size) lies within [0, limit), without
+    // overflow; for offsets and sizes read from an untrusted file
+    constexpr bool InRange(uint64_t offset, uint64_t size, uint64_t limit)
+    {
+        return offset <= limit && size <= limit - offset;
+    }
+
+    // Writes 'data' to 'tmp' (default: 'path' + ".tmp") and renames it over
+    // 'path', creating parent directories, so readers never see a partial
+    // file. False on any failure, with the temporary removed.
+    bool WriteFileAtomic(const std::filesystem::path& path, const void* data, size_t size,
+                         const std::filesystem::path& tmp = {});
+    // The rename step alone, for writers that stream into 'tmp' themselves
+    bool ReplaceFile(const std::filesystem::path& tmp, const std::filesystem::path& path);
+
+    // Whether 'path' is 'dir' or below it. Compares components after
+    // lexically_normal(): no file system access, symlinks not resolved.
+    bool IsWithin(const std::filesystem::path& dir, const std::filesystem::path& path);
+}
@@ -0,0 +1,94 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace ace {
+    // 64-bit content hash (xxHash64 algorithm). Stable across runs and platforms,
+    // so it is safe to persist in caches and manifests.
+    namespace detail {
+        constexpr uint64_t kP1 = 11400714785074694791ull;
+        constexpr uint64_t kP2 = 14029467366897019727ull;
+        constexpr uint64_t kP3 =  1609587929392839161ull;
+        constexpr uint64_t kP4 =  9650029242287828579ull;
+        constexpr uint64_t kP5 =  2870177450012600261ull;
+
+        inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+        inline uint64_t Read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+        inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        inline uint64_t Round(uint64_t acc, uint64_t in) { acc += in * kP2; acc = Rotl(acc, 31); return acc * kP1; }
+        inline uint64_t Merge(uint64_t acc, uint64_t v) { acc ^= Round(0, v); return acc * kP1 + kP4; }
+    }
+
+    inline uint64_t Hash64(const void* data, size_t len, uint64_t seed = 0)
+    {
+        using namespace detail;
+        const uint8_t* p   = static_cast<const uint8_t*>(data);
+        const uint8_t* end = p + len;
+        uint64_t h;
+
+        if (len >= 32) {
+            uint64_t v1 = seed + kP1 + kP2, v2 = seed + kP2, v3 = seed, v4 = seed - kP1;
+            const uint8_t* limit = end - 32;
+            do {
+                v1 = Round(v1, Read64(p));      v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16)); v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = Merge(h, v1); h = Merge(h, v2); h = Merge(h, v3); h = Merge(h, v4);
+        } else {
+            h = seed + kP5;
+        }
+        h += (uint64_t)len;
+
+        for (; p + 8 <= end; p += 8) { h ^= Round(0, Read64(p)); h = Rotl(h, 27) * kP1 + kP4; }
+        if  (p + 4 <= end)           { h ^= (uint64_t)Read32(p) * kP1; h = Rotl(h, 23) * kP2 + kP3; p += 4; }
+        for (; p < end; ++p)         { h ^= (*p) * kP5; h = Rotl(h, 11) * kP1; }
+
+        h ^= h >> 33; h *= kP2;
+        h ^= h >> 29; h *= kP3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    inline uint64_t HashString(std::string_view s, uint64_t seed = 0) { return Hash64(s.data(), s.size(), seed); }
+
+    inline uint64_t HashCombine(uint64_t a, uint64_t b)
+    {
+        return a ^ (b + 0x9E3779B97F4A7C15ull + (a << 6) + (a >> 2));
+    }
+
+    // Hash functor for 128-bit ids with Hi/Lo halves (AssetGuid, DdcKey).
+    // The halves are already random, so mixing them is enough.
+    struct Hash128 {
+        template<class T>
+        size_t operator()(const T& k) const noexcept { return (size_t)(k.Hi ^ (k.Lo * 0x9E3779B97F4A7C15ull)); }
+    };
+
+    // 16 lowercase hex digits, e.g. for file names and manifests.
+    inline std::string HashToHex(uint64_t h)
+    {
+        static const char* digits = "0123456789abcdef";
+        std::string s(16, '0');
+        for (int i = 15; i >= 0; --i) { s[i] = digits[h & 0xF]; h >>= 4; }
+        return s;
+    }
+
+    inline bool HashFromHex(std::string_view s, uint64_t& out)
+    {
+        if (s.size() != 16) return false;
+        uint64_t v = 0;
+        for (char c : s) {
+            v <<= 4;
+            if      (c >= '0' && c <= '9') v |= (uint64_t)(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= (uint64_t)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= (uint64_t)(c - 'A' + 10);
+            else return false;
+        }
+        out = v;
+        return true;
+    }
+}
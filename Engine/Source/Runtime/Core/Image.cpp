@@ -0,0 +1,607 @@
+﻿#include "Runtime/Core/Image.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace ace {
+    namespace {
+        inline uint32_t ReadBe32(const uint8_t* p) { return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]; }
+        inline uint32_t ReadLe32(const uint8_t* p) { return (uint32_t)p[3] << 24 | (uint32_t)p[2] << 16 | (uint32_t)p[1] << 8 | p[0]; }
+        inline uint16_t ReadLe16(const uint8_t* p) { return (uint16_t)(p[1] << 8 | p[0]); }
+
+        bool Allocate(Image& out, uint32_t w, uint32_t h)
+        {
+            if (!w || !h || w > kMaxImageSide || h > kMaxImageSide) return false;
+            out.Width = w;
+            out.Height = h;
+            out.Rgba.assign((size_t)w * h * 4, 0);
+            return true;
+        }
+
+        // ---- zlib / DEFLATE (RFC 1950/1951) ----
+
+        // LSB-first bit reader. Past the end it feeds zeros and remembers how
+        // many, so a stream that reads them fails at the next Overrun() check.
+        class BitReader {
+        public:
+            BitReader(const uint8_t* p, size_t n) : P(p), End(p + n) {}
+
+            void Need(int n)
+            {
+                while (Count < n) {
+                    uint64_t b = 0;
+                    if (P < End) b = *P++; else ++Extra;
+                    Buf |= b << Count;
+                    Count += 8;
+                }
+            }
+            uint32_t Peek(int n) { Need(n); return (uint32_t)(Buf & ((1ull << n) - 1)); }
+            void     Drop(int n) { Buf >>= n; Count -= n; }
+            uint32_t Bits(int n) { if (!n) return 0; const uint32_t v = Peek(n); Drop(n); return v; }
+            void     AlignToByte() { Drop(Count & 7); }
+            bool     Overrun() const { return Extra * 8 > (size_t)Count; }
+
+        private:
+            const uint8_t* P;
+            const uint8_t* End;
+            uint64_t       Buf = 0;
+            int            Count = 0;
+            size_t         Extra = 0;
+        };
+
+        // Canonical Huffman code as one lookup over the next MaxBits input
+        // bits: entry = symbol << 4 | code length, 0 = no such code
+        struct Huffman {
+            std::vector<uint16_t> Table;
+            int                   MaxBits = 0;
+
+            bool Build(const uint8_t* lengths, int n)
+            {
+                int count[16] = {};
+                for (int i = 0; i < n; ++i) ++count[lengths[i]];
+                count[0] = 0;
+                MaxBits = 0;
+                int left = 1;
+                for (int len = 1; len < 16; ++len) {
+                    left = (left << 1) - count[len];
+                    if (left < 0) return false;                 // over-subscribed
+                    if (count[len]) MaxBits = len;
+                }
+                if (!MaxBits) MaxBits = 1;                      // no codes: every lookup fails
+                int next[16] = {};
+                for (int len = 1, code = 0; len < 16; ++len) {
+                    code = (code + count[len - 1]) << 1;
+                    next[len] = code;
+                }
+                Table.assign((size_t)1 << MaxBits, 0);
+                for (int sym = 0; sym < n; ++sym) {
+                    const int len = lengths[sym];
+                    if (!len) continue;
+                    uint32_t code = (uint32_t)next[len]++, rev = 0;
+                    for (int i = 0; i < len; ++i) { rev = rev << 1 | (code & 1); code >>= 1; }
+                    for (size_t k = rev; k < Table.size(); k += (size_t)1 << len)
+                        Table[k] = (uint16_t)(sym << 4 | len);
+                }
+                return true;
+            }
+
+            int Decode(BitReader& br) const
+            {
+                const uint16_t e = Table[br.Peek(MaxBits)];
+                if (!e) return -1;
+                br.Drop(e & 15);
+                return e >> 4;
+            }
+        };
+
+        constexpr uint16_t kLenBase[29]  = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+        constexpr uint8_t  kLenExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+        constexpr uint16_t kDistBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,
+                                             4097,6145,8193,12289,16385,24577 };
+        constexpr uint8_t  kDistExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+        // DEFLATE expands at most 1032:1 (a 258-byte match in two 1-bit codes)
+        constexpr size_t kMaxInflateRatio = 1032;
+
+        // Inflates a zlib stream into 'out'; more than 'maxSize' bytes fails.
+        // The buffer is sized by what 'size' bytes can possibly inflate to,
+        // so a tiny stream cannot claim a huge 'maxSize' allocation.
+        bool ZlibInflate(const uint8_t* data, size_t size, size_t maxSize, std::vector<uint8_t>& out)
+        {
+            if (size < 2 || (data[0] & 0x0F) != 8 || (data[0] >> 4) > 7 || (data[1] & 0x20) ||
+                ((uint32_t)data[0] << 8 | data[1]) % 31 != 0)
+                return false;
+            BitReader br(data + 2, size - 2);
+            if (size - 2 < maxSize / kMaxInflateRatio) maxSize = (size - 2) * kMaxInflateRatio;
+            out.resize(maxSize);
+            uint8_t* const base = out.data();
+            uint8_t* op = base;
+            uint8_t* const end = base + maxSize;
+
+            Huffman lit, dist;
+            uint8_t lengths[288 + 32];
+            bool last = false;
+            while (!last) {
+                last = br.Bits(1) != 0;
+                const uint32_t type = br.Bits(2);
+                if (type == 0) {
+                    br.AlignToByte();
+                    const uint32_t len = br.Bits(16), nlen = br.Bits(16);
+                    if ((len ^ 0xFFFF) != nlen || len > (size_t)(end - op)) return false;
+                    for (uint32_t i = 0; i < len; ++i) *op++ = (uint8_t)br.Bits(8);
+                    if (br.Overrun()) return false;
+                    continue;
+                }
+                if (type == 1) {
+                    std::fill(lengths, lengths + 144, 8);
+                    std::fill(lengths + 144, lengths + 256, 9);
+                    std::fill(lengths + 256, lengths + 280, 7);
+                    std::fill(lengths + 280, lengths + 288, 8);
+                    std::fill(lengths + 288, lengths + 320, 5);
+                    lit.Build(lengths, 288);
+                    dist.Build(lengths + 288, 30);
+                } else if (type == 2) {
+                    const int nlit = (int)br.Bits(5) + 257, ndist = (int)br.Bits(5) + 1, nclen = (int)br.Bits(4) + 4;
+                    static constexpr uint8_t kOrder[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+                    uint8_t clen[19] = {};
+                    for (int i = 0; i < nclen; ++i) clen[kOrder[i]] = (uint8_t)br.Bits(3);
+                    Huffman cl;
+                    if (nlit > 286 || ndist > 30 || !cl.Build(clen, 19)) return false;
+                    for (int i = 0; i < nlit + ndist;) {
+                        const int sym = cl.Decode(br);
+                        if (sym < 0) return false;
+                        if (sym < 16) { lengths[i++] = (uint8_t)sym; continue; }
+                        uint8_t value = 0;
+                        int repeat;
+                        if (sym == 16) {
+                            if (i == 0) return false;
+                            value = lengths[i - 1];
+                            repeat = 3 + (int)br.Bits(2);
+                        } else if (sym == 17) {
+                            repeat = 3 + (int)br.Bits(3);
+                        } else {
+                            repeat = 11 + (int)br.Bits(7);
+                        }
+                        if (i + repeat > nlit + ndist) return false;
+                        std::fill(lengths + i, lengths + i + repeat, value);
+                        i += repeat;
+                    }
+                    if (!lengths[256] || !lit.Build(lengths, nlit) || !dist.Build(lengths + nlit, ndist)) return false;
+                } else {
+                    return false;
+                }
+
+                for (;;) {
+                    const int sym = lit.Decode(br);
+                    if (sym < 0 || br.Overrun()) return false;
+                    if (sym < 256) {
+                        if (op == end) return false;
+                        *op++ = (uint8_t)sym;
+                        continue;
+                    }
+                    if (sym == 256) break;
+                    if (sym > 285) return false;
+                    const size_t len = kLenBase[sym - 257] + br.Bits(kLenExtra[sym - 257]);
+                    const int d = dist.Decode(br);
+                    if (d < 0 || d > 29) return false;
+                    const size_t distance = kDistBase[d] + br.Bits(kDistExtra[d]);
+                    if (distance > (size_t)(op - base) || len > (size_t)(end - op)) return false;
+                    const uint8_t* from = op - distance;
+                    for (size_t i = 0; i < len; ++i) op[i] = from[i];  // may overlap
+                    op += len;
+                }
+            }
+            out.resize((size_t)(op - base));
+            return !br.Overrun();
+        }
+
+        // ---- PNG ----
+
+        uint8_t Paeth(int a, int b, int c)
+        {
+            const int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            return (uint8_t)(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+        }
+
+        // Reverses the per-row filters of one (sub-)image in place. The first
+        // row filters against an implicit row of zeros.
+        bool Unfilter(uint8_t* data, uint32_t rows, size_t rowBytes, size_t bpp)
+        {
+            std::vector<uint8_t> zeros(rowBytes, 0);
+            const uint8_t* prev = zeros.data();
+            for (uint32_t y = 0; y < rows; ++y) {
+                const uint8_t filter = data[0];
+                uint8_t* row = data + 1;
+                const size_t head = std::min(bpp, rowBytes);
+                switch (filter) {
+                    case 0: break;
+                    case 1:
+                        for (size_t i = bpp; i < rowBytes; ++i) row[i] = (uint8_t)(row[i] + row[i - bpp]);
+                        break;
+                    case 2:
+                        for (size_t i = 0; i < rowBytes; ++i) row[i] = (uint8_t)(row[i] + prev[i]);
+                        break;
+                    case 3:
+                        for (size_t i = 0; i < head; ++i) row[i] = (uint8_t)(row[i] + (prev[i] >> 1));
+                        for (size_t i = bpp; i < rowBytes; ++i) row[i] = (uint8_t)(row[i] + ((row[i - bpp] + prev[i]) >> 1));
+                        break;
+                    case 4:
+                        for (size_t i = 0; i < head; ++i) row[i] = (uint8_t)(row[i] + prev[i]);
+                        for (size_t i = bpp; i < rowBytes; ++i) row[i] = (uint8_t)(row[i] + Paeth(row[i - bpp], prev[i], prev[i - bpp]));
+                        break;
+                    default:
+                        return false;
+                }
+                prev = row;
+                data += rowBytes + 1;
+            }
+            return true;
+        }
+    }
+
+    bool DecodePng(const uint8_t* data, size_t size, Image& out)
+    {
+        static constexpr uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (size < 8 || std::memcmp(data, kSignature, 8) != 0) return false;
+
+        uint32_t w = 0, h = 0;
+        uint8_t depth = 0, colour = 0, interlace = 0;
+        std::array<uint8_t, 256 * 4> palette{};
+        size_t paletteSize = 0;
+        const uint8_t* trns = nullptr;
+        size_t trnsSize = 0;
+        std::vector<uint8_t> idat;
+        bool header = false;
+
+        for (size_t pos = 8; pos + 12 <= size;) {
+            const uint32_t len = ReadBe32(data + pos);
+            const uint8_t* type = data + pos + 4;
+            const uint8_t* body = data + pos + 8;
+            if (len > size - pos - 12) return false;
+            pos += 12 + (size_t)len;
+
+            if (std::memcmp(type, "IHDR", 4) == 0) {
+                if (len < 13) return false;
+                w = ReadBe32(body);
+                h = ReadBe32(body + 4);
+                depth = body[8];
+                colour = body[9];
+                interlace = body[12];
+                if (body[10] != 0 || body[11] != 0 || interlace > 1) return false;
+                header = true;
+            } else if (std::memcmp(type, "PLTE", 4) == 0) {
+                paletteSize = std::min<size_t>(len / 3, 256);
+                for (size_t i = 0; i < paletteSize; ++i) {
+                    std::memcpy(&palette[i * 4], body + i * 3, 3);
+                    palette[i * 4 + 3] = 255;
+                }
+            } else if (std::memcmp(type, "tRNS", 4) == 0) {
+                trns = body;
+                trnsSize = len;
+            } else if (std::memcmp(type, "IDAT", 4) == 0) {
+                idat.insert(idat.end(), body, body + len);
+            } else if (std::memcmp(type, "IEND", 4) == 0) {
+                break;
+            } else if (!(type[0] & 0x20)) {
+                return false;                                   // unknown critical chunk
+            }
+        }
+        if (!header || w == 0 || h == 0 || w > kMaxImageSide || h > kMaxImageSide) return false;
+
+        int channels;
+        switch (colour) {
+            case 0: channels = 1; break;
+            case 2: channels = 3; break;
+            case 3: channels = 1; break;
+            case 4: channels = 2; break;
+            case 6: channels = 4; break;
+            default: return false;
+        }
+        const bool depthOk = colour == 0 ? (depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16)
+                           : colour == 3 ? (depth == 1 || depth == 2 || depth == 4 || depth == 8)
+                           : (depth == 8 || depth == 16);
+        if (!depthOk || (colour == 3 && !paletteSize)) return false;
+        if (colour == 3 && trns)
+            for (size_t i = 0; i < std::min(trnsSize, paletteSize); ++i) palette[i * 4 + 3] = trns[i];
+
+        // Adam7 passes, or one pass covering everything
+        struct Pass { uint32_t X0, Y0, Dx, Dy; };
+        static constexpr Pass kAdam7[7] = { {0,0,8,8}, {4,0,8,8}, {0,4,4,8}, {2,0,4,4}, {0,2,2,4}, {1,0,2,2}, {0,1,1,2} };
+        static constexpr Pass kSingle[1] = { {0,0,1,1} };
+        const Pass* passes = interlace ? kAdam7 : kSingle;
+        const int passCount = interlace ? 7 : 1;
+
+        const size_t bitsPerPixel = (size_t)channels * depth;
+        const size_t bpp = std::max<size_t>(1, bitsPerPixel / 8);
+        auto passSize = [&](const Pass& p, uint32_t& pw, uint32_t& ph) {
+            pw = w > p.X0 ? (w - p.X0 + p.Dx - 1) / p.Dx : 0;
+            ph = h > p.Y0 ? (h - p.Y0 + p.Dy - 1) / p.Dy : 0;
+            return pw && ph ? (size_t)ph * (1 + (pw * bitsPerPixel + 7) / 8) : 0;
+        };
+        size_t expected = 0;
+        for (int i = 0; i < passCount; ++i) { uint32_t pw, ph; expected += passSize(passes[i], pw, ph); }
+
+        // A header that claims more pixels than the IDAT data can inflate to
+        // is rejected here, before the inflate buffer is allocated
+        if (idat.size() < 2 || idat.size() - 2 < expected / kMaxInflateRatio) return false;
+        std::vector<uint8_t> raw;
+        if (!ZlibInflate(idat.data(), idat.size(), expected, raw) || raw.size() != expected) return false;
+        idat = {};
+        if (!Allocate(out, w, h)) return false;
+
+        const uint32_t maxSample = (1u << depth) - 1;
+        auto sample = [&](const uint8_t* row, size_t i) -> uint32_t {
+            if (depth == 16) return (uint32_t)row[i * 2] << 8 | row[i * 2 + 1];
+            if (depth == 8)  return row[i];
+            const size_t bit = i * depth;
+            return (row[bit >> 3] >> (8 - depth - (bit & 7))) & maxSample;
+        };
+        auto to8 = [&](uint32_t v) -> uint8_t {
+            return (uint8_t)(depth == 16 ? v >> 8 : depth == 8 ? v : v * 255 / maxSample);
+        };
+        const bool grayKey = colour == 0 && trns && trnsSize >= 2;
+        const bool rgbKey  = colour == 2 && trns && trnsSize >= 6;
+        const uint32_t keyR = trns && trnsSize >= 2 ? (uint32_t)trns[0] << 8 | trns[1] : 0;
+        const uint32_t keyG = rgbKey ? (uint32_t)trns[2] << 8 | trns[3] : 0;
+        const uint32_t keyB = rgbKey ? (uint32_t)trns[4] << 8 | trns[5] : 0;
+
+        uint8_t* src = raw.data();
+        for (int pi = 0; pi < passCount; ++pi) {
+            const Pass& p = passes[pi];
+            uint32_t pw, ph;
+            const size_t bytes = passSize(p, pw, ph);
+            if (!bytes) continue;
+            const size_t rowBytes = (pw * bitsPerPixel + 7) / 8;
+            if (!Unfilter(src, ph, rowBytes, bpp)) return false;
+            for (uint32_t y = 0; y < ph; ++y) {
+                const uint8_t* row = src + (size_t)y * (rowBytes + 1) + 1;
+                uint8_t* dst = out.Rgba.data() + ((size_t)(p.Y0 + y * p.Dy) * w + p.X0) * 4;
+                const size_t step = (size_t)p.Dx * 4;
+                for (uint32_t x = 0; x < pw; ++x, dst += step) {
+                    const size_t i = (size_t)x * channels;
+                    switch (colour) {
+                        case 0: {
+                            const uint32_t g = sample(row, i);
+                            dst[0] = dst[1] = dst[2] = to8(g);
+                            dst[3] = grayKey && g == keyR ? 0 : 255;
+                            break;
+                        }
+                        case 2: {
+                            const uint32_t r = sample(row, i), g = sample(row, i + 1), b = sample(row, i + 2);
+                            dst[0] = to8(r); dst[1] = to8(g); dst[2] = to8(b);
+                            dst[3] = rgbKey && r == keyR && g == keyG && b == keyB ? 0 : 255;
+                            break;
+                        }
+                        case 3: {
+                            const uint32_t idx = sample(row, i);
+                            if (idx >= paletteSize) return false;
+                            std::memcpy(dst, &palette[idx * 4], 4);
+                            break;
+                        }
+                        case 4:
+                            dst[0] = dst[1] = dst[2] = to8(sample(row, i));
+                            dst[3] = to8(sample(row, i + 1));
+                            break;
+                        default:
+                            for (int c = 0; c < 4; ++c) dst[c] = to8(sample(row, i + c));
+                            break;
+                    }
+                }
+            }
+            src += bytes;
+        }
+        return true;
+    }
+
+    bool DecodeBmp(const uint8_t* data, size_t size, Image& out)
+    {
+        if (size < 54 || data[0] != 'B' || data[1] != 'M') return false;
+        const uint32_t offset = ReadLe32(data + 10);
+        const uint32_t headerSize = ReadLe32(data + 14);
+        if (headerSize < 40 || 14 + (size_t)headerSize > size) return false;
+        const int32_t  sw = (int32_t)ReadLe32(data + 18);
+        const int32_t  sh = (int32_t)ReadLe32(data + 22);
+        const uint16_t bits = ReadLe16(data + 28);
+        const uint32_t compression = ReadLe32(data + 30);
+        uint32_t colours = ReadLe32(data + 46);
+        if (sw <= 0 || sh == 0 || sh == INT32_MIN) return false;
+        const uint32_t w = (uint32_t)sw, h = (uint32_t)(sh < 0 ? -sh : sh);
+        const bool topDown = sh < 0;
+
+        // Channel masks for 16/32-bit: BI_BITFIELDS masks follow the 40-byte
+        // header (inside it for V4/V5); BI_RGB uses the fixed layouts
+        uint32_t masks[4] = {};
+        if (compression == 3) {
+            if (bits != 16 && bits != 32) return false;
+            if (14 + 40 + 12 > size) return false;
+            for (int i = 0; i < 3; ++i) masks[i] = ReadLe32(data + 54 + i * 4);
+            if (headerSize >= 56) masks[3] = ReadLe32(data + 66);
+        } else if (compression == 0) {
+            if (bits == 32)      { masks[0] = 0xFF0000; masks[1] = 0xFF00; masks[2] = 0xFF; }
+            else if (bits == 16) { masks[0] = 0x7C00;   masks[1] = 0x3E0;  masks[2] = 0x1F; }
+            else if (bits != 1 && bits != 4 && bits != 8 && bits != 24) return false;
+        } else {
+            return false;                                       // RLE and embedded JPEG/PNG
+        }
+
+        std::array<uint8_t, 256 * 4> palette{};
+        if (bits <= 8) {
+            if (!colours || colours > (1u << bits)) colours = 1u << bits;
+            const size_t at = 14 + (size_t)headerSize + (compression == 3 ? 12 : 0);
+            if (at + (size_t)colours * 4 > size) return false;
+            for (uint32_t i = 0; i < colours; ++i) {
+                const uint8_t* c = data + at + i * 4;
+                palette[i * 4 + 0] = c[2]; palette[i * 4 + 1] = c[1]; palette[i * 4 + 2] = c[0]; palette[i * 4 + 3] = 255;
+            }
+        }
+
+        const size_t stride = ((size_t)w * bits + 31) / 32 * 4;
+        if (offset > size || stride * h > size - offset) return false;
+        if (!Allocate(out, w, h)) return false;
+
+        int shift[4], width[4];
+        for (int c = 0; c < 4; ++c) {
+            shift[c] = masks[c] ? std::countr_zero(masks[c]) : 0;
+            width[c] = masks[c] ? std::popcount(masks[c]) : 0;
+            if (width[c] > 8) { shift[c] += width[c] - 8; width[c] = 8; }
+        }
+        auto channel = [&](uint32_t px, int c) -> uint8_t {
+            if (!masks[c]) return 255;
+            const uint32_t v = (px & masks[c]) >> shift[c] & ((1u << width[c]) - 1);
+            return (uint8_t)(width[c] == 8 ? v : v * 255 / ((1u << width[c]) - 1));
+        };
+
+        for (uint32_t y = 0; y < h; ++y) {
+            const uint8_t* row = data + offset + stride * (topDown ? y : h - 1 - y);
+            uint8_t* dst = out.Rgba.data() + (size_t)y * w * 4;
+            for (uint32_t x = 0; x < w; ++x, dst += 4) {
+                if (bits <= 8) {
+                    const size_t bit = (size_t)x * bits;
+                    const uint32_t idx = (row[bit >> 3] >> (8 - bits - (bit & 7))) & ((1u << bits) - 1);
+                    std::memcpy(dst, &palette[std::min(idx, colours - 1) * 4], 4);
+                } else if (bits == 24) {
+                    dst[0] = row[x * 3 + 2]; dst[1] = row[x * 3 + 1]; dst[2] = row[x * 3]; dst[3] = 255;
+                } else {
+                    const uint32_t px = bits == 32 ? ReadLe32(row + x * 4) : ReadLe16(row + x * 2);
+                    for (int c = 0; c < 4; ++c) dst[c] = channel(px, c);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool DecodeTga(const uint8_t* data, size_t size, Image& out)
+    {
+        if (size < 18) return false;
+        const uint8_t idLength = data[0], mapType = data[1], type = data[2];
+        const uint16_t mapFirst = ReadLe16(data + 3), mapLength = ReadLe16(data + 5);
+        const uint8_t mapBits = data[7];
+        const uint32_t w = ReadLe16(data + 12), h = ReadLe16(data + 14);
+        const uint8_t bits = data[16], desc = data[17];
+
+        const bool rle = type >= 9;
+        const uint8_t base = rle ? (uint8_t)(type - 8) : type;
+        if (mapType > 1 || base < 1 || base > 3 || (rle && type > 11)) return false;
+        if (base == 1 && (mapType != 1 || bits != 8 || (mapBits != 24 && mapBits != 32))) return false;
+        if (base == 2 && bits != 16 && bits != 24 && bits != 32) return false;
+        if (base == 3 && bits != 8) return false;
+
+        size_t pos = 18 + (size_t)idLength;
+        const uint8_t* map = data + pos;
+        const size_t mapEntry = (mapBits + 7) / 8;
+        if (mapType == 1) pos += (size_t)mapLength * mapEntry;
+        if (pos > size) return false;
+
+        // Fewest bytes that can hold w x h pixels (an RLE packet repeats one
+        // pixel at most 128 times), checked before allocating for them
+        const size_t pixelBytes = bits / 8;
+        const size_t pixels = (size_t)w * h;
+        const size_t minBytes = rle ? (pixels + 127) / 128 * (1 + pixelBytes) : pixels * pixelBytes;
+        if (minBytes > size - pos || !Allocate(out, w, h)) return false;
+
+        const bool alpha = (desc & 0x0F) != 0;
+        auto decode = [&](const uint8_t* p, uint8_t* dst) {
+            switch (base) {
+                case 1: {
+                    const uint32_t idx = p[0];
+                    if (idx < mapFirst || idx - mapFirst >= mapLength) { std::memset(dst, 0, 4); return; }
+                    const uint8_t* e = map + (idx - mapFirst) * mapEntry;
+                    dst[0] = e[2]; dst[1] = e[1]; dst[2] = e[0]; dst[3] = mapBits == 32 && alpha ? e[3] : 255;
+                    return;
+                }
+                case 3:
+                    dst[0] = dst[1] = dst[2] = p[0]; dst[3] = 255;
+                    return;
+                default:
+                    if (bits == 16) {
+                        const uint16_t v = ReadLe16(p);
+                        dst[0] = (uint8_t)(((v >> 10) & 31) * 255 / 31);
+                        dst[1] = (uint8_t)(((v >> 5) & 31) * 255 / 31);
+                        dst[2] = (uint8_t)((v & 31) * 255 / 31);
+                        dst[3] = alpha && !(v & 0x8000) ? 0 : 255;
+                    } else {
+                        dst[0] = p[2]; dst[1] = p[1]; dst[2] = p[0];
+                        dst[3] = bits == 32 && alpha ? p[3] : 255;
+                    }
+                    return;
+            }
+        };
+
+        // Pixels in file order, flipped into place below
+        const size_t count = (size_t)w * h;
+        uint8_t* dst = out.Rgba.data();
+        for (size_t i = 0; i < count;) {
+            size_t run = 1;
+            bool repeat = false;
+            if (rle) {
+                if (pos >= size) return false;
+                const uint8_t packet = data[pos++];
+                run = std::min<size_t>((packet & 0x7F) + 1, count - i);
+                repeat = (packet & 0x80) != 0;
+            }
+            if (repeat) {
+                if (pos + pixelBytes > size) return false;
+                decode(data + pos, dst);
+                pos += pixelBytes;
+                for (size_t k = 1; k < run; ++k) std::memcpy(dst + k * 4, dst, 4);
+            } else {
+                if (pos + run * pixelBytes > size) return false;
+                for (size_t k = 0; k < run; ++k, pos += pixelBytes) decode(data + pos, dst + k * 4);
+            }
+            dst += run * 4;
+            i += run;
+        }
+
+        const size_t rowBytes = (size_t)w * 4;
+        if (!(desc & 0x20))                                     // bottom-up
+            for (uint32_t y = 0; y < h / 2; ++y)
+                std::swap_ranges(out.Rgba.begin() + y * rowBytes, out.Rgba.begin() + (y + 1) * rowBytes,
+                                 out.Rgba.begin() + (h - 1 - y) * rowBytes);
+        if (desc & 0x10)                                        // right-to-left
+            for (uint32_t y = 0; y < h; ++y) {
+                auto* row = reinterpret_cast<uint32_t*>(out.Rgba.data() + y * rowBytes);
+                std::reverse(row, row + w);
+            }
+        return true;
+    }
+
+    bool DecodeImage(const uint8_t* data, size_t size, Image& out)
+    {
+        if (size >= 8 && data[0] == 0x89 && data[1] == 'P') return DecodePng(data, size, out);
+        if (size >= 2 && data[0] == 'B' && data[1] == 'M')  return DecodeBmp(data, size, out);
+        return DecodeTga(data, size, out);                      // no signature; the header checks stand in
+    }
+
+    void ResizeImage(const Image& src, uint32_t width, uint32_t height, Image& out)
+    {
+        out.Width = width;
+        out.Height = height;
+        out.Rgba.assign((size_t)width * height * 4, 0);
+        if (!src.IsValid()) return;
+
+        // Average of each output pixel's source footprint, colour weighted by
+        // alpha so transparent texels don't bleed into the edges
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint32_t y0 = (uint32_t)((uint64_t)y * src.Height / height);
+            const uint32_t y1 = std::max(y0 + 1, (uint32_t)((uint64_t)(y + 1) * src.Height / height));
+            for (uint32_t x = 0; x < width; ++x) {
+                const uint32_t x0 = (uint32_t)((uint64_t)x * src.Width / width);
+                const uint32_t x1 = std::max(x0 + 1, (uint32_t)((uint64_t)(x + 1) * src.Width / width));
+                uint64_t r = 0, g = 0, b = 0, a = 0;
+                for (uint32_t sy = y0; sy < y1; ++sy) {
+                    const uint8_t* p = src.Rgba.data() + ((size_t)sy * src.Width + x0) * 4;
+                    for (uint32_t sx = x0; sx < x1; ++sx, p += 4) {
+                        r += (uint64_t)p[0] * p[3]; g += (uint64_t)p[1] * p[3]; b += (uint64_t)p[2] * p[3];
+                        a += p[3];
+                    }
+                }
+                uint8_t* d = out.Rgba.data() + ((size_t)y * width + x) * 4;
+                const uint64_t n = (uint64_t)(x1 - x0) * (y1 - y0);
+                if (a) { d[0] = (uint8_t)(r / a); d[1] = (uint8_t)(g / a); d[2] = (uint8_t)(b / a); }
+                d[3] = (uint8_t)(a / n);
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ace {
+    // 8-bit RGBA pixels, rows top to bottom, no padding
+    struct Image {
+        uint32_t             Width = 0;
+        uint32_t             Height = 0;
+        std::vector<uint8_t> Rgba;
+
+        bool IsValid() const { return Width && Height && Rgba.size() == (size_t)Width * Height * 4; }
+    };
+
+    // Larger images are rejected before anything is allocated, as are images
+    // whose header claims more pixels than the file's data could hold
+    inline constexpr uint32_t kMaxImageSide = 16384;
+
+    // Decodes PNG (any bit depth and colour type, interlaced or not), BMP
+    // (uncompressed or bitfields, 1 to 32 bits) and TGA (paletted, true-colour
+    // or grey, raw or RLE), chosen by content. Lossy formats are not supported. Every read is
+    // bounds-checked, so corrupt input fails instead of overrunning.
+    bool DecodeImage(const uint8_t* data, size_t size, Image& out);
+    bool DecodePng(const uint8_t* data, size_t size, Image& out);
+    bool DecodeBmp(const uint8_t* data, size_t size, Image& out);
+    bool DecodeTga(const uint8_t* data, size_t size, Image& out);
+
+    // Box-filtered resample of 'src' to width x height (both non-zero)
+    void ResizeImage(const Image& src, uint32_t width, uint32_t height, Image& out);
+}
@@ -0,0 +1,360 @@
+﻿#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+namespace ace {
+    struct JobSystem::Job {
+        std::function<void()> Fn;
+        JobCounter*           Counter = nullptr;
+    };
+
+    // Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient
+    // Work-Stealing for Weak Memory Models"). Fixed capacity; the owner falls
+    // back to the injection queue when it is full.
+    struct JobSystem::Deque {
+        static constexpr int64_t kCapacity = 4096;
+        static constexpr int64_t kMask     = kCapacity - 1;
+
+        alignas(64) std::atomic<int64_t> Top{0};
+        alignas(64) std::atomic<int64_t> Bottom{0};
+        std::atomic<Job*> Buffer[kCapacity] = {};
+
+        bool Push(Job* job)
+        {
+            const int64_t b = Bottom.load(std::memory_order_relaxed);
+            const int64_t t = Top.load(std::memory_order_acquire);
+            if (b - t >= kCapacity) return false;
+            Buffer[b & kMask].store(job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            Bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        Job* Pop()
+        {
+            const int64_t b = Bottom.load(std::memory_order_relaxed) - 1;
+            Bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = Top.load(std::memory_order_relaxed);
+            if (t > b) { Bottom.store(b + 1, std::memory_order_relaxed); return nullptr; }
+
+            Job* job = Buffer[b & kMask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Last element: race against thieves
+                if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    job = nullptr;
+                Bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        Job* Steal()
+        {
+            int64_t t = Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = Bottom.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+            Job* job = Buffer[t & kMask].load(std::memory_order_relaxed);
+            if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+            return job;
+        }
+    };
+
+    struct JobSystem::Worker {
+        Deque        Queue;
+        std::thread  Thread;
+        uint32_t     Index = 0;
+        std::minstd_rand Rng;
+    };
+
+    namespace {
+        thread_local JobSystem*         tSystem = nullptr;
+        thread_local void*              tWorker = nullptr;
+        // Main-thread jobs running on this thread (PumpMainThread does not nest)
+        thread_local int                tMainJobDepth = 0;
+
+        // Get() is on every Run/Wait path: published through an atomic so
+        // it is one acquire load once the pool exists. The mutex only
+        // serializes creation and Shutdown().
+        std::mutex                      gPoolMutex;
+        std::atomic<JobSystem*>         gPool{nullptr};
+        bool                            gPoolShutDown = false;     // guarded by gPoolMutex
+
+        bool                            gPoolStarted = false;      // guarded by gPoolMutex
+    }
+
+    // ---- shared pool ----
+
+    void JobSystem::Startup(uint32_t numWorkers)
+    {
+        // An explicit Startup() may bring the pool back after a Shutdown()
+        std::lock_guard lock(gPoolMutex);
+        gPoolShutDown = false;
+        gPoolStarted = true;
+        if (gPool.load(std::memory_order_acquire)) return;
+        gPool.store(new JobSystem(numWorkers), std::memory_order_release);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        std::lock_guard lock(gPoolMutex);
+        gPoolShutDown = true;
+        // Jobs still running while the workers join may call Get(): they see
+        // the closing pool, whose queued leftovers are dropped unrun
+        delete gPool.load(std::memory_order_acquire);
+        gPool.store(nullptr, std::memory_order_release);
+    }
+
+    JobSystem& JobSystem::Get()
+    {
+        if (JobSystem* pool = gPool.load(std::memory_order_acquire)) return *pool;
+        std::lock_guard lock(gPoolMutex);
+        if (JobSystem* pool = gPool.load(std::memory_order_acquire)) return *pool;
+        std::fprintf(stderr, gPoolShutDown || gPoolStarted ? "ACE: JobSystem::Get() after JobSystem::Shutdown()\n"
+                                                           : "ACE: JobSystem::Get() before JobSystem::Startup()\n");
+        std::abort();
+    }
+
+    // ---- lifetime ----
+
+    JobSystem::JobSystem(uint32_t numWorkers)
+        : MainThreadId(std::this_thread::get_id())
+    {
+        if (numWorkers == 0) {
+            const uint32_t hw = std::max(1u, std::thread::hardware_concurrency());
+            numWorkers = hw > 1 ? hw - 1 : 1;
+        }
+        Injected.reserve(256);
+        Workers.reserve(numWorkers);
+        for (uint32_t i = 0; i < numWorkers; ++i) {
+            auto w = std::make_unique<Worker>();
+            w->Index = i;
+            w->Rng.seed(i * 7919u + 1u);
+            Workers.push_back(std::move(w));
+        }
+        for (auto& w : Workers) {
+            Worker* raw = w.get();
+            raw->Thread = std::thread([this, raw] { WorkerMain(raw->Index); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(SleepMutex);
+            Quit.store(true);
+        }
+        SleepCv.notify_all();
+        for (auto& w : Workers) if (w->Thread.joinable()) w->Thread.join();
+
+        // Anything left was never started; release it without running
+        for (size_t i = InjectHead; i < Injected.size(); ++i) delete Injected[i];
+        for (Job* j : MainQueue) delete j;
+        for (auto& w : Workers) while (Job* j = w->Queue.Pop()) delete j;
+    }
+
+    bool JobSystem::IsWorkerThread() const
+    {
+        return tSystem == this && tWorker != nullptr;
+    }
+
+    // ---- submission ----
+
+    void JobSystem::Run(std::function<void()> fn, JobCounter* counter)
+    {
+        if (counter) counter->Pending.fetch_add(1, std::memory_order_relaxed);
+        Submit(new Job{std::move(fn), counter});
+    }
+
+    void JobSystem::RunOnMainThread(std::function<void()> fn, JobCounter* counter)
+    {
+        if (counter) counter->Pending.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(MainMutex);
+        MainQueue.push_back(new Job{std::move(fn), counter});
+    }
+
+    void JobSystem::Then(JobCounter& after, std::function<void()> fn, JobCounter* counter, bool mainThread)
+    {
+        if (counter) counter->Pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(after.Mutex);
+            if (!after.IsDone()) {
+                after.Continuations.push_back({std::move(fn), counter, mainThread});
+                return;
+            }
+        }
+        // Already drained: schedule right away
+        if (mainThread) { std::lock_guard lock(MainMutex); MainQueue.push_back(new Job{std::move(fn), counter}); }
+        else            Submit(new Job{std::move(fn), counter});
+    }
+
+    void JobSystem::Submit(Job* job)
+    {
+        Worker* self = (tSystem == this) ? static_cast<Worker*>(tWorker) : nullptr;
+        Queued.fetch_add(1);   // seq_cst pairs with the Sleeping check below
+        if (!self || !self->Queue.Push(job)) {
+            std::lock_guard lock(InjectMutex);
+            Injected.push_back(job);
+        }
+        Wake(1);
+    }
+
+    void JobSystem::Wake(uint32_t n)
+    {
+        if (Sleeping.load() == 0) return;
+        std::lock_guard lock(SleepMutex);
+        if (n == 1) SleepCv.notify_one(); else SleepCv.notify_all();
+    }
+
+    // ---- execution ----
+
+    JobSystem::Job* JobSystem::FindJob(Worker* self)
+    {
+        if (self) if (Job* j = self->Queue.Pop()) return j;
+
+        {
+            std::lock_guard lock(InjectMutex);
+            if (InjectHead < Injected.size()) {
+                Job* j = Injected[InjectHead++];
+                if (InjectHead == Injected.size()) { Injected.clear(); InjectHead = 0; }
+                return j;
+            }
+        }
+
+        const uint32_t n = (uint32_t)Workers.size();
+        if (n == 0) return nullptr;
+        const uint32_t start = self ? (uint32_t)self->Rng() % n : (uint32_t)(std::hash<std::thread::id>{}(std::this_thread::get_id()) % n);
+        for (uint32_t i = 0; i < n; ++i) {
+            Worker* victim = Workers[(start + i) % n].get();
+            if (victim == self) continue;
+            if (Job* j = victim->Queue.Steal()) return j;
+        }
+        return nullptr;
+    }
+
+    bool JobSystem::RunOneJob(Worker* self)
+    {
+        Job* job = FindJob(self);
+        if (!job) return false;
+        Queued.fetch_sub(1, std::memory_order_acq_rel);
+        Execute(job);
+        return true;
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        try {
+            ACE_PROFILE_SCOPE("Job");
+            job->Fn();
+        } catch (...) {
+            Fail(job->Counter, std::current_exception());
+        }
+        JobCounter* counter = job->Counter;
+        delete job;
+        Finish(counter);
+    }
+
+    void JobSystem::Fail(JobCounter* counter, std::exception_ptr error)
+    {
+        Failed.fetch_add(1, std::memory_order_relaxed);
+        if (counter) {
+            std::lock_guard lock(counter->Mutex);
+            if (!counter->Error) counter->Error = std::move(error);
+            return;
+        }
+        try { std::rethrow_exception(error); }
+        catch (const std::exception& e) { ACE_LOG_ERROR("Jobs", "Job without a counter threw: %s", e.what()); }
+        catch (...)                     { ACE_LOG_ERROR("Jobs", "Job without a counter threw a non-std exception"); }
+    }
+
+    void JobSystem::Finish(JobCounter* counter)
+    {
+        if (!counter) return;
+        std::vector<JobCounter::Continuation> ready;
+        {
+            // Lock before the final decrement so Then() cannot slip a
+            // continuation in after we collected them
+            std::lock_guard lock(counter->Mutex);
+            if (counter->Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            ready.swap(counter->Continuations);
+        }
+        for (auto& c : ready) {
+            if (c.MainThread) { std::lock_guard lock(MainMutex); MainQueue.push_back(new Job{std::move(c.Fn), c.Counter}); }
+            else              Submit(new Job{std::move(c.Fn), c.Counter});
+        }
+    }
+
+    void JobSystem::WorkerMain(uint32_t index)
+    {
+        Worker* self = Workers[index].get();
+        tSystem = this;
+        tWorker = self;
+        char name[32];
+        std::snprintf(name, sizeof(name), "Worker %u", index);
+        ACE_PROFILE_THREAD(name);
+
+        int idleSpins = 0;
+        while (!Quit.load(std::memory_order_acquire)) {
+            if (RunOneJob(self)) { idleSpins = 0; continue; }
+            if (++idleSpins < 64) { std::this_thread::yield(); continue; }
+
+            std::unique_lock lock(SleepMutex);
+            Sleeping.fetch_add(1);
+            SleepCv.wait(lock, [&] { return Quit.load() || Queued.load() > 0; });
+            Sleeping.fetch_sub(1, std::memory_order_acq_rel);
+            idleSpins = 0;
+        }
+        tWorker = nullptr;
+        tSystem = nullptr;
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        Worker* self = (tSystem == this) ? static_cast<Worker*>(tWorker) : nullptr;
+        const bool main = IsMainThread();
+        while (!counter.IsDone()) {
+            if (RunOneJob(self)) continue;
+            if (main && PumpMainThread(0.0) > 0) continue;
+            std::this_thread::yield();
+        }
+        // The job that drained the counter may still be inside Finish(); taking
+        // the lock once guarantees it is done with 'counter' before we return.
+        std::exception_ptr error;
+        {
+            std::lock_guard sync(counter.Mutex);
+            error = std::exchange(counter.Error, nullptr);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    size_t JobSystem::PumpMainThread(double budgetMs)
+    {
+        // Called again from a main-thread job (through Wait() or directly):
+        // the outer pump owns the queue, so do not start a job inside a job
+        if (tMainJobDepth > 0) return 0;
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::duration<double, std::milli>(budgetMs);
+        size_t ran = 0;
+        for (;;) {
+            Job* job = nullptr;
+            {
+                std::lock_guard lock(MainMutex);
+                if (MainQueue.empty()) break;
+                job = MainQueue.front();
+                MainQueue.pop_front();
+            }
+            ++tMainJobDepth;
+            Execute(job);
+            --tMainJobDepth;
+            ++ran;
+            if (Clock::now() >= deadline) break;
+        }
+        return ran;
+    }
+}
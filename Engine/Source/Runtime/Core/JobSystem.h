@@ -0,0 +1,156 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ace {
+    class JobSystem;
+
+    // Tracks a group of jobs. Every job submitted with a counter bumps it and
+    // decrements it when done; continuations registered with Then() run once
+    // it reaches zero. Destroy or reuse a counter only after Wait() returns.
+    // A job that throws still counts as done; Wait() rethrows the first
+    // such exception once the counter drains.
+    class JobCounter {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+        int  Count() const  { return Pending.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+        struct Continuation {
+            std::function<void()> Fn;
+            JobCounter*           Counter = nullptr;
+            bool                  MainThread = false;
+        };
+        std::atomic<int>          Pending{0};
+        std::mutex                Mutex;
+        std::vector<Continuation> Continuations;
+        std::exception_ptr        Error;            // first exception from a job; guarded by Mutex
+    };
+
+    // Work-stealing job system: one worker per core (minus the main thread),
+    // each with a Chase-Lev deque. Workers pop their own deque LIFO and steal
+    // FIFO from others; jobs submitted from outside the pool go through a
+    // shared injection queue. Main-thread-affine jobs queue separately and run
+    // from PumpMainThread().
+    class JobSystem {
+    public:
+        // Shared pool used by the editor and runtime. Startup() must be
+        // called from the main thread before the first Get(), which binds
+        // IsMainThread() and PumpMainThread() to it; Get() before Startup()
+        // or after Shutdown() aborts instead of quietly starting a pool on
+        // whichever thread got there first.
+        static void       Startup(uint32_t numWorkers = 0);
+        static void       Shutdown();
+        static JobSystem& Get();
+
+        explicit JobSystem(uint32_t numWorkers = 0);
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        uint32_t NumWorkers() const { return (uint32_t)Workers.size(); }
+        // Worker threads plus the calling thread (which helps while waiting)
+        uint32_t NumThreads() const { return NumWorkers() + 1; }
+        bool     IsWorkerThread() const;
+        bool     IsMainThread() const { return std::this_thread::get_id() == MainThreadId; }
+        // Jobs that threw, with or without a counter; the ones without a
+        // counter have nobody to rethrow to and are logged instead
+        uint64_t FailedJobs() const { return Failed.load(std::memory_order_relaxed); }
+
+        void Run(std::function<void()> fn, JobCounter* counter = nullptr);
+        void RunOnMainThread(std::function<void()> fn, JobCounter* counter = nullptr);
+        // Runs 'fn' (on a worker, or on the main thread) once 'after' drains.
+        void Then(JobCounter& after, std::function<void()> fn, JobCounter* counter = nullptr, bool mainThread = false);
+
+        // Blocks until the counter drains, executing other jobs meanwhile,
+        // then rethrows the first exception thrown by one of its jobs.
+        // On the main thread this also pumps main-thread jobs, so those run
+        // inside the caller's frame code: wait only where any queued
+        // main-thread job may safely run. From inside a main-thread job it
+        // only helps with worker jobs, so such a job must not wait on
+        // another main-thread job.
+        void Wait(JobCounter& counter);
+
+        // Runs main-thread jobs until the queue is empty or 'budgetMs' elapses.
+        // Returns the number of jobs executed; 0 when called from inside a
+        // main-thread job.
+        size_t PumpMainThread(double budgetMs = 2.0);
+
+        // body(begin, end) over [0, count). The range is split lazily: each
+        // task halves its range and exposes the upper half to thieves until it
+        // is at or below the grain, so idle workers take big pieces and busy
+        // ones never pay for fine-grained jobs. grain = 0 picks count/(8*threads).
+        template<class F>
+        void ParallelFor(size_t count, F&& body, size_t grain = 0);
+
+    private:
+        struct Job;
+        struct Deque;
+        struct Worker;
+
+        void  Submit(Job* job);
+        Job*  FindJob(Worker* self);
+        bool  RunOneJob(Worker* self);
+        void  Execute(Job* job);
+        void  Finish(JobCounter* counter);
+        void  Fail(JobCounter* counter, std::exception_ptr error);
+        void  WorkerMain(uint32_t index);
+        void  Wake(uint32_t n);
+
+        std::vector<std::unique_ptr<Worker>> Workers;
+        std::thread::id                      MainThreadId;
+
+        std::mutex             InjectMutex;
+        std::vector<Job*>      Injected;      // FIFO via InjectHead
+        size_t                 InjectHead = 0;
+
+        std::mutex             MainMutex;
+        std::deque<Job*>       MainQueue;
+
+        std::mutex              SleepMutex;
+        std::condition_variable SleepCv;
+        std::atomic<int>        Sleeping{0};
+        std::atomic<int64_t>    Queued{0};     // jobs sitting in any worker-visible queue
+        std::atomic<uint64_t>   Failed{0};
+        std::atomic<bool>       Quit{false};
+    };
+
+    template<class F>
+    void JobSystem::ParallelFor(size_t count, F&& body, size_t grain)
+    {
+        if (count == 0) return;
+        if (grain == 0) grain = std::max<size_t>(1, count / (8 * (size_t)NumThreads()));
+        if (count <= grain || Workers.empty()) { body((size_t)0, count); return; }
+
+        JobCounter done;
+        std::function<void(size_t, size_t)> task = [&](size_t b, size_t e) {
+            while (e - b > grain) {
+                const size_t m = b + (e - b) / 2;
+                Run([&task, m, e] { task(m, e); }, &done);
+                e = m;
+            }
+            body(b, e);
+        };
+        // Jobs already spawned reference 'task' and 'done' on this frame:
+        // drain them before a throw from the caller's share leaves it
+        std::exception_ptr error;
+        try { task(0, count); } catch (...) { error = std::current_exception(); }
+        Wait(done);
+        if (error) std::rethrow_exception(error);
+    }
+}
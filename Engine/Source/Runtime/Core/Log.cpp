@@ -0,0 +1,516 @@
+﻿#include "Runtime/Core/Log.h"
+#include "Runtime/Core/Hash.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <signal.h>
+#endif
+
+namespace ace {
+    const char* ToString(LogLevel level)
+    {
+        switch (level) {
+        case LogLevel::Trace:   return "Trace";
+        case LogLevel::Debug:   return "Debug";
+        case LogLevel::Info:    return "Info";
+        case LogLevel::Warning: return "Warning";
+        case LogLevel::Error:   return "Error";
+        case LogLevel::Fatal:   return "Fatal";
+        }
+        return "?";
+    }
+
+    namespace {
+        constexpr size_t kRingBytes      = 1u << 20;
+        constexpr size_t kMaxMessage     = 2048;
+        constexpr size_t kMaxDisabled    = 32;
+        constexpr auto   kWriterInterval = std::chrono::milliseconds(50);
+
+        // Signals that flush the log before the process dies
+    #ifdef _WIN32
+        constexpr int kCrashSignals[] = {SIGABRT};      // the rest arrive as SEH exceptions
+    #else
+        constexpr int kCrashSignals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+    #endif
+        constexpr size_t kNumCrashSignals = sizeof(kCrashSignals) / sizeof(kCrashSignals[0]);
+
+        // Records are 8-byte aligned and never straddle the end of the ring;
+        // a header with Size == 0 means "continue at offset 0".
+        struct RecordHeader {
+            uint32_t    Size;       // header + message, rounded up to 8
+            uint32_t    Length;     // message bytes
+            int64_t     Time;       // system_clock, nanoseconds
+            const char* Category;
+            LogLevel    Level;
+        };
+
+        // Single producer (the owning thread), single consumer (the writer)
+        struct Ring {
+            std::unique_ptr<uint8_t[]> Data{new uint8_t[kRingBytes]};
+            alignas(64) std::atomic<uint64_t> Head{0};   // bytes published
+            alignas(64) std::atomic<uint64_t> Tail{0};   // bytes consumed
+            std::atomic<uint64_t> Dropped{0};            // lines lost to a full ring, not yet reported
+            std::atomic<bool> InUse{true};
+        };
+
+        // An Error or Fatal line that did not fit its ring: header and message
+        // in one 8-aligned allocation, laid out as in the ring
+        using Spilled = std::unique_ptr<uint64_t[]>;
+
+        // Formatted "YYYY-mm-dd HH:MM:SS", recomputed once per second
+        struct StampCache {
+            int64_t Second = -1;
+            char    Text[32] = {};
+        };
+
+        struct State {
+            std::mutex                         RingsMutex;
+            std::vector<std::unique_ptr<Ring>> Rings;
+
+            std::mutex           SpillMutex;
+            std::vector<Spilled> Spill;
+
+            std::atomic<int>      MinLevel{(int)LogLevel::Trace};
+            std::atomic<uint64_t> Disabled[kMaxDisabled] = {};
+            std::atomic<int>      DisabledCount{0};
+
+            std::atomic<bool> Running{false};
+            std::atomic<int>  Active{0};            // producers between the Running check and publish
+            std::thread       Writer;
+            std::thread::id   WriterId;
+            bool              Stop = false;
+
+            std::mutex              WakeMutex;
+            std::condition_variable WakeCv;
+            bool                    WakeFlag = false;
+            std::atomic<bool>       WakePending{false};
+
+            std::mutex              FlushMutex;
+            std::condition_variable FlushCv;
+            uint64_t                FlushRequested = 0;
+            uint64_t                FlushCompleted = 0;
+
+            std::mutex SyncMutex;                  // direct writes while the writer is down
+            StampCache SyncStamp;
+            std::FILE* File = nullptr;
+            std::terminate_handler PrevTerminate = nullptr;
+
+            // Crash flush: lock-free handshake with the writer (see CrashFlush)
+            std::atomic<bool> CrashFlushRequested{false};
+            std::atomic<bool> CrashFlushDone{false};
+        #ifdef _WIN32
+            void (*PrevSignal[kNumCrashSignals])(int) = {};
+            LPTOP_LEVEL_EXCEPTION_FILTER PrevExceptionFilter = nullptr;
+        #else
+            struct sigaction PrevSignal[kNumCrashSignals] = {};
+        #endif
+
+            // Writer-only scratch, reused across batches
+            std::vector<const RecordHeader*> Pending;
+            std::vector<std::pair<Ring*, uint64_t>> Consumed;
+            std::vector<Spilled> Spilling;
+            std::string Batch;
+            StampCache  WriterStamp;
+        };
+
+        // Never destroyed, so logging keeps working during static destruction
+        State& G()
+        {
+            static State* s = new State;
+            return *s;
+        }
+
+        struct ThreadRing {
+            Ring* R = nullptr;
+            ~ThreadRing() { if (R) R->InUse.store(false, std::memory_order_release); }
+        };
+        thread_local ThreadRing tRing;
+
+        Ring& AcquireRing()
+        {
+            if (tRing.R) return *tRing.R;
+            State& s = G();
+            std::lock_guard lock(s.RingsMutex);
+            for (auto& r : s.Rings) {
+                // Rings of exited threads are reused once drained
+                if (!r->InUse.load(std::memory_order_acquire) &&
+                    r->Head.load(std::memory_order_acquire) == r->Tail.load(std::memory_order_acquire)) {
+                    r->InUse.store(true, std::memory_order_relaxed);
+                    return *(tRing.R = r.get());
+                }
+            }
+            s.Rings.push_back(std::make_unique<Ring>());
+            return *(tRing.R = s.Rings.back().get());
+        }
+
+        void Wake()
+        {
+            State& s = G();
+            if (s.WakePending.exchange(true, std::memory_order_acq_rel)) return;
+            { std::lock_guard lock(s.WakeMutex); s.WakeFlag = true; }
+            s.WakeCv.notify_one();
+        }
+
+        void Push(LogLevel level, const char* category, int64_t time, const char* msg, uint32_t len)
+        {
+            Ring& r = AcquireRing();
+            const uint64_t size = (sizeof(RecordHeader) + len + 7) & ~uint64_t(7);
+            uint64_t head = r.Head.load(std::memory_order_relaxed);
+            uint64_t pos  = head % kRingBytes;
+            const uint64_t tailRoom = kRingBytes - pos;
+            const uint64_t need = tailRoom < size ? tailRoom + size : size;
+
+            // Full: never wait for the writer. Errors go to the shared spill
+            // list; anything less is counted and reported by the writer.
+            if (head + need - r.Tail.load(std::memory_order_acquire) > kRingBytes) {
+                if (level >= LogLevel::Error) {
+                    Spilled rec(new uint64_t[size / 8]);
+                    const RecordHeader h{(uint32_t)size, len, time, category, level};
+                    std::memcpy(rec.get(), &h, sizeof(h));
+                    std::memcpy(reinterpret_cast<uint8_t*>(rec.get()) + sizeof(h), msg, len);
+                    State& s = G();
+                    std::lock_guard lock(s.SpillMutex);
+                    s.Spill.push_back(std::move(rec));
+                } else {
+                    r.Dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                Wake();
+                return;
+            }
+            if (tailRoom < size) {
+                const uint32_t wrap = 0;
+                std::memcpy(r.Data.get() + pos, &wrap, sizeof(wrap));
+                head += tailRoom;
+                pos = 0;
+            }
+            RecordHeader h{(uint32_t)size, len, time, category, level};
+            std::memcpy(r.Data.get() + pos, &h, sizeof(h));
+            std::memcpy(r.Data.get() + pos + sizeof(h), msg, len);
+            r.Head.store(head + size, std::memory_order_release);
+
+            const uint64_t used = head + size - r.Tail.load(std::memory_order_relaxed);
+            if (level >= LogLevel::Error || used > kRingBytes / 2) Wake();
+        }
+
+        // "[YYYY-mm-dd HH:MM:SS] [Category] Level: message\n" (level omitted for Info)
+        void AppendLine(StampCache& stamp, std::string& out, int64_t timeNs, LogLevel level, const char* category,
+                        const char* msg, size_t len)
+        {
+            const int64_t sec = timeNs / 1000000000;
+            if (sec != stamp.Second) {
+                const std::time_t t = (std::time_t)sec;
+                std::tm tm{};
+            #ifdef _WIN32
+                localtime_s(&tm, &t);
+            #else
+                localtime_r(&t, &tm);
+            #endif
+                std::strftime(stamp.Text, sizeof(stamp.Text), "%Y-%m-%d %H:%M:%S", &tm);
+                stamp.Second = sec;
+            }
+            out += '[';
+            out += stamp.Text;
+            out += "] [";
+            out += category ? category : "Log";
+            out += "] ";
+            if (level != LogLevel::Info) { out += ToString(level); out += ": "; }
+            out.append(msg, len);
+            out += '\n';
+        }
+
+        void Emit(State& s, const std::string& text)
+        {
+            if (text.empty()) return;
+            std::fwrite(text.data(), 1, text.size(), stdout);
+            if (s.File) std::fwrite(text.data(), 1, text.size(), s.File);
+        #ifdef _WIN32
+            OutputDebugStringA(text.c_str());
+        #endif
+        }
+
+        // Writer thread: collect every published record, order by time, write one batch
+        void DrainAll(State& s)
+        {
+            s.Pending.clear();
+            s.Consumed.clear();
+            s.Spilling.clear();
+            uint64_t dropped = 0;
+            {
+                std::lock_guard lock(s.SpillMutex);
+                s.Spilling.swap(s.Spill);
+            }
+            for (const Spilled& rec : s.Spilling) s.Pending.push_back(reinterpret_cast<const RecordHeader*>(rec.get()));
+            {
+                std::lock_guard lock(s.RingsMutex);
+                for (auto& ring : s.Rings) {
+                    Ring& r = *ring;
+                    dropped += r.Dropped.exchange(0, std::memory_order_relaxed);
+                    uint64_t tail = r.Tail.load(std::memory_order_relaxed);
+                    const uint64_t head = r.Head.load(std::memory_order_acquire);
+                    if (tail == head) continue;
+                    while (tail < head) {
+                        const uint64_t pos = tail % kRingBytes;
+                        const auto* h = reinterpret_cast<const RecordHeader*>(r.Data.get() + pos);
+                        if (h->Size == 0) { tail += kRingBytes - pos; continue; }
+                        s.Pending.push_back(h);
+                        tail += h->Size;
+                    }
+                    s.Consumed.push_back({&r, tail});
+                }
+            }
+            if (s.Pending.empty() && dropped == 0) return;
+
+            std::stable_sort(s.Pending.begin(), s.Pending.end(),
+                             [](const RecordHeader* a, const RecordHeader* b) { return a->Time < b->Time; });
+            s.Batch.clear();
+            for (const RecordHeader* h : s.Pending)
+                AppendLine(s.WriterStamp, s.Batch, h->Time, h->Level, h->Category, reinterpret_cast<const char*>(h + 1), h->Length);
+            if (dropped) {
+                const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                char msg[96];
+                const int n = std::snprintf(msg, sizeof(msg), "%llu messages dropped (log writer fell behind)",
+                                            (unsigned long long)dropped);
+                AppendLine(s.WriterStamp, s.Batch, now, LogLevel::Warning, "Log", msg, (size_t)n);
+            }
+            // Records are copied out; hand the space back before the (slow) write
+            for (auto& [r, tail] : s.Consumed) r->Tail.store(tail, std::memory_order_release);
+            Emit(s, s.Batch);
+        }
+
+        void WriterMain()
+        {
+            State& s = G();
+            for (;;) {
+                bool stop;
+                {
+                    std::unique_lock lock(s.WakeMutex);
+                    s.WakeCv.wait_for(lock, kWriterInterval, [&] { return s.WakeFlag || s.Stop; });
+                    s.WakeFlag = false;
+                    stop = s.Stop;
+                }
+                s.WakePending.store(false, std::memory_order_release);
+
+                uint64_t flushTarget;
+                { std::lock_guard lock(s.FlushMutex); flushTarget = s.FlushRequested; }
+                // Read before draining: every line logged before the request is then included
+                const bool crash = s.CrashFlushRequested.load();
+                DrainAll(s);
+                if (flushTarget != s.FlushCompleted || stop || crash) {
+                    std::fflush(stdout);
+                    if (s.File) std::fflush(s.File);
+                    { std::lock_guard lock(s.FlushMutex); s.FlushCompleted = flushTarget; }
+                    s.FlushCv.notify_all();
+                }
+                if (crash) s.CrashFlushDone.store(true);
+                if (stop) return;
+            }
+        }
+
+        [[noreturn]] void OnTerminate()
+        {
+            State& s = G();
+            if (std::this_thread::get_id() != s.WriterId) Log::Flush();
+            if (s.PrevTerminate) s.PrevTerminate();
+            std::abort();
+        }
+
+        // Flush from a signal or exception handler. The crashing thread may
+        // hold any lock (a ring, the wake mutex), so nothing here blocks on
+        // one: the request is an atomic the writer checks at least every
+        // kWriterInterval, and the wait for it is bounded.
+        void CrashFlush()
+        {
+            State& s = G();
+            if (!s.Running.load() || std::this_thread::get_id() == s.WriterId) return;
+            s.CrashFlushRequested.store(true);
+            s.WakeCv.notify_one();
+            for (int i = 0; i < 100 && !s.CrashFlushDone.load(); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        void RestoreCrashHandlers()
+        {
+            State& s = G();
+            for (size_t i = 0; i < kNumCrashSignals; ++i) {
+            #ifdef _WIN32
+                std::signal(kCrashSignals[i], s.PrevSignal[i] ? s.PrevSignal[i] : SIG_DFL);
+            #else
+                sigaction(kCrashSignals[i], &s.PrevSignal[i], nullptr);
+            #endif
+            }
+        #ifdef _WIN32
+            SetUnhandledExceptionFilter(s.PrevExceptionFilter);
+        #endif
+        }
+
+        void OnCrashSignal(int sig)
+        {
+            CrashFlush();
+            // Put back what was installed before Startup() and re-raise, so the
+            // process still dies of the original signal (core dump, exit status)
+            RestoreCrashHandlers();
+            std::raise(sig);
+        }
+
+    #ifdef _WIN32
+        LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* info)
+        {
+            CrashFlush();
+            LPTOP_LEVEL_EXCEPTION_FILTER prev = G().PrevExceptionFilter;
+            return prev ? prev(info) : EXCEPTION_CONTINUE_SEARCH;
+        }
+    #endif
+
+        void InstallCrashHandlers()
+        {
+            State& s = G();
+            for (size_t i = 0; i < kNumCrashSignals; ++i) {
+            #ifdef _WIN32
+                s.PrevSignal[i] = std::signal(kCrashSignals[i], OnCrashSignal);
+                if (s.PrevSignal[i] == SIG_ERR) s.PrevSignal[i] = nullptr;
+            #else
+                struct sigaction sa = {};
+                sa.sa_handler = OnCrashSignal;
+                sigemptyset(&sa.sa_mask);
+                sigaction(kCrashSignals[i], &sa, &s.PrevSignal[i]);
+            #endif
+            }
+        #ifdef _WIN32
+            s.PrevExceptionFilter = SetUnhandledExceptionFilter(OnUnhandledException);
+        #endif
+        }
+    }
+
+    void Log::Startup(const std::filesystem::path& logFile)
+    {
+        State& s = G();
+        if (s.Running.load()) return;
+        if (!logFile.empty()) {
+        #ifdef _WIN32
+            s.File = _wfopen(logFile.c_str(), L"ab");
+        #else
+            s.File = std::fopen(logFile.c_str(), "ab");
+        #endif
+            if (s.File) std::setvbuf(s.File, nullptr, _IOFBF, 64 * 1024);
+        }
+        s.Stop = false;
+        s.Writer = std::thread(WriterMain);
+        s.WriterId = s.Writer.get_id();
+        s.PrevTerminate = std::set_terminate(OnTerminate);
+        s.CrashFlushRequested.store(false);
+        s.CrashFlushDone.store(false);
+        InstallCrashHandlers();
+        s.Running.store(true);
+    }
+
+    void Log::Shutdown()
+    {
+        State& s = G();
+        if (!s.Running.exchange(false)) return;
+        while (s.Active.load() != 0) std::this_thread::yield();
+        { std::lock_guard lock(s.WakeMutex); s.Stop = true; }
+        s.WakeCv.notify_one();
+        s.Writer.join();
+        std::set_terminate(s.PrevTerminate);
+        RestoreCrashHandlers();
+        if (s.File) { std::fclose(s.File); s.File = nullptr; }
+    }
+
+    void Log::Flush()
+    {
+        State& s = G();
+        if (!s.Running.load() || std::this_thread::get_id() == s.WriterId) { std::fflush(stdout); return; }
+        uint64_t target;
+        { std::lock_guard lock(s.FlushMutex); target = ++s.FlushRequested; }
+        Wake();
+        std::unique_lock lock(s.FlushMutex);
+        s.FlushCv.wait(lock, [&] { return s.FlushCompleted >= target || !s.Running.load(); });
+    }
+
+    void Log::SetLevel(LogLevel minLevel) { G().MinLevel.store((int)minLevel, std::memory_order_relaxed); }
+    LogLevel Log::GetLevel()              { return (LogLevel)G().MinLevel.load(std::memory_order_relaxed); }
+
+    void Log::SetCategoryEnabled(const char* category, bool enabled)
+    {
+        State& s = G();
+        const uint64_t h = HashString(category ? category : "");
+        std::lock_guard lock(s.RingsMutex);      // serialises writers of the table
+        const int n = s.DisabledCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            if (s.Disabled[i].load(std::memory_order_relaxed) != h) continue;
+            if (!enabled) return;
+            // Swap-remove; readers may briefly see either value, which is harmless
+            s.Disabled[i].store(s.Disabled[n - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            s.DisabledCount.store(n - 1, std::memory_order_release);
+            return;
+        }
+        if (!enabled && n < (int)kMaxDisabled) {
+            s.Disabled[n].store(h, std::memory_order_relaxed);
+            s.DisabledCount.store(n + 1, std::memory_order_release);
+        }
+    }
+
+    bool Log::IsEnabled(LogLevel level, const char* category)
+    {
+        State& s = G();
+        if ((int)level < s.MinLevel.load(std::memory_order_relaxed)) return false;
+        const int n = s.DisabledCount.load(std::memory_order_acquire);
+        if (n == 0) return true;
+        const uint64_t h = HashString(category ? category : "");
+        for (int i = 0; i < n; ++i)
+            if (s.Disabled[i].load(std::memory_order_relaxed) == h) return false;
+        return true;
+    }
+
+    void Log::Write(LogLevel level, const char* category, const char* fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        WriteV(level, category, fmt, args);
+        va_end(args);
+    }
+
+    void Log::WriteV(LogLevel level, const char* category, const char* fmt, va_list args)
+    {
+        char msg[kMaxMessage];
+        const int n = std::vsnprintf(msg, sizeof(msg), fmt, args);
+        const uint32_t len = n < 0 ? 0 : (uint32_t)std::min<size_t>((size_t)n, sizeof(msg) - 1);
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        State& s = G();
+        s.Active.fetch_add(1);
+        if (!s.Running.load()) {
+            s.Active.fetch_sub(1);
+            std::lock_guard lock(s.SyncMutex);
+            std::string line;
+            AppendLine(s.SyncStamp, line, now, level, category, msg, len);
+            Emit(s, line);
+            if (level >= LogLevel::Error) std::fflush(stdout);
+            return;
+        }
+        Push(level, category, now, msg, len);
+        s.Active.fetch_sub(1);
+        if (level == LogLevel::Fatal) Flush();
+    }
+}
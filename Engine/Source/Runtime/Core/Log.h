@@ -0,0 +1,75 @@
+﻿#pragma once
+#include <cstdarg>
+#include <cstdint>
+#include <filesystem>
+
+// Lines below this level are compiled out by the ACE_LOG_* macros
+// (0 Trace, 1 Debug, 2 Info, 3 Warning, 4 Error, 5 Fatal). ACE_LOG tests
+// 'level > LEVEL - 1': '>=' is always true at 0 and trips -Wtype-limits.
+#ifndef ACE_LOG_COMPILE_LEVEL
+#define ACE_LOG_COMPILE_LEVEL 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ACE_PRINTF_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define ACE_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
+
+namespace ace {
+    enum class LogLevel : uint8_t { Trace, Debug, Info, Warning, Error, Fatal };
+
+    const char* ToString(LogLevel level);
+
+    // Asynchronous logger. Each thread formats into its own lock-free SPSC
+    // ring; a background writer drains the rings, timestamps the lines and
+    // writes them in batches to stdout, the debugger and a log file kept open
+    // for the whole session. Callers never touch the file system.
+    //
+    // Write() never waits for the writer. If its thread's ring is full (the
+    // writer is behind by ~1 MiB of text), lines below Error are dropped and
+    // counted, and the writer reports "N messages dropped"; Error and Fatal
+    // lines go to a shared overflow list instead. Error and Fatal lines wake
+    // the writer immediately; Fatal also waits until everything is on disk.
+    // Outside Startup() and Shutdown() lines are written synchronously to
+    // stdout.
+    //
+    // While running, std::terminate, SIGSEGV, SIGABRT, SIGBUS, SIGFPE and
+    // SIGILL (unhandled SEH exceptions on Windows) flush what is queued
+    // before the process dies. That flush waits at most ~1 s, as the
+    // crashing thread may hold a lock the writer needs.
+    //
+    // 'category' must point to static storage (a string literal).
+    class Log {
+    public:
+        // Opens 'logFile' (appending; empty = no file) and starts the writer.
+        static void Startup(const std::filesystem::path& logFile = {});
+        // Flushes and joins the writer.
+        static void Shutdown();
+        // Blocks until every line logged before the call has been written.
+        static void Flush();
+
+        static void     SetLevel(LogLevel minLevel);
+        static LogLevel GetLevel();
+        static void     SetCategoryEnabled(const char* category, bool enabled);
+        static bool     IsEnabled(LogLevel level, const char* category);
+
+        static void Write(LogLevel level, const char* category, const char* fmt, ...) ACE_PRINTF_FORMAT(3, 4);
+        static void WriteV(LogLevel level, const char* category, const char* fmt, va_list args);
+    };
+}
+
+#define ACE_LOG(level, category, ...)                                                           \
+    do {                                                                                        \
+        if constexpr ((int)::ace::LogLevel::level > (ACE_LOG_COMPILE_LEVEL) - 1) {              \
+            if (::ace::Log::IsEnabled(::ace::LogLevel::level, category))                        \
+                ::ace::Log::Write(::ace::LogLevel::level, category, __VA_ARGS__);               \
+        }                                                                                       \
+    } while (0)
+
+#define ACE_LOG_TRACE(category, ...) ACE_LOG(Trace,   category, __VA_ARGS__)
+#define ACE_LOG_DEBUG(category, ...) ACE_LOG(Debug,   category, __VA_ARGS__)
+#define ACE_LOG_INFO(category, ...)  ACE_LOG(Info,    category, __VA_ARGS__)
+#define ACE_LOG_WARN(category, ...)  ACE_LOG(Warning, category, __VA_ARGS__)
+#define ACE_LOG_ERROR(category, ...) ACE_LOG(Error,   category, __VA_ARGS__)
+#define ACE_LOG_FATAL(category, ...) ACE_LOG(Fatal,   category, __VA_ARGS__)
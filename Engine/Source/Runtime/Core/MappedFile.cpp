@@ -0,0 +1,95 @@
+﻿#include "Runtime/Core/MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ace {
+    MappedFile::MappedFile(MappedFile&& o) noexcept
+    {
+        *this = std::move(o);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& o) noexcept
+    {
+        if (this != &o) {
+            Close();
+            std::swap(Base, o.Base);
+            std::swap(Length, o.Length);
+            std::swap(Opened, o.Opened);
+        #ifdef _WIN32
+            std::swap(Mapping, o.Mapping);
+        #endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size)) { CloseHandle(file); return false; }
+        if (size.QuadPart == 0) { CloseHandle(file); Opened = true; return true; }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);   // the mapping keeps the file open
+        if (!mapping) return false;
+        void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { CloseHandle(mapping); return false; }
+
+        Base    = base;
+        Mapping = mapping;
+        Length  = (size_t)size.QuadPart;
+        Opened  = true;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (Base)    UnmapViewOfFile(Base);
+        if (Mapping) CloseHandle(Mapping);
+        Base = nullptr; Mapping = nullptr; Length = 0; Opened = false;
+    }
+#else
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) { ::close(fd); return false; }
+        if (st.st_size == 0) { ::close(fd); Opened = true; return true; }
+
+        void* base = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps its own reference
+        if (base == MAP_FAILED) return false;
+    #ifdef MADV_WILLNEED
+        ::madvise(base, (size_t)st.st_size, MADV_WILLNEED);
+    #endif
+
+        Base   = base;
+        Length = (size_t)st.st_size;
+        Opened = true;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (Base) ::munmap(Base, Length);
+        Base = nullptr; Length = 0; Opened = false;
+    }
+#endif
+}
@@ -0,0 +1,33 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ace {
+    // Read-only memory mapping of a whole file. The view stays valid until
+    // Close() or destruction; the file must not be truncated meanwhile.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+        MappedFile(MappedFile&& o) noexcept;
+        MappedFile& operator=(MappedFile&& o) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool           IsOpen() const { return Opened; }
+        const uint8_t* Data() const   { return static_cast<const uint8_t*>(Base); }
+        size_t         Size() const   { return Length; }
+
+    private:
+        void*  Base   = nullptr;
+        size_t Length = 0;
+        bool   Opened = false;   // true for an open zero-length file (nothing mapped)
+    #ifdef _WIN32
+        void*  Mapping = nullptr;
+    #endif
+    };
+}
@@ -0,0 +1,77 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ace {
+    struct Vec3 {
+        float X = 0, Y = 0, Z = 0;
+
+        constexpr Vec3() = default;
+        constexpr Vec3(float x, float y, float z) : X(x), Y(y), Z(z) {}
+
+        constexpr Vec3 operator+(const Vec3& o) const { return {X + o.X, Y + o.Y, Z + o.Z}; }
+        constexpr Vec3 operator-(const Vec3& o) const { return {X - o.X, Y - o.Y, Z - o.Z}; }
+        constexpr Vec3 operator*(float s) const       { return {X * s, Y * s, Z * s}; }
+        constexpr bool operator==(const Vec3&) const = default;
+    };
+
+    constexpr float Dot(const Vec3& a, const Vec3& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+    constexpr Vec3  Min(const Vec3& a, const Vec3& b) { return {std::min(a.X, b.X), std::min(a.Y, b.Y), std::min(a.Z, b.Z)}; }
+    constexpr Vec3  Max(const Vec3& a, const Vec3& b) { return {std::max(a.X, b.X), std::max(a.Y, b.Y), std::max(a.Z, b.Z)}; }
+    inline float    Length(const Vec3& v) { return std::sqrt(Dot(v, v)); }
+
+    // Axis-aligned box. Empty() is inverted so that Union() with it is a no-op.
+    struct AABB {
+        Vec3 Min, Max;
+
+        static constexpr AABB Empty()
+        {
+            constexpr float inf = std::numeric_limits<float>::infinity();
+            return {{inf, inf, inf}, {-inf, -inf, -inf}};
+        }
+
+        constexpr Vec3 Center() const { return (Min + Max) * 0.5f; }
+        constexpr bool Contains(const AABB& o) const
+        {
+            return Min.X <= o.Min.X && Min.Y <= o.Min.Y && Min.Z <= o.Min.Z &&
+                   Max.X >= o.Max.X && Max.Y >= o.Max.Y && Max.Z >= o.Max.Z;
+        }
+        constexpr bool Overlaps(const AABB& o) const
+        {
+            return Min.X <= o.Max.X && Max.X >= o.Min.X && Min.Y <= o.Max.Y &&
+                   Max.Y >= o.Min.Y && Min.Z <= o.Max.Z && Max.Z >= o.Min.Z;
+        }
+        constexpr float SurfaceArea() const
+        {
+            const Vec3 d = Max - Min;
+            return 2.0f * (d.X * d.Y + d.Y * d.Z + d.Z * d.X);
+        }
+        constexpr AABB Expanded(float m) const { return {Min - Vec3(m, m, m), Max + Vec3(m, m, m)}; }
+    };
+
+    constexpr AABB Union(const AABB& a, const AABB& b) { return {Min(a.Min, b.Min), Max(a.Max, b.Max)}; }
+
+    // Squared distance from p to the box (0 inside)
+    constexpr float DistanceSq(const AABB& b, const Vec3& p)
+    {
+        const Vec3 c = Max(b.Min, Min(p, b.Max));
+        return Dot(p - c, p - c);
+    }
+
+    // Dir need not be normalized; hit distances are in multiples of Dir.
+    struct Ray {
+        Vec3 Origin;
+        Vec3 Dir{0, 0, 1};
+    };
+
+    // Points with Dot(Normal, p) + D >= 0 are on the inside.
+    struct Plane {
+        Vec3  Normal{0, 0, 1};
+        float D = 0;
+    };
+
+    struct Frustum {
+        Plane Planes[6];
+    };
+}
@@ -0,0 +1,228 @@
+﻿#include "Runtime/Core/Memory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace ace::mem {
+    namespace {
+        thread_local uint64_t tAllocCount = 0;
+        std::atomic<uint64_t> gAllocCount{0};
+        std::atomic<uint64_t> gAllocBytes{0};
+
+        size_t AlignUp(size_t v, size_t a) { return (v + a - 1) & ~(a - 1); }
+
+        std::byte* AllocBlock(size_t size)
+        {
+            return static_cast<std::byte*>(::operator new(size, std::align_val_t{64}));
+        }
+        void FreeBlock(std::byte* p)
+        {
+            ::operator delete(p, std::align_val_t{64});
+        }
+    }
+
+    uint64_t ThreadAllocCount() { return tAllocCount; }
+    uint64_t TotalAllocCount()  { return gAllocCount.load(std::memory_order_relaxed); }
+    uint64_t TotalAllocBytes()  { return gAllocBytes.load(std::memory_order_relaxed); }
+
+    // ---- LinearArena ----
+
+    LinearArena::LinearArena(size_t blockSize) : BlockSize(blockSize) {}
+
+    LinearArena::~LinearArena()
+    {
+        for (auto& b : Blocks) FreeBlock(b.Data);
+    }
+
+    void LinearArena::AddBlock(size_t minSize)
+    {
+        Block b;
+        b.Size = std::max(BlockSize, AlignUp(minSize, 4096));
+        b.Data = AllocBlock(b.Size);
+        Blocks.push_back(b);
+    }
+
+    void* LinearArena::Allocate(size_t size, size_t align)
+    {
+        if (align == 0 || (align & (align - 1)) != 0) {
+            std::fprintf(stderr, "ACE: LinearArena::Allocate alignment %zu is not a power of two\n", align);
+            std::abort();
+        }
+        if (Blocks.empty()) AddBlock(size + align);
+        for (;;) {
+            Block& b = Blocks[Current];
+            // Align the address, not the offset: blocks are only 64-aligned
+            const uintptr_t base = reinterpret_cast<uintptr_t>(b.Data);
+            const size_t off = AlignUp(base + b.Used, align) - base;
+            if (off + size <= b.Size) {
+                b.Used = off + size;
+                Peak = std::max(Peak, BytesUsed());
+                return b.Data + off;
+            }
+            // Reuse a later block kept from a previous cycle, or grow
+            if (Current + 1 < Blocks.size() && Blocks[Current + 1].Size >= size + align) {
+                ++Current;
+                Blocks[Current].Used = 0;
+                continue;
+            }
+            if (Current + 1 < Blocks.size()) {
+                for (size_t i = Current + 1; i < Blocks.size(); ++i) FreeBlock(Blocks[i].Data);
+                Blocks.resize(Current + 1);
+            }
+            AddBlock(size + align);
+            ++Current;
+        }
+    }
+
+    void LinearArena::Rewind(Marker m)
+    {
+        if (Blocks.empty()) return;
+        Current = m.Block;
+        Blocks[Current].Used = m.Used;
+    }
+
+    void LinearArena::Reset()
+    {
+        if (Blocks.size() > 1 && Current > 0) {
+            // Spilled last cycle: replace the chain with one block that fits the peak
+            const size_t want = AlignUp(Peak + Peak / 4, 4096);
+            for (auto& b : Blocks) FreeBlock(b.Data);
+            Blocks.clear();
+            AddBlock(want);
+        }
+        for (auto& b : Blocks) b.Used = 0;
+        Current = 0;
+        Peak = 0;
+    }
+
+    size_t LinearArena::BytesUsed() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i <= Current && i < Blocks.size(); ++i) n += Blocks[i].Used;
+        return n;
+    }
+
+    size_t LinearArena::Capacity() const
+    {
+        size_t n = 0;
+        for (auto& b : Blocks) n += b.Size;
+        return n;
+    }
+
+    LinearArena& FrameArena()
+    {
+        static LinearArena arena(1024 * 1024);
+        return arena;
+    }
+
+    LinearArena& ScratchArena()
+    {
+        thread_local LinearArena arena(256 * 1024);
+        return arena;
+    }
+
+    // ---- PoolAllocator ----
+
+    PoolAllocator::PoolAllocator(size_t blockSize, size_t align, size_t blocksPerPage)
+        : Align(std::max(align, alignof(FreeNode))), PerPage(std::max<size_t>(blocksPerPage, 1))
+    {
+        Stride = AlignUp(std::max(blockSize, sizeof(FreeNode)), Align);
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+        for (auto* p : Pages) ::operator delete(p, std::align_val_t{Align});
+    }
+
+    void PoolAllocator::AddPage()
+    {
+        auto* page = static_cast<std::byte*>(::operator new(Stride * PerPage, std::align_val_t{Align}));
+        Pages.push_back(page);
+        for (size_t i = PerPage; i-- > 0;) {
+            auto* n = reinterpret_cast<FreeNode*>(page + i * Stride);
+            n->Next = FreeList;
+            FreeList = n;
+        }
+    }
+
+    void* PoolAllocator::Allocate()
+    {
+        if (!FreeList) AddPage();
+        FreeNode* n = FreeList;
+        FreeList = n->Next;
+        ++Live;
+        return n;
+    }
+
+    void PoolAllocator::Free(void* p)
+    {
+        if (!p) return;
+        auto* n = static_cast<FreeNode*>(p);
+        n->Next = FreeList;
+        FreeList = n;
+        --Live;
+    }
+
+    namespace detail {
+        void CountAlloc(size_t n)
+        {
+            ++tAllocCount;
+            gAllocCount.fetch_add(1, std::memory_order_relaxed);
+            gAllocBytes.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+}
+
+#if defined(ACE_TRACK_ALLOCATIONS) && ACE_TRACK_ALLOCATIONS
+// ---- Global operator new/delete replacement (counting only) ----
+// The nothrow overloads are left to the standard library; they forward here.
+
+namespace {
+    void* AlignedAlloc(size_t n, size_t align)
+    {
+    #ifdef _WIN32
+        return _aligned_malloc(n ? n : 1, align);
+    #else
+        return std::aligned_alloc(align, (n + align - 1) / align * align);
+    #endif
+    }
+    void AlignedFree(void* p)
+    {
+    #ifdef _WIN32
+        _aligned_free(p);
+    #else
+        std::free(p);
+    #endif
+    }
+}
+
+void* operator new(size_t n)
+{
+    ace::mem::detail::CountAlloc(n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return ::operator new(n); }
+
+void* operator new(size_t n, std::align_val_t a)
+{
+    ace::mem::detail::CountAlloc(n);
+    if (void* p = AlignedAlloc(n ? n : 1, (size_t)a)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n, std::align_val_t a) { return ::operator new(n, a); }
+
+void operator delete(void* p) noexcept                             { std::free(p); }
+void operator delete[](void* p) noexcept                           { std::free(p); }
+void operator delete(void* p, size_t) noexcept                     { std::free(p); }
+void operator delete[](void* p, size_t) noexcept                   { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept           { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept         { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept   { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+#endif
@@ -0,0 +1,186 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ace::mem {
+    // ---- Heap accounting ----
+    // With ACE_TRACK_ALLOCATIONS the runtime replaces global operator new/delete
+    // and counts every call; otherwise the counters stay at zero.
+    constexpr bool IsTrackingHeap()
+    {
+    #if defined(ACE_TRACK_ALLOCATIONS) && ACE_TRACK_ALLOCATIONS
+        return true;
+    #else
+        return false;
+    #endif
+    }
+    uint64_t ThreadAllocCount();      // operator new calls made by this thread
+    uint64_t TotalAllocCount();       // all threads
+    uint64_t TotalAllocBytes();
+
+    // Counts heap allocations made by this thread while in scope.
+    class AllocCounterScope {
+    public:
+        explicit AllocCounterScope(uint64_t& out) : Out(out), Start(ThreadAllocCount()) {}
+        ~AllocCounterScope() { Out += ThreadAllocCount() - Start; }
+    private:
+        uint64_t& Out;
+        uint64_t  Start;
+    };
+
+    // ---- Linear arena ----
+    // Bump allocator over a chain of blocks. Nothing is freed individually and
+    // destructors are not run: store trivially destructible data, or types whose
+    // own allocations also come from the arena (see ArenaAllocator).
+    class LinearArena {
+    public:
+        explicit LinearArena(size_t blockSize = 64 * 1024);
+        ~LinearArena();
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        // 'align' is any power of two, including over-aligned (> 64) requests
+        void* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+        template<class T, class... Args>
+        T* New(Args&&... args) { return ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...); }
+
+        template<class T>
+        T* NewArray(size_t n)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "arena arrays are never destroyed");
+            T* p = static_cast<T*>(Allocate(sizeof(T) * n, alignof(T)));
+            for (size_t i = 0; i < n; ++i) ::new (p + i) T();
+            return p;
+        }
+
+        struct Marker { size_t Block = 0; size_t Used = 0; };
+        Marker Mark() const { return {Current, Blocks.empty() ? 0 : Blocks[Current].Used}; }
+        void   Rewind(Marker m);
+
+        // Drops everything. If the last cycle spilled into several blocks they
+        // are merged into one, so a steady workload stops touching the heap.
+        void Reset();
+
+        size_t BytesUsed() const;
+        size_t Capacity() const;
+        size_t PeakBytes() const { return Peak; }
+
+    private:
+        struct Block { std::byte* Data = nullptr; size_t Size = 0; size_t Used = 0; };
+        void AddBlock(size_t minSize);
+
+        std::vector<Block> Blocks;
+        size_t             Current   = 0;
+        size_t             BlockSize = 0;
+        size_t             Peak      = 0;
+    };
+
+    // Main-thread arena reset once per frame by the application loop. Anything
+    // allocated from it is valid until the next frame begins.
+    LinearArena& FrameArena();
+
+    // Per-thread temporary arena; pair with ScratchScope.
+    LinearArena& ScratchArena();
+
+    class ScratchScope {
+    public:
+        ScratchScope() : Arena(ScratchArena()), Mark(Arena.Mark()) {}
+        ~ScratchScope() { Arena.Rewind(Mark); }
+        LinearArena& Get() { return Arena; }
+    private:
+        LinearArena&        Arena;
+        LinearArena::Marker Mark;
+    };
+
+    // ---- Fixed-size pool ----
+    // Free-list allocator for one block size. Pages are kept until the pool
+    // dies, so a steady alloc/free pattern never reaches the heap.
+    class PoolAllocator {
+    public:
+        PoolAllocator(size_t blockSize, size_t align = alignof(std::max_align_t), size_t blocksPerPage = 256);
+        ~PoolAllocator();
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        void*  Allocate();
+        void   Free(void* p);
+        size_t BlockSize() const { return Stride; }
+        size_t LiveCount() const { return Live; }
+
+    private:
+        struct FreeNode { FreeNode* Next; };
+        void AddPage();
+
+        std::vector<std::byte*> Pages;
+        FreeNode* FreeList = nullptr;
+        size_t    Stride = 0;
+        size_t    Align  = 0;
+        size_t    PerPage = 0;
+        size_t    Live = 0;
+    };
+
+    // Thread-safe shared pool for one (size, align) pair
+    template<size_t Size, size_t Align>
+    struct SharedPool {
+        static SharedPool& Get() { static SharedPool p; return p; }
+        void* Allocate()     { std::lock_guard l(Mutex); return Pool.Allocate(); }
+        void  Free(void* ptr){ std::lock_guard l(Mutex); Pool.Free(ptr); }
+    private:
+        std::mutex    Mutex;
+        PoolAllocator Pool{Size, Align};
+    };
+
+    // ---- STL adapters ----
+
+    // Allocates from a LinearArena; deallocate is a no-op.
+    template<class T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator() noexcept : Arena(&FrameArena()) {}
+        explicit ArenaAllocator(LinearArena& a) noexcept : Arena(&a) {}
+        template<class U> ArenaAllocator(const ArenaAllocator<U>& o) noexcept : Arena(o.GetArena()) {}
+
+        T*   allocate(size_t n) { return static_cast<T*>(Arena->Allocate(n * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) noexcept {}
+
+        LinearArena* GetArena() const noexcept { return Arena; }
+        template<class U> bool operator==(const ArenaAllocator<U>& o) const noexcept { return Arena == o.GetArena(); }
+
+    private:
+        LinearArena* Arena;
+    };
+
+    // Single-object allocations (list/map/set nodes) come from a shared pool
+    // sized for T; array allocations fall back to operator new.
+    template<class T>
+    class PoolStlAllocator {
+    public:
+        using value_type = T;
+
+        PoolStlAllocator() noexcept = default;
+        template<class U> PoolStlAllocator(const PoolStlAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n)
+        {
+            if (n == 1) return static_cast<T*>(SharedPool<sizeof(T), alignof(T)>::Get().Allocate());
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if (n == 1) SharedPool<sizeof(T), alignof(T)>::Get().Free(p);
+            else        ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+
+        template<class U> bool operator==(const PoolStlAllocator<U>&) const noexcept { return true; }
+    };
+
+    template<class T> using FrameVector = std::vector<T, ArenaAllocator<T>>;
+}
@@ -0,0 +1,281 @@
+﻿#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <system_error>
+
+namespace ace {
+    namespace {
+        using Buffer = detail::ProfileBuffer;
+
+        constexpr size_t   kBufferEvents     = Buffer::kEvents;
+        constexpr size_t   kMaxCaptureEvents = 1u << 22;   // ~128 MiB
+        constexpr uint16_t kNoThread         = 0xFFFF;
+
+        struct CaptureFrame {
+            uint64_t Index;
+            int64_t  Start;
+            int64_t  End;
+        };
+
+        struct State {
+            std::mutex Mutex;                                // Buffers, names
+            std::vector<std::unique_ptr<Buffer>> Buffers;    // reused after their thread exits
+
+            // Tick rate, refined in EndFrame() as the baseline grows
+            int64_t EpochTicks = 0;
+            std::chrono::steady_clock::time_point EpochTime;
+            std::atomic<double> TicksPerNs{1.0};
+
+            // Main thread only
+            Profiler::Frame History[Profiler::kHistoryFrames];
+            size_t   HistoryNext  = 0;
+            size_t   HistoryCount = 0;
+            uint64_t FrameIndex   = 0;
+            int64_t  FrameStart   = 0;
+            std::vector<ProfileEvent> Drain;
+
+            bool Capturing = false;
+            std::vector<ProfileEvent> Capture;
+            std::vector<CaptureFrame> CaptureFrames;
+
+            State()
+            {
+                EpochTime  = std::chrono::steady_clock::now();
+                EpochTicks = Profiler::Now();
+                FrameStart = EpochTicks;
+                Calibrate(std::chrono::microseconds(500));
+            }
+
+            // Spins for 'minSpan' on first use, afterwards just re-measures
+            // against the epoch so the estimate converges over the session.
+            void Calibrate(std::chrono::microseconds minSpan)
+            {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+                std::chrono::steady_clock::time_point t;
+                do { t = std::chrono::steady_clock::now(); } while (t - EpochTime < minSpan);
+                const int64_t ticks = Profiler::Now() - EpochTicks;
+                const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t - EpochTime).count();
+                if (ns > 0 && ticks > 0) TicksPerNs.store((double)ticks / ns, std::memory_order_relaxed);
+#else
+                (void)minSpan;   // ticks are steady_clock nanoseconds already
+#endif
+            }
+        };
+
+        // Never destroyed, so scopes in static destructors stay harmless
+        State& G()
+        {
+            static State* s = new State;
+            return *s;
+        }
+
+        // Releases the thread's buffer for reuse when the thread exits
+        struct ThreadBuffer {
+            Buffer* B = nullptr;
+            ~ThreadBuffer() { if (B) B->InUse.store(false, std::memory_order_release); }
+        };
+        thread_local ThreadBuffer tBuffer;
+
+        Buffer& AcquireBuffer()
+        {
+            if (tBuffer.B) return *tBuffer.B;
+            State& s = G();
+            std::lock_guard lock(s.Mutex);
+            for (auto& b : s.Buffers) {
+                // Only take over a drained buffer so old events keep their thread
+                if (!b->InUse.load(std::memory_order_acquire) &&
+                    b->Head.load(std::memory_order_acquire) == b->Tail.load(std::memory_order_acquire)) {
+                    b->InUse.store(true, std::memory_order_relaxed);
+                    b->CachedTail = b->Tail.load(std::memory_order_relaxed);
+                    b->Name.clear();
+                    tBuffer.B = detail::tProfileBuffer = b.get();
+                    return *b;
+                }
+            }
+            auto b = std::make_unique<Buffer>();
+            b->Index = (uint16_t)std::min<size_t>(s.Buffers.size(), kNoThread - 1);
+            tBuffer.B = detail::tProfileBuffer = b.get();
+            s.Buffers.push_back(std::move(b));
+            return *tBuffer.B;
+        }
+
+        void DrainAll(State& s, std::vector<ProfileEvent>& out)
+        {
+            std::lock_guard lock(s.Mutex);
+            for (auto& b : s.Buffers) {
+                const uint64_t tail = b->Tail.load(std::memory_order_relaxed);
+                const uint64_t head = b->Head.load(std::memory_order_acquire);
+                for (uint64_t i = tail; i < head; ++i)
+                    out.push_back(b->Events[i & (kBufferEvents - 1)]);
+                b->Tail.store(head, std::memory_order_release);
+            }
+        }
+
+        void WriteJsonString(std::FILE* f, const char* str)
+        {
+            std::fputc('"', f);
+            for (const char* p = str ? str : ""; *p; ++p) {
+                const unsigned char c = (unsigned char)*p;
+                if (c == '"' || c == '\\') { std::fputc('\\', f); std::fputc(c, f); }
+                else if (c < 0x20) std::fprintf(f, "\\u%04x", c);
+                else std::fputc(c, f);
+            }
+            std::fputc('"', f);
+        }
+    }
+
+    detail::ProfileBuffer& detail::AttachProfileBuffer()
+    {
+        return AcquireBuffer();
+    }
+
+    double Profiler::ToNs(int64_t ticks)
+    {
+        State& s = G();
+        return (double)(ticks - s.EpochTicks) / s.TicksPerNs.load(std::memory_order_relaxed);
+    }
+
+    double Profiler::DurationNs(int64_t startTicks, int64_t endTicks)
+    {
+        return (double)(endTicks - startTicks) / G().TicksPerNs.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        Buffer& b = AcquireBuffer();
+        std::lock_guard lock(G().Mutex);
+        b.Name = name ? name : "";
+    }
+
+    std::string Profiler::ThreadName(uint16_t thread)
+    {
+        State& s = G();
+        std::lock_guard lock(s.Mutex);
+        if (thread < s.Buffers.size() && !s.Buffers[thread]->Name.empty())
+            return s.Buffers[thread]->Name;
+        return "Thread " + std::to_string(thread);
+    }
+
+    size_t Profiler::ThreadCount()
+    {
+        State& s = G();
+        std::lock_guard lock(s.Mutex);
+        return s.Buffers.size();
+    }
+
+    void Profiler::EndFrame()
+    {
+        State& s = G();
+        const int64_t now = Now();
+
+        Frame& f = s.History[s.HistoryNext];
+        f.Index = s.FrameIndex++;
+        f.Start = s.FrameStart;
+        f.End   = now;
+        f.Events.clear();
+        DrainAll(s, f.Events);
+        s.FrameStart = now;
+        s.HistoryNext = (s.HistoryNext + 1) % kHistoryFrames;
+        s.HistoryCount = std::min(s.HistoryCount + 1, kHistoryFrames);
+
+        if (s.Capturing) {
+            s.CaptureFrames.push_back({ f.Index, f.Start, f.End });
+            const size_t room = kMaxCaptureEvents - std::min(kMaxCaptureEvents, s.Capture.size());
+            const size_t n = std::min(room, f.Events.size());
+            s.Capture.insert(s.Capture.end(), f.Events.begin(), f.Events.begin() + (ptrdiff_t)n);
+        }
+
+        // Cheap once the baseline is long: refine roughly once a second
+        if ((f.Index & 63) == 0) s.Calibrate(std::chrono::microseconds(0));
+    }
+
+    size_t Profiler::FrameCount()
+    {
+        return G().HistoryCount;
+    }
+
+    const Profiler::Frame& Profiler::GetFrame(size_t i)
+    {
+        State& s = G();
+        const size_t oldest = (s.HistoryNext + kHistoryFrames - s.HistoryCount) % kHistoryFrames;
+        return s.History[(oldest + std::min(i, s.HistoryCount - 1)) % kHistoryFrames];
+    }
+
+    uint64_t Profiler::DroppedEvents()
+    {
+        State& s = G();
+        std::lock_guard lock(s.Mutex);
+        uint64_t n = 0;
+        for (auto& b : s.Buffers) n += b->Dropped.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    void Profiler::BeginCapture()
+    {
+        State& s = G();
+        s.Capture.clear();
+        s.CaptureFrames.clear();
+        s.Capturing = true;
+    }
+
+    bool Profiler::IsCapturing()
+    {
+        return G().Capturing;
+    }
+
+    bool Profiler::EndCapture(const std::filesystem::path& file)
+    {
+        State& s = G();
+        s.Capturing = false;
+        // Pick up whatever finished since the last frame (e.g. a capture
+        // around a load that runs outside the frame loop)
+        s.Drain.clear();
+        DrainAll(s, s.Drain);
+        s.Capture.insert(s.Capture.end(), s.Drain.begin(), s.Drain.end());
+
+        std::error_code ec;
+        if (file.has_parent_path()) std::filesystem::create_directories(file.parent_path(), ec);
+#ifdef _WIN32
+        std::FILE* f = _wfopen(file.c_str(), L"wb");
+#else
+        std::FILE* f = std::fopen(file.c_str(), "wb");
+#endif
+        if (!f) return false;
+
+        const size_t threads = ThreadCount();
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+        for (size_t t = 0; t < threads; ++t) {
+            std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":", t);
+            WriteJsonString(f, ThreadName((uint16_t)t).c_str());
+            std::fputs("}},\n", f);
+        }
+        // Frames get their own row below the threads
+        std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"Frames\"}}", threads);
+        for (const CaptureFrame& fr : s.CaptureFrames) {
+            std::fprintf(f, ",\n{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+                         (unsigned long long)fr.Index, threads, ToNs(fr.Start) / 1000.0,
+                         DurationNs(fr.Start, fr.End) / 1000.0);
+        }
+        for (const ProfileEvent& ev : s.Capture) {
+            std::fputs(",\n{\"name\":", f);
+            WriteJsonString(f, ev.Name);
+            if (ev.Type == ProfileEvent::Counter) {
+                std::fprintf(f, ",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+                             (unsigned)ev.Thread, ToNs(ev.Start) / 1000.0, ev.Value);
+            } else {
+                std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             (unsigned)ev.Thread, ToNs(ev.Start) / 1000.0, DurationNs(ev.Start, ev.End) / 1000.0);
+            }
+        }
+        std::fputs("\n]}\n", f);
+
+        s.Capture.clear();
+        s.Capture.shrink_to_fit();
+        s.CaptureFrames.clear();
+        s.CaptureFrames.shrink_to_fit();
+        const bool ok = !std::ferror(f);
+        return std::fclose(f) == 0 && ok;
+    }
+}
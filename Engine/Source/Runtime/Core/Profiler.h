@@ -0,0 +1,210 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// Shipping builds get ACE_ENABLE_PROFILER=0 from Engine/CMakeLists.txt; the
+// macros below then expand to nothing and no profiler code is referenced.
+#ifndef ACE_ENABLE_PROFILER
+#define ACE_ENABLE_PROFILER 1
+#endif
+
+namespace ace {
+    // One record in a thread's event buffer. Scopes are written once, when
+    // they close, with both timestamps; counters carry a value instead.
+    struct ProfileEvent {
+        enum Kind : uint8_t { Scope, Counter };
+
+        const char* Name = nullptr;     // static storage (a string literal)
+        int64_t     Start = 0;          // ticks, see Profiler::Now()
+        union {
+            int64_t End = 0;            // Scope
+            double  Value;              // Counter
+        };
+        uint16_t    Thread = 0;         // index into Profiler::ThreadName()
+        uint8_t     Depth = 0;          // nesting level on its thread
+        Kind        Type = Scope;
+    };
+
+    namespace detail {
+        // One thread's event ring: single producer (the owning thread),
+        // single consumer (EndFrame). In the header so that Record(), the
+        // per-scope path, inlines down to the field stores and a release.
+        struct ProfileBuffer {
+            static constexpr size_t kEvents = 1u << 15;   // 1 MiB per thread
+
+            std::unique_ptr<ProfileEvent[]> Events{new ProfileEvent[kEvents]};
+            alignas(64) std::atomic<uint64_t> Head{0};    // events published
+            alignas(64) std::atomic<uint64_t> Tail{0};    // events consumed
+            uint64_t CachedTail = 0;                      // producer's copy of Tail
+            std::atomic<uint64_t> Dropped{0};
+            std::atomic<bool> InUse{true};
+            uint16_t    Index = 0;
+            std::string Name;                             // guarded by the profiler's mutex
+        };
+
+        // The calling thread's buffer once it has recorded anything
+        inline thread_local ProfileBuffer* tProfileBuffer = nullptr;
+        // Registers a buffer for the calling thread (first event only)
+        ProfileBuffer& AttachProfileBuffer();
+    }
+
+    // Hierarchical instrumentation profiler. Every thread appends to its own
+    // lock-free SPSC buffer; the main thread drains all buffers in EndFrame()
+    // and keeps the last kHistoryFrames frames for the Profiler panel. While a
+    // capture is running, drained events are also kept for a Chrome trace
+    // (chrome://tracing, Perfetto).
+    //
+    // Timestamps are raw TSC ticks on x86 (steady_clock nanoseconds
+    // elsewhere), converted with ToNs() against a self-calibrating rate.
+    //
+    // Cost: a recorded scope is two Now() calls plus ~5 ns of bookkeeping
+    // (ACEBenchProfiler). That meets a 20 ns per-scope budget only where
+    // rdtsc is cheap; on the VM it was measured on, rdtsc alone takes
+    // ~20 ns and a scope ~45 ns. Bare-metal numbers have not been measured.
+    class Profiler {
+    public:
+        static constexpr size_t kHistoryFrames = 240;
+
+        struct Frame {
+            uint64_t Index = 0;
+            int64_t  Start = 0;         // ticks
+            int64_t  End = 0;
+            std::vector<ProfileEvent> Events;   // all threads, in drain order
+        };
+
+        static int64_t Now()
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            return (int64_t)__rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+            return (int64_t)__builtin_ia32_rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+        // Absolute ticks -> nanoseconds since the profiler started.
+        static double ToNs(int64_t ticks);
+        static double DurationNs(int64_t startTicks, int64_t endTicks);
+
+        // Recording is on by default; when off, scopes cost one relaxed load.
+        static void SetEnabled(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+        // Names the calling thread in the panel and in exported traces.
+        static void SetThreadName(const char* name);
+        static std::string ThreadName(uint16_t thread);
+        static size_t ThreadCount();
+
+        // Main thread, once per frame: closes the current frame and drains
+        // every thread's buffer into it.
+        static void EndFrame();
+
+        static size_t FrameCount();                 // <= kHistoryFrames
+        static const Frame& GetFrame(size_t i);     // 0 = oldest, FrameCount()-1 = newest
+        static uint64_t DroppedEvents();            // events lost to full buffers
+
+        static void BeginCapture();
+        static bool IsCapturing();
+        // Stops the capture and writes it as Chrome trace JSON.
+        static bool EndCapture(const std::filesystem::path& file);
+
+        // Used by ProfileScope / ACE_PROFILE_COUNTER: fill(ProfileEvent&)
+        // sets every field but Thread, directly in the ring slot. Copying a
+        // whole ProfileEvent in instead stalls on store forwarding (~13 ns).
+        template<class F>
+        static void Record(F&& fill)
+        {
+            detail::ProfileBuffer* b = detail::tProfileBuffer;
+            if (!b) b = &detail::AttachProfileBuffer();
+            const uint64_t head = b->Head.load(std::memory_order_relaxed);
+            if (head - b->CachedTail >= detail::ProfileBuffer::kEvents) {
+                b->CachedTail = b->Tail.load(std::memory_order_acquire);
+                if (head - b->CachedTail >= detail::ProfileBuffer::kEvents) {
+                    b->Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            ProfileEvent& ev = b->Events[head & (detail::ProfileBuffer::kEvents - 1)];
+            fill(ev);
+            ev.Thread = b->Index;
+            b->Head.store(head + 1, std::memory_order_release);
+        }
+        static uint8_t& Depth() { return tDepth; }
+
+    private:
+        static inline std::atomic<bool> sEnabled{true};
+        static inline thread_local uint8_t tDepth = 0;
+    };
+
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name)
+        {
+            if (!Profiler::IsEnabled()) return;
+            Name = name;
+            Depth = Profiler::Depth()++;
+            Start = Profiler::Now();
+        }
+        ~ProfileScope()
+        {
+            if (!Name) return;
+            const int64_t end = Profiler::Now();
+            Profiler::Record([&](ProfileEvent& ev) {
+                ev.Name = Name;
+                ev.Start = Start;
+                ev.End = end;
+                ev.Depth = Depth;
+                ev.Type = ProfileEvent::Scope;
+            });
+            --Profiler::Depth();
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* Name = nullptr;
+        int64_t     Start = 0;
+        uint8_t     Depth = 0;
+    };
+}
+
+#define ACE_PROFILE_CAT_IMPL(a, b) a##b
+#define ACE_PROFILE_CAT(a, b)      ACE_PROFILE_CAT_IMPL(a, b)
+
+#if ACE_ENABLE_PROFILER
+#define ACE_PROFILE_SCOPE(name) ::ace::ProfileScope ACE_PROFILE_CAT(aceProfileScope_, __LINE__)(name)
+#define ACE_PROFILE_FUNCTION()  ACE_PROFILE_SCOPE(__func__)
+#define ACE_PROFILE_COUNTER(name, value)                                                        \
+    do {                                                                                        \
+        if (::ace::Profiler::IsEnabled()) {                                                     \
+            const char* const aceProfileName_ = (name);                                         \
+            const double aceProfileValue_ = (double)(value);                                    \
+            const int64_t aceProfileNow_ = ::ace::Profiler::Now();                              \
+            ::ace::Profiler::Record([&](::ace::ProfileEvent& aceProfileEv_) {                   \
+                aceProfileEv_.Name = aceProfileName_;                                           \
+                aceProfileEv_.Start = aceProfileNow_;                                           \
+                aceProfileEv_.Value = aceProfileValue_;                                         \
+                aceProfileEv_.Depth = 0;                                                        \
+                aceProfileEv_.Type = ::ace::ProfileEvent::Counter;                              \
+            });                                                                                 \
+        }                                                                                       \
+    } while (0)
+#define ACE_PROFILE_FRAME() ::ace::Profiler::EndFrame()
+#define ACE_PROFILE_THREAD(name) ::ace::Profiler::SetThreadName(name)
+#else
+#define ACE_PROFILE_SCOPE(name)          do {} while (0)
+#define ACE_PROFILE_FUNCTION()           do {} while (0)
+#define ACE_PROFILE_COUNTER(name, value) do {} while (0)
+#define ACE_PROFILE_FRAME()              do {} while (0)
+#define ACE_PROFILE_THREAD(name)         do {} while (0)
+#endif
@@ -0,0 +1,243 @@
+﻿#pragma once
+// Compile-time reflection tables emitted by ACEHeaderTool.
+//
+// For every ACE_CLASS/ACE_STRUCT that contains GENERATED_BODY(), the header tool
+// writes <Class>.generated.h with a per-line GENERATED_BODY expansion. That
+// expansion adds constexpr AceStaticProperties()/AceStaticFunctions() tables to
+// the class; TClass<T> turns them into a flat ClassInfo that serialization, the
+// Inspector and blueprints can walk without string-keyed lookups.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ace::reflect {
+
+    enum class EPropertyType : uint8_t {
+        Unknown,
+        Bool,
+        Int8, Int16, Int32, Int64,
+        UInt8, UInt16, UInt32, UInt64,
+        Float, Double,
+        String,
+        Path,
+        Enum,
+        Struct,
+    };
+
+    // Specifiers accepted inside ACE_PROPERTY(...)
+    enum EPropertyFlags : uint32_t {
+        PF_None               = 0,
+        PF_EditAnywhere       = 1u << 0,
+        PF_EditDefaultsOnly   = 1u << 1,
+        PF_VisibleAnywhere    = 1u << 2,
+        PF_BlueprintReadOnly  = 1u << 3,
+        PF_BlueprintReadWrite = 1u << 4,
+        PF_Transient          = 1u << 5,
+        PF_SaveGame           = 1u << 6,
+        PF_Config             = 1u << 7,
+    };
+
+    // Specifiers accepted inside ACE_FUNCTION(...)
+    enum EFunctionFlags : uint32_t {
+        FF_None              = 0,
+        FF_BlueprintCallable = 1u << 0,
+        FF_BlueprintPure     = 1u << 1,
+        FF_Exec              = 1u << 2,
+        FF_Static            = 1u << 3,
+        FF_Const             = 1u << 4,
+    };
+
+    template<class T>
+    constexpr EPropertyType PropertyTypeOf()
+    {
+        using U = std::remove_cv_t<T>;
+        if constexpr (std::is_same_v<U, bool>)                  return EPropertyType::Bool;
+        else if constexpr (std::is_same_v<U, float>)            return EPropertyType::Float;
+        else if constexpr (std::is_same_v<U, double>)           return EPropertyType::Double;
+        else if constexpr (std::is_same_v<U, std::string>)      return EPropertyType::String;
+        else if constexpr (std::is_same_v<U, std::filesystem::path>) return EPropertyType::Path;
+        else if constexpr (std::is_enum_v<U>)                   return EPropertyType::Enum;
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            if constexpr (sizeof(U) == 1) return EPropertyType::Int8;
+            else if constexpr (sizeof(U) == 2) return EPropertyType::Int16;
+            else if constexpr (sizeof(U) == 4) return EPropertyType::Int32;
+            else return EPropertyType::Int64;
+        }
+        else if constexpr (std::is_integral_v<U>) {
+            if constexpr (sizeof(U) == 1) return EPropertyType::UInt8;
+            else if constexpr (sizeof(U) == 2) return EPropertyType::UInt16;
+            else if constexpr (sizeof(U) == 4) return EPropertyType::UInt32;
+            else return EPropertyType::UInt64;
+        }
+        else if constexpr (std::is_class_v<U>)                 return EPropertyType::Struct;
+        else return EPropertyType::Unknown;
+    }
+
+    struct PropertyInfo {
+        std::string_view Name;
+        std::string_view TypeName;   // spelling from the header, array bounds included
+        std::string_view Category;
+        EPropertyType    Type   = EPropertyType::Unknown;
+        uint32_t         Flags  = PF_None;
+        uint32_t         Offset = 0;
+        uint32_t         Size   = 0;
+
+        void*       Address(void* obj) const             { return static_cast<char*>(obj) + Offset; }
+        const void* Address(const void* obj) const       { return static_cast<const char*>(obj) + Offset; }
+        template<class V> V&       As(void* obj) const       { return *static_cast<V*>(Address(obj)); }
+        template<class V> const V& As(const void* obj) const { return *static_cast<const V*>(Address(obj)); }
+    };
+
+    // Uniform calling convention for reflected functions:
+    //   Args[i] points at the i-th argument, Ret (may be null) receives the result.
+    using FunctionThunk = void (*)(void* Self, void* const* Args, void* Ret);
+
+    struct FunctionInfo {
+        std::string_view Name;
+        std::string_view Category;
+        uint32_t         Flags     = FF_None;
+        uint32_t         NumParams = 0;
+        FunctionThunk    Thunk     = nullptr;
+    };
+
+    struct ClassInfo {
+        std::string_view              Name;
+        std::string_view              SuperName;
+        uint32_t                      Size = 0;
+        std::span<const PropertyInfo> Properties;
+        std::span<const FunctionInfo> Functions;
+
+        constexpr const PropertyInfo* FindProperty(std::string_view name) const
+        {
+            for (const auto& p : Properties) if (p.Name == name) return &p;
+            return nullptr;
+        }
+        constexpr const FunctionInfo* FindFunction(std::string_view name) const
+        {
+            for (const auto& f : Functions) if (f.Name == name) return &f;
+            return nullptr;
+        }
+    };
+
+    // --- Function thunks ---
+
+    template<class F> struct TFunctionTraits;
+
+    template<class R, class... A>
+    struct TFunctionTraits<R (*)(A...)> {
+        using Class  = void;
+        using Return = R;
+        using Args   = std::tuple<A...>;
+        static constexpr bool IsMember = false;
+    };
+    template<class R, class... A>
+    struct TFunctionTraits<R (*)(A...) noexcept> : TFunctionTraits<R (*)(A...)> {};
+
+    template<class C, class R, class... A>
+    struct TFunctionTraits<R (C::*)(A...)> {
+        using Class  = C;
+        using Return = R;
+        using Args   = std::tuple<A...>;
+        static constexpr bool IsMember = true;
+    };
+    template<class C, class R, class... A>
+    struct TFunctionTraits<R (C::*)(A...) const> : TFunctionTraits<R (C::*)(A...)> { using Class = const C; };
+    template<class C, class R, class... A>
+    struct TFunctionTraits<R (C::*)(A...) noexcept> : TFunctionTraits<R (C::*)(A...)> {};
+    template<class C, class R, class... A>
+    struct TFunctionTraits<R (C::*)(A...) const noexcept> : TFunctionTraits<R (C::*)(A...) const> {};
+
+    template<auto Fn>
+    struct TThunk {
+        using Traits = TFunctionTraits<decltype(Fn)>;
+        static constexpr uint32_t NumParams = (uint32_t)std::tuple_size_v<typename Traits::Args>;
+
+        static void Call(void* Self, void* const* Args, void* Ret)
+        {
+            CallImpl(Self, Args, Ret, std::make_index_sequence<NumParams>{});
+        }
+
+    private:
+        template<std::size_t I>
+        static decltype(auto) Arg(void* const* Args)
+        {
+            using A = std::tuple_element_t<I, typename Traits::Args>;
+            return std::forward<A>(*static_cast<std::remove_cvref_t<A>*>(Args[I]));
+        }
+
+        template<std::size_t... I>
+        static void CallImpl([[maybe_unused]] void* Self, [[maybe_unused]] void* const* Args,
+                             [[maybe_unused]] void* Ret, std::index_sequence<I...>)
+        {
+            using R = typename Traits::Return;
+            auto invoke = [&]() -> decltype(auto) {
+                if constexpr (Traits::IsMember)
+                    return std::invoke(Fn, *static_cast<typename Traits::Class*>(Self), Arg<I>(Args)...);
+                else
+                    return std::invoke(Fn, Arg<I>(Args)...);
+            };
+            if constexpr (std::is_void_v<R>) {
+                invoke();
+            } else {
+                if (Ret) *static_cast<std::remove_cvref_t<R>*>(Ret) = invoke();
+                else     (void)invoke();
+            }
+        }
+    };
+
+    // --- Class tables ---
+
+    template<class T>
+    struct TClass {
+        static constexpr auto Properties = T::AceStaticProperties();
+        static constexpr auto Functions  = T::AceStaticFunctions();
+        static constexpr ClassInfo Info{
+            T::AceStaticName(),
+            T::AceStaticSuperName(),
+            (uint32_t)sizeof(T),
+            std::span<const PropertyInfo>(Properties.data(), Properties.size()),
+            std::span<const FunctionInfo>(Functions.data(), Functions.size()),
+        };
+    };
+
+    template<class T>
+    concept Reflected = requires { T::AceStaticProperties(); T::AceStaticFunctions(); };
+
+    template<Reflected T>
+    constexpr const ClassInfo& GetClass() { return TClass<T>::Info; }
+}
+
+// offsetof on non-standard-layout types (classes with virtual functions) is
+// conditionally supported; every compiler we target evaluates it as a constant.
+#define ACE_REFLECT_OFFSETOF(Type, Member) ((uint32_t)offsetof(Type, Member))
+
+#if defined(__clang__)
+  #define ACE_REFLECT_DISABLE_OFFSETOF_WARNING _Pragma("clang diagnostic push") _Pragma("clang diagnostic ignored \"-Winvalid-offsetof\"")
+  #define ACE_REFLECT_RESTORE_WARNINGS         _Pragma("clang diagnostic pop")
+#elif defined(__GNUC__)
+  #define ACE_REFLECT_DISABLE_OFFSETOF_WARNING _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+  #define ACE_REFLECT_RESTORE_WARNINGS         _Pragma("GCC diagnostic pop")
+#else
+  #define ACE_REFLECT_DISABLE_OFFSETOF_WARNING
+  #define ACE_REFLECT_RESTORE_WARNINGS
+#endif
+
+// Table rows used by generated code (inside the class, where ThisClass is declared).
+#define ACE_REFLECT_PROPERTY(Member, TypeName, Category, Flags)                            \
+    ::ace::reflect::PropertyInfo{ #Member, TypeName, Category,                             \
+        ::ace::reflect::PropertyTypeOf<decltype(ThisClass::Member)>(), (uint32_t)(Flags),  \
+        ACE_REFLECT_OFFSETOF(ThisClass, Member), (uint32_t)sizeof(ThisClass::Member) }
+
+#define ACE_REFLECT_FUNCTION(Function, Category, Flags)                                    \
+    ::ace::reflect::FunctionInfo{ #Function, Category, (uint32_t)(Flags),                  \
+        ::ace::reflect::TThunk<&ThisClass::Function>::NumParams,                           \
+        &::ace::reflect::TThunk<&ThisClass::Function>::Call }
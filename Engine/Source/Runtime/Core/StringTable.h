@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    // Deduplicating string table for binary files; index 0 is always "".
+    // Serialized as uint32 offsets[Count() + 1] followed by the UTF-8 bytes,
+    // so string i is bytes[offsets[i], offsets[i + 1]).
+    class StringTable {
+    public:
+        StringTable() { Intern({}); }
+
+        uint32_t Intern(std::string_view s)
+        {
+            if (auto it = Index.find(s); it != Index.end()) return it->second;
+            const uint32_t id = (uint32_t)Offsets.size();
+            Offsets.push_back((uint32_t)Bytes.size());
+            Bytes.append(s);
+            // keys view into Storage; deque never relocates its elements
+            Storage.emplace_back(s);
+            Index.emplace(Storage.back(), id);
+            return id;
+        }
+
+        uint32_t Count() const { return (uint32_t)Offsets.size(); }
+        uint64_t ByteSize() const { return (Offsets.size() + 1) * sizeof(uint32_t) + Bytes.size(); }
+
+        // Writes ByteSize() bytes at out[at]
+        void Write(std::vector<uint8_t>& out, uint64_t at) const
+        {
+            uint8_t* p = out.data() + at;
+            std::memcpy(p, Offsets.data(), Offsets.size() * sizeof(uint32_t));
+            p += Offsets.size() * sizeof(uint32_t);
+            const uint32_t end = (uint32_t)Bytes.size();
+            std::memcpy(p, &end, sizeof(end));
+            p += sizeof(end);
+            std::memcpy(p, Bytes.data(), Bytes.size());
+        }
+
+    private:
+        std::vector<uint32_t> Offsets;
+        std::string           Bytes;
+        std::deque<std::string> Storage;
+        std::unordered_map<std::string_view, uint32_t> Index;
+    };
+}
@@ -0,0 +1,444 @@
+﻿#include "Runtime/IO/FileWatcher.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ace {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+        using PathKey = std::filesystem::path::string_type;
+
+        struct Command {
+            enum class Op { Watch, Unwatch, Clear } Kind;
+            uint32_t              Id = 0;
+            std::filesystem::path Dir;
+        };
+
+        // What the snapshot backend remembers per path
+        struct Stamp {
+            uint64_t Size;
+            int64_t  Time;
+            bool     IsDir;
+        };
+        using Snapshot = std::unordered_map<PathKey, Stamp>;
+
+        // 'path' is 'dir' or below it (both as built by the watcher, so lexical)
+        bool UnderDir(const PathKey& path, const PathKey& dir)
+        {
+            if (path.size() < dir.size() || path.compare(0, dir.size(), dir) != 0) return false;
+            return path.size() == dir.size() || path[dir.size()] == std::filesystem::path::preferred_separator ||
+                   path[dir.size()] == '/';
+        }
+
+        void TakeSnapshot(const std::filesystem::path& dir, Snapshot& out)
+        {
+            out.clear();
+            std::error_code ec;
+            for (std::filesystem::recursive_directory_iterator it(dir, std::filesystem::directory_options::skip_permission_denied, ec), end;
+                 !ec && it != end; it.increment(ec)) {
+                std::error_code eec;
+                Stamp s{0, 0, it->is_directory(eec)};
+                if (!s.IsDir) s.Size = (uint64_t)it->file_size(eec);
+                const auto t = it->last_write_time(eec);
+                s.Time = eec ? 0 : (int64_t)t.time_since_epoch().count();
+                out.emplace(it->path().native(), s);
+            }
+        }
+
+    #ifdef __linux__
+        constexpr uint32_t kInotifyMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                          IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_ONLYDIR;
+    #endif
+    }
+
+    struct FileWatcher::State {
+        Settings                Config;
+        std::thread             Thread;
+        std::atomic<bool>       Stop{false};
+        std::atomic<bool>       Polling{false};
+
+        std::mutex              Mutex;          // Commands, Published, NextId
+        std::condition_variable Wake;           // snapshot backend sleeps here
+        std::vector<Command>    Commands;
+        std::vector<FileChange> Published;
+        std::atomic<bool>       HasPublished{false};
+        std::atomic<uint64_t>   Batches{0};
+        uint32_t                NextId = 1;
+
+        // ---- watcher thread only ----
+        struct Root {
+            uint32_t              Id;
+            std::filesystem::path Dir;
+            Snapshot              Files;        // snapshot backend
+        };
+        std::vector<Root> Roots;
+
+        // Burst being coalesced, in first-seen order; Live[i] false = cancelled out
+        std::unordered_map<PathKey, size_t> PendingIndex;
+        std::vector<FileChange> Pending;
+        std::vector<uint8_t>    Live;
+        Clock::time_point       BurstStart, LastEvent;
+
+    #ifdef __linux__
+        int Inotify = -1;
+        int WakeFd  = -1;
+        std::unordered_map<int, std::filesystem::path> WatchDirs;   // wd -> directory
+        bool OutOfWatches = false;
+    #endif
+
+        void Signal()
+        {
+        #ifdef __linux__
+            if (WakeFd >= 0) { const uint64_t one = 1; (void)!::write(WakeFd, &one, sizeof(one)); }
+        #endif
+            Wake.notify_one();
+        }
+
+        void Emit(const std::filesystem::path& path, FileChangeKind kind, bool isDir)
+        {
+            const auto now = Clock::now();
+            if (Pending.empty()) BurstStart = now;
+            LastEvent = now;
+
+            auto [it, inserted] = PendingIndex.try_emplace(path.native(), Pending.size());
+            if (inserted) {
+                Pending.push_back({kind, isDir, path});
+                Live.push_back(1);
+                return;
+            }
+            FileChange& p = Pending[it->second];
+            uint8_t& live = Live[it->second];
+            if (!live) { p.Kind = kind; p.IsDir = isDir; live = 1; return; }
+            if (isDir) p.IsDir = true;
+
+            using K = FileChangeKind;
+            if (p.Kind == K::Rescan || kind == K::Rescan) { p.Kind = K::Rescan; return; }
+            switch (p.Kind) {
+            case K::Added:    if (kind == K::Removed) live = 0; break;              // never existed as far as anyone saw
+            case K::Modified: if (kind == K::Removed) p.Kind = K::Removed; break;
+            case K::Removed:  if (kind != K::Removed) p.Kind = K::Modified; break;  // replaced
+            default: break;
+            }
+        }
+
+        bool FlushDue() const
+        {
+            if (Pending.empty()) return false;
+            const auto now = Clock::now();
+            return now - LastEvent >= std::chrono::milliseconds(Config.CoalesceMs) ||
+                   now - BurstStart >= std::chrono::milliseconds(Config.MaxLatencyMs);
+        }
+
+        // Milliseconds until FlushDue() becomes true; -1 = nothing pending
+        int FlushTimeoutMs() const
+        {
+            if (Pending.empty()) return -1;
+            const auto due = std::min(LastEvent + std::chrono::milliseconds(Config.CoalesceMs),
+                                      BurstStart + std::chrono::milliseconds(Config.MaxLatencyMs));
+            const auto ms = std::chrono::ceil<std::chrono::milliseconds>(due - Clock::now()).count();
+            return (int)std::max<long long>(0, ms);
+        }
+
+        void Flush()
+        {
+            std::vector<FileChange> batch;
+            batch.reserve(Pending.size());
+            for (size_t i = 0; i < Pending.size(); ++i)
+                if (Live[i]) batch.push_back(std::move(Pending[i]));
+            Pending.clear();
+            Live.clear();
+            PendingIndex.clear();
+            if (batch.empty()) return;
+
+            std::lock_guard lock(Mutex);
+            if (Published.empty()) Published = std::move(batch);
+            else Published.insert(Published.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+            HasPublished.store(true, std::memory_order_release);
+            Batches.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void ApplyCommands()
+        {
+            std::vector<Command> cmds;
+            {
+                std::lock_guard lock(Mutex);
+                cmds.swap(Commands);
+            }
+            for (auto& c : cmds) {
+                switch (c.Kind) {
+                case Command::Op::Watch:
+                    Roots.push_back({c.Id, std::move(c.Dir), {}});
+                    AttachRoot(Roots.back());
+                    break;
+                case Command::Op::Unwatch:
+                    for (auto it = Roots.begin(); it != Roots.end(); ++it)
+                        if (it->Id == c.Id) { DetachRoot(*it); Roots.erase(it); break; }
+                    break;
+                case Command::Op::Clear:
+                    for (auto& r : Roots) DetachRoot(r);
+                    Roots.clear();
+                    break;
+                }
+            }
+        }
+
+        void AttachRoot(Root& r)
+        {
+            if (Polling.load()) { TakeSnapshot(r.Dir, r.Files); return; }
+        #ifdef __linux__
+            AddTree(r.Dir, false);
+        #endif
+        }
+
+        void DetachRoot(Root& r)
+        {
+            r.Files.clear();
+        #ifdef __linux__
+            if (!Polling.load()) RemoveTree(r.Dir);
+        #endif
+        }
+
+        // ---- snapshot backend ----
+
+        void DiffRoot(Root& r)
+        {
+            Snapshot now;
+            TakeSnapshot(r.Dir, now);
+            for (const auto& [path, s] : now) {
+                const auto it = r.Files.find(path);
+                if (it == r.Files.end())
+                    Emit(path, FileChangeKind::Added, s.IsDir);
+                else if (it->second.IsDir != s.IsDir || (!s.IsDir && (it->second.Size != s.Size || it->second.Time != s.Time)))
+                    Emit(path, FileChangeKind::Modified, s.IsDir);
+            }
+            for (const auto& [path, s] : r.Files)
+                if (!now.count(path)) Emit(path, FileChangeKind::Removed, s.IsDir);
+            r.Files = std::move(now);
+        }
+
+        void PollLoop()
+        {
+            for (auto& r : Roots) TakeSnapshot(r.Dir, r.Files);
+            while (!Stop.load()) {
+                {
+                    std::unique_lock lock(Mutex);
+                    Wake.wait_for(lock, std::chrono::milliseconds(Config.PollIntervalMs),
+                                  [&] { return Stop.load() || !Commands.empty(); });
+                }
+                if (Stop.load()) break;
+                ACE_PROFILE_SCOPE("FileWatcher::Poll");
+                ApplyCommands();
+                for (auto& r : Roots) DiffRoot(r);
+                Flush();    // the interval already coalesced the burst
+            }
+        }
+
+        // ---- inotify backend ----
+
+    #ifdef __linux__
+        void AddTree(const std::filesystem::path& dir, bool emitContents)
+        {
+            if (OutOfWatches) return;
+            const int wd = inotify_add_watch(Inotify, dir.c_str(), kInotifyMask);
+            if (wd < 0) {
+                if (errno == ENOSPC || errno == ENOMEM) OutOfWatches = true;
+                return;     // otherwise the directory is already gone
+            }
+            WatchDirs[wd] = dir;
+            // Anything created before the watch existed is reported here
+            std::error_code ec;
+            for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                std::error_code eec;
+                const bool isDir = it->is_directory(eec) && !it->is_symlink(eec);
+                if (emitContents) Emit(it->path(), FileChangeKind::Added, isDir);
+                if (isDir) AddTree(it->path(), emitContents);
+            }
+        }
+
+        void RemoveTree(const std::filesystem::path& dir)
+        {
+            for (auto it = WatchDirs.begin(); it != WatchDirs.end();) {
+                if (UnderDir(it->second.native(), dir.native())) {
+                    inotify_rm_watch(Inotify, it->first);
+                    it = WatchDirs.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void ReadEvents()
+        {
+            alignas(inotify_event) char buf[64 * 1024];
+            for (;;) {
+                const ssize_t n = ::read(Inotify, buf, sizeof(buf));
+                if (n <= 0) return;     // EAGAIN: drained
+                for (const char* p = buf; p < buf + n;) {
+                    const auto* ev = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + ev->len;
+
+                    if (ev->mask & IN_Q_OVERFLOW) {
+                        for (const auto& r : Roots) Emit(r.Dir, FileChangeKind::Rescan, true);
+                        continue;
+                    }
+                    const auto it = WatchDirs.find(ev->wd);
+                    if (it == WatchDirs.end()) continue;
+                    if (ev->mask & IN_IGNORED) { WatchDirs.erase(it); continue; }
+                    if (ev->len == 0) continue;     // the watched directory itself; its parent reports it
+
+                    const std::filesystem::path path = it->second / ev->name;
+                    const bool isDir = (ev->mask & IN_ISDIR) != 0;
+                    if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        Emit(path, FileChangeKind::Added, isDir);
+                        if (isDir) AddTree(path, true);
+                    } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                        Emit(path, FileChangeKind::Removed, isDir);
+                        if (isDir) RemoveTree(path);
+                    } else if (!isDir) {
+                        Emit(path, FileChangeKind::Modified, false);
+                    }
+                }
+            }
+        }
+
+        void InotifyLoop()
+        {
+            while (!Stop.load()) {
+                ApplyCommands();
+                if (OutOfWatches) {
+                    ACE_LOG_WARN("FileWatcher", "inotify watch limit reached (fs.inotify.max_user_watches); polling instead");
+                    return;
+                }
+                pollfd fds[2] = {{Inotify, POLLIN, 0}, {WakeFd, POLLIN, 0}};
+                if (::poll(fds, 2, FlushTimeoutMs()) < 0 && errno != EINTR) {
+                    ACE_LOG_WARN("FileWatcher", "poll() failed (errno %d); polling instead", errno);
+                    return;
+                }
+                if (fds[1].revents & POLLIN) { uint64_t v; (void)!::read(WakeFd, &v, sizeof(v)); }
+                if (fds[0].revents & POLLIN) {
+                    ACE_PROFILE_SCOPE("FileWatcher::Read");
+                    ReadEvents();
+                }
+                if (FlushDue()) Flush();
+            }
+        }
+
+        void CloseInotify()
+        {
+            if (Inotify >= 0) ::close(Inotify);
+            Inotify = -1;
+            WatchDirs.clear();
+        }
+    #endif
+
+        void Run()
+        {
+            ACE_PROFILE_THREAD("FileWatcher");
+        #ifdef __linux__
+            if (!Polling.load()) {
+                InotifyLoop();
+                if (Stop.load()) return;
+                // Fell back mid-session: whatever happened meanwhile is unknown
+                CloseInotify();
+                Polling.store(true);
+                Flush();
+                for (const auto& r : Roots) Emit(r.Dir, FileChangeKind::Rescan, true);
+                Flush();
+            }
+        #endif
+            PollLoop();
+        }
+    };
+
+    FileWatcher::FileWatcher() : FileWatcher(Settings{}) {}
+
+    FileWatcher::FileWatcher(const Settings& settings) : S(std::make_unique<State>())
+    {
+        S->Config = settings;
+        S->Polling.store(true);
+    #ifdef __linux__
+        if (!settings.ForcePolling) {
+            S->Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            S->WakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (S->Inotify >= 0 && S->WakeFd >= 0) S->Polling.store(false);
+            else S->CloseInotify();
+        }
+    #endif
+        S->Thread = std::thread([s = S.get()] { s->Run(); });
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        S->Stop.store(true);
+        {
+            std::lock_guard lock(S->Mutex);     // no lost wakeup between the predicate check and the wait
+        }
+        S->Signal();
+        S->Thread.join();
+    #ifdef __linux__
+        S->CloseInotify();
+        if (S->WakeFd >= 0) ::close(S->WakeFd);
+    #endif
+    }
+
+    uint32_t FileWatcher::Watch(const std::filesystem::path& dir)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec)) return 0;
+        uint32_t id;
+        {
+            std::lock_guard lock(S->Mutex);
+            id = S->NextId++;
+            S->Commands.push_back({Command::Op::Watch, id, dir});
+        }
+        S->Signal();
+        return id;
+    }
+
+    void FileWatcher::Unwatch(uint32_t id)
+    {
+        {
+            std::lock_guard lock(S->Mutex);
+            S->Commands.push_back({Command::Op::Unwatch, id, {}});
+        }
+        S->Signal();
+    }
+
+    void FileWatcher::UnwatchAll()
+    {
+        {
+            std::lock_guard lock(S->Mutex);
+            S->Commands.push_back({Command::Op::Clear, 0, {}});
+        }
+        S->Signal();
+    }
+
+    bool FileWatcher::Poll(std::vector<FileChange>& out)
+    {
+        if (!S->HasPublished.load(std::memory_order_acquire)) return false;
+        std::lock_guard lock(S->Mutex);
+        if (out.empty()) out.swap(S->Published);
+        else out.insert(out.end(), std::make_move_iterator(S->Published.begin()), std::make_move_iterator(S->Published.end()));
+        S->Published.clear();
+        S->HasPublished.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t FileWatcher::BatchCount() const { return S->Batches.load(std::memory_order_relaxed); }
+    bool     FileWatcher::IsPolling() const  { return S->Polling.load(); }
+}
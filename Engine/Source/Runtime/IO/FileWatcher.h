@@ -0,0 +1,64 @@
+﻿#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace ace {
+    enum class FileChangeKind : uint8_t {
+        Added,
+        Modified,
+        Removed,
+        Rescan,         // notifications were lost: treat everything under Path as changed
+    };
+
+    struct FileChange {
+        FileChangeKind        Kind = FileChangeKind::Modified;
+        bool                  IsDir = false;    // best effort; false when not known (e.g. after removal)
+        std::filesystem::path Path;             // absolute, as passed to Watch() plus the relative part
+    };
+
+    // Recursive directory watcher with its own background thread. Linux uses
+    // inotify; other platforms, or Linux when inotify is unavailable or out of
+    // watches, diff a size/mtime snapshot every PollIntervalMs.
+    //
+    // Events for the same path are merged (Added then Modified is Added, Added
+    // then Removed is nothing, Removed then Added is Modified) and published as
+    // one batch once the tree has been quiet for CoalesceMs, or MaxLatencyMs
+    // after the burst started. Poll() is a flag check when nothing was
+    // published, so calling it every frame costs no syscalls.
+    //
+    // Roots must not overlap.
+    class FileWatcher {
+    public:
+        struct Settings {
+            uint32_t CoalesceMs     = 100;
+            uint32_t MaxLatencyMs   = 500;
+            uint32_t PollIntervalMs = 1000;     // snapshot backend only
+            bool     ForcePolling   = false;
+        };
+
+        FileWatcher();
+        explicit FileWatcher(const Settings& settings);
+        ~FileWatcher();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        // Starts watching 'dir' and everything below it. Returns an id for
+        // Unwatch(), or 0 if 'dir' is not a directory.
+        uint32_t Watch(const std::filesystem::path& dir);
+        void     Unwatch(uint32_t id);
+        void     UnwatchAll();
+
+        // Appends everything published since the last call, oldest first;
+        // false if there was nothing
+        bool Poll(std::vector<FileChange>& out);
+
+        uint64_t BatchCount() const;            // batches published so far
+        bool     IsPolling() const;             // snapshot backend in use
+
+    private:
+        struct State;
+        std::unique_ptr<State> S;
+    };
+}
@@ -0,0 +1,456 @@
+﻿#include "Runtime/IO/PakFile.h"
+#include "Runtime/Core/Compression.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace ace {
+    static_assert(std::endian::native == std::endian::little, ".acepak is little-endian only");
+    static_assert(sizeof(PakHeader) == 56 && sizeof(PakEntry) == 24 && sizeof(PakBlob) == 24 && sizeof(PakBlock) == 16);
+
+    namespace {
+        constexpr uint64_t kBlobAlign    = 16;
+        constexpr uint64_t kBatchBytes   = 256ull << 20;   // raw input held in memory at once
+        constexpr uint64_t kSecondSeed   = 0x9E3779B97F4A7C15ull;
+
+        std::string_view LastComponent(std::string_view path)
+        {
+            const size_t slash = path.find_last_of('/');
+            return slash == std::string_view::npos ? path : path.substr(slash + 1);
+        }
+    }
+
+    // ---- PakFile ----
+
+    bool PakFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        if (!File.Open(path)) return false;
+        const uint8_t* base = File.Data();
+        const uint64_t size = File.Size();
+        if (size < sizeof(PakHeader)) { Close(); return false; }
+
+        const auto* h = reinterpret_cast<const PakHeader*>(base);
+        const uint64_t tocSize = uint64_t(h->EntryCount) * sizeof(PakEntry) + uint64_t(h->BlobCount) * sizeof(PakBlob) +
+                                 uint64_t(h->BlockCount) * sizeof(PakBlock);
+        const bool headerOk =
+            std::memcmp(h->Magic, kPakMagic, sizeof(kPakMagic)) == 0 && h->Version == kPakVersion &&
+            h->BlockSize == kPakBlockSize && h->FileSize == size && h->TocOffset % alignof(uint64_t) == 0 &&
+            InRange(h->TocOffset, h->TocSize, size) && tocSize <= h->TocSize;
+        if (!headerOk) { Close(); return false; }
+
+        const uint8_t* toc = base + h->TocOffset;
+        const auto* entries = reinterpret_cast<const PakEntry*>(toc);
+        const auto* blobs   = reinterpret_cast<const PakBlob*>(entries + h->EntryCount);
+        const auto* blocks  = reinterpret_cast<const PakBlock*>(blobs + h->BlobCount);
+        const char* paths   = reinterpret_cast<const char*>(blocks + h->BlockCount);
+        const uint64_t pathBytes = h->TocSize - tocSize;
+
+        for (uint32_t i = 0; i < h->BlockCount; ++i) {
+            const PakBlock& b = blocks[i];
+            if (!InRange(b.Offset, b.Size, h->TocOffset) || b.Size > LzCompressBound(h->BlockSize)) { Close(); return false; }
+        }
+        for (uint32_t i = 0; i < h->BlobCount; ++i) {
+            const PakBlob& b = blobs[i];
+            // The exact 64-bit count also bounds RawSize by BlockCount * BlockSize,
+            // which Read() allocates up front
+            if (b.RawSize > kLzMaxRawSize || b.BlockCount != LzBlockCount(b.RawSize, h->BlockSize) ||
+                !InRange(b.FirstBlock, b.BlockCount, h->BlockCount)) { Close(); return false; }
+        }
+        for (uint32_t i = 0; i < h->EntryCount; ++i) {
+            const PakEntry& e = entries[i];
+            if (e.Blob >= h->BlobCount || !InRange(e.PathOffset, e.PathLength, pathBytes) ||
+                (i > 0 && entries[i - 1].PathHash > e.PathHash)) { Close(); return false; }
+        }
+
+        Header  = h;
+        Entries = entries;
+        Blobs   = blobs;
+        Blocks  = blocks;
+        Paths   = paths;
+
+        ByPath.resize(h->EntryCount);
+        for (uint32_t i = 0; i < h->EntryCount; ++i) ByPath[i] = i;
+        std::sort(ByPath.begin(), ByPath.end(), [this](uint32_t a, uint32_t b) { return Path(a) < Path(b); });
+
+        std::error_code ec;
+        const auto t = std::filesystem::last_write_time(path, ec);
+        FileTime = ec ? 0 : (int64_t)t.time_since_epoch().count();
+        return true;
+    }
+
+    void PakFile::Close()
+    {
+        File.Close();
+        Header = nullptr;
+        Entries = nullptr;
+        Blobs = nullptr;
+        Blocks = nullptr;
+        Paths = nullptr;
+        ByPath.clear();
+        FileTime = 0;
+    }
+
+    uint32_t PakFile::Find(std::string_view path) const
+    {
+        if (!Header) return kNotFound;
+        const uint64_t hash = HashString(path);
+        const PakEntry* end = Entries + Header->EntryCount;
+        const PakEntry* it = std::lower_bound(Entries, end, hash,
+                                              [](const PakEntry& e, uint64_t h) { return e.PathHash < h; });
+        for (; it != end && it->PathHash == hash; ++it) {
+            const uint32_t i = (uint32_t)(it - Entries);
+            if (Path(i) == path) return i;
+        }
+        return kNotFound;
+    }
+
+    std::string_view PakFile::Path(uint32_t entry) const
+    {
+        if (!Header || entry >= Header->EntryCount) return {};
+        return { Paths + Entries[entry].PathOffset, Entries[entry].PathLength };
+    }
+
+    uint64_t PakFile::Size(uint32_t entry) const
+    {
+        if (!Header || entry >= Header->EntryCount) return 0;
+        return Blobs[Entries[entry].Blob].RawSize;
+    }
+
+    size_t PakFile::LowerBoundPath(std::string_view path) const
+    {
+        return (size_t)(std::lower_bound(ByPath.begin(), ByPath.end(), path,
+                                         [this](uint32_t e, std::string_view p) { return Path(e) < p; }) - ByPath.begin());
+    }
+
+    bool PakFile::IsDirectory(std::string_view dir) const
+    {
+        if (!Header) return false;
+        if (dir.empty()) return true;
+        const std::string prefix = std::string(dir) + '/';
+        const size_t i = LowerBoundPath(prefix);
+        return i < ByPath.size() && Path(ByPath[i]).starts_with(prefix);
+    }
+
+    void PakFile::List(std::string_view dir, std::vector<VfsEntry>& out) const
+    {
+        if (!Header) return;
+        const std::string prefix = dir.empty() ? std::string() : std::string(dir) + '/';
+        const size_t first = out.size();
+        for (size_t i = LowerBoundPath(prefix); i < ByPath.size(); ++i) {
+            const std::string_view p = Path(ByPath[i]);
+            if (!p.starts_with(prefix)) break;
+            const std::string_view rest = p.substr(prefix.size());
+            const size_t slash = rest.find('/');
+            const std::string_view name = rest.substr(0, slash);
+            // Paths are sorted, so a folder's files are contiguous
+            if (out.size() > first && out.back().Name == name) continue;
+            VfsEntry e;
+            e.Name = std::string(name);
+            e.IsDir = slash != std::string_view::npos;
+            e.Size = e.IsDir ? 0 : Size(ByPath[i]);
+            e.ModifiedTime = FileTime;
+            out.push_back(std::move(e));
+        }
+    }
+
+    bool PakFile::DecodeBlock(const PakBlob& blob, uint32_t index, uint8_t* dst) const
+    {
+        const PakBlock& b = Blocks[blob.FirstBlock + index];
+        const uint64_t at = uint64_t(index) * Header->BlockSize;
+        const size_t raw = (size_t)std::min<uint64_t>(Header->BlockSize, blob.RawSize - at);
+        const uint8_t* src = File.Data() + b.Offset;
+        if (b.Flags & PakBlockStored) {
+            if (b.Size != raw) return false;
+            std::memcpy(dst, src, raw);
+            return true;
+        }
+        return LzDecompress(src, b.Size, dst, raw);
+    }
+
+    bool PakFile::Read(uint32_t entry, std::vector<uint8_t>& out) const
+    {
+        ACE_PROFILE_SCOPE("PakFile::Read");
+        if (!Header || entry >= Header->EntryCount) return false;
+        const PakBlob& blob = Blobs[Entries[entry].Blob];
+        out.resize((size_t)blob.RawSize);
+        if (blob.BlockCount <= 1)
+            return blob.BlockCount == 0 || DecodeBlock(blob, 0, out.data());
+
+        std::atomic<bool> failed{false};
+        JobSystem::Get().ParallelFor(blob.BlockCount, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+                if (!DecodeBlock(blob, (uint32_t)i, out.data() + i * Header->BlockSize))
+                    failed.store(true, std::memory_order_relaxed);
+        }, 1);
+        return !failed.load();
+    }
+
+    bool PakFile::ReadRange(uint32_t entry, uint64_t offset, void* dstData, size_t size) const
+    {
+        if (!Header || entry >= Header->EntryCount) return false;
+        const PakBlob& blob = Blobs[Entries[entry].Blob];
+        if (!InRange(offset, size, blob.RawSize)) return false;
+        if (size == 0) return true;
+
+        uint8_t* dst = static_cast<uint8_t*>(dstData);
+        const uint32_t bs = Header->BlockSize;
+        std::vector<uint8_t> scratch;
+        for (uint64_t pos = offset; pos < offset + size;) {
+            const uint32_t index = (uint32_t)(pos / bs);
+            const uint64_t blockStart = uint64_t(index) * bs;
+            const uint64_t blockEnd = std::min<uint64_t>(blockStart + bs, blob.RawSize);
+            const uint64_t take = std::min<uint64_t>(blockEnd, offset + size) - pos;
+            if (pos == blockStart && take == blockEnd - blockStart) {
+                if (!DecodeBlock(blob, index, dst + (pos - offset))) return false;
+            } else {
+                scratch.resize(bs);
+                if (!DecodeBlock(blob, index, scratch.data())) return false;
+                std::memcpy(dst + (pos - offset), scratch.data() + (pos - blockStart), (size_t)take);
+            }
+            pos += take;
+        }
+        return true;
+    }
+
+    // ---- PakSource ----
+
+    bool PakSource::Stat(std::string_view rel, VfsEntry& out) const
+    {
+        const uint32_t i = Pak.Find(rel);
+        if (i != PakFile::kNotFound) {
+            out.Name = std::string(LastComponent(rel));
+            out.Size = Pak.Size(i);
+            out.IsDir = false;
+        } else if (Pak.IsDirectory(rel)) {
+            out.Name = std::string(LastComponent(rel));
+            out.Size = 0;
+            out.IsDir = true;
+        } else {
+            return false;
+        }
+        out.ModifiedTime = Pak.ModifiedTime();
+        return true;
+    }
+
+    bool PakSource::Open(std::string_view rel, VfsFile& out) const
+    {
+        const uint32_t i = Pak.Find(rel);
+        if (i == PakFile::kNotFound) return false;
+        std::vector<uint8_t> data;
+        if (!Pak.Read(i, data)) return false;
+        out.Assign(std::move(data));
+        return true;
+    }
+
+    void PakSource::List(std::string_view rel, std::vector<VfsEntry>& out) const
+    {
+        Pak.List(rel, out);
+    }
+
+    bool MountPak(VFS& vfs, std::string_view point, const std::filesystem::path& pak, int priority)
+    {
+        auto source = std::make_unique<PakSource>();
+        if (!source->OpenArchive(pak)) return false;
+        return vfs.Mount(point, std::move(source), priority);
+    }
+
+    // ---- writing ----
+
+    std::vector<PakInput> CollectPakInputs(const std::filesystem::path& dir)
+    {
+        std::vector<PakInput> out;
+        std::error_code ec;
+        for (std::filesystem::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code fec;
+            if (!it->is_regular_file(fec)) continue;
+            const std::u8string rel = it->path().lexically_relative(dir).generic_u8string();
+            out.push_back({ std::string(reinterpret_cast<const char*>(rel.data()), rel.size()), it->path() });
+        }
+        return out;
+    }
+
+    namespace {
+        struct SourceData {
+            MappedFile Map;
+            uint64_t   Hash = 0;
+            uint64_t   Hash2 = 0;       // second seed: dedup trusts 128 bits plus the size
+        };
+
+        struct DedupKey {
+            uint64_t Size, Hash, Hash2;
+            bool operator==(const DedupKey&) const = default;
+        };
+        struct DedupKeyHash {
+            size_t operator()(const DedupKey& k) const noexcept { return (size_t)HashCombine(k.Hash, k.Size); }
+        };
+
+        struct PendingBlock {
+            const uint8_t*       Src = nullptr;
+            uint32_t             Length = 0;
+            bool                 FirstOfBlob = false;
+            bool                 Stored = false;
+            std::vector<uint8_t> Out;
+        };
+
+        void Pad(std::ofstream& os, uint64_t& pos, uint64_t align)
+        {
+            static const char zeros[16] = {};
+            const uint64_t n = (align - pos % align) % align;
+            os.write(zeros, (std::streamsize)n);
+            pos += n;
+        }
+
+        template<class T>
+        void WriteArray(std::ofstream& os, uint64_t& pos, const std::vector<T>& v)
+        {
+            os.write(reinterpret_cast<const char*>(v.data()), (std::streamsize)(v.size() * sizeof(T)));
+            pos += v.size() * sizeof(T);
+        }
+    }
+
+    bool WritePak(const std::filesystem::path& out, std::vector<PakInput> files, PakWriteStats* stats)
+    {
+        ACE_PROFILE_SCOPE("WritePak");
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& f : files) f.Path = VFS::Normalize(f.Path).substr(1);
+        std::sort(files.begin(), files.end(), [](const PakInput& a, const PakInput& b) { return a.Path < b.Path; });
+        for (size_t i = 0; i < files.size(); ++i)
+            if (files[i].Path.empty() || (i > 0 && files[i].Path == files[i - 1].Path)) return false;
+
+        std::error_code ec;
+        if (out.has_parent_path()) std::filesystem::create_directories(out.parent_path(), ec);
+        std::filesystem::path tmp = out;
+        tmp += ".tmp";
+        std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+        if (!os) return false;
+
+        PakHeader h{};
+        os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        uint64_t pos = sizeof(h);
+
+        std::vector<PakEntry> entries(files.size());
+        std::vector<PakBlob>  blobs;
+        std::vector<PakBlock> blocks;
+        std::string           pathBytes;
+        std::unordered_map<DedupKey, uint32_t, DedupKeyHash> known;
+        uint64_t rawBytes = 0, packedBytes = 0;
+        auto& jobs = JobSystem::Get();
+
+        for (size_t begin = 0; begin < files.size();) {
+            // Bound memory: map and hash up to kBatchBytes of input at a time
+            size_t end = begin;
+            for (uint64_t bytes = 0; end < files.size() && (end == begin || bytes < kBatchBytes); ++end)
+                bytes += std::filesystem::file_size(files[end].Source, ec);
+
+            std::vector<SourceData> data(end - begin);
+            std::atomic<bool> failed{false};
+            jobs.ParallelFor(data.size(), [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    SourceData& d = data[i];
+                    if (!d.Map.Open(files[begin + i].Source) || d.Map.Size() > kLzMaxRawSize) { failed = true; continue; }
+                    d.Hash  = Hash64(d.Map.Data(), d.Map.Size());
+                    d.Hash2 = Hash64(d.Map.Data(), d.Map.Size(), kSecondSeed);
+                }
+            }, 1);
+            if (failed) { os.close(); std::filesystem::remove(tmp, ec); return false; }
+
+            std::vector<PendingBlock> pending;
+            for (size_t i = 0; i < data.size(); ++i) {
+                const SourceData& d = data[i];
+                const PakInput& f = files[begin + i];
+                PakEntry& e = entries[begin + i];
+                e.PathHash   = HashString(f.Path);
+                e.PathOffset = (uint32_t)pathBytes.size();
+                e.PathLength = (uint32_t)f.Path.size();
+                pathBytes += f.Path;
+                rawBytes  += d.Map.Size();
+
+                const DedupKey key{ d.Map.Size(), d.Hash, d.Hash2 };
+                if (auto it = known.find(key); it != known.end()) { e.Blob = it->second; continue; }
+
+                PakBlob blob{};
+                blob.RawSize     = d.Map.Size();
+                blob.ContentHash = d.Hash;
+                blob.FirstBlock  = (uint32_t)(blocks.size() + pending.size());
+                blob.BlockCount  = (uint32_t)LzBlockCount(blob.RawSize, kPakBlockSize);
+                for (uint32_t b = 0; b < blob.BlockCount; ++b) {
+                    PendingBlock p;
+                    p.Src = d.Map.Data() + uint64_t(b) * kPakBlockSize;
+                    p.Length = (uint32_t)std::min<uint64_t>(kPakBlockSize, blob.RawSize - uint64_t(b) * kPakBlockSize);
+                    p.FirstOfBlob = b == 0;
+                    pending.push_back(std::move(p));
+                }
+                e.Blob = (uint32_t)blobs.size();
+                known.emplace(key, e.Blob);
+                blobs.push_back(blob);
+            }
+
+            jobs.ParallelFor(pending.size(), [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    PendingBlock& p = pending[i];
+                    // Capacity below the raw size: only keep real savings
+                    p.Out.resize(p.Length);
+                    const size_t n = p.Length > 1 ? LzCompress(p.Src, p.Length, p.Out.data(), p.Length - 1) : 0;
+                    if (n) { p.Out.resize(n); }
+                    else   { std::memcpy(p.Out.data(), p.Src, p.Length); p.Stored = true; }
+                }
+            }, 1);
+
+            for (const PendingBlock& p : pending) {
+                if (p.FirstOfBlob) Pad(os, pos, kBlobAlign);
+                blocks.push_back({ pos, (uint32_t)p.Out.size(), p.Stored ? (uint32_t)PakBlockStored : 0u });
+                os.write(reinterpret_cast<const char*>(p.Out.data()), (std::streamsize)p.Out.size());
+                pos += p.Out.size();
+                packedBytes += p.Out.size();
+            }
+            begin = end;
+        }
+
+        // Hash order for lookups; path order breaks ties so output is deterministic
+        std::sort(entries.begin(), entries.end(), [&](const PakEntry& a, const PakEntry& b) {
+            if (a.PathHash != b.PathHash) return a.PathHash < b.PathHash;
+            return std::string_view(pathBytes).substr(a.PathOffset, a.PathLength) <
+                   std::string_view(pathBytes).substr(b.PathOffset, b.PathLength);
+        });
+
+        Pad(os, pos, kBlobAlign);
+        std::memcpy(h.Magic, kPakMagic, sizeof(h.Magic));
+        h.Version    = kPakVersion;
+        h.BlockSize  = kPakBlockSize;
+        h.EntryCount = (uint32_t)entries.size();
+        h.BlobCount  = (uint32_t)blobs.size();
+        h.BlockCount = (uint32_t)blocks.size();
+        h.TocOffset  = pos;
+        WriteArray(os, pos, entries);
+        WriteArray(os, pos, blobs);
+        WriteArray(os, pos, blocks);
+        os.write(pathBytes.data(), (std::streamsize)pathBytes.size());
+        pos += pathBytes.size();
+        h.TocSize  = pos - h.TocOffset;
+        h.FileSize = pos;
+        os.seekp(0);
+        os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        os.close();
+        if (!os) { std::filesystem::remove(tmp, ec); return false; }
+
+        if (!ReplaceFile(tmp, out)) return false;
+
+        if (stats) {
+            stats->Files       = files.size();
+            stats->Blobs       = blobs.size();
+            stats->RawBytes    = rawBytes;
+            stats->PackedBytes = packedBytes;
+            stats->Seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+}
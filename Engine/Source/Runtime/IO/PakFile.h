@@ -0,0 +1,144 @@
+﻿#pragma once
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/IO/VFS.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ace {
+    // .acepak archive (little-endian):
+    //
+    //   PakHeader
+    //   blob data        each blob is a run of blocks; every block holds
+    //                    kPakBlockSize raw bytes (the last one fewer),
+    //                    LZ-compressed on its own or stored raw if that is
+    //                    smaller, so any 64 KiB range decodes independently
+    //   PakEntry[EntryCount]    sorted by PathHash
+    //   PakBlob[BlobCount]
+    //   PakBlock[BlockCount]
+    //   path bytes              UTF-8, '/'-separated, relative, no leading '/'
+    //
+    // Files with identical content share one blob. Blobs start 16-byte
+    // aligned. The table of contents sits at the end so the writer can
+    // stream the data in one pass.
+
+    inline constexpr char     kPakMagic[8]  = {'A','C','E','P','A','K','\0','\x1A'};
+    inline constexpr uint32_t kPakVersion   = 1;
+    inline constexpr uint32_t kPakBlockSize = 64 * 1024;
+
+    struct PakHeader {
+        char     Magic[8];
+        uint32_t Version;
+        uint32_t BlockSize;
+        uint32_t EntryCount;
+        uint32_t BlobCount;
+        uint32_t BlockCount;
+        uint32_t Reserved;
+        uint64_t TocOffset;
+        uint64_t TocSize;
+        uint64_t FileSize;
+    };
+
+    struct PakEntry {
+        uint64_t PathHash;          // HashString(path)
+        uint32_t PathOffset;        // into the path bytes
+        uint32_t PathLength;
+        uint32_t Blob;
+        uint32_t Reserved;
+    };
+
+    struct PakBlob {
+        uint64_t RawSize;
+        uint64_t ContentHash;       // Hash64 of the raw bytes
+        uint32_t FirstBlock;
+        uint32_t BlockCount;
+    };
+
+    enum PakBlockFlags : uint32_t { PakBlockStored = 1 };
+
+    struct PakBlock {
+        uint64_t Offset;            // absolute file offset
+        uint32_t Size;              // bytes on disk
+        uint32_t Flags;             // PakBlockFlags
+    };
+
+    // Validated, memory-mapped archive. Lookups are a binary search over the
+    // hash-sorted entries; nothing is read until a file is requested.
+    class PakFile {
+    public:
+        static constexpr uint32_t kNotFound = ~0u;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+        bool IsOpen() const { return Header != nullptr; }
+
+        uint32_t         EntryCount() const { return Header ? Header->EntryCount : 0; }
+        uint32_t         Find(std::string_view path) const;    // path as stored
+        std::string_view Path(uint32_t entry) const;
+        uint64_t         Size(uint32_t entry) const;
+        bool             IsDirectory(std::string_view dir) const;
+        // Names directly under 'dir' ("" = root); folders are inferred from paths
+        void             List(std::string_view dir, std::vector<VfsEntry>& out) const;
+
+        // Whole file. Multi-block files decompress in parallel on the job system.
+        bool Read(uint32_t entry, std::vector<uint8_t>& out) const;
+        // 'size' bytes at 'offset'; only the blocks covering the range are decoded
+        bool ReadRange(uint32_t entry, uint64_t offset, void* dst, size_t size) const;
+
+        int64_t ModifiedTime() const { return FileTime; }
+
+    private:
+        bool DecodeBlock(const PakBlob& blob, uint32_t index, uint8_t* dst) const;
+        size_t LowerBoundPath(std::string_view path) const;
+
+        MappedFile         File;
+        const PakHeader*   Header = nullptr;
+        const PakEntry*    Entries = nullptr;
+        const PakBlob*     Blobs = nullptr;
+        const PakBlock*    Blocks = nullptr;
+        const char*        Paths = nullptr;
+        std::vector<uint32_t> ByPath;       // entry indices sorted by path, for listing
+        int64_t            FileTime = 0;
+    };
+
+    // Mounts a PakFile into the VFS
+    class PakSource final : public VfsSource {
+    public:
+        bool OpenArchive(const std::filesystem::path& path) { return Pak.Open(path); }
+        const PakFile& GetPak() const { return Pak; }
+
+        bool Stat(std::string_view rel, VfsEntry& out) const override;
+        bool Open(std::string_view rel, VfsFile& out) const override;
+        void List(std::string_view rel, std::vector<VfsEntry>& out) const override;
+
+    private:
+        PakFile Pak;
+    };
+
+    bool MountPak(VFS& vfs, std::string_view point, const std::filesystem::path& pak, int priority = 0);
+
+    // ---- writing ----
+
+    struct PakInput {
+        std::string           Path;     // archive path, e.g. "Maps/Start.acemap"
+        std::filesystem::path Source;   // file on disk
+    };
+
+    struct PakWriteStats {
+        size_t   Files = 0;
+        size_t   Blobs = 0;             // after deduplication
+        uint64_t RawBytes = 0;          // sum over all input files
+        uint64_t PackedBytes = 0;       // blob data written
+        double   Seconds = 0.0;
+    };
+
+    // Every regular file under 'dir', with paths relative to it
+    std::vector<PakInput> CollectPakInputs(const std::filesystem::path& dir);
+
+    // Reads, deduplicates and compresses on the job system, then writes
+    // 'out' via a temporary file. Fails on unreadable inputs, inputs over
+    // kLzMaxRawSize, or duplicate paths.
+    bool WritePak(const std::filesystem::path& out, std::vector<PakInput> files, PakWriteStats* stats = nullptr);
+}
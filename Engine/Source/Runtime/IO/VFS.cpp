@@ -0,0 +1,357 @@
+﻿#include "Runtime/IO/VFS.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+namespace ace {
+    namespace {
+        std::filesystem::path RelToPath(std::string_view rel)
+        {
+            return std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(rel.data()), rel.size()));
+        }
+
+        std::string PathToUtf8(const std::filesystem::path& p)
+        {
+            const std::u8string s = p.generic_u8string();
+            return std::string(reinterpret_cast<const char*>(s.data()), s.size());
+        }
+
+        int64_t FileTime(const std::filesystem::directory_entry& e, std::error_code& ec)
+        {
+            const auto t = e.last_write_time(ec);
+            return ec ? 0 : (int64_t)t.time_since_epoch().count();
+        }
+    }
+
+    // ---- DirectorySource ----
+
+    std::filesystem::path DirectorySource::NativePath(std::string_view rel) const
+    {
+        return rel.empty() ? Root : Root / RelToPath(rel);
+    }
+
+    bool DirectorySource::Stat(std::string_view rel, VfsEntry& out) const
+    {
+        std::error_code ec;
+        const std::filesystem::directory_entry e(NativePath(rel), ec);
+        if (ec || !e.exists(ec)) return false;
+        out.Name = PathToUtf8(e.path().filename());
+        out.IsDir = e.is_directory(ec);
+        out.Size = out.IsDir ? 0 : (uint64_t)e.file_size(ec);
+        out.ModifiedTime = FileTime(e, ec);
+        return true;
+    }
+
+    bool DirectorySource::Open(std::string_view rel, VfsFile& out) const
+    {
+        MappedFile map;
+        if (!map.Open(NativePath(rel))) return false;
+        out.Assign(std::move(map));
+        return true;
+    }
+
+    void DirectorySource::List(std::string_view rel, std::vector<VfsEntry>& out) const
+    {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(NativePath(rel), ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code eec;
+            VfsEntry v;
+            v.Name = PathToUtf8(it->path().filename());
+            v.IsDir = it->is_directory(eec);
+            v.Size = v.IsDir ? 0 : (uint64_t)it->file_size(eec);
+            v.ModifiedTime = FileTime(*it, eec);
+            out.push_back(std::move(v));
+        }
+    }
+
+    // ---- VFS ----
+
+    VFS& VFS::Get()
+    {
+        static VFS s;
+        return s;
+    }
+
+    std::string VFS::Normalize(std::string_view path)
+    {
+        std::string out = "/";
+        size_t i = 0;
+        while (i < path.size()) {
+            while (i < path.size() && (path[i] == '/' || path[i] == '\\')) ++i;
+            size_t j = i;
+            while (j < path.size() && path[j] != '/' && path[j] != '\\') ++j;
+            const std::string_view part = path.substr(i, j - i);
+            if (part == "..") {
+                // Never climbs above the root
+                const size_t slash = out.find_last_of('/', out.size() > 1 ? out.size() - 1 : 0);
+                out.resize(slash == 0 ? 1 : slash);
+            } else if (!part.empty() && part != ".") {
+                if (out.size() > 1) out += '/';
+                out += part;
+            }
+            i = j;
+        }
+        return out;
+    }
+
+    bool VFS::Covers(const std::string& point, std::string_view path, std::string_view& rel)
+    {
+        if (point == "/") { rel = path.substr(1); return true; }
+        if (path.size() < point.size() || path.compare(0, point.size(), point) != 0) return false;
+        if (path.size() == point.size()) { rel = {}; return true; }
+        if (path[point.size()] != '/') return false;
+        rel = path.substr(point.size() + 1);
+        return true;
+    }
+
+    bool VFS::Mount(std::string_view point, std::unique_ptr<VfsSource> source, int priority)
+    {
+        if (!source) return false;
+        auto m = std::make_unique<MountPoint>();
+        m->Point = Normalize(point);
+        m->Source = std::move(source);
+        m->Priority = priority;
+
+        std::unique_lock lock(MountMutex);
+        m->Order = NextOrder++;
+        Mounts.push_back(std::move(m));
+        std::stable_sort(Mounts.begin(), Mounts.end(), [](const auto& a, const auto& b) {
+            return a->Priority != b->Priority ? a->Priority > b->Priority : a->Order > b->Order;
+        });
+        std::unique_lock cacheLock(CacheMutex);
+        ClearCache();
+        return true;
+    }
+
+    bool VFS::MountDirectory(std::string_view point, const std::filesystem::path& dir, int priority)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec)) return false;
+        return Mount(point, std::make_unique<DirectorySource>(dir), priority);
+    }
+
+    size_t VFS::Unmount(std::string_view point)
+    {
+        const std::string p = Normalize(point);
+        std::unique_lock lock(MountMutex);
+        const auto it = std::remove_if(Mounts.begin(), Mounts.end(), [&](const auto& m) { return m->Point == p; });
+        const size_t n = (size_t)(Mounts.end() - it);
+        Mounts.erase(it, Mounts.end());
+        std::unique_lock cacheLock(CacheMutex);
+        ClearCache();
+        return n;
+    }
+
+    void VFS::UnmountAll()
+    {
+        std::unique_lock lock(MountMutex);
+        Mounts.clear();
+        std::unique_lock cacheLock(CacheMutex);
+        ClearCache();
+    }
+
+    // Caller holds MountMutex (shared)
+    bool VFS::Resolve(const std::string& path, Lookup& out)
+    {
+        uint64_t generation;
+        {
+            std::shared_lock lock(CacheMutex);
+            if (auto it = Cache.find(path); it != Cache.end()) {
+                out = it->second;
+                return out.Mount != nullptr;
+            }
+            generation = CacheGeneration;
+        }
+
+        Lookup found;
+        for (const auto& m : Mounts) {
+            std::string_view rel;
+            if (!Covers(m->Point, path, rel)) continue;
+            if (m->Source->Stat(rel, found.Entry)) {
+                found.Mount = m.get();
+                found.Rel = std::string(rel);
+                break;
+            }
+        }
+        // A mount point is a directory even if no source has it
+        if (!found.Mount) {
+            for (const auto& m : Mounts) {
+                std::string_view rel;
+                if (Covers(path, m->Point, rel) && !rel.empty()) {
+                    found.Mount = m.get();
+                    found.Entry = VfsEntry{};
+                    found.Entry.Name = path.substr(path.find_last_of('/') + 1);
+                    found.Entry.IsDir = true;
+                    found.Rel.clear();
+                    break;
+                }
+            }
+        }
+
+        {
+            // An Invalidate() or WriteFile() since the miss may have made this
+            // result stale: return it, but do not let it outlive the invalidation
+            std::unique_lock lock(CacheMutex);
+            if (CacheGeneration == generation) {
+                // Full: start over rather than track recency, which would
+                // make every hit a write
+                if (Cache.size() >= kMaxCachedLookups && !Cache.contains(path)) ClearCache();
+                const auto [it, added] = Cache.insert_or_assign(path, found);
+                if (added) CacheOrder.insert(it->first);
+            }
+        }
+        out = std::move(found);
+        return out.Mount != nullptr;
+    }
+
+    bool VFS::Exists(std::string_view path)
+    {
+        VfsEntry e;
+        return Stat(path, e);
+    }
+
+    bool VFS::Stat(std::string_view path, VfsEntry& out)
+    {
+        std::shared_lock lock(MountMutex);
+        Lookup l;
+        if (!Resolve(Normalize(path), l)) return false;
+        out = std::move(l.Entry);
+        return true;
+    }
+
+    bool VFS::Open(std::string_view path, VfsFile& out)
+    {
+        ACE_PROFILE_SCOPE("VFS::Open");
+        std::shared_lock lock(MountMutex);
+        Lookup l;
+        if (!Resolve(Normalize(path), l) || l.Entry.IsDir) return false;
+        return l.Mount->Source->Open(l.Rel, out);
+    }
+
+    bool VFS::ReadText(std::string_view path, std::string& out)
+    {
+        VfsFile f;
+        if (!Open(path, f)) return false;
+        out.assign(f.Text());
+        return true;
+    }
+
+    void VFS::List(std::string_view dir, std::vector<VfsEntry>& out)
+    {
+        const std::string d = Normalize(dir);
+        const size_t first = out.size();
+        std::shared_lock lock(MountMutex);
+        for (const auto& m : Mounts) {
+            std::string_view rel;
+            if (Covers(m->Point, d, rel)) {
+                m->Source->List(rel, out);
+            } else if (Covers(d, m->Point, rel) && !rel.empty()) {
+                VfsEntry e;
+                e.Name = std::string(rel.substr(0, rel.find('/')));
+                e.IsDir = true;
+                out.push_back(std::move(e));
+            }
+        }
+        // Mounts were visited in precedence order: keep the first of each name
+        std::stable_sort(out.begin() + (ptrdiff_t)first, out.end(),
+                         [](const VfsEntry& a, const VfsEntry& b) { return a.Name < b.Name; });
+        out.erase(std::unique(out.begin() + (ptrdiff_t)first, out.end(),
+                              [](const VfsEntry& a, const VfsEntry& b) { return a.Name == b.Name; }),
+                  out.end());
+    }
+
+    void VFS::ReadAsync(std::string path, std::function<void(bool ok, VfsFile& file)> done,
+                        bool mainThread, JobCounter* counter)
+    {
+        JobSystem& jobs = JobSystem::Get();
+        jobs.Run([this, path = std::move(path), done = std::move(done), mainThread, counter]() mutable {
+            auto file = std::make_shared<VfsFile>();
+            const bool ok = Open(path, *file);
+            if (!mainThread) { done(ok, *file); return; }
+            // Counted again before this job finishes, so 'counter' never drains early
+            JobSystem::Get().RunOnMainThread([ok, file, done = std::move(done)] { done(ok, *file); }, counter);
+        }, counter);
+    }
+
+    bool VFS::WriteFile(std::string_view path, const void* data, size_t size)
+    {
+        const std::string p = Normalize(path);
+        std::filesystem::path native;
+        {
+            std::shared_lock lock(MountMutex);
+            for (const auto& m : Mounts) {
+                std::string_view rel;
+                if (Covers(m->Point, p, rel) && !rel.empty()) {
+                    native = m->Source->NativePath(rel);
+                    if (!native.empty()) break;
+                }
+            }
+        }
+        if (native.empty()) return false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(native.parent_path(), ec);
+        std::ofstream out(native, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(static_cast<const char*>(data), (std::streamsize)size);
+        out.close();
+        Invalidate(p);
+        return (bool)out;
+    }
+
+    std::filesystem::path VFS::ToNative(std::string_view path)
+    {
+        std::shared_lock lock(MountMutex);
+        Lookup l;
+        if (Resolve(Normalize(path), l)) return l.Mount->Source->NativePath(l.Rel);
+        return {};
+    }
+
+    std::optional<std::string> VFS::ToVirtual(const std::filesystem::path& native)
+    {
+        const std::filesystem::path abs = native.lexically_normal();
+        std::shared_lock lock(MountMutex);
+        for (const auto& m : Mounts) {
+            const std::filesystem::path root = m->Source->NativePath("");
+            if (root.empty()) continue;
+            const std::filesystem::path rel = abs.lexically_relative(root.lexically_normal());
+            if (rel.empty() || *rel.begin() == "..") continue;
+            const std::string r = PathToUtf8(rel);
+            return Normalize(m->Point + "/" + (r == "." ? std::string() : r));
+        }
+        return std::nullopt;
+    }
+
+    void VFS::Invalidate(std::string_view path)
+    {
+        const std::string p = Normalize(path);
+        std::unique_lock lock(CacheMutex);
+        if (p == "/") { ClearCache(); return; }
+        ++CacheGeneration;
+        // 'p' itself, then everything in ["p/", "p0"): '0' follows '/'
+        if (const auto it = CacheOrder.find(p); it != CacheOrder.end()) {
+            const std::string_view key = *it;
+            CacheOrder.erase(it);
+            Cache.erase(Cache.find(key));
+        }
+        const auto first = CacheOrder.lower_bound(p + '/');
+        const auto last  = CacheOrder.lower_bound(p + '0');
+        for (auto it = first; it != last; ++it) Cache.erase(Cache.find(*it));
+        CacheOrder.erase(first, last);
+    }
+
+    void VFS::InvalidateAll()
+    {
+        std::unique_lock lock(CacheMutex);
+        ClearCache();
+    }
+
+    void VFS::ClearCache()
+    {
+        CacheOrder.clear();
+        Cache.clear();
+        ++CacheGeneration;
+    }
+}
@@ -0,0 +1,154 @@
+﻿#pragma once
+#include "Runtime/Core/MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    class JobCounter;
+
+    struct VfsEntry {
+        std::string Name;               // last path component
+        uint64_t    Size = 0;
+        int64_t     ModifiedTime = 0;   // file_time_type ticks; 0 if the source has none
+        bool        IsDir = false;
+    };
+
+    // Read-only file contents: a mapping of a loose file or a buffer owned by
+    // the handle (e.g. decompressed from an archive).
+    class VfsFile {
+    public:
+        const uint8_t*   Data() const { return Map.IsOpen() ? Map.Data() : Buffer.data(); }
+        size_t           Size() const { return Map.IsOpen() ? Map.Size() : Buffer.size(); }
+        std::string_view Text() const { return { reinterpret_cast<const char*>(Data()), Size() }; }
+        bool             IsOpen() const { return Opened; }
+
+        void Reset()                             { Map.Close(); Buffer.clear(); Opened = false; }
+        void Assign(MappedFile&& map)            { Reset(); Map = std::move(map); Opened = true; }
+        void Assign(std::vector<uint8_t>&& data) { Reset(); Buffer = std::move(data); Opened = true; }
+
+    private:
+        MappedFile           Map;
+        std::vector<uint8_t> Buffer;
+        bool                 Opened = false;
+    };
+
+    // Something that can be mounted: a loose directory, a packed archive, ...
+    // Paths passed in are relative to the mount point, '/'-separated, with no
+    // leading slash ("" is the source's root).
+    class VfsSource {
+    public:
+        virtual ~VfsSource() = default;
+        virtual bool Stat(std::string_view rel, VfsEntry& out) const = 0;
+        virtual bool Open(std::string_view rel, VfsFile& out) const = 0;
+        // Appends the children of directory 'rel'
+        virtual void List(std::string_view rel, std::vector<VfsEntry>& out) const = 0;
+        // Where 'rel' lives on disk; empty for sources that are not loose files
+        virtual std::filesystem::path NativePath(std::string_view rel) const { (void)rel; return {}; }
+    };
+
+    class DirectorySource final : public VfsSource {
+    public:
+        explicit DirectorySource(std::filesystem::path root) : Root(std::move(root)) {}
+
+        bool Stat(std::string_view rel, VfsEntry& out) const override;
+        bool Open(std::string_view rel, VfsFile& out) const override;
+        void List(std::string_view rel, std::vector<VfsEntry>& out) const override;
+        std::filesystem::path NativePath(std::string_view rel) const override;
+
+        const std::filesystem::path& GetRoot() const { return Root; }
+
+    private:
+        std::filesystem::path Root;
+    };
+
+    // Virtual file system. Virtual paths look like "/Game/Maps/Start.acemap";
+    // a mount binds a source to a path prefix. When several mounts cover a
+    // path, higher priority wins, then the most recent mount, so a patch
+    // archive or a loose override directory can shadow packaged content.
+    //
+    // Lookups (hits and misses) are cached, so repeated Exists/Stat/Open of
+    // the same path costs a hash lookup instead of a stat() per call. The
+    // cache holds at most kMaxCachedLookups paths and starts over when full.
+    // Anything that changes files behind the VFS's back must call Invalidate().
+    // All functions are thread-safe.
+    class VFS {
+    public:
+        static constexpr size_t kMaxCachedLookups = 64 * 1024;
+
+        static VFS& Get();
+
+        bool   Mount(std::string_view point, std::unique_ptr<VfsSource> source, int priority = 0);
+        bool   MountDirectory(std::string_view point, const std::filesystem::path& dir, int priority = 0);
+        // Removes every mount at exactly 'point'; returns how many
+        size_t Unmount(std::string_view point);
+        void   UnmountAll();
+
+        bool Exists(std::string_view path);
+        bool Stat(std::string_view path, VfsEntry& out);
+        bool Open(std::string_view path, VfsFile& out);
+        bool ReadText(std::string_view path, std::string& out);
+        // Merged listing of a directory across mounts, sorted by name;
+        // shadowed entries are dropped and mount points show up as folders.
+        void List(std::string_view dir, std::vector<VfsEntry>& out);
+
+        // Opens on a job worker and calls 'done' on the main thread (from
+        // JobSystem::PumpMainThread) or, with mainThread = false, on the worker.
+        void ReadAsync(std::string path, std::function<void(bool ok, VfsFile& file)> done,
+                       bool mainThread = true, JobCounter* counter = nullptr);
+
+        // Writes through to the highest-priority loose mount covering 'path'
+        bool WriteFile(std::string_view path, const void* data, size_t size);
+
+        // Loose mounts only: virtual <-> native path
+        std::filesystem::path      ToNative(std::string_view path);
+        std::optional<std::string> ToVirtual(const std::filesystem::path& native);
+
+        // Drops cached lookups for 'path' and everything below it
+        void Invalidate(std::string_view path);
+        void InvalidateAll();
+
+        // "\\Game//Maps/./A.acemap/" -> "/Game/Maps/A.acemap"
+        static std::string Normalize(std::string_view path);
+
+    private:
+        struct MountPoint {
+            std::string                Point;      // normalized, "/" for the root
+            std::unique_ptr<VfsSource> Source;
+            int                        Priority = 0;
+            uint64_t                   Order = 0;
+        };
+        struct Lookup {
+            const MountPoint* Mount = nullptr;     // null: not found
+            std::string       Rel;
+            VfsEntry          Entry;
+        };
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+        };
+
+        bool Resolve(const std::string& path, Lookup& out);
+        static bool Covers(const std::string& point, std::string_view path, std::string_view& rel);
+        void ClearCache();                                  // caller holds CacheMutex (unique)
+
+        std::shared_mutex MountMutex;
+        std::vector<std::unique_ptr<MountPoint>> Mounts;   // sorted: priority, then newest first
+        uint64_t NextOrder = 0;
+
+        std::shared_mutex CacheMutex;
+        std::unordered_map<std::string, Lookup, StringHash, std::equal_to<>> Cache;
+        // Cache's keys in order, so Invalidate() erases a subtree as one range
+        std::set<std::string_view> CacheOrder;
+        // Bumped by every invalidation; a lookup made across one is not cached
+        uint64_t CacheGeneration = 0;                       // guarded by CacheMutex
+    };
+}
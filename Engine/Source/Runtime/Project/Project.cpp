@@ -1,4 +1,6 @@
 ﻿#include "Runtime/Project/Project.h"
+#include "Runtime/IO/PakFile.h"
+#include "Runtime/IO/VFS.h"
 #include <fstream>
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
@@ -37,4 +39,14 @@ namespace ace {
         out << j.dump(2);
         return true;
     }
+
+    bool Project::MountContent() const
+    {
+        VFS& vfs = VFS::Get();
+        vfs.Unmount(kContentMount);
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(PaksDir(), ec), end; !ec && it != end; it.increment(ec))
+            if (it->path().extension() == ".acepak") MountPak(vfs, kContentMount, it->path(), -1);
+        return vfs.MountDirectory(kContentMount, ContentDir());
+    }
 }
@@ -15,12 +15,23 @@ namespace ace {
 
     class Project {
     public:
+        // Virtual path of ContentDir() once MountContent() has run
+        static constexpr const char* kContentMount = "/Game";
+
         static std::optional<Project> Load(const std::filesystem::path& aceprojFile);
         bool Save(const std::filesystem::path& aceprojFile) const;
 
         const ProjectInfo& GetInfo() const { return Info; }
         std::filesystem::path ContentDir() const { return Info.RootDir / "Content"; }
         std::filesystem::path SourceDir()  const { return Info.RootDir / "Source";  }
+        std::filesystem::path IntermediateDir() const { return Info.RootDir / "Intermediate"; } // tool caches, snapshots
+        std::filesystem::path PaksDir() const { return Info.RootDir / "Paks"; }                 // packaged .acepak content
+        std::filesystem::path CookedDir() const { return Info.RootDir / "Cooked"; }             // ACECook output, one folder per platform
+        std::filesystem::path DerivedDataDir() const { return IntermediateDir() / "DerivedDataCache"; } // see DerivedDataCache
+
+        // (Re)mounts ContentDir() at kContentMount in VFS::Get(), over any
+        // PaksDir()/*.acepak, so loose files override packaged ones.
+        bool MountContent() const;
 
     private:
         ProjectInfo Info;
@@ -0,0 +1,122 @@
+﻿#include "Runtime/World/Archetype.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace ace {
+    namespace {
+        constexpr size_t kChunkAlign = 64;
+
+        uint32_t AlignUp(uint32_t v, uint32_t a) { return (v + a - 1) & ~(a - 1); }
+    }
+
+    Archetype::Archetype(ComponentMask mask) : Signature(mask)
+    {
+        ColumnOf.fill(-1);
+        for (ComponentTypeId t = 0; t < kMaxComponentTypes; ++t)
+            if ((mask >> t) & 1) TypeList.push_back(t);
+
+        uint32_t rowBytes = (uint32_t)sizeof(Entity);
+        for (auto t : TypeList) {
+            Infos.push_back(&GetComponentInfo(t));
+            rowBytes += Infos.back()->Size;
+        }
+
+        // Largest capacity whose aligned column layout still fits in one chunk
+        auto layout = [&](uint32_t cap) {
+            uint32_t off = AlignUp((uint32_t)sizeof(Entity) * cap, 16);
+            ColumnOffsets.clear();
+            for (auto* info : Infos) {
+                off = AlignUp(off, std::max<uint32_t>(info->Align, 1));
+                ColumnOffsets.push_back(off);
+                off += info->Size * cap;
+            }
+            return off;
+        };
+        Capacity = std::max<uint32_t>(1, kChunkBytes / rowBytes);
+        while (Capacity > 1 && layout(Capacity) > kChunkBytes) --Capacity;
+        // A row too big for a standard chunk gets a chunk of its own size
+        ChunkBytes = std::max(kChunkBytes, AlignUp(layout(Capacity), (uint32_t)kChunkAlign));
+
+        for (size_t i = 0; i < TypeList.size(); ++i) ColumnOf[TypeList[i]] = (int8_t)i;
+    }
+
+    Archetype::~Archetype()
+    {
+        Clear();
+    }
+
+    Entity& Archetype::EntityAt(uint32_t row) const
+    {
+        const Chunk& c = ChunkList[row / Capacity];
+        return Entities(c)[row % Capacity];
+    }
+
+    void* Archetype::ComponentAt(uint32_t row, ComponentTypeId t) const
+    {
+        const int col = ColumnOf[t];
+        const Chunk& c = ChunkList[row / Capacity];
+        return c.Data + ColumnOffsets[col] + (size_t)Infos[col]->Size * (row % Capacity);
+    }
+
+    uint32_t Archetype::AllocateRow(Entity e)
+    {
+        if (ChunkList.empty() || ChunkList.back().Count == Capacity) {
+            Chunk c;
+            c.Data = static_cast<std::byte*>(::operator new(ChunkBytes, std::align_val_t{kChunkAlign}));
+            ChunkList.push_back(c);
+        }
+        Chunk& c = ChunkList.back();
+        Entities(c)[c.Count++] = e;
+        return NumRows++;
+    }
+
+    void Archetype::ConstructRow(uint32_t row, ComponentMask skipMask)
+    {
+        for (size_t i = 0; i < TypeList.size(); ++i) {
+            if ((skipMask >> TypeList[i]) & 1) continue;
+            Infos[i]->DefaultConstruct(ComponentAt(row, TypeList[i]));
+        }
+    }
+
+    Entity Archetype::RemoveRow(uint32_t row, ComponentMask destroyMask)
+    {
+        const uint32_t last = NumRows - 1;
+        Entity moved{};
+
+        for (size_t i = 0; i < TypeList.size(); ++i) {
+            const auto* info = Infos[i];
+            void* dst = ComponentAt(row, TypeList[i]);
+            if (((destroyMask >> TypeList[i]) & 1) && info->Destroy) info->Destroy(dst);
+            if (row == last) continue;
+            void* src = ComponentAt(last, TypeList[i]);
+            if (info->MoveConstruct) { info->MoveConstruct(dst, src); info->Destroy(src); }
+            else                     std::memcpy(dst, src, info->Size);
+        }
+        if (row != last) {
+            moved = EntityAt(last);
+            EntityAt(row) = moved;
+        }
+
+        --NumRows;
+        if (--ChunkList.back().Count == 0) {
+            ::operator delete(ChunkList.back().Data, std::align_val_t{kChunkAlign});
+            ChunkList.pop_back();
+        }
+        return moved;
+    }
+
+    void Archetype::Clear()
+    {
+        for (auto& c : ChunkList) {
+            for (size_t i = 0; i < TypeList.size(); ++i) {
+                if (!Infos[i]->Destroy) continue;
+                std::byte* col = c.Data + ColumnOffsets[i];
+                for (uint32_t r = 0; r < c.Count; ++r) Infos[i]->Destroy(col + (size_t)Infos[i]->Size * r);
+            }
+            ::operator delete(c.Data, std::align_val_t{kChunkAlign});
+        }
+        ChunkList.clear();
+        NumRows = 0;
+    }
+}
@@ -0,0 +1,73 @@
+﻿#pragma once
+#include "Runtime/World/ComponentType.h"
+#include "Runtime/World/Entity.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ace {
+    // All entities with exactly the same component set. Storage is a list of
+    // fixed-size chunks; each chunk holds an Entity column followed by one
+    // tightly packed column per component type (SoA). Rows are kept dense:
+    // every chunk but the last is full, removal swaps the last row in. A row
+    // larger than kChunkBytes gets chunks of one row, sized to fit.
+    class Archetype {
+    public:
+        static constexpr uint32_t kChunkBytes = 16 * 1024;
+
+        struct Chunk {
+            std::byte* Data  = nullptr;
+            uint32_t   Count = 0;
+        };
+
+        explicit Archetype(ComponentMask mask);
+        ~Archetype();
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        ComponentMask Mask() const { return Signature; }
+        bool Has(ComponentTypeId t) const { return (Signature >> t) & 1; }
+        const std::vector<ComponentTypeId>& Types() const { return TypeList; }
+
+        uint32_t Count() const         { return NumRows; }
+        uint32_t ChunkCapacity() const { return Capacity; }
+        uint32_t ChunkSize() const     { return ChunkBytes; }
+        const std::vector<Chunk>& Chunks() const { return ChunkList; }
+
+        // Column base pointers for one chunk; ColumnIndex(t) must be >= 0.
+        int      ColumnIndex(ComponentTypeId t) const { return ColumnOf[t]; }
+        Entity*  Entities(const Chunk& c) const { return reinterpret_cast<Entity*>(c.Data); }
+        void*    Column(const Chunk& c, int column) const { return c.Data + ColumnOffsets[column]; }
+
+        Entity&  EntityAt(uint32_t row) const;
+        void*    ComponentAt(uint32_t row, ComponentTypeId t) const;
+
+        // Appends a row with uninitialised component storage; returns its index.
+        uint32_t AllocateRow(Entity e);
+        // Default-constructs the components of a freshly allocated row that the
+        // caller did not fill in itself (skipMask bits are left untouched).
+        void     ConstructRow(uint32_t row, ComponentMask skipMask);
+        // Removes 'row'. Components whose bit is in destroyMask are destroyed;
+        // the rest must already have been moved out and destroyed. Returns the entity that was
+        // moved into 'row' (null if 'row' was the last one).
+        Entity   RemoveRow(uint32_t row, ComponentMask destroyMask);
+        // Destroys every row and frees all chunks.
+        void     Clear();
+
+        // Cached transitions for add/remove of a single component type
+        std::array<Archetype*, kMaxComponentTypes> AddEdges{};
+        std::array<Archetype*, kMaxComponentTypes> RemoveEdges{};
+
+    private:
+        ComponentMask                 Signature = 0;
+        std::vector<ComponentTypeId>  TypeList;
+        std::vector<const ComponentInfo*> Infos;
+        std::vector<uint32_t>         ColumnOffsets;
+        std::array<int8_t, kMaxComponentTypes> ColumnOf{};
+        uint32_t                      Capacity = 0;
+        uint32_t                      ChunkBytes = kChunkBytes;
+        uint32_t                      NumRows  = 0;
+        std::vector<Chunk>            ChunkList;
+    };
+}
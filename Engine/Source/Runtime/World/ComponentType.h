@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ace {
+    // Component types are numbered on first use. Archetype signatures are a
+    // 64-bit mask, which caps a world at 64 distinct component types.
+    using ComponentTypeId = uint32_t;
+    using ComponentMask   = uint64_t;
+    constexpr ComponentTypeId kMaxComponentTypes = 64;
+
+    // Type-erased operations the chunk storage needs. Null Move/Destroy means the
+    // type is trivially relocatable and can be memcpy'd / dropped.
+    struct ComponentInfo {
+        std::string_view Name;
+        uint32_t Size  = 0;
+        uint32_t Align = 0;
+        void (*DefaultConstruct)(void* dst)           = nullptr;
+        void (*MoveConstruct)(void* dst, void* src)   = nullptr;
+        void (*Destroy)(void* p)                      = nullptr;
+    };
+
+    namespace detail {
+        ComponentTypeId RegisterComponentType(const ComponentInfo& info);
+
+        template<class T>
+        constexpr std::string_view TypeNameOf()
+        {
+        #if defined(__clang__) || defined(__GNUC__)
+            std::string_view s = __PRETTY_FUNCTION__;
+            const auto b = s.find("T = ") + 4;
+            return s.substr(b, s.find_first_of(";]", b) - b);
+        #elif defined(_MSC_VER)
+            std::string_view s = __FUNCSIG__;
+            const auto b = s.find("TypeNameOf<") + 11;
+            return s.substr(b, s.find(">(void)", b) - b);
+        #else
+            return "Component";
+        #endif
+        }
+    }
+
+    const ComponentInfo& GetComponentInfo(ComponentTypeId id);
+    ComponentTypeId      GetComponentTypeCount();
+
+    template<class T>
+    ComponentTypeId ComponentTypeOf()
+    {
+        static_assert(std::is_same_v<T, std::remove_cvref_t<T>>, "use the plain component type");
+        static_assert(std::is_default_constructible_v<T> && std::is_move_constructible_v<T>,
+                      "components must be default- and move-constructible");
+        static const ComponentTypeId id = [] {
+            ComponentInfo info;
+            info.Name  = detail::TypeNameOf<T>();
+            info.Size  = (uint32_t)sizeof(T);
+            info.Align = (uint32_t)alignof(T);
+            info.DefaultConstruct = [](void* dst) { ::new (dst) T(); };
+            if constexpr (!std::is_trivially_copyable_v<T>) {
+                info.MoveConstruct = [](void* dst, void* src) { ::new (dst) T(std::move(*static_cast<T*>(src))); };
+                info.Destroy       = [](void* p) { static_cast<T*>(p)->~T(); };
+            }
+            return detail::RegisterComponentType(info);
+        }();
+        return id;
+    }
+
+    template<class... C>
+    ComponentMask ComponentMaskOf() { return (ComponentMask{0} | ... | (ComponentMask{1} << ComponentTypeOf<C>())); }
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include "Runtime/Core/Math.h"
+#include <string>
+#include <vector>
+
+namespace ace {
+    // Built-in components shared by the editor and the runtime.
+
+    // Persistent id written to map files ("Id"); unrelated to the Entity handle.
+    struct IdComponent {
+        int Id = 0;
+    };
+
+    struct NameComponent {
+        std::string Name = "Entity";
+    };
+
+    struct TransformComponent {
+        Vec3 Position{0, 0, 0};
+        Vec3 Rotation{0, 0, 0};   // Euler degrees
+        Vec3 Scale{1, 1, 1};
+    };
+
+    struct StaticMeshComponent {
+        std::string Mesh;        // e.g. /Game/Props/SM_Crate.aceasset
+        std::string Material;    // optional
+    };
+
+    // Map files allow any number of StaticMesh components per entity, the
+    // ECS one per type: the first is the entity's StaticMeshComponent, the
+    // rest (rare) live here, in file order.
+    struct ExtraStaticMeshComponent {
+        std::vector<StaticMeshComponent> Meshes;
+    };
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+#include <cstdint>
+#include <functional>
+
+namespace ace {
+    // Generational handle: Index picks the slot, Generation detects reuse of a
+    // destroyed slot. Generation 0 is never issued, so Entity{} is the null handle.
+    struct Entity {
+        uint32_t Index      = 0;
+        uint32_t Generation = 0;
+
+        constexpr bool IsNull() const { return Generation == 0; }
+        constexpr explicit operator bool() const { return Generation != 0; }
+        constexpr bool operator==(const Entity&) const = default;
+
+        constexpr uint64_t Packed() const { return (uint64_t)Generation << 32 | Index; }
+        static constexpr Entity FromPacked(uint64_t v) { return Entity{(uint32_t)v, (uint32_t)(v >> 32)}; }
+    };
+}
+
+template<>
+struct std::hash<ace::Entity> {
+    size_t operator()(const ace::Entity& e) const noexcept { return std::hash<uint64_t>{}(e.Packed()); }
+};
@@ -0,0 +1,273 @@
+﻿#include "Runtime/World/MapBinary.h"
+#include "Runtime/World/MapJson.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/Core/StringTable.h"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ace {
+    static_assert(std::endian::native == std::endian::little, "binary .acemap is little-endian only");
+    static_assert(sizeof(MapBinaryHeader) == 80 && sizeof(MapEntityRecord) == 16 && sizeof(MapComponentBlob) == 8);
+    static_assert(sizeof(TransformComponent) == 36 && std::is_trivially_copyable_v<TransformComponent>,
+                  "transforms are stored as raw floats");
+
+    namespace {
+        constexpr uint64_t kSectionAlign = 16;
+
+        uint64_t AlignUp(uint64_t v, uint64_t a) { return (v + a - 1) & ~(a - 1); }
+
+        void AppendBlob(std::vector<uint8_t>& out, MapComponentKind kind, const void* payload, uint32_t size)
+        {
+            const MapComponentBlob blob{(uint32_t)kind, size};
+            const size_t at = out.size();
+            out.resize(at + sizeof(blob) + ((size + 3u) & ~3u), 0);
+            std::memcpy(out.data() + at, &blob, sizeof(blob));
+            std::memcpy(out.data() + at + sizeof(blob), payload, size);
+        }
+    }
+
+    // ---- MapBinaryView ----
+
+    bool MapBinaryView::Open(const std::filesystem::path& path)
+    {
+        Header = nullptr;
+        if (!File.Open(path)) return false;
+        return Validate(File.Data(), File.Size());
+    }
+
+    bool MapBinaryView::Open(const uint8_t* data, size_t size)
+    {
+        Header = nullptr;
+        File.Close();
+        if (reinterpret_cast<uintptr_t>(data) % alignof(MapBinaryHeader)) return false;
+        return Validate(data, size);
+    }
+
+    bool MapBinaryView::Validate(const uint8_t* base, uint64_t fileSize)
+    {
+        if (!base || fileSize < sizeof(MapBinaryHeader)) return false;
+
+        const auto* h = reinterpret_cast<const MapBinaryHeader*>(base);
+        if (std::memcmp(h->Magic, kMapBinaryMagic, sizeof(kMapBinaryMagic)) != 0) return false;
+        if (h->Version != kMapBinaryVersion || h->HeaderSize != sizeof(MapBinaryHeader)) return false;
+        if (h->FileSize != fileSize || h->StringCount == 0) return false;
+
+        const uint64_t n = h->EntityCount;
+        if (!InRange(h->EntitiesOffset,   n * sizeof(MapEntityRecord),    fileSize)) return false;
+        if (!InRange(h->TransformsOffset, n * sizeof(TransformComponent), fileSize)) return false;
+        if (!InRange(h->ComponentsOffset, h->ComponentsSize,              fileSize)) return false;
+        if (!InRange(h->StringsOffset,    h->StringsSize,                 fileSize)) return false;
+        if ((h->EntitiesOffset | h->TransformsOffset | h->ComponentsOffset | h->StringsOffset) % alignof(uint32_t)) return false;
+
+        // String table: offsets must be monotonic and end inside the section
+        const uint64_t offsetBytes = (uint64_t(h->StringCount) + 1) * sizeof(uint32_t);
+        if (offsetBytes > h->StringsSize) return false;
+        const auto* offsets = reinterpret_cast<const uint32_t*>(base + h->StringsOffset);
+        const uint64_t byteCount = h->StringsSize - offsetBytes;
+        for (uint32_t i = 0; i < h->StringCount; ++i)
+            if (offsets[i] > offsets[i + 1]) return false;
+        if (offsets[0] != 0 || offsets[h->StringCount] > byteCount) return false;
+
+        // Entity records and their component blobs
+        const auto* ents = reinterpret_cast<const MapEntityRecord*>(base + h->EntitiesOffset);
+        const uint8_t* comps = base + h->ComponentsOffset;
+        for (uint64_t i = 0; i < n; ++i) {
+            const MapEntityRecord& r = ents[i];
+            if (r.Name >= h->StringCount) return false;
+            uint64_t at = r.ComponentOffset;
+            for (uint32_t c = 0; c < r.ComponentCount; ++c) {
+                if (!InRange(at, sizeof(MapComponentBlob), h->ComponentsSize)) return false;
+                MapComponentBlob blob;
+                std::memcpy(&blob, comps + at, sizeof(blob));
+                at += sizeof(blob);
+                if (!InRange(at, blob.Size, h->ComponentsSize)) return false;
+                if (blob.Kind == (uint32_t)MapComponentKind::StaticMesh) {
+                    uint32_t ids[2];
+                    if (blob.Size < sizeof(ids)) return false;
+                    std::memcpy(ids, comps + at, sizeof(ids));
+                    if (ids[0] >= h->StringCount || ids[1] >= h->StringCount) return false;
+                }
+                at += (blob.Size + 3u) & ~3u;
+            }
+        }
+
+        Header         = h;
+        EntityTable    = ents;
+        TransformTable = reinterpret_cast<const TransformComponent*>(base + h->TransformsOffset);
+        Components     = comps;
+        StringOffsets  = offsets;
+        StringBytes    = reinterpret_cast<const char*>(base + h->StringsOffset + offsetBytes);
+        return true;
+    }
+
+    std::string_view MapBinaryView::String(uint32_t index) const
+    {
+        if (!Header || index >= Header->StringCount) return {};
+        return std::string_view(StringBytes + StringOffsets[index], StringOffsets[index + 1] - StringOffsets[index]);
+    }
+
+    // ---- save / load ----
+
+    MapFileFormat DetectMapFormat(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return MapFileFormat::Unknown;
+        uint8_t head[sizeof(kMapBinaryMagic)] = {};
+        in.read(reinterpret_cast<char*>(head), sizeof(head));
+        return DetectMapFormat(head, (size_t)in.gcount());
+    }
+
+    MapFileFormat DetectMapFormat(const uint8_t* head, size_t size)
+    {
+        const size_t got = std::min(size, sizeof(kMapBinaryMagic));
+        if (got == sizeof(kMapBinaryMagic) && std::memcmp(head, kMapBinaryMagic, got) == 0) return MapFileFormat::Binary;
+        // JSON: first non-space character (after an optional UTF-8 BOM) is '{'
+        size_t i = (got >= 3 && (uint8_t)head[0] == 0xEF && (uint8_t)head[1] == 0xBB && (uint8_t)head[2] == 0xBF) ? 3 : 0;
+        while (i < got && (head[i] == ' ' || head[i] == '\t' || head[i] == '\r' || head[i] == '\n')) ++i;
+        return (i < got && head[i] == '{') ? MapFileFormat::Json : MapFileFormat::Unknown;
+    }
+
+    void WriteMapBinary(const World& world, std::vector<uint8_t>& out)
+    {
+        ACE_PROFILE_SCOPE("WriteMapBinary");
+        StringTable strings;
+        std::vector<MapEntityRecord>    records;
+        std::vector<TransformComponent> transforms;
+        std::vector<uint8_t>            comps;
+        records.reserve(world.Count());
+        transforms.reserve(world.Count());
+
+        world.ForEachEntity([&](Entity e) {
+            const auto* id   = world.TryGet<IdComponent>(e);
+            const auto* name = world.TryGet<NameComponent>(e);
+            const auto* xf   = world.TryGet<TransformComponent>(e);
+
+            MapEntityRecord r{};
+            r.Id   = id ? id->Id : 0;
+            r.Name = strings.Intern(name ? std::string_view(name->Name) : std::string_view("Entity"));
+            r.ComponentOffset = (uint32_t)comps.size();
+            auto mesh = [&](const StaticMeshComponent& sm) {
+                const uint32_t ids[2] = { strings.Intern(sm.Mesh), strings.Intern(sm.Material) };
+                AppendBlob(comps, MapComponentKind::StaticMesh, ids, sizeof(ids));
+                ++r.ComponentCount;
+            };
+            if (const auto* sm = world.TryGet<StaticMeshComponent>(e)) mesh(*sm);
+            if (const auto* extra = world.TryGet<ExtraStaticMeshComponent>(e))
+                for (const auto& sm : extra->Meshes) mesh(sm);
+            records.push_back(r);
+            transforms.push_back(xf ? *xf : TransformComponent{});
+        });
+
+        MapBinaryHeader h{};
+        std::memcpy(h.Magic, kMapBinaryMagic, sizeof(h.Magic));
+        h.Version          = kMapBinaryVersion;
+        h.HeaderSize       = sizeof(MapBinaryHeader);
+        h.EntityCount      = (uint32_t)records.size();
+        h.StringCount      = strings.Count();
+        h.EntitiesOffset   = AlignUp(sizeof(MapBinaryHeader), kSectionAlign);
+        h.TransformsOffset = AlignUp(h.EntitiesOffset + records.size() * sizeof(MapEntityRecord), kSectionAlign);
+        h.ComponentsOffset = AlignUp(h.TransformsOffset + transforms.size() * sizeof(TransformComponent), kSectionAlign);
+        h.ComponentsSize   = comps.size();
+        h.StringsOffset    = AlignUp(h.ComponentsOffset + h.ComponentsSize, kSectionAlign);
+        h.StringsSize      = strings.ByteSize();
+        h.FileSize         = h.StringsOffset + h.StringsSize;
+
+        out.assign((size_t)h.FileSize, 0);
+        std::memcpy(out.data(), &h, sizeof(h));
+        if (!records.empty())    std::memcpy(out.data() + h.EntitiesOffset,   records.data(),    records.size() * sizeof(MapEntityRecord));
+        if (!transforms.empty()) std::memcpy(out.data() + h.TransformsOffset, transforms.data(), transforms.size() * sizeof(TransformComponent));
+        if (!comps.empty())      std::memcpy(out.data() + h.ComponentsOffset, comps.data(),      comps.size());
+        strings.Write(out, h.StringsOffset);
+    }
+
+    bool SaveMapBinary(const World& world, const std::filesystem::path& path)
+    {
+        std::vector<uint8_t> out;
+        WriteMapBinary(world, out);
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) return false;
+        f.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size());
+        return (bool)f;
+    }
+
+    namespace {
+        void LoadFromView(World& world, const MapBinaryView& view, int* maxId)
+        {
+            ACE_PROFILE_SCOPE("LoadMapBinary");
+            world.Clear();
+            world.Reserve(view.EntityCount());
+            int m = 0;
+            const MapEntityRecord*    ents = view.Entities();
+            const TransformComponent* xfs  = view.Transforms();
+            for (uint32_t i = 0; i < view.EntityCount(); ++i) {
+                const MapEntityRecord& r = ents[i];
+                bool hasMesh = false;
+                StaticMeshComponent sm;
+                ExtraStaticMeshComponent extra;
+                view.ForEachComponent(i, [&](MapComponentKind kind, const uint8_t* payload, uint32_t) {
+                    if (kind != MapComponentKind::StaticMesh) return;
+                    uint32_t ids[2];
+                    std::memcpy(ids, payload, sizeof(ids));
+                    StaticMeshComponent& dst = hasMesh ? extra.Meshes.emplace_back() : sm;
+                    dst.Mesh     = view.String(ids[0]);
+                    dst.Material = view.String(ids[1]);
+                    hasMesh = true;
+                });
+
+                // Create straight into the final archetype: no per-entity moves
+                NameComponent name{std::string(view.String(r.Name))};
+                if (!extra.Meshes.empty())
+                    world.Create(IdComponent{r.Id}, std::move(name), TransformComponent(xfs[i]), std::move(sm), std::move(extra));
+                else if (hasMesh)
+                    world.Create(IdComponent{r.Id}, std::move(name), TransformComponent(xfs[i]), std::move(sm));
+                else
+                    world.Create(IdComponent{r.Id}, std::move(name), TransformComponent(xfs[i]));
+                m = std::max(m, (int)r.Id);
+            }
+            if (maxId) *maxId = m;
+        }
+    }
+
+    bool LoadMapBinary(World& world, const std::filesystem::path& path, int* maxId)
+    {
+        MapBinaryView view;
+        if (!view.Open(path)) return false;
+        LoadFromView(world, view, maxId);
+        return true;
+    }
+
+    bool LoadMapBinary(World& world, const uint8_t* data, size_t size, int* maxId)
+    {
+        MapBinaryView view;
+        if (!view.Open(data, size)) return false;
+        LoadFromView(world, view, maxId);
+        return true;
+    }
+
+    bool LoadMap(World& world, const uint8_t* data, size_t size, int* maxId)
+    {
+        switch (DetectMapFormat(data, size)) {
+        case MapFileFormat::Binary: return LoadMapBinary(world, data, size, maxId);
+        case MapFileFormat::Json:   return LoadMapJson(world, reinterpret_cast<const char*>(data), size, maxId);
+        default:                    return false;
+        }
+    }
+
+    bool LoadMap(World& world, const std::filesystem::path& path, int* maxId)
+    {
+        switch (DetectMapFormat(path)) {
+        case MapFileFormat::Binary: return LoadMapBinary(world, path, maxId);
+        case MapFileFormat::Json:   return LoadMapJson(world, path, maxId);
+        default:                    return false;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+﻿#pragma once
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/World.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace ace {
+    // Binary .acemap (little-endian, every section 16-byte aligned):
+    //
+    //   MapBinaryHeader
+    //   MapEntityRecord[EntityCount]       Id, name string, component range
+    //   TransformComponent[EntityCount]    packed floats, readable in place
+    //   component blobs                    { MapComponentBlob, payload }...
+    //   string table                       uint32 offsets[StringCount + 1], UTF-8 bytes
+    //
+    // Entities are written in slot order and read back in file order, like the
+    // JSON format. Blobs of unknown Kind are skipped on load.
+
+    inline constexpr char     kMapBinaryMagic[8] = {'A','C','E','M','A','P','B','\x1A'};
+    inline constexpr uint32_t kMapBinaryVersion  = 1;
+
+    struct MapBinaryHeader {
+        char     Magic[8];
+        uint32_t Version;
+        uint32_t HeaderSize;
+        uint32_t EntityCount;
+        uint32_t StringCount;
+        uint64_t EntitiesOffset;
+        uint64_t TransformsOffset;
+        uint64_t ComponentsOffset;
+        uint64_t ComponentsSize;
+        uint64_t StringsOffset;
+        uint64_t StringsSize;
+        uint64_t FileSize;
+    };
+
+    struct MapEntityRecord {
+        int32_t  Id;
+        uint32_t Name;              // string index
+        uint32_t ComponentOffset;   // byte offset into the component section
+        uint32_t ComponentCount;
+    };
+
+    enum class MapComponentKind : uint32_t {
+        StaticMesh = 1,             // payload: uint32 Mesh, uint32 Material (string indices)
+    };
+
+    struct MapComponentBlob {
+        uint32_t Kind;
+        uint32_t Size;              // payload bytes; the next blob starts 4-byte aligned
+    };
+
+    // Validated read-only view over a mapped binary map. Nothing is copied:
+    // transforms and strings point into the mapping.
+    class MapBinaryView {
+    public:
+        bool Open(const std::filesystem::path& path);
+        // View over caller-owned bytes (8-byte aligned) that outlive the view
+        bool Open(const uint8_t* data, size_t size);
+
+        uint32_t EntityCount() const { return Header ? Header->EntityCount : 0; }
+        const MapEntityRecord*    Entities() const   { return EntityTable; }
+        const TransformComponent* Transforms() const { return TransformTable; }
+        std::string_view          String(uint32_t index) const;
+
+        // fn(MapComponentKind, const uint8_t* payload, uint32_t size) per blob of entity i
+        template<class F> void ForEachComponent(uint32_t i, F&& fn) const;
+
+    private:
+        bool Validate(const uint8_t* base, uint64_t fileSize);
+
+        MappedFile                File;
+        const MapBinaryHeader*    Header = nullptr;
+        const MapEntityRecord*    EntityTable = nullptr;
+        const TransformComponent* TransformTable = nullptr;
+        const uint8_t*            Components = nullptr;
+        const uint32_t*           StringOffsets = nullptr;
+        const char*               StringBytes = nullptr;
+    };
+
+    enum class MapFileFormat { Unknown, Json, Binary };
+
+    // Sniffs the first bytes of 'path'
+    MapFileFormat DetectMapFormat(const std::filesystem::path& path);
+    MapFileFormat DetectMapFormat(const uint8_t* data, size_t size);
+
+    // Whole file image, e.g. for a cooker that hashes or caches it first
+    void WriteMapBinary(const World& world, std::vector<uint8_t>& out);
+    bool SaveMapBinary(const World& world, const std::filesystem::path& path);
+    // Replaces the contents of 'world'. Fails without touching 'world' if the
+    // file is truncated or inconsistent.
+    bool LoadMapBinary(World& world, const std::filesystem::path& path, int* maxId = nullptr);
+    bool LoadMapBinary(World& world, const uint8_t* data, size_t size, int* maxId = nullptr);
+
+    // Picks the loader by magic. The in-memory form takes e.g. a VfsFile's bytes.
+    bool LoadMap(World& world, const std::filesystem::path& path, int* maxId = nullptr);
+    bool LoadMap(World& world, const uint8_t* data, size_t size, int* maxId = nullptr);
+
+    // ---- template implementation ----
+
+    template<class F>
+    void MapBinaryView::ForEachComponent(uint32_t i, F&& fn) const
+    {
+        const MapEntityRecord& r = EntityTable[i];
+        const uint8_t* p = Components + r.ComponentOffset;
+        for (uint32_t c = 0; c < r.ComponentCount; ++c) {
+            MapComponentBlob blob;
+            std::memcpy(&blob, p, sizeof(blob));
+            fn((MapComponentKind)blob.Kind, p + sizeof(blob), blob.Size);
+            p += sizeof(blob) + ((blob.Size + 3u) & ~3u);
+        }
+    }
+}
@@ -0,0 +1,339 @@
+﻿#include "Runtime/World/MapJson.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/MappedFile.h"
+#include "Runtime/Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace ace {
+    namespace {
+        json ToJson(const Vec3& v) { return json::array({v.X, v.Y, v.Z}); }
+
+        // Fields are type-checked rather than read with get<>()/value(),
+        // which throw on a mismatch: decoding runs inside jobs, and a bad
+        // file should fail its load, not the process
+        bool Vec3FromJson(const json& j, Vec3& v)
+        {
+            if (!j.is_array() || j.size() < 3 || !j[0].is_number() || !j[1].is_number() || !j[2].is_number()) return false;
+            v.X = j[0].get<float>();
+            v.Y = j[1].get<float>();
+            v.Z = j[2].get<float>();
+            return true;
+        }
+
+        // 'key' of 'j' as a string: false if present with another type
+        bool StringField(const json& j, const char* key, std::string& out)
+        {
+            const auto it = j.find(key);
+            if (it == j.end()) return true;
+            if (!it->is_string()) return false;
+            out = it->get<std::string>();
+            return true;
+        }
+
+        // One entity's components, decoded but not yet in a World
+        struct EntityDesc {
+            IdComponent         Id;
+            NameComponent       Name;
+            TransformComponent  Transform;
+            StaticMeshComponent Mesh;
+            bool                HasMesh = false;
+            ExtraStaticMeshComponent Extra;     // StaticMesh components after the first
+        };
+
+        // Missing fields keep their defaults; a field of the wrong type
+        // fails the entity and names it in 'bad' (null: not an object)
+        bool DescFromJson(const json& j, EntityDesc& d, const char*& bad)
+        {
+            bad = nullptr;
+            if (!j.is_object()) return false;
+            d.Name.Name = "Entity";
+            if (auto it = j.find("Id"); it != j.end()) {
+                bad = "Id";
+                if (!it->is_number_integer()) return false;
+                d.Id.Id = it->get<int>();
+            }
+            bad = "Name";
+            if (!StringField(j, "Name", d.Name.Name)) return false;
+            if (auto it = j.find("Transform"); it != j.end()) {
+                bad = "Transform";
+                if (!it->is_object()) return false;
+                const std::pair<const char*, Vec3*> parts[] = {
+                    {"Pos", &d.Transform.Position}, {"Rot", &d.Transform.Rotation}, {"Scale", &d.Transform.Scale}};
+                for (const auto& [key, v] : parts) {
+                    bad = key;
+                    if (auto f = it->find(key); f != it->end() && !Vec3FromJson(*f, *v)) return false;
+                }
+            }
+            if (auto it = j.find("Components"); it != j.end()) {
+                bad = "Components";
+                if (!it->is_array()) return false;
+                for (const auto& jc : *it) {
+                    std::string type = "StaticMesh";
+                    StaticMeshComponent sm;
+                    if (!jc.is_object() || !StringField(jc, "Type", type)) return false;
+                    if (type != "StaticMesh") continue;
+                    if (!StringField(jc, "Mesh", sm.Mesh) || !StringField(jc, "Material", sm.Material)) return false;
+                    if (d.HasMesh) d.Extra.Meshes.push_back(std::move(sm));
+                    else           { d.Mesh = std::move(sm); d.HasMesh = true; }
+                }
+            }
+            bad = nullptr;
+            return true;
+        }
+
+        Entity CreateFromDesc(World& world, EntityDesc&& d)
+        {
+            if (!d.HasMesh)
+                return world.Create(std::move(d.Id), std::move(d.Name), std::move(d.Transform));
+            if (d.Extra.Meshes.empty())
+                return world.Create(std::move(d.Id), std::move(d.Name), std::move(d.Transform), std::move(d.Mesh));
+            return world.Create(std::move(d.Id), std::move(d.Name), std::move(d.Transform), std::move(d.Mesh), std::move(d.Extra));
+        }
+
+        // Byte range of one element of the top-level "Entities" array
+        struct Span { size_t Begin, End; };
+
+        bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+        // 'i' is just past an opening quote; returns the index of the closing one (or n)
+        size_t SkipString(const char* p, size_t i, size_t n)
+        {
+            for (;;) {
+                const void* q = std::memchr(p + i, '"', n - i);
+                if (!q) return n;
+                const size_t k = (size_t)(static_cast<const char*>(q) - p);
+                size_t b = k;
+                while (b > i && p[b - 1] == '\\') --b;
+                if (((k - b) & 1) == 0) return k;     // not escaped
+                i = k + 1;
+            }
+        }
+
+        // Structural scan: tracks only strings and bracket depth, so it runs at
+        // memory speed. Finds the top-level "Entities" key and records where
+        // each array element starts and ends, and the array's brackets in
+        // 'array'. Returns false if the text does not have that shape; the
+        // caller then falls back to a full parse.
+        bool FindEntitySpans(const char* p, size_t n, std::vector<Span>& out, Span& arrayBrackets)
+        {
+            size_t i = (n >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) ? 3 : 0;
+            int    depth = 0;
+            size_t array = 0;
+            for (; i < n && !array; ++i) {
+                const char c = p[i];
+                if (c == '"') {
+                    const size_t start = i + 1;
+                    i = SkipString(p, start, n);
+                    if (i >= n) return false;
+                    if (depth != 1 || i - start != 8 || std::memcmp(p + start, "Entities", 8) != 0) continue;
+                    size_t k = i + 1;
+                    while (k < n && IsSpace(p[k])) ++k;
+                    if (k >= n || p[k] != ':') continue;       // a value, not a key
+                    ++k;
+                    while (k < n && IsSpace(p[k])) ++k;
+                    if (k >= n || p[k] != '[') return false;
+                    array = k;
+                } else if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    --depth;
+                }
+            }
+            if (!array) return false;
+
+            depth = 0;
+            size_t begin = SIZE_MAX;
+            for (i = array + 1; i < n; ++i) {
+                const char c = p[i];
+                if (depth == 0) {
+                    if (c == ',' || c == ']') {
+                        if (begin != SIZE_MAX) out.push_back({begin, i});
+                        else if (c == ',' || !out.empty()) return false;   // empty element or trailing comma
+                        if (c == ']') { arrayBrackets = {array, i}; return true; }
+                        begin = SIZE_MAX;
+                        continue;
+                    }
+                    if (IsSpace(c)) continue;
+                    if (begin == SIZE_MAX) begin = i;
+                }
+                if (c == '"') {
+                    i = SkipString(p, i + 1, n);
+                    if (i >= n) return false;
+                } else if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth < 0) return false;
+                }
+            }
+            return false;
+        }
+    }
+
+    json EntityToJson(const World& world, Entity e)
+    {
+        json j;
+        const auto* id   = world.TryGet<IdComponent>(e);
+        const auto* name = world.TryGet<NameComponent>(e);
+        j["Id"]   = id ? id->Id : 0;
+        j["Name"] = name ? name->Name : std::string("Entity");
+
+        TransformComponent xf{};
+        if (const auto* t = world.TryGet<TransformComponent>(e)) xf = *t;
+        j["Transform"] = json{ {"Pos", ToJson(xf.Position)}, {"Rot", ToJson(xf.Rotation)}, {"Scale", ToJson(xf.Scale)} };
+
+        j["Components"] = json::array();
+        auto mesh = [&](const StaticMeshComponent& sm) {
+            json c;
+            c["Type"] = "StaticMesh";
+            c["Mesh"] = sm.Mesh;
+            if (!sm.Material.empty()) c["Material"] = sm.Material;
+            j["Components"].push_back(std::move(c));
+        };
+        if (const auto* sm = world.TryGet<StaticMeshComponent>(e)) mesh(*sm);
+        if (const auto* extra = world.TryGet<ExtraStaticMeshComponent>(e))
+            for (const auto& sm : extra->Meshes) mesh(sm);
+        return j;
+    }
+
+    bool EntityFromJson(World& world, const json& j, Entity* out)
+    {
+        EntityDesc d;
+        const char* bad = nullptr;
+        if (!DescFromJson(j, d, bad)) return false;
+        const Entity e = CreateFromDesc(world, std::move(d));
+        if (out) *out = e;
+        return true;
+    }
+
+    json MapToJson(const World& world)
+    {
+        json root;
+        root["Type"]     = "Map";
+        root["Version"]  = 1;
+        root["Entities"] = json::array();
+        world.ForEachEntity([&](Entity e) { root["Entities"].push_back(EntityToJson(world, e)); });
+        return root;
+    }
+
+    bool MapFromJson(World& world, const json& j, int* maxId, std::string* error)
+    {
+        // Decode everything before touching 'world', so a bad entity leaves it as it was
+        std::vector<EntityDesc> descs;
+        auto it = j.is_object() ? j.find("Entities") : j.end();
+        if (it != j.end() && it->is_array()) {
+            descs.resize(it->size());
+            for (size_t i = 0; i < descs.size(); ++i) {
+                const char* bad = nullptr;
+                if (DescFromJson((*it)[i], descs[i], bad)) continue;
+                if (error) *error = "entity " + std::to_string(i) + (bad ? ": \"" + std::string(bad) + "\" has the wrong type" : " is not an object");
+                return false;
+            }
+        }
+        world.Clear();
+        world.Reserve(descs.size());
+        int m = 0;
+        for (EntityDesc& d : descs) {
+            m = std::max(m, d.Id.Id);
+            CreateFromDesc(world, std::move(d));
+        }
+        if (maxId) *maxId = m;
+        return true;
+    }
+
+    bool SaveMapJson(const World& world, const std::filesystem::path& path)
+    {
+        ACE_PROFILE_SCOPE("SaveMapJson");
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << MapToJson(world).dump(2);
+        return (bool)out;
+    }
+
+    bool LoadMapJson(World& world, const std::filesystem::path& path, int* maxId)
+    {
+        MappedFile file;
+        if (!file.Open(path)) return false;
+        return LoadMapJson(world, reinterpret_cast<const char*>(file.Data()), file.Size(), maxId);
+    }
+
+    bool LoadMapJson(World& world, const char* text, size_t size, int* maxId)
+    {
+        ACE_PROFILE_SCOPE("LoadMapJson");
+        std::vector<Span> spans;
+        Span brackets{};
+        ACE_PROFILE_COUNTER("Map bytes", size);
+        bool useSpans = FindEntitySpans(text, size, spans, brackets);
+        if (useSpans) {
+            // The elements are validated by their own parses below; the rest of
+            // the document must be valid too, with this array as its Entities
+            // (not shadowed by a duplicate key, not nested in a top-level array)
+            std::string skeleton;
+            skeleton.reserve(size - (brackets.End - brackets.Begin) + 1);
+            skeleton.append(text, brackets.Begin).append("[]").append(text + brackets.End + 1, size - brackets.End - 1);
+            json sk = json::parse(skeleton, nullptr, false);
+            if (sk.is_discarded()) return false;
+            auto it = sk.is_object() ? sk.find("Entities") : sk.end();
+            useSpans = it != sk.end() && it->is_array() && it->empty();
+        }
+        if (!useSpans) {
+            // Unusual layout: parse the whole document on this thread
+            json j = json::parse(text, text + size, nullptr, false);
+            return !j.is_discarded() && MapFromJson(world, j, maxId);
+        }
+
+        // Parse and decode the elements in parallel. Each job only keeps the
+        // decoded components, so peak memory is the output plus one DOM per thread.
+        auto& jobs = JobSystem::Get();
+        std::vector<EntityDesc> descs(spans.size());
+        std::atomic<bool> failed{false};
+        jobs.ParallelFor(spans.size(), [&](size_t b, size_t e) {
+            ACE_PROFILE_SCOPE("LoadMapJson.Parse");
+            for (size_t i = b; i < e && !failed.load(std::memory_order_relaxed); ++i) {
+                json je = json::parse(text + spans[i].Begin, text + spans[i].End, nullptr, false);
+                const char* bad = nullptr;
+                if (je.is_discarded() || !DescFromJson(je, descs[i], bad)) { failed = true; return; }
+            }
+        });
+        if (failed) return false;
+
+        // Allocate rows in file order (keeps slot order = file order), then move
+        // the decoded components into the preallocated storage in parallel.
+        world.Clear();
+        world.Reserve(descs.size());
+        std::vector<Entity> entities(descs.size());
+        int m = 0;
+        ACE_PROFILE_SCOPE("LoadMapJson.Allocate");
+        for (size_t i = 0; i < descs.size(); ++i) {
+            entities[i] = !descs[i].HasMesh
+                ? world.CreateUninitialized<IdComponent, NameComponent, TransformComponent>()
+                : descs[i].Extra.Meshes.empty()
+                ? world.CreateUninitialized<IdComponent, NameComponent, TransformComponent, StaticMeshComponent>()
+                : world.CreateUninitialized<IdComponent, NameComponent, TransformComponent, StaticMeshComponent, ExtraStaticMeshComponent>();
+            m = std::max(m, descs[i].Id.Id);
+        }
+        jobs.ParallelFor(descs.size(), [&](size_t b, size_t e) {
+            ACE_PROFILE_SCOPE("LoadMapJson.Fill");
+            for (size_t i = b; i < e; ++i) {
+                EntityDesc& d = descs[i];
+                const Entity en = entities[i];
+                ::new (world.TryGet<IdComponent>(en))        IdComponent(d.Id);
+                ::new (world.TryGet<NameComponent>(en))      NameComponent(std::move(d.Name));
+                ::new (world.TryGet<TransformComponent>(en)) TransformComponent(d.Transform);
+                if (d.HasMesh) ::new (world.TryGet<StaticMeshComponent>(en)) StaticMeshComponent(std::move(d.Mesh));
+                if (!d.Extra.Meshes.empty()) ::new (world.TryGet<ExtraStaticMeshComponent>(en)) ExtraStaticMeshComponent(std::move(d.Extra));
+            }
+        });
+        if (maxId) *maxId = m;
+        return true;
+    }
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include "Runtime/World/World.h"
+#include <filesystem>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace ace {
+    // JSON .acemap format:
+    //   { "Type":"Map", "Version":1, "Entities":[ { "Id", "Name",
+    //     "Transform":{"Pos","Rot","Scale"}, "Components":[{"Type":"StaticMesh","Mesh","Material"}] } ] }
+    // Entities are written in slot order and read back in file order.
+    // Missing fields take defaults; a field of the wrong type fails the load
+    // (never throws) and leaves 'world' unchanged.
+
+    nlohmann::json EntityToJson(const World& world, Entity e);
+    bool           EntityFromJson(World& world, const nlohmann::json& j, Entity* out = nullptr);
+
+    nlohmann::json MapToJson(const World& world);
+    // Replaces the contents of 'world'; 'maxId' receives the largest
+    // IdComponent seen. 'error' names the first bad entity and field.
+    bool           MapFromJson(World& world, const nlohmann::json& j, int* maxId = nullptr, std::string* error = nullptr);
+
+    bool SaveMapJson(const World& world, const std::filesystem::path& path);
+    bool LoadMapJson(World& world, const std::filesystem::path& path, int* maxId = nullptr);
+    bool LoadMapJson(World& world, const char* text, size_t size, int* maxId = nullptr);
+}
@@ -0,0 +1,354 @@
+﻿#include "Runtime/World/SpatialIndex.h"
+#include <algorithm>
+#include <queue>
+
+namespace ace {
+    AABB EntityBounds(const TransformComponent& t)
+    {
+        // Half-diagonal of the scaled unit cube bounds it under any rotation
+        const float h = 0.5f * Length(t.Scale);
+        return {t.Position - Vec3(h, h, h), t.Position + Vec3(h, h, h)};
+    }
+
+    // ---- node pool ----
+
+    int32_t SpatialIndex::AllocateNode()
+    {
+        if (FreeList == kNull) {
+            Nodes.emplace_back();
+            return (int32_t)Nodes.size() - 1;
+        }
+        const int32_t n = FreeList;
+        FreeList = Nodes[n].Parent;
+        Nodes[n] = Node{};
+        return n;
+    }
+
+    void SpatialIndex::FreeNode(int32_t n)
+    {
+        Nodes[n].Parent = FreeList;
+        Nodes[n].Height = -1;
+        Nodes[n].Owner  = {};
+        FreeList = n;
+    }
+
+    int32_t SpatialIndex::LeafOf(Entity e) const
+    {
+        if (e.Index >= LeafByIndex.size()) return kNull;
+        const int32_t n = LeafByIndex[e.Index];
+        return (n != kNull && Nodes[n].Owner == e) ? n : kNull;
+    }
+
+    const AABB* SpatialIndex::Bounds(Entity e) const
+    {
+        const int32_t n = LeafOf(e);
+        return n == kNull ? nullptr : &Nodes[n].Tight;
+    }
+
+    void SpatialIndex::Clear()
+    {
+        Nodes.clear();
+        LeafByIndex.clear();
+        Root = FreeList = kNull;
+        Leaves = 0;
+    }
+
+    // ---- mutation ----
+
+    void SpatialIndex::Insert(Entity e, const AABB& box)
+    {
+        if (e.IsNull()) return;
+        if (LeafOf(e) != kNull) { Update(e, box); return; }
+        const int32_t leaf = AllocateNode();
+        Node& n = Nodes[leaf];
+        n.Tight = box;
+        n.Box   = box.Expanded(Margin);
+        n.Owner = e;
+        if (e.Index >= LeafByIndex.size()) LeafByIndex.resize((size_t)e.Index + 1, kNull);
+        LeafByIndex[e.Index] = leaf;
+        InsertLeaf(leaf);
+        ++Leaves;
+    }
+
+    bool SpatialIndex::Update(Entity e, const AABB& box)
+    {
+        const int32_t leaf = LeafOf(e);
+        if (leaf == kNull) { Insert(e, box); return true; }
+        Nodes[leaf].Tight = box;
+        if (Nodes[leaf].Box.Contains(box)) return false;
+
+        RemoveLeaf(leaf);
+        Nodes[leaf].Box = box.Expanded(Margin);
+        InsertLeaf(leaf);
+        return true;
+    }
+
+    void SpatialIndex::Remove(Entity e)
+    {
+        const int32_t leaf = LeafOf(e);
+        if (leaf == kNull) return;
+        RemoveLeaf(leaf);
+        FreeNode(leaf);
+        LeafByIndex[e.Index] = kNull;
+        --Leaves;
+    }
+
+    void SpatialIndex::Refit(int32_t n)
+    {
+        Node& node = Nodes[n];
+        node.Box    = Union(Nodes[node.Left].Box, Nodes[node.Right].Box);
+        node.Height = 1 + std::max(Nodes[node.Left].Height, Nodes[node.Right].Height);
+    }
+
+    void SpatialIndex::InsertLeaf(int32_t leaf)
+    {
+        if (Root == kNull) {
+            Root = leaf;
+            Nodes[leaf].Parent = kNull;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest surface-area cost
+        const AABB box = Nodes[leaf].Box;
+        int32_t index = Root;
+        while (!Nodes[index].IsLeaf()) {
+            const Node& node = Nodes[index];
+            const float area     = node.Box.SurfaceArea();
+            const float combined = Union(node.Box, box).SurfaceArea();
+            const float cost        = 2.0f * combined;              // new parent here
+            const float inheritance = 2.0f * (combined - area);     // pushing down grows this node
+
+            auto childCost = [&](int32_t c) {
+                const Node& child = Nodes[c];
+                const float grown = Union(box, child.Box).SurfaceArea();
+                return child.IsLeaf() ? grown + inheritance : grown - child.Box.SurfaceArea() + inheritance;
+            };
+            const float costL = childCost(node.Left);
+            const float costR = childCost(node.Right);
+            if (cost < costL && cost < costR) break;
+            index = costL < costR ? node.Left : node.Right;
+        }
+
+        // Splice in a new parent above the chosen sibling
+        const int32_t sibling   = index;
+        const int32_t oldParent = Nodes[sibling].Parent;
+        const int32_t parent    = AllocateNode();
+        Node& p = Nodes[parent];
+        p.Parent = oldParent;
+        p.Left   = sibling;
+        p.Right  = leaf;
+        Nodes[sibling].Parent = parent;
+        Nodes[leaf].Parent    = parent;
+        Refit(parent);
+        if (oldParent == kNull) Root = parent;
+        else if (Nodes[oldParent].Left == sibling) Nodes[oldParent].Left = parent;
+        else Nodes[oldParent].Right = parent;
+
+        // Walk back up refitting and rebalancing
+        for (int32_t i = Nodes[leaf].Parent; i != kNull; i = Nodes[i].Parent) {
+            i = Balance(i);
+            Refit(i);
+        }
+    }
+
+    void SpatialIndex::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == Root) { Root = kNull; return; }
+
+        const int32_t parent      = Nodes[leaf].Parent;
+        const int32_t grandParent = Nodes[parent].Parent;
+        const int32_t sibling     = Nodes[parent].Left == leaf ? Nodes[parent].Right : Nodes[parent].Left;
+
+        if (grandParent == kNull) {
+            Root = sibling;
+            Nodes[sibling].Parent = kNull;
+            FreeNode(parent);
+            return;
+        }
+        if (Nodes[grandParent].Left == parent) Nodes[grandParent].Left = sibling;
+        else Nodes[grandParent].Right = sibling;
+        Nodes[sibling].Parent = grandParent;
+        FreeNode(parent);
+
+        for (int32_t i = grandParent; i != kNull; i = Nodes[i].Parent) {
+            i = Balance(i);
+            Refit(i);
+        }
+    }
+
+    // AVL-style rotation: if one child of 'a' is two levels taller than the
+    // other, promote it. Returns the index now at a's position.
+    int32_t SpatialIndex::Balance(int32_t iA)
+    {
+        Node& A = Nodes[iA];
+        if (A.IsLeaf() || A.Height < 2) return iA;
+
+        const int32_t iB = A.Left, iC = A.Right;
+        const int32_t balance = Nodes[iC].Height - Nodes[iB].Height;
+
+        auto rotateUp = [&](int32_t iUp, int32_t iOther, bool upWasRight) {
+            // iUp (a child of A) replaces A; A takes one of iUp's children
+            Node& U = Nodes[iUp];
+            const int32_t iF = U.Left, iG = U.Right;
+            U.Left   = iA;
+            U.Parent = A.Parent;
+            A.Parent = iUp;
+            if (U.Parent == kNull) Root = iUp;
+            else if (Nodes[U.Parent].Left == iA) Nodes[U.Parent].Left = iUp;
+            else Nodes[U.Parent].Right = iUp;
+
+            // Keep the taller grandchild under iUp, hand the other to A
+            const bool keepF = Nodes[iF].Height > Nodes[iG].Height;
+            const int32_t iKeep = keepF ? iF : iG;
+            const int32_t iGive = keepF ? iG : iF;
+            U.Right = iKeep;
+            if (upWasRight) { A.Right = iGive; A.Left = iOther; }
+            else            { A.Left = iGive;  A.Right = iOther; }
+            Nodes[iGive].Parent = iA;
+            Refit(iA);
+            Refit(iUp);
+            return iUp;
+        };
+
+        if (balance > 1)  return rotateUp(iC, iB, true);
+        if (balance < -1) return rotateUp(iB, iC, false);
+        return iA;
+    }
+
+    // ---- bulk build ----
+
+    void SpatialIndex::Build(const std::vector<std::pair<Entity, AABB>>& items)
+    {
+        Clear();
+        Nodes.reserve(items.size() * 2);
+        std::vector<int32_t> leaves;
+        leaves.reserve(items.size());
+        for (const auto& [e, box] : items) {
+            if (e.IsNull() || LeafOf(e) != kNull) continue;
+            const int32_t leaf = AllocateNode();
+            Node& n = Nodes[leaf];
+            n.Tight = box;
+            n.Box   = box.Expanded(Margin);
+            n.Owner = e;
+            if (e.Index >= LeafByIndex.size()) LeafByIndex.resize((size_t)e.Index + 1, kNull);
+            LeafByIndex[e.Index] = leaf;
+            leaves.push_back(leaf);
+        }
+        Leaves = leaves.size();
+        if (!leaves.empty()) {
+            Root = BuildRange(leaves.data(), leaves.size());
+            Nodes[Root].Parent = kNull;
+        }
+    }
+
+    // Median split along the longest axis of the centroid bounds
+    int32_t SpatialIndex::BuildRange(int32_t* leaves, size_t count)
+    {
+        if (count == 1) return leaves[0];
+
+        AABB centroids = AABB::Empty();
+        for (size_t i = 0; i < count; ++i) {
+            const Vec3 c = Nodes[leaves[i]].Box.Center();
+            centroids = Union(centroids, AABB{c, c});
+        }
+        const Vec3 ext = centroids.Max - centroids.Min;
+        const int axis = (ext.X >= ext.Y && ext.X >= ext.Z) ? 0 : (ext.Y >= ext.Z ? 1 : 2);
+        auto key = [&](int32_t n) {
+            const Vec3 c = Nodes[n].Box.Center();
+            return axis == 0 ? c.X : axis == 1 ? c.Y : c.Z;
+        };
+
+        const size_t mid = count / 2;
+        std::nth_element(leaves, leaves + mid, leaves + count,
+                         [&](int32_t a, int32_t b) { return key(a) < key(b); });
+
+        const int32_t left  = BuildRange(leaves, mid);
+        const int32_t right = BuildRange(leaves + mid, count - mid);
+        const int32_t n = AllocateNode();
+        Nodes[n].Left  = left;
+        Nodes[n].Right = right;
+        Nodes[left].Parent  = n;
+        Nodes[right].Parent = n;
+        Refit(n);
+        return n;
+    }
+
+    // ---- queries ----
+
+    bool SpatialIndex::Raycast(const Ray& ray, float maxT, RayHit& out) const
+    {
+        if (Root == kNull) return false;
+        const Vec3 inv(1.0f / ray.Dir.X, 1.0f / ray.Dir.Y, 1.0f / ray.Dir.Z);
+
+        // Slab test; returns the entry distance or +inf on a miss
+        auto enter = [&](const AABB& b, float limit) {
+            float t0 = 0.0f, t1 = limit;
+            const float o[3]  = {ray.Origin.X, ray.Origin.Y, ray.Origin.Z};
+            const float id[3] = {inv.X, inv.Y, inv.Z};
+            const float lo[3] = {b.Min.X, b.Min.Y, b.Min.Z};
+            const float hi[3] = {b.Max.X, b.Max.Y, b.Max.Z};
+            for (int a = 0; a < 3; ++a) {
+                float ta = (lo[a] - o[a]) * id[a];
+                float tb = (hi[a] - o[a]) * id[a];
+                if (ta > tb) std::swap(ta, tb);
+                t0 = ta > t0 ? ta : t0;    // NaN-safe (origin on a slab plane)
+                t1 = tb < t1 ? tb : t1;
+                if (t0 > t1) return std::numeric_limits<float>::infinity();
+            }
+            return t0;
+        };
+
+        float best = maxT;
+        bool  hit  = false;
+        NodeStack stack;
+        stack.Push(Root);
+        while (!stack.Empty()) {
+            const Node& node = Nodes[stack.Pop()];
+            if (node.IsLeaf()) {
+                const float t = enter(node.Tight, best);
+                if (t <= best) { best = t; out.Hit = node.Owner; out.T = t; hit = true; }
+                continue;
+            }
+            // Visit the nearer child first so 'best' shrinks sooner
+            const float tl = enter(Nodes[node.Left].Box, best);
+            const float tr = enter(Nodes[node.Right].Box, best);
+            if (tl <= tr) {
+                if (tr <= best) stack.Push(node.Right);
+                if (tl <= best) stack.Push(node.Left);
+            } else {
+                if (tl <= best) stack.Push(node.Left);
+                if (tr <= best) stack.Push(node.Right);
+            }
+        }
+        return hit;
+    }
+
+    void SpatialIndex::Nearest(const Vec3& p, size_t k, std::vector<Entity>& out) const
+    {
+        out.clear();
+        if (Root == kNull || k == 0) return;
+
+        using Item = std::pair<float, int32_t>;     // squared distance, node
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;   // nearest node first
+        std::priority_queue<Item> found;                                         // farthest result on top
+        open.push({DistanceSq(Nodes[Root].Box, p), Root});
+
+        while (!open.empty()) {
+            const auto [d, i] = open.top();
+            open.pop();
+            if (found.size() == k && d >= found.top().first) break;
+            const Node& node = Nodes[i];
+            if (node.IsLeaf()) {
+                const float dl = DistanceSq(node.Tight, p);
+                if (found.size() < k) found.push({dl, i});
+                else if (dl < found.top().first) { found.pop(); found.push({dl, i}); }
+                continue;
+            }
+            open.push({DistanceSq(Nodes[node.Left].Box, p),  node.Left});
+            open.push({DistanceSq(Nodes[node.Right].Box, p), node.Right});
+        }
+
+        out.resize(found.size());
+        for (size_t i = out.size(); i-- > 0; found.pop()) out[i] = Nodes[found.top().second].Owner;
+    }
+}
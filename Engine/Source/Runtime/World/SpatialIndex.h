@@ -0,0 +1,182 @@
+﻿#pragma once
+#include "Runtime/Core/Math.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/Entity.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ace {
+    // Conservative world bounds of an entity until meshes carry their own:
+    // a unit cube scaled by Scale, large enough for any rotation.
+    AABB EntityBounds(const TransformComponent& t);
+
+    // Dynamic AABB tree (BVH) over entity bounds, keyed by Entity.
+    //
+    // Leaves store the exact box plus a "fat" copy enlarged by Margin; Update()
+    // is free while the new box stays inside the fat one, and otherwise
+    // re-inserts only that leaf (touching its path to the root, with
+    // rotations to keep the tree balanced). Build() makes a fresh top-down
+    // tree for bulk loads.
+    class SpatialIndex {
+    public:
+        SpatialIndex() = default;
+        explicit SpatialIndex(float margin) : Margin(margin) {}
+
+        void   Clear();
+        // Replaces the contents with 'items'
+        void   Build(const std::vector<std::pair<Entity, AABB>>& items);
+
+        void   Insert(Entity e, const AABB& box);   // replaces an existing entry
+        // Returns true if the tree structure changed
+        bool   Update(Entity e, const AABB& box);
+        void   Remove(Entity e);
+
+        bool   Contains(Entity e) const { return LeafOf(e) >= 0; }
+        const AABB* Bounds(Entity e) const;
+        size_t Count() const  { return Leaves; }
+        int    Height() const { return Root < 0 ? 0 : Nodes[Root].Height; }
+
+        struct RayHit {
+            Entity Hit;
+            float  T = 0;      // entry distance along the ray, in multiples of Dir
+        };
+        // Closest entity whose box the ray enters within [0, maxT]
+        bool Raycast(const Ray& ray, float maxT, RayHit& out) const;
+
+        // fn(Entity) for every box overlapping 'box'
+        template<class F> void QueryAABB(const AABB& box, F&& fn) const;
+        // fn(Entity) for every box at least partly inside the frustum
+        template<class F> void QueryFrustum(const Frustum& frustum, F&& fn) const;
+
+        // Up to k entities closest to p, nearest first
+        void Nearest(const Vec3& p, size_t k, std::vector<Entity>& out) const;
+
+    private:
+        static constexpr int32_t kNull = -1;
+
+        struct Node {
+            AABB    Box;                // fat box for leaves, union of children otherwise
+            AABB    Tight;              // leaves only: exact box
+            int32_t Parent = kNull;     // next free node while on the free list
+            int32_t Left   = kNull;     // kNull for leaves
+            int32_t Right  = kNull;
+            int32_t Height = 0;         // 0 = leaf, -1 = free
+            Entity  Owner;
+
+            bool IsLeaf() const { return Left == kNull; }
+        };
+
+        // Depth-first traversal stack. A balanced tree needs Height() + 1
+        // entries, which fit inline; a deeper one spills to the heap.
+        class NodeStack {
+        public:
+            NodeStack() = default;
+            NodeStack(const NodeStack&) = delete;
+            NodeStack& operator=(const NodeStack&) = delete;
+
+            bool    Empty() const { return Size == 0; }
+            void    Push(int32_t n) { if (Size == Capacity) Grow(); Data[Size++] = n; }
+            int32_t Pop() { return Data[--Size]; }
+
+        private:
+            static constexpr size_t kInline = 64;
+            void Grow()
+            {
+                std::vector<int32_t> bigger(Capacity * 2);
+                std::copy(Data, Data + Size, bigger.begin());
+                Heap.swap(bigger);
+                Data = Heap.data();
+                Capacity = Heap.size();
+            }
+
+            int32_t              Inline[kInline];
+            std::vector<int32_t> Heap;
+            int32_t*             Data     = Inline;
+            size_t               Size     = 0;
+            size_t               Capacity = kInline;
+        };
+
+        int32_t AllocateNode();
+        void    FreeNode(int32_t n);
+        void    InsertLeaf(int32_t leaf);
+        void    RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t a);
+        void    Refit(int32_t n);
+        int32_t BuildRange(int32_t* leaves, size_t count);
+        int32_t LeafOf(Entity e) const;
+
+        // Walks every leaf under 'n'
+        template<class F> void ForEachLeaf(int32_t n, F&& fn) const;
+
+        std::vector<Node>    Nodes;
+        std::vector<int32_t> LeafByIndex;   // Entity::Index -> leaf node
+        int32_t Root     = kNull;
+        int32_t FreeList = kNull;
+        size_t  Leaves   = 0;
+        float   Margin   = 0.1f;
+    };
+
+    // ---- template implementation ----
+
+    template<class F>
+    void SpatialIndex::ForEachLeaf(int32_t n, F&& fn) const
+    {
+        NodeStack stack;
+        stack.Push(n);
+        while (!stack.Empty()) {
+            const Node& node = Nodes[stack.Pop()];
+            if (node.IsLeaf()) { fn(node.Owner); continue; }
+            stack.Push(node.Left);
+            stack.Push(node.Right);
+        }
+    }
+
+    template<class F>
+    void SpatialIndex::QueryAABB(const AABB& box, F&& fn) const
+    {
+        if (Root == kNull) return;
+        NodeStack stack;
+        stack.Push(Root);
+        while (!stack.Empty()) {
+            const Node& node = Nodes[stack.Pop()];
+            if (node.IsLeaf()) {
+                if (node.Tight.Overlaps(box)) fn(node.Owner);
+            } else if (node.Box.Overlaps(box)) {
+                stack.Push(node.Left);
+                stack.Push(node.Right);
+            }
+        }
+    }
+
+    template<class F>
+    void SpatialIndex::QueryFrustum(const Frustum& frustum, F&& fn) const
+    {
+        if (Root == kNull) return;
+        // -1 = outside, 0 = intersecting, 1 = fully inside
+        auto classify = [&](const AABB& b) {
+            int result = 1;
+            for (const Plane& pl : frustum.Planes) {
+                const Vec3& n = pl.Normal;
+                const Vec3 pos(n.X >= 0 ? b.Max.X : b.Min.X, n.Y >= 0 ? b.Max.Y : b.Min.Y, n.Z >= 0 ? b.Max.Z : b.Min.Z);
+                if (Dot(n, pos) + pl.D < 0) return -1;
+                const Vec3 neg(n.X >= 0 ? b.Min.X : b.Max.X, n.Y >= 0 ? b.Min.Y : b.Max.Y, n.Z >= 0 ? b.Min.Z : b.Max.Z);
+                if (Dot(n, neg) + pl.D < 0) result = 0;
+            }
+            return result;
+        };
+
+        NodeStack stack;
+        stack.Push(Root);
+        while (!stack.Empty()) {
+            const int32_t i = stack.Pop();
+            const Node& node = Nodes[i];
+            const int c = classify(node.IsLeaf() ? node.Tight : node.Box);
+            if (c < 0) continue;
+            if (node.IsLeaf()) fn(node.Owner);
+            else if (c > 0) ForEachLeaf(i, fn);   // no more plane tests below
+            else { stack.Push(node.Left); stack.Push(node.Right); }
+        }
+    }
+}
@@ -0,0 +1,222 @@
+﻿#include "Runtime/World/World.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ace {
+    // ---- component type registry ----
+
+    namespace {
+        struct Registry {
+            std::mutex                 Mutex;
+            std::vector<ComponentInfo> Types;
+            // Never reallocates, so references handed out stay valid without locking
+            Registry() { Types.reserve(kMaxComponentTypes); }
+        };
+        Registry& GetRegistry() { static Registry r; return r; }
+    }
+
+    ComponentTypeId detail::RegisterComponentType(const ComponentInfo& info)
+    {
+        auto& reg = GetRegistry();
+        std::lock_guard lock(reg.Mutex);
+        if (reg.Types.size() >= kMaxComponentTypes) {
+            // Hard limit of the 64-bit archetype mask
+            std::fprintf(stderr, "ACE: too many component types (max %u)\n", kMaxComponentTypes);
+            std::abort();
+        }
+        reg.Types.push_back(info);
+        return (ComponentTypeId)reg.Types.size() - 1;
+    }
+
+    const ComponentInfo& GetComponentInfo(ComponentTypeId id)
+    {
+        return GetRegistry().Types[id];
+    }
+
+    ComponentTypeId GetComponentTypeCount()
+    {
+        auto& reg = GetRegistry();
+        std::lock_guard lock(reg.Mutex);
+        return (ComponentTypeId)reg.Types.size();
+    }
+
+    // ---- World ----
+
+    World::World()
+    {
+        EmptyArchetype = FindOrCreateArchetype(0);
+    }
+
+    World::~World() = default;
+
+    World::World(World&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    // The moved-from world is left empty and usable: Create() makes its
+    // empty archetype again on demand
+    World& World::operator=(World&& other) noexcept
+    {
+        if (this == &other) return *this;
+        Records         = std::move(other.Records);
+        FreeSlots       = std::move(other.FreeSlots);
+        AliveCount      = std::exchange(other.AliveCount, 0);
+        Archetypes      = std::move(other.Archetypes);
+        ArchetypeByMask = std::move(other.ArchetypeByMask);
+        EmptyArchetype  = std::exchange(other.EmptyArchetype, nullptr);
+        other.Records.clear();
+        other.FreeSlots.clear();
+        other.Archetypes.clear();
+        other.ArchetypeByMask.clear();
+        return *this;
+    }
+
+    Entity World::AllocateEntity()
+    {
+        uint32_t index;
+        if (!FreeSlots.empty()) {
+            index = FreeSlots.back();
+            FreeSlots.pop_back();
+        } else {
+            index = (uint32_t)Records.size();
+            Records.emplace_back();
+        }
+        ++AliveCount;
+        return Entity{index, Records[index].Generation};
+    }
+
+    Entity World::Create()
+    {
+        if (!EmptyArchetype) EmptyArchetype = FindOrCreateArchetype(0);
+        Entity e = AllocateEntity();
+        Record& r = Records[e.Index];
+        r.Arch = EmptyArchetype;
+        r.Row  = EmptyArchetype->AllocateRow(e);
+        return e;
+    }
+
+    void World::Destroy(Entity e)
+    {
+        if (!IsAlive(e)) return;
+        Record& r = Records[e.Index];
+        FixupMoved(r.Arch->RemoveRow(r.Row, ~ComponentMask{0}), r.Row);
+
+        r.Arch = nullptr;
+        r.Row  = 0;
+        if (++r.Generation == 0) r.Generation = 1;
+        FreeSlots.push_back(e.Index);
+        --AliveCount;
+    }
+
+    bool World::IsAlive(Entity e) const
+    {
+        return e.Index < Records.size() && Records[e.Index].Arch && Records[e.Index].Generation == e.Generation;
+    }
+
+    void World::RequireAlive(Entity e, const char* what) const
+    {
+        if (IsAlive(e)) return;
+        std::fprintf(stderr, "ACE: %s on a dead or stale entity (index %u, generation %u)\n", what, e.Index, e.Generation);
+        std::abort();
+    }
+
+    void World::Clear()
+    {
+        for (auto& a : Archetypes) a->Clear();
+        for (uint32_t i = 0; i < (uint32_t)Records.size(); ++i) {
+            Record& r = Records[i];
+            if (!r.Arch) continue;
+            r.Arch = nullptr;
+            if (++r.Generation == 0) r.Generation = 1;
+        }
+        // Reissue slots lowest-first so a reload keeps file order
+        FreeSlots.clear();
+        for (uint32_t i = (uint32_t)Records.size(); i-- > 0;) FreeSlots.push_back(i);
+        AliveCount = 0;
+    }
+
+    void World::Reserve(size_t entities)
+    {
+        Records.reserve(entities);
+    }
+
+    bool World::HasComponent(Entity e, ComponentTypeId t) const
+    {
+        return IsAlive(e) && Records[e.Index].Arch->Has(t);
+    }
+
+    void* World::GetComponent(Entity e, ComponentTypeId t)
+    {
+        if (!HasComponent(e, t)) return nullptr;
+        const Record& r = Records[e.Index];
+        return r.Arch->ComponentAt(r.Row, t);
+    }
+
+    ComponentMask World::GetMask(Entity e) const
+    {
+        return IsAlive(e) ? Records[e.Index].Arch->Mask() : 0;
+    }
+
+    Archetype* World::FindOrCreateArchetype(ComponentMask mask)
+    {
+        auto it = ArchetypeByMask.find(mask);
+        if (it != ArchetypeByMask.end()) return it->second;
+        Archetypes.push_back(std::make_unique<Archetype>(mask));
+        Archetype* a = Archetypes.back().get();
+        ArchetypeByMask.emplace(mask, a);
+        return a;
+    }
+
+    Archetype* World::TransitionAdd(Archetype* from, ComponentTypeId t)
+    {
+        Archetype*& edge = from->AddEdges[t];
+        if (!edge) {
+            edge = FindOrCreateArchetype(from->Mask() | (ComponentMask{1} << t));
+            edge->RemoveEdges[t] = from;
+        }
+        return edge;
+    }
+
+    Archetype* World::TransitionRemove(Archetype* from, ComponentTypeId t)
+    {
+        Archetype*& edge = from->RemoveEdges[t];
+        if (!edge) {
+            edge = FindOrCreateArchetype(from->Mask() & ~(ComponentMask{1} << t));
+            edge->AddEdges[t] = from;
+        }
+        return edge;
+    }
+
+    uint32_t World::MoveEntity(Entity e, Archetype* dst)
+    {
+        Record& r = Records[e.Index];
+        Archetype* src = r.Arch;
+        const uint32_t srcRow = r.Row;
+        const uint32_t dstRow = dst->AllocateRow(e);
+
+        ComponentMask dropped = 0;
+        for (ComponentTypeId t : src->Types()) {
+            if (!dst->Has(t)) { dropped |= ComponentMask{1} << t; continue; }
+            const ComponentInfo& info = GetComponentInfo(t);
+            void* from = src->ComponentAt(srcRow, t);
+            void* to   = dst->ComponentAt(dstRow, t);
+            if (info.MoveConstruct) { info.MoveConstruct(to, from); info.Destroy(from); }
+            else                    std::memcpy(to, from, info.Size);
+        }
+        FixupMoved(src->RemoveRow(srcRow, dropped), srcRow);
+
+        r.Arch = dst;
+        r.Row  = dstRow;
+        return dstRow;
+    }
+
+    void World::FixupMoved(Entity moved, uint32_t row)
+    {
+        if (moved) Records[moved.Index].Row = row;
+    }
+}
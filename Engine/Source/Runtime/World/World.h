@@ -0,0 +1,199 @@
+﻿#pragma once
+#include "Runtime/World/Archetype.h"
+#include "Runtime/World/ComponentType.h"
+#include "Runtime/World/Entity.h"
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ace {
+    // Archetype ECS. Entities with the same component set share an Archetype and
+    // are stored densely in its chunks, so a query walks contiguous columns.
+    //
+    // Structural changes (Create/Destroy/Add/Remove) invalidate component
+    // references and must not happen inside Each/EachChunk.
+    class World {
+    public:
+        World();
+        ~World();
+        World(World&&) noexcept;
+        World& operator=(World&&) noexcept;
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        Entity Create();
+        template<class... C> Entity Create(C&&... components);
+        // Allocates an entity in the C... archetype without constructing its
+        // components. Each one must be placement-constructed into TryGet<T>()
+        // before the world is used again; distinct entities may be filled
+        // from different threads (bulk loaders).
+        template<class... C> Entity CreateUninitialized();
+        void   Destroy(Entity e);
+        bool   IsAlive(Entity e) const;
+        void   Clear();
+        void   Reserve(size_t entities);
+
+        size_t Count() const { return AliveCount; }
+
+        // Adds (or replaces) a component. O(1) amortized: the archetype
+        // transition is cached on the source archetype after the first use.
+        // 'e' must be alive: there is nothing to return a reference into.
+        template<class T, class... Args> T& Add(Entity e, Args&&... args);
+        template<class T> void Remove(Entity e);
+        template<class T> bool Has(Entity e) const;
+        template<class T> T*   TryGet(Entity e);
+        template<class T> const T* TryGet(Entity e) const;
+        template<class T> T&   Get(Entity e) { return *TryGet<T>(e); }
+        template<class T> const T& Get(Entity e) const { return *TryGet<T>(e); }
+
+        // fn(Entity, C&...) for every entity that has all of C...
+        template<class... C, class F> void Each(F&& fn);
+        // fn(uint32_t count, const Entity*, C*...) once per matching chunk; the
+        // fastest way to stream a column.
+        template<class... C, class F> void EachChunk(F&& fn);
+
+        // fn(Entity) for every live entity in slot order (stable across
+        // archetype moves; used for outliners and serialization).
+        template<class F> void ForEachEntity(F&& fn) const;
+
+        // Type-erased access for serializers and tools
+        bool  HasComponent(Entity e, ComponentTypeId t) const;
+        void* GetComponent(Entity e, ComponentTypeId t);
+        ComponentMask GetMask(Entity e) const;
+
+        const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return Archetypes; }
+
+    private:
+        struct Record {
+            Archetype* Arch       = nullptr;
+            uint32_t   Row        = 0;
+            uint32_t   Generation = 1;
+        };
+
+        Archetype* FindOrCreateArchetype(ComponentMask mask);
+        Archetype* TransitionAdd(Archetype* from, ComponentTypeId t);
+        Archetype* TransitionRemove(Archetype* from, ComponentTypeId t);
+        Entity     AllocateEntity();
+        // Reports and aborts on a dead or stale handle
+        void       RequireAlive(Entity e, const char* what) const;
+        // Moves e's row into dst, carrying over shared components. Components in
+        // dst that e did not have are left unconstructed. Returns the new row.
+        uint32_t   MoveEntity(Entity e, Archetype* dst);
+        void       FixupMoved(Entity moved, uint32_t row);
+
+        template<class T> T* Cell(const Record& r) const
+        {
+            return static_cast<T*>(r.Arch->ComponentAt(r.Row, ComponentTypeOf<T>()));
+        }
+
+        std::vector<Record>   Records;
+        std::vector<uint32_t> FreeSlots;
+        size_t                AliveCount = 0;
+
+        std::vector<std::unique_ptr<Archetype>>     Archetypes;
+        std::unordered_map<ComponentMask, Archetype*> ArchetypeByMask;
+        Archetype*                                  EmptyArchetype = nullptr;
+    };
+
+    // ---- template implementation ----
+
+    template<class... C>
+    Entity World::Create(C&&... components)
+    {
+        if constexpr (sizeof...(C) == 0) {
+            return Create();
+        } else {
+            Entity e = CreateUninitialized<std::remove_cvref_t<C>...>();
+            const Record& r = Records[e.Index];
+            (::new (Cell<std::remove_cvref_t<C>>(r)) std::remove_cvref_t<C>(std::forward<C>(components)), ...);
+            return e;
+        }
+    }
+
+    template<class... C>
+    Entity World::CreateUninitialized()
+    {
+        Archetype* arch = FindOrCreateArchetype(ComponentMaskOf<C...>());
+        Entity e = AllocateEntity();
+        Record& r = Records[e.Index];
+        r.Arch = arch;
+        r.Row  = arch->AllocateRow(e);
+        return e;
+    }
+
+    template<class T, class... Args>
+    T& World::Add(Entity e, Args&&... args)
+    {
+        RequireAlive(e, "World::Add");
+        if (T* existing = TryGet<T>(e)) {
+            *existing = T(std::forward<Args>(args)...);
+            return *existing;
+        }
+        Record& r = Records[e.Index];
+        Archetype* dst = TransitionAdd(r.Arch, ComponentTypeOf<T>());
+        MoveEntity(e, dst);
+        return *::new (Cell<T>(Records[e.Index])) T(std::forward<Args>(args)...);
+    }
+
+    template<class T>
+    void World::Remove(Entity e)
+    {
+        if (!Has<T>(e)) return;
+        Record& r = Records[e.Index];
+        MoveEntity(e, TransitionRemove(r.Arch, ComponentTypeOf<T>()));
+    }
+
+    template<class T>
+    bool World::Has(Entity e) const
+    {
+        return HasComponent(e, ComponentTypeOf<T>());
+    }
+
+    template<class T>
+    T* World::TryGet(Entity e)
+    {
+        if (!IsAlive(e)) return nullptr;
+        const Record& r = Records[e.Index];
+        return r.Arch->Has(ComponentTypeOf<T>()) ? Cell<T>(r) : nullptr;
+    }
+
+    template<class T>
+    const T* World::TryGet(Entity e) const
+    {
+        return const_cast<World*>(this)->TryGet<T>(e);
+    }
+
+    template<class... C, class F>
+    void World::EachChunk(F&& fn)
+    {
+        const ComponentMask query = ComponentMaskOf<C...>();
+        const ComponentTypeId ids[] = { ComponentTypeOf<C>()..., 0 };
+        for (auto& a : Archetypes) {
+            if ((a->Mask() & query) != query || a->Count() == 0) continue;
+            int cols[sizeof...(C) + 1] = {};
+            for (size_t i = 0; i < sizeof...(C); ++i) cols[i] = a->ColumnIndex(ids[i]);
+            for (const auto& chunk : a->Chunks()) {
+                size_t i = 0;
+                std::tuple<C*...> ptrs{ static_cast<C*>(a->Column(chunk, cols[i++]))... };
+                std::apply([&](C*... p) { fn(chunk.Count, (const Entity*)a->Entities(chunk), p...); }, ptrs);
+            }
+        }
+    }
+
+    template<class... C, class F>
+    void World::Each(F&& fn)
+    {
+        EachChunk<C...>([&](uint32_t n, const Entity* ents, C*... cols) {
+            for (uint32_t i = 0; i < n; ++i) fn(ents[i], cols[i]...);
+        });
+    }
+
+    template<class F>
+    void World::ForEachEntity(F&& fn) const
+    {
+        for (uint32_t i = 0; i < (uint32_t)Records.size(); ++i)
+            if (Records[i].Arch) fn(Entity{i, Records[i].Generation});
+    }
+}
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// Helpers shared by the ACEBench* programs
+namespace ace::bench {
+    using Clock = std::chrono::steady_clock;
+
+    inline double SecondsSince(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    // Fastest of 'runs' calls to fn(), in seconds: the least disturbed run
+    template<class F>
+    double BestOf(int runs, F&& fn)
+    {
+        double best = 1e30;
+        for (int i = 0; i < runs; ++i) {
+            const auto t0 = Clock::now();
+            fn();
+            best = std::min(best, SecondsSince(t0));
+        }
+        return best;
+    }
+
+    // "--name <value>" from the command line, or 'fallback'
+    inline long long ArgInt(int argc, char** argv, const char* name, long long fallback)
+    {
+        for (int i = 1; i + 1 < argc; ++i)
+            if (!std::strcmp(argv[i], name)) return std::atoll(argv[i + 1]);
+        return fallback;
+    }
+
+    inline volatile double gSink = 0;
+
+    // Keeps the optimizer from dropping a computed (arithmetic) result
+    template<class T>
+    inline void KeepAlive(T value)
+    {
+        gSink = (double)value;
+    }
+}
@@ -0,0 +1,164 @@
+﻿#include "Bench.h"
+#include "Runtime/Blueprint/BlueprintCompiler.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ACEBenchBlueprint [--nodes <n>] [--iterations <n>] [--runs <n>]
+//
+// One random graph of --nodes nodes (a tenth "Const" nodes, the rest ops
+// drawn from ACE_BLUEPRINT_OPS), evaluated --iterations times:
+//   compile    CompileBlueprint() + BlueprintVM::Load()
+//   vm         BlueprintVM::Run()
+//   tree-walk  recursive evaluation from each result pin, following links,
+//              no caching: what an interpreter over the editor graph does
+// Every output feeds at most one input (some inputs are left unlinked and
+// read 0), so the tree-walk visits each node once per evaluation; with
+// shared outputs it would evaluate them once per reader. The ~32 results of
+// both are checked to agree.
+
+namespace {
+    using namespace ace;
+
+    constexpr int kOutputPin = 100000;
+    constexpr int kInputPin  = 200000;
+    constexpr size_t kMinOpen = 32;                         // outputs left unread: the results
+
+    BlueprintGraph MakeGraph(size_t count)
+    {
+        std::mt19937 rng(25);
+        BlueprintGraph g;
+        std::vector<size_t> open;                           // nodes whose output nothing reads yet
+        for (size_t i = 0; i < count; ++i) {
+            BlueprintGraph::Node& n = g.Nodes.emplace_back();
+            n.Id = (int)i + 1;
+            n.Outputs.push_back(kOutputPin + (int)i);
+            if (i < count / 10) {
+                n.Title = "Const " + std::to_string((int)(rng() % 401) - 200) + "." + std::to_string(rng() % 100);
+            } else {
+                const auto op = (BlueprintOp)(1 + rng() % ((uint32_t)BlueprintOp::Count - 1));
+                n.Title = std::string(BlueprintOpName(op)) + " (Float)";
+                for (uint32_t k = 0; k < BlueprintOperandCount(op); ++k) {
+                    n.Inputs.push_back(kInputPin + (int)i * 4 + (int)k);
+                    if (open.size() <= kMinOpen || rng() % 4 == 0) continue;
+                    const size_t pick = rng() % open.size();
+                    const size_t from = open[pick];
+                    open[pick] = open.back();
+                    open.pop_back();
+                    g.Links.push_back({g.Nodes[from].Id, g.Nodes[from].Outputs[0], n.Id, n.Inputs.back()});
+                }
+            }
+            open.push_back(i);
+        }
+        return g;
+    }
+
+    // The editor graph as a tree interpreter sees it
+    struct WalkNode {
+        bool        Constant = false;
+        float       Value = 0.0f;
+        BlueprintOp Op = BlueprintOp::Return;
+        int         In[3] = {-1, -1, -1};                   // feeding node, or -1 for 0
+    };
+
+    float Eval(const std::vector<WalkNode>& nodes, int i)
+    {
+        if (i < 0) return 0.0f;
+        const WalkNode& n = nodes[(size_t)i];
+        if (n.Constant) return n.Value;
+        const uint32_t operands = BlueprintOperandCount(n.Op);
+        const float a = Eval(nodes, n.In[0]);
+        const float b = operands > 1 ? Eval(nodes, n.In[1]) : 0.0f;
+        const float c = operands > 2 ? Eval(nodes, n.In[2]) : 0.0f;
+        switch (n.Op) {
+            case BlueprintOp::Add:      return a + b;
+            case BlueprintOp::Subtract: return a - b;
+            case BlueprintOp::Multiply: return a * b;
+            case BlueprintOp::Divide:   return a / b;
+            case BlueprintOp::Min:      return b < a ? b : a;
+            case BlueprintOp::Max:      return a < b ? b : a;
+            case BlueprintOp::Negate:   return -a;
+            case BlueprintOp::Abs:      return std::fabs(a);
+            case BlueprintOp::Sqrt:     return std::sqrt(a);
+            case BlueprintOp::Sin:      return std::sin(a);
+            case BlueprintOp::Cos:      return std::cos(a);
+            case BlueprintOp::Lerp:     return a + (b - a) * c;
+            case BlueprintOp::Clamp:    return a < b ? b : (c < a ? c : a);
+            default:                    return 0.0f;
+        }
+    }
+
+    std::vector<WalkNode> WalkNodes(const BlueprintGraph& g, std::vector<int>& roots)
+    {
+        std::vector<WalkNode> nodes(g.Nodes.size());
+        std::vector<bool> read(g.Nodes.size());
+        for (size_t i = 0; i < g.Nodes.size(); ++i) {
+            const std::string& title = g.Nodes[i].Title;
+            WalkNode& w = nodes[i];
+            w.Constant = title.rfind("Const ", 0) == 0;
+            if (w.Constant) { w.Value = std::strtof(title.c_str() + 6, nullptr); continue; }
+            for (uint16_t op = 1; op < (uint16_t)BlueprintOp::Count; ++op)
+                if (title.rfind(BlueprintOpName((BlueprintOp)op), 0) == 0 && title[std::strlen(BlueprintOpName((BlueprintOp)op))] == ' ')
+                    w.Op = (BlueprintOp)op;
+        }
+        // Node ids are index + 1; input pins encode the node and slot
+        for (const auto& l : g.Links) {
+            const int slot = (l.ToPin - kInputPin) % 4;
+            nodes[(size_t)l.ToNode - 1].In[slot] = l.FromNode - 1;
+            read[(size_t)l.FromNode - 1] = true;
+        }
+        for (size_t i = 0; i < nodes.size(); ++i)
+            if (!read[i]) roots.push_back((int)i);
+        return nodes;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count      = (size_t)bench::ArgInt(argc, argv, "--nodes", 1000);
+    const size_t iterations = (size_t)bench::ArgInt(argc, argv, "--iterations", 1'000'000);
+    const int    runs       = (int)bench::ArgInt(argc, argv, "--runs", 3);
+
+    const BlueprintGraph graph = MakeGraph(count);
+    std::printf("ACEBenchBlueprint: %zu nodes, %zu links, %zu iterations, best of %d\n\n",
+                graph.Nodes.size(), graph.Links.size(), iterations, runs);
+
+    BlueprintProgram program;
+    BlueprintVM vm;
+    std::string error;
+    bool ok = true;
+    const double compile = bench::BestOf(runs, [&] { ok = CompileBlueprint(graph, program, error) && vm.Load(program); });
+    if (!ok) {
+        std::fprintf(stderr, "ACEBenchBlueprint: compile failed: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<int> roots;
+    const std::vector<WalkNode> nodes = WalkNodes(graph, roots);
+    std::vector<float> walked(roots.size());
+
+    const double run = bench::BestOf(runs, [&] { for (size_t i = 0; i < iterations; ++i) vm.Run(); });
+    const double walk = bench::BestOf(runs, [&] {
+        for (size_t i = 0; i < iterations; ++i)
+            for (size_t r = 0; r < roots.size(); ++r) walked[r] = Eval(nodes, roots[r]);
+    });
+
+    size_t agree = 0, finite = 0;
+    for (size_t r = 0; r < roots.size(); ++r) {
+        const float v = vm.Result(graph.Nodes[(size_t)roots[r]].Outputs[0]);
+        agree += v == walked[r] || (std::isnan(v) && std::isnan(walked[r]));
+        finite += std::isfinite(v);
+    }
+
+    const double evals = (double)iterations * (double)graph.Nodes.size();
+    std::printf("%-10s %8.3f ms   %zu instructions, %u registers\n", "compile", compile * 1e3,
+                program.Instructions() - 1, program.NumRegisters);
+    std::printf("%-10s %8.2f ns/node  %6.1fx\n", "vm", run / evals * 1e9, walk / run);
+    std::printf("%-10s %8.2f ns/node  %6.1fx\n", "tree-walk", walk / evals * 1e9, 1.0);
+    std::printf("%-10s %5zu/%zu results agree (%zu finite)\n", "check", agree, roots.size(), finite);
+    return agree == roots.size() ? 0 : 1;
+}
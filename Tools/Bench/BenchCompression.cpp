@@ -0,0 +1,142 @@
+﻿#include "Bench.h"
+#include "Runtime/Core/Compression.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/MapJson.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ACEBenchCompression [--entities <n>] [--runs <n>]
+//
+// LzCompress / LzDecompress over 64 KiB blocks (the .acepak block size):
+//   map json   a MapToJson() dump, the typical loose content
+//   floats     vertex-like float data: structured but noisy
+//   random     incompressible bytes (LzCompress must give up cheaply)
+// Also checks that compression is deterministic: a block compresses to the
+// same bytes after other input has gone through the thread's hash table,
+// and on a different thread.
+
+namespace {
+    using namespace ace;
+
+    constexpr size_t kBlock = 64 * 1024;
+
+    struct Corpus {
+        const char*          Name;
+        std::vector<uint8_t> Data;
+    };
+
+    std::vector<uint8_t> MapText(size_t entities)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        World world;
+        for (size_t i = 0; i < entities; ++i) {
+            TransformComponent t;
+            t.Position = Vec3(pos(rng), pos(rng), pos(rng));
+            const std::string mesh = "/Game/Meshes/Prop_" + std::to_string(rng() % 40) + ".acemesh";
+            world.Create(IdComponent{(int)i + 1}, NameComponent{"Entity_" + std::to_string(i)}, std::move(t),
+                         StaticMeshComponent{mesh, "/Game/Materials/M_Default.acemat"});
+        }
+        const std::string text = MapToJson(world).dump(2);
+        return {text.begin(), text.end()};
+    }
+
+    std::vector<uint8_t> Floats(size_t bytes)
+    {
+        std::mt19937 rng(11);
+        std::normal_distribution<float> n(0.0f, 1.0f);
+        std::vector<float> v(bytes / sizeof(float));
+        for (size_t i = 0; i < v.size(); i += 8) {
+            // position, normal, uv
+            for (size_t k = 0; k < 8 && i + k < v.size(); ++k) v[i + k] = k < 3 ? n(rng) * 100.0f : k < 6 ? n(rng) : (float)(rng() % 1024) / 1024.0f;
+        }
+        std::vector<uint8_t> out(v.size() * sizeof(float));
+        std::memcpy(out.data(), v.data(), out.size());
+        return out;
+    }
+
+    std::vector<uint8_t> Random(size_t bytes)
+    {
+        std::mt19937 rng(13);
+        std::vector<uint8_t> out(bytes);
+        for (auto& b : out) b = (uint8_t)rng();
+        return out;
+    }
+
+    // Compresses every block; raw-stored blocks get size 0 like the pak writer
+    size_t CompressAll(const std::vector<uint8_t>& in, std::vector<uint8_t>& out, std::vector<size_t>& sizes)
+    {
+        const size_t blocks = (in.size() + kBlock - 1) / kBlock;
+        out.resize(blocks * LzCompressBound(kBlock));
+        sizes.resize(blocks);
+        size_t total = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t raw = std::min(kBlock, in.size() - b * kBlock);
+            uint8_t* slot = out.data() + b * LzCompressBound(kBlock);
+            sizes[b] = LzCompress(in.data() + b * kBlock, raw, slot, raw - 1);
+            if (!sizes[b]) std::memcpy(slot, in.data() + b * kBlock, raw);
+            total += sizes[b] ? sizes[b] : raw;
+        }
+        return total;
+    }
+
+    bool DecompressAll(const std::vector<uint8_t>& packed, const std::vector<size_t>& sizes, std::vector<uint8_t>& out)
+    {
+        for (size_t b = 0; b < sizes.size(); ++b) {
+            const size_t raw = std::min(kBlock, out.size() - b * kBlock);
+            const uint8_t* src = packed.data() + b * LzCompressBound(kBlock);
+            if (!sizes[b]) std::memcpy(out.data() + b * kBlock, src, raw);   // stored raw
+            else if (!LzDecompress(src, sizes[b], out.data() + b * kBlock, raw)) return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t entities = (size_t)bench::ArgInt(argc, argv, "--entities", 100'000);
+    const int    runs     = (int)bench::ArgInt(argc, argv, "--runs", 5);
+
+    std::vector<Corpus> corpora;
+    corpora.push_back({"map json", MapText(entities)});
+    const size_t bytes = corpora[0].Data.size();
+    corpora.push_back({"floats", Floats(bytes)});
+    corpora.push_back({"random", Random(bytes)});
+
+    std::printf("ACEBenchCompression: %.1f MiB per corpus, %zu KiB blocks, best of %d\n\n",
+                bytes / 1048576.0, kBlock / 1024, runs);
+    std::printf("%-10s %8s %14s %14s %10s\n", "corpus", "ratio", "compress", "decompress", "roundtrip");
+
+    for (const Corpus& c : corpora) {
+        std::vector<uint8_t> packed, back(c.Data.size());
+        std::vector<size_t> sizes;
+        size_t total = 0;
+        const double comp = bench::BestOf(runs, [&] { total = CompressAll(c.Data, packed, sizes); });
+        bool ok = true;
+        const double dec = bench::BestOf(runs, [&] { ok = DecompressAll(packed, sizes, back) && ok; });
+        ok = ok && back == c.Data;
+        const double mb = c.Data.size() / 1e6;
+        std::printf("%-10s %8.3f %9.0f MB/s %9.0f MB/s %10s\n", c.Name, (double)total / c.Data.size(),
+                    mb / comp, mb / dec, ok ? "ok" : "FAILED");
+    }
+
+    // Determinism: the same block, before and after other input, and on a new thread
+    const std::vector<uint8_t>& text = corpora[0].Data;
+    const size_t n = std::min(kBlock, text.size());
+    std::vector<uint8_t> first(LzCompressBound(kBlock)), again(first.size()), other(first.size()), fresh(first.size());
+    const size_t a = LzCompress(text.data(), n, first.data(), first.size());
+    for (const Corpus& c : corpora)
+        for (size_t off = 0; off + kBlock <= c.Data.size(); off += 7 * kBlock)
+            LzCompress(c.Data.data() + off, kBlock, other.data(), other.size());
+    const size_t b = LzCompress(text.data(), n, again.data(), again.size());
+    size_t f = 0;
+    std::thread([&] { f = LzCompress(text.data(), n, fresh.data(), fresh.size()); }).join();
+    const bool same = a == b && a == f && std::memcmp(first.data(), again.data(), a) == 0 &&
+                      std::memcmp(first.data(), fresh.data(), a) == 0;
+    std::printf("\ndeterministic: %s (%zu, %zu, %zu bytes)\n", same ? "yes" : "NO", a, b, f);
+    return same ? 0 : 1;
+}
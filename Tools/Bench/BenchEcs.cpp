@@ -0,0 +1,143 @@
+﻿#include "Bench.h"
+#include "Runtime/World/Components.h"
+#include "Runtime/World/World.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ACEBenchEcs [--entities <n>] [--runs <n>]
+//
+// Transform iteration and structural changes on --entities map-like
+// entities (Id, Name, Transform; every other one also a StaticMesh):
+//   vector     a bare std::vector<TransformComponent>: the bandwidth ceiling
+//   ecs each   World::Each<TransformComponent>
+//   ecs chunk  World::EachChunk<TransformComponent>, one column at a time
+//   eworld     the editor's old std::vector<EEntity> layout (heap name,
+//              transform, vector of components holding filesystem::paths),
+//              kept here only as the baseline
+// Each pass reads and writes every transform (Position += Scale); GB/s
+// counts those bytes both ways. The position sums of all layouts are
+// checked to agree.
+//   create     World::Create of the full entity set
+//   add        Add<StaticMeshComponent> on the entities without one
+//   remove     Remove<StaticMeshComponent> on the same entities
+
+namespace {
+    using namespace ace;
+
+    // The pre-ECS editor world, as it was
+    struct EComponent {
+        int Type = 0;
+        std::filesystem::path Mesh;
+        std::filesystem::path Material;
+    };
+
+    struct EEntity {
+        int                     Id = 0;
+        std::string             Name = "Entity";
+        TransformComponent      Xf;
+        std::vector<EComponent> Components;
+    };
+
+    // Long enough to leave the small-string buffer, as real names do
+    std::string NameOf(size_t i) { return "StaticMeshActor_" + std::to_string(i); }
+
+    TransformComponent TransformOf(size_t i)
+    {
+        TransformComponent t;
+        t.Position = {(float)(i % 1000), (float)(i / 1000 % 1000), 0.0f};
+        t.Scale = {0.5f, 0.25f, 1.0f};
+        return t;
+    }
+
+    void Step(TransformComponent& t)
+    {
+        t.Position.X += t.Scale.X;
+        t.Position.Y += t.Scale.Y;
+        t.Position.Z += t.Scale.Z;
+    }
+
+    template<class F>
+    double Sum(F&& each)
+    {
+        double s = 0;
+        each([&](const TransformComponent& t) { s += t.Position.X + t.Position.Y + t.Position.Z; });
+        return s;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = (size_t)bench::ArgInt(argc, argv, "--entities", 1'000'000);
+    const int    runs  = (int)bench::ArgInt(argc, argv, "--runs", 5);
+
+    std::printf("ACEBenchEcs: %zu entities, best of %d\n\n", count, runs);
+
+    std::vector<TransformComponent> flat(count);
+    std::vector<EEntity> old(count);
+    for (size_t i = 0; i < count; ++i) {
+        flat[i] = TransformOf(i);
+        old[i].Id = (int)i + 1;
+        old[i].Name = NameOf(i);
+        old[i].Xf = TransformOf(i);
+        if (i % 2 == 0) old[i].Components.push_back({0, "/Game/Props/SM_Crate.aceasset", "/Game/Materials/M_Wood.aceasset"});
+    }
+
+    World world;
+    std::vector<Entity> entities(count);
+    const double create = bench::BestOf(runs, [&] {
+        world.Clear();
+        world.Reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0)
+                entities[i] = world.Create(IdComponent{(int)i + 1}, NameComponent{NameOf(i)}, TransformOf(i),
+                                           StaticMeshComponent{"/Game/Props/SM_Crate.aceasset", "/Game/Materials/M_Wood.aceasset"});
+            else
+                entities[i] = world.Create(IdComponent{(int)i + 1}, NameComponent{NameOf(i)}, TransformOf(i));
+        }
+    });
+
+    // Every layout takes 2 * runs steps in all, so the sums below agree
+    const double vec = bench::BestOf(runs * 2, [&] { for (TransformComponent& t : flat) Step(t); });
+    const double each = bench::BestOf(runs, [&] { world.Each<TransformComponent>([](Entity, TransformComponent& t) { Step(t); }); });
+    const double chunk = bench::BestOf(runs, [&] {
+        world.EachChunk<TransformComponent>([](uint32_t n, const Entity*, TransformComponent* t) {
+            for (uint32_t i = 0; i < n; ++i) Step(t[i]);
+        });
+    });
+    const double eworld = bench::BestOf(runs * 2, [&] { for (EEntity& e : old) Step(e.Xf); });
+
+    const double sVec = Sum([&](auto&& fn) { for (const TransformComponent& t : flat) fn(t); });
+    const double sEcs = Sum([&](auto&& fn) { world.Each<TransformComponent>([&](Entity, TransformComponent& t) { fn(t); }); });
+    const double sOld = Sum([&](auto&& fn) { for (const EEntity& e : old) fn(e.Xf); });
+    const bool agree = sVec == sEcs && sVec == sOld;
+
+    // Structural changes on the entities that have no mesh yet
+    double add = 1e30, remove = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        const auto t0 = bench::Clock::now();
+        for (size_t i = 1; i < count; i += 2) world.Add<StaticMeshComponent>(entities[i]);
+        add = std::min(add, bench::SecondsSince(t0));
+        const auto t1 = bench::Clock::now();
+        for (size_t i = 1; i < count; i += 2) world.Remove<StaticMeshComponent>(entities[i]);
+        remove = std::min(remove, bench::SecondsSince(t1));
+    }
+    bench::KeepAlive(world.Count());
+
+    const double bytes = (double)count * sizeof(TransformComponent) * 2;
+    auto row = [&](const char* name, double s) {
+        std::printf("%-10s %8.2f ms  %6.2f ns/entity  %6.2f GB/s  %6.1fx\n", name, s * 1e3, s / count * 1e9,
+                    bytes / s / 1e9, eworld / s);
+    };
+    row("vector", vec);
+    row("ecs each", each);
+    row("ecs chunk", chunk);
+    row("eworld", eworld);
+    std::printf("%-10s %s\n\n", "check", agree ? "sums agree" : "SUMS DIFFER");
+    const double half = (double)(count / 2);
+    std::printf("%-10s %8.2f ms  %6.2f ns/entity\n", "create", create * 1e3, create / count * 1e9);
+    std::printf("%-10s %8.2f ms  %6.2f ns/op\n", "add", add * 1e3, add / half * 1e9);
+    std::printf("%-10s %8.2f ms  %6.2f ns/op\n", "remove", remove * 1e3, remove / half * 1e9);
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+﻿#include "Bench.h"
+#include "Runtime/Core/Image.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// ACEBenchImage [--size <pixels>] [--runs <n>]
+//
+// Thumbnail path of the content browser: DecodeImage() then ResizeImage()
+// to 128x128, on a generated RGBA PNG (Sub-filtered gradient, fixed-Huffman
+// DEFLATE with run matches, so it compresses like a real texture would).
+// Also times the rejection of a tiny PNG whose header declares a
+// 16384x16384 16-bit RGBA image (2 GiB of scanlines): it must fail fast
+// without allocating for the declared size.
+
+namespace {
+    using namespace ace;
+
+    uint32_t Crc32(const uint8_t* p, size_t n)
+    {
+        uint32_t c = 0xFFFFFFFFu;
+        for (size_t i = 0; i < n; ++i) {
+            c ^= p[i];
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+        }
+        return ~c;
+    }
+
+    // LSB-first DEFLATE bit writer; Huffman codes go in MSB-first
+    struct BitWriter {
+        std::vector<uint8_t> Out;
+        uint32_t Acc = 0;
+        int      Count = 0;
+
+        void Bits(uint32_t v, int n)
+        {
+            Acc |= v << Count;
+            Count += n;
+            while (Count >= 8) { Out.push_back((uint8_t)Acc); Acc >>= 8; Count -= 8; }
+        }
+        void Code(uint32_t code, int n)
+        {
+            uint32_t r = 0;
+            for (int i = 0; i < n; ++i) r |= ((code >> i) & 1) << (n - 1 - i);
+            Bits(r, n);
+        }
+        void Finish() { if (Count) Out.push_back((uint8_t)Acc); Acc = 0; Count = 0; }
+    };
+
+    // Fixed-Huffman literal/length symbol
+    void Symbol(BitWriter& bw, uint32_t sym)
+    {
+        if (sym < 144)      bw.Code(0x30 + sym, 8);
+        else if (sym < 256) bw.Code(0x190 + sym - 144, 9);
+        else if (sym < 280) bw.Code(sym - 256, 7);
+        else                bw.Code(0xC0 + sym - 280, 8);
+    }
+
+    // Match of 'len' (3..258) at distance 1
+    void Match(BitWriter& bw, size_t len)
+    {
+        static constexpr uint16_t kBase[29]  = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+        static constexpr uint8_t  kExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+        int s = 28;
+        while (kBase[s] > len) --s;
+        Symbol(bw, 257 + (uint32_t)s);
+        bw.Bits((uint32_t)(len - kBase[s]), kExtra[s]);
+        bw.Code(0, 5);                                  // distance code 0 = 1
+    }
+
+    std::vector<uint8_t> Zlib(const std::vector<uint8_t>& raw)
+    {
+        BitWriter bw;
+        bw.Out = {0x78, 0x01};
+        bw.Bits(1, 1);                                  // final block
+        bw.Bits(1, 2);                                  // fixed Huffman
+        for (size_t i = 0; i < raw.size();) {
+            size_t run = 0;
+            while (i > 0 && i + run < raw.size() && raw[i + run] == raw[i - 1] && run < 258) ++run;
+            if (run >= 3) { Match(bw, run); i += run; continue; }
+            Symbol(bw, raw[i++]);
+        }
+        Symbol(bw, 256);
+        bw.Finish();
+        uint32_t a = 1, b = 0;
+        for (uint8_t v : raw) { a = (a + v) % 65521; b = (b + a) % 65521; }
+        const uint32_t adler = b << 16 | a;
+        for (int k = 3; k >= 0; --k) bw.Out.push_back((uint8_t)(adler >> (8 * k)));
+        return bw.Out;
+    }
+
+    void Chunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& body)
+    {
+        const uint32_t len = (uint32_t)body.size();
+        for (int k = 3; k >= 0; --k) png.push_back((uint8_t)(len >> (8 * k)));
+        const size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), body.begin(), body.end());
+        const uint32_t crc = Crc32(png.data() + start, png.size() - start);
+        for (int k = 3; k >= 0; --k) png.push_back((uint8_t)(crc >> (8 * k)));
+    }
+
+    std::vector<uint8_t> Png(uint32_t w, uint32_t h, uint8_t depth, const std::vector<uint8_t>& idat)
+    {
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        std::vector<uint8_t> ihdr(13, 0);
+        for (int k = 0; k < 4; ++k) { ihdr[k] = (uint8_t)(w >> (24 - 8 * k)); ihdr[4 + k] = (uint8_t)(h >> (24 - 8 * k)); }
+        ihdr[8] = depth;
+        ihdr[9] = 6;                                    // RGBA
+        Chunk(png, "IHDR", ihdr);
+        Chunk(png, "IDAT", idat);
+        Chunk(png, "IEND", {});
+        return png;
+    }
+
+    // Gradient with a little texture; rows use the Sub filter
+    std::vector<uint8_t> GradientPng(uint32_t size)
+    {
+        std::vector<uint8_t> raw;
+        raw.reserve((size_t)size * (1 + size * 4));
+        for (uint32_t y = 0; y < size; ++y) {
+            raw.push_back(1);
+            uint8_t prev[4] = {};
+            for (uint32_t x = 0; x < size; ++x) {
+                const uint8_t px[4] = { (uint8_t)(x * 255 / size), (uint8_t)(y * 255 / size),
+                                        (uint8_t)(((x / 16) ^ (y / 16)) & 1 ? 200 : 60), 255 };
+                for (int c = 0; c < 4; ++c) { raw.push_back((uint8_t)(px[c] - prev[c])); prev[c] = px[c]; }
+            }
+        }
+        return Png(size, size, 8, Zlib(raw));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t size = (uint32_t)bench::ArgInt(argc, argv, "--size", 1024);
+    const int      runs = (int)bench::ArgInt(argc, argv, "--runs", 10);
+
+    const std::vector<uint8_t> png = GradientPng(size);
+    std::printf("ACEBenchImage: %ux%u RGBA PNG, %.1f KiB, best of %d\n\n", size, size, png.size() / 1024.0, runs);
+
+    Image img, thumb;
+    bool ok = true;
+    const double decode = bench::BestOf(runs, [&] { ok = DecodeImage(png.data(), png.size(), img) && ok; });
+    const double resize = bench::BestOf(runs, [&] { ResizeImage(img, 128, 128, thumb); });
+    const double mp = (double)size * size / 1e6;
+    std::printf("%-10s %8.2f ms  %7.1f Mpixel/s  %s\n", "decode", decode * 1e3, mp / decode, ok && img.IsValid() ? "ok" : "FAILED");
+    std::printf("%-10s %8.2f ms  (to 128x128)\n", "resize", resize * 1e3);
+    std::printf("%-10s %8.2f ms\n", "thumbnail", (decode + resize) * 1e3);
+
+    // Declares 16384x16384x8 bytes of scanlines; the IDAT is a few bytes of zeros
+    const std::vector<uint8_t> bomb = Png(kMaxImageSide, kMaxImageSide, 16, Zlib(std::vector<uint8_t>(64, 0)));
+    bool rejected = true;
+    const double reject = bench::BestOf(runs, [&] { Image tmp; rejected = !DecodeImage(bomb.data(), bomb.size(), tmp) && rejected; });
+    std::printf("%-10s %8.3f ms  (%zu-byte PNG declaring %ux%u 16-bit RGBA) %s\n", "bomb", reject * 1e3, bomb.size(),
+                kMaxImageSide, kMaxImageSide, rejected ? "rejected" : "ACCEPTED");
+    return ok && rejected ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+﻿#include "Bench.h"
+#include "Runtime/Core/JobSystem.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// ACEBenchJobs [--threads <max>] [--items <n>] [--jobs <n>] [--runs <n>]
+//
+// JobSystem scaling from 1 to N threads (workers + the waiting caller):
+//   parallel-for   ParallelFor over a compute-bound loop, default grain
+//   fan-out        many small Run() jobs on one counter (scheduling cost)
+//   nested         ParallelFor whose bodies run ParallelFor (stealing)
+// The 1-thread column is the plain loop, without a JobSystem.
+
+namespace {
+    using namespace ace;
+
+    // ~100 ns of dependent floating-point work per item
+    double Work(size_t i)
+    {
+        double x = (double)(i & 1023) + 1.0;
+        for (int k = 0; k < 24; ++k) x = std::sqrt(x * 1.0001 + 3.0);
+        return x;
+    }
+
+    double SumRange(size_t b, size_t e)
+    {
+        double s = 0;
+        for (size_t i = b; i < e; ++i) s += Work(i);
+        return s;
+    }
+
+    struct Row {
+        const char* Name;
+        double      Serial = 0;
+        std::vector<double> Seconds;   // per thread count
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t hw      = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t threads = (uint32_t)bench::ArgInt(argc, argv, "--threads", hw);
+    const size_t   items   = (size_t)bench::ArgInt(argc, argv, "--items", 4'000'000);
+    const size_t   jobs    = (size_t)bench::ArgInt(argc, argv, "--jobs", 200'000);
+    const int      runs    = (int)bench::ArgInt(argc, argv, "--runs", 5);
+
+    std::printf("ACEBenchJobs: %u hardware threads, %zu items, %zu jobs, best of %d\n", hw, items, jobs, runs);
+
+    Row rows[] = { {"parallel-for", 0, {}}, {"fan-out", 0, {}}, {"nested", 0, {}} };
+    const size_t outer = 64;
+
+    // Serial baselines
+    rows[0].Serial = bench::BestOf(runs, [&] { bench::KeepAlive(SumRange(0, items)); });
+    rows[1].Serial = bench::BestOf(runs, [&] {
+        double s = 0;
+        for (size_t j = 0; j < jobs; ++j) s += Work(j);
+        bench::KeepAlive(s);
+    });
+    rows[2].Serial = bench::BestOf(runs, [&] {
+        double s = 0;
+        for (size_t o = 0; o < outer; ++o) s += SumRange(0, items / outer);
+        bench::KeepAlive(s);
+    });
+
+    for (uint32_t t = 2; t <= threads; ++t) {
+        JobSystem pool(t - 1);
+
+        rows[0].Seconds.push_back(bench::BestOf(runs, [&] {
+            std::atomic<double> total{0};
+            pool.ParallelFor(items, [&](size_t b, size_t e) { total += SumRange(b, e); });
+            bench::KeepAlive(total.load());
+        }));
+
+        rows[1].Seconds.push_back(bench::BestOf(runs, [&] {
+            JobCounter done;
+            std::atomic<double> total{0};
+            for (size_t j = 0; j < jobs; ++j)
+                pool.Run([&total, j] { total += Work(j); }, &done);
+            pool.Wait(done);
+            bench::KeepAlive(total.load());
+        }));
+
+        rows[2].Seconds.push_back(bench::BestOf(runs, [&] {
+            std::atomic<double> total{0};
+            pool.ParallelFor(outer, [&](size_t ob, size_t oe) {
+                for (size_t o = ob; o < oe; ++o)
+                    pool.ParallelFor(items / outer, [&](size_t b, size_t e) { total += SumRange(b, e); });
+            }, 1);
+            bench::KeepAlive(total.load());
+        }));
+    }
+
+    std::printf("\n%-14s %9s", "threads", "1");
+    for (uint32_t t = 2; t <= threads; ++t) std::printf(" %9u", t);
+    std::printf("\n");
+    for (const Row& r : rows) {
+        std::printf("%-14s %7.1fms", r.Name, r.Serial * 1e3);
+        for (double s : r.Seconds) std::printf(" %7.1fms", s * 1e3);
+        std::printf("\n%-14s %8.2fx", "  speedup", 1.0);
+        for (double s : r.Seconds) std::printf(" %8.2fx", r.Serial / s);
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+﻿#include "Bench.h"
+#include "Runtime/Core/Profiler.h"
+#include <cstdio>
+
+// ACEBenchProfiler [--scopes <n>] [--frame <n>] [--runs <n>]
+//
+// Cost of one profiler scope on the calling thread, net of the empty loop:
+//   timestamp  Profiler::Now() alone; a scope takes two
+//   disabled   Profiler::SetEnabled(false): the relaxed load only
+//   scope      one ProfileScope per iteration (two timestamps + Record)
+//   nested x4  four nested scopes per iteration, cost per scope
+//   counter    ACE_PROFILE_COUNTER-equivalent Record
+// Buffers are drained with EndFrame() every --frame scopes, outside the
+// timed part. ProfileScope is used directly, so this measures the same code
+// whatever ACE_ENABLE_PROFILER is for this configuration.
+
+namespace {
+    using namespace ace;
+
+    // Runs body(i) 'count' times in frames of 'frame' iterations and returns
+    // the seconds spent in the loops, excluding EndFrame()
+    template<class F>
+    double Timed(size_t count, size_t frame, F&& body)
+    {
+        double seconds = 0;
+        for (size_t done = 0; done < count; done += frame) {
+            const size_t n = std::min(frame, count - done);
+            const auto t0 = bench::Clock::now();
+            for (size_t i = 0; i < n; ++i) body(i);
+            seconds += bench::SecondsSince(t0);
+            Profiler::EndFrame();
+        }
+        return seconds;
+    }
+
+    // Keeps the loops from being folded away
+    volatile size_t gTouch = 0;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t scopes = (size_t)bench::ArgInt(argc, argv, "--scopes", 10'000'000);
+    const size_t frame  = (size_t)bench::ArgInt(argc, argv, "--frame", 4096);
+    const int    runs   = (int)bench::ArgInt(argc, argv, "--runs", 5);
+
+    std::printf("ACEBenchProfiler: %zu scopes, drained every %zu, best of %d (ACE_ENABLE_PROFILER=%d)\n",
+                scopes, frame, runs, ACE_ENABLE_PROFILER);
+    Profiler::SetThreadName("Bench");
+
+    const double empty = bench::BestOf(runs, [&] {
+        Timed(scopes, frame, [](size_t i) { gTouch = i; });
+    });
+    auto perScope = [&](double s, size_t perIter) { return (s - empty) / (double)(scopes * perIter) * 1e9; };
+
+    volatile int64_t ticks = 0;
+    const double now = bench::BestOf(runs, [&] {
+        Timed(scopes, frame, [&](size_t i) { ticks = Profiler::Now(); gTouch = i; });
+    });
+
+    Profiler::SetEnabled(false);
+    const double disabled = bench::BestOf(runs, [&] {
+        Timed(scopes, frame, [](size_t i) { ProfileScope scope("Disabled"); gTouch = i; });
+    });
+    Profiler::SetEnabled(true);
+
+    double scope = 1e30, nested = 1e30, counter = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        scope = std::min(scope, Timed(scopes, frame, [](size_t i) { ProfileScope s("Scope"); gTouch = i; }));
+        nested = std::min(nested, Timed(scopes / 4, frame / 4, [](size_t i) {
+            ProfileScope a("A");
+            ProfileScope b("B");
+            ProfileScope c("C");
+            ProfileScope d("D");
+            gTouch = i;
+        }));
+        counter = std::min(counter, Timed(scopes, frame, [](size_t i) {
+            const int64_t now = Profiler::Now();
+            Profiler::Record([&](ProfileEvent& ev) {
+                ev.Name = "Counter";
+                ev.Start = now;
+                ev.Value = (double)i;
+                ev.Depth = 0;
+                ev.Type = ProfileEvent::Counter;
+            });
+            gTouch = i;
+        }));
+    }
+
+    std::printf("\n%-12s %8.2f ns per iteration\n", "empty loop", empty / (double)scopes * 1e9);
+    std::printf("%-12s %8.2f ns per call\n", "timestamp", perScope(now, 1));
+    std::printf("%-12s %8.2f ns per scope\n", "disabled", perScope(disabled, 1));
+    std::printf("%-12s %8.2f ns per scope\n", "scope", perScope(scope, 1));
+    std::printf("%-12s %8.2f ns per scope\n", "nested x4", (nested - empty / 4) / (double)scopes * 1e9);
+    std::printf("%-12s %8.2f ns per counter\n", "counter", perScope(counter, 1));
+    std::printf("%-12s %8llu\n", "dropped", (unsigned long long)Profiler::DroppedEvents());
+    return 0;
+}
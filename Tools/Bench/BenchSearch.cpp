@@ -0,0 +1,185 @@
+﻿#include "Bench.h"
+#include "Runtime/Asset/SearchIndex.h"
+#include "Runtime/Core/JobSystem.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ACEBenchSearch [--files <n>] [--runs <n>] [--keep 1]
+//
+// SearchIndex over a generated Content tree (asset-style names in ~200-file
+// folders, one file in ten a .json/.aceasset/.blueprint with a little text),
+// written under the temp directory and removed afterwards unless --keep:
+//   build      Build() of the whole tree, content included
+//   substring  3+ character queries, against a case-insensitive scan of
+//              every path (the hit counts are checked to agree; the scan
+//              only counts, the index also scores and returns the best 1000)
+//   short      1-2 character queries (mask filter, no trigrams)
+//   fuzzy      file-name subsequences such as "plctrl"
+//   content    substring queries that also search the files' text
+//   typing     "player" typed a key at a time, each query narrowing the last
+// Each query is timed from scratch: the previous-query cache is reset first.
+
+namespace {
+    using namespace ace;
+    namespace fs = std::filesystem;
+
+    const char* const kWords[] = {
+        "Player", "Enemy", "Controller", "Rock", "Tree", "Wall", "Door", "Light", "Crate", "Barrel",
+        "Spawn", "Point", "Weapon", "Rifle", "Pistol", "Health", "Pickup", "Cliff", "Grass", "Water",
+        "Bridge", "Tower", "Gate", "Fence", "Lamp", "Torch", "Chest", "Key", "Menu", "Button",
+        "Camera", "Trigger", "Volume", "Sky", "Cloud", "Fire", "Smoke", "Spark", "Metal", "Wood",
+    };
+    const char* const kCategories[] = { "Characters", "Environment", "Props", "Materials", "Textures",
+                                        "Blueprints", "Maps", "Audio", "UI", "FX" };
+    const char* const kPrefixes[]   = { "SM_", "T_", "M_", "BP_", "S_", "MI_", "SK_", "FX_" };
+    const char* const kBinary[]     = { ".acemesh", ".acetex", ".acemat", ".acesound" };
+    const char* const kText[]       = { ".json", ".aceasset", ".blueprint" };
+
+    template<class T, size_t N>
+    const char* Pick(const T (&list)[N], std::mt19937& rng) { return list[rng() % N]; }
+
+    // Writes 'files' files; returns every relative path, folders included
+    std::vector<std::string> MakeTree(const fs::path& root, size_t files)
+    {
+        std::mt19937 rng(19);
+        std::vector<std::string> paths;
+        size_t folder = 0;
+        for (size_t done = 0; done < files; ++folder) {
+            const std::string cat = kCategories[folder % std::size(kCategories)];
+            const std::string rel = cat + "/" + Pick(kWords, rng) + Pick(kWords, rng) + "_" + std::to_string(folder);
+            fs::create_directories(root / rel);
+            if (paths.empty() || paths.back() != cat) paths.push_back(cat);
+            paths.push_back(rel);
+            const size_t n = std::min<size_t>(files - done, 100 + rng() % 200);
+            for (size_t i = 0; i < n; ++i, ++done) {
+                const bool text = rng() % 10 == 0;
+                const std::string name = std::string(Pick(kPrefixes, rng)) + Pick(kWords, rng) + Pick(kWords, rng) + "_" +
+                                         std::to_string(i) + (text ? Pick(kText, rng) : Pick(kBinary, rng));
+                paths.push_back(rel + "/" + name);
+                std::ofstream f(root / paths.back(), std::ios::binary);
+                if (!text) { f << "ACE"; continue; }
+                f << "{\n  \"Name\": \"" << name << "\",\n  \"Tags\": [\"" << Pick(kWords, rng) << "\", \""
+                  << Pick(kWords, rng) << "\"],\n  \"Mesh\": \"/Game/Props/SM_" << Pick(kWords, rng) << ".acemesh\",\n"
+                  << "  \"Script\": \"On" << Pick(kWords, rng) << Pick(kWords, rng) << "\"\n}\n";
+            }
+        }
+        // Categories were added once per run of folders; keep each path once
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+        return paths;
+    }
+
+    std::string Lower(std::string s)
+    {
+        for (char& c : s) c = (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+        return s;
+    }
+
+    // The previous-query cache only serves queries extending its needle
+    void ResetLastQuery(const SearchIndex& index)
+    {
+        SearchQuery q;
+        q.Text = "~";
+        q.Folder = "~";
+        std::vector<SearchHit> hits;
+        index.Search(q, hits);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t files = (size_t)bench::ArgInt(argc, argv, "--files", 200'000);
+    const int    runs  = (int)bench::ArgInt(argc, argv, "--runs", 5);
+    const bool   keep  = bench::ArgInt(argc, argv, "--keep", 0) != 0;
+
+    JobSystem::Startup();
+    const fs::path root = fs::temp_directory_path() / "ACEBenchSearch" / "Content";
+    fs::remove_all(root.parent_path());
+    std::printf("ACEBenchSearch: %zu files under %s, best of %d\n", files, root.string().c_str(), runs);
+    const auto gt0 = bench::Clock::now();
+    const std::vector<std::string> paths = MakeTree(root, files);
+    std::printf("generated in %.1f s\n\n", bench::SecondsSince(gt0));
+
+    std::vector<std::string> lower;
+    lower.reserve(paths.size());
+    for (const std::string& p : paths) lower.push_back(Lower(p));
+
+    SearchIndex index;
+    index.Build(root);
+    const SearchIndexStats st = index.GetStats();
+    std::printf("%-10s %10.1f ms   %zu entries, %zu with text, %.1f MiB postings, %.1f MiB paths\n\n", "build",
+                st.BuildSeconds * 1e3, st.Files, st.ContentFiles, st.PostingBytes / 1048576.0, st.PathBytes / 1048576.0);
+
+    struct Case {
+        const char* Kind;
+        const char* Text;
+        bool        Fuzzy;
+        bool        Content;
+    };
+    const Case cases[] = {
+        {"substring", "player", false, false}, {"substring", "SM_Rock", false, false}, {"substring", "barrel_1", false, false},
+        {"substring", "qzx", false, false},    {"short", "p", false, false},           {"short", "sk", false, false},
+        {"fuzzy", "plctrl", true, false},      {"fuzzy", "bpspwn", true, false},       {"content", "onspawn", false, true},
+        {"content", "rifle", false, true},
+    };
+
+    std::printf("%-10s %-10s %10s %9s %10s %8s\n", "kind", "query", "index", "matches", "scan", "agree");
+    bool allAgree = true;
+    for (const Case& c : cases) {
+        SearchQuery q;
+        q.Text = c.Text;
+        q.Fuzzy = c.Fuzzy;
+        q.Content = c.Content;
+        std::vector<SearchHit> hits;
+        size_t total = 0;
+        double best = 1e30;
+        for (int r = 0; r < runs; ++r) {
+            ResetLastQuery(index);
+            hits.clear();
+            const auto t0 = bench::Clock::now();
+            total = index.Search(q, hits);
+            best = std::min(best, bench::SecondsSince(t0));
+        }
+        // Plain substring queries can be checked against a scan of the paths
+        if (c.Fuzzy || c.Content) {
+            std::printf("%-10s %-10s %8.2f ms %9zu %10s %8s\n", c.Kind, c.Text, best * 1e3, total, "-", "-");
+            continue;
+        }
+        const std::string needle = Lower(c.Text);
+        size_t expect = 0;
+        const double scan = bench::BestOf(runs, [&] {
+            expect = 0;
+            for (const std::string& p : lower) expect += p.find(needle) != std::string::npos;
+        });
+        allAgree = allAgree && expect == total;
+        std::printf("%-10s %-10s %8.2f ms %9zu %7.2f ms %8s\n", c.Kind, c.Text, best * 1e3, total, scan * 1e3,
+                    expect == total ? "yes" : "NO");
+    }
+
+    // Typing: each keystroke's query starts from the last one's matches
+    const std::string typed = "player";
+    double typing = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        ResetLastQuery(index);
+        std::vector<SearchHit> hits;
+        const auto t0 = bench::Clock::now();
+        for (size_t len = 1; len <= typed.size(); ++len) {
+            SearchQuery q;
+            q.Text = std::string_view(typed).substr(0, len);
+            q.Fuzzy = true;
+            hits.clear();
+            index.Search(q, hits);
+        }
+        typing = std::min(typing, bench::SecondsSince(t0));
+    }
+    std::printf("\n%-10s %8.2f ms per key, fuzzy, \"%s\" typed one key at a time\n", "typing",
+                typing / typed.size() * 1e3, typed.c_str());
+
+    JobSystem::Shutdown();
+    if (!keep) fs::remove_all(root.parent_path());
+    return allAgree ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+﻿#include "Bench.h"
+#include "Runtime/World/SpatialIndex.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+// ACEBenchSpatial [--entities <n>] [--rays <n>] [--brute <n>] [--runs <n>]
+//
+// SpatialIndex over random boxes in a 1 km cube:
+//   build      Build() from scratch
+//   ray pick   closest hit per ray, against a brute-force scan over every
+//              box (fewer rays; the hits are checked to agree)
+//   frustum    a 60 degree view cone from the middle of the scene
+//   nearest    k = 16 nearest entities to random points
+//   update     moves smaller than the margin (no restructuring expected)
+
+namespace {
+    using namespace ace;
+
+    constexpr float kWorld = 1000.0f;
+
+    float Enter(const Ray& ray, const AABB& b, float limit)
+    {
+        float t0 = 0.0f, t1 = limit;
+        const float o[3]  = {ray.Origin.X, ray.Origin.Y, ray.Origin.Z};
+        const float d[3]  = {ray.Dir.X, ray.Dir.Y, ray.Dir.Z};
+        const float lo[3] = {b.Min.X, b.Min.Y, b.Min.Z};
+        const float hi[3] = {b.Max.X, b.Max.Y, b.Max.Z};
+        for (int a = 0; a < 3; ++a) {
+            float ta = (lo[a] - o[a]) / d[a];
+            float tb = (hi[a] - o[a]) / d[a];
+            if (ta > tb) std::swap(ta, tb);
+            t0 = ta > t0 ? ta : t0;
+            t1 = tb < t1 ? tb : t1;
+            if (t0 > t1) return std::numeric_limits<float>::infinity();
+        }
+        return t0;
+    }
+
+    // View cone along +Z from 'eye': four side planes at +-halfAngle, near and far
+    Frustum MakeFrustum(const Vec3& eye, float halfAngle, float nearZ, float farZ)
+    {
+        const float t = std::tan(halfAngle);
+        Frustum f;
+        const Vec3 normals[6] = {{1, 0, t}, {-1, 0, t}, {0, 1, t}, {0, -1, t}, {0, 0, 1}, {0, 0, -1}};
+        for (int i = 0; i < 6; ++i) {
+            f.Planes[i].Normal = normals[i];
+            f.Planes[i].D = -Dot(normals[i], eye);
+        }
+        f.Planes[4].D -= nearZ;
+        f.Planes[5].D += farZ;
+        return f;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = (size_t)bench::ArgInt(argc, argv, "--entities", 1'000'000);
+    const size_t rays  = (size_t)bench::ArgInt(argc, argv, "--rays", 100'000);
+    const size_t brute = (size_t)bench::ArgInt(argc, argv, "--brute", 50);
+    const int    runs  = (int)bench::ArgInt(argc, argv, "--runs", 3);
+
+    std::printf("ACEBenchSpatial: %zu entities, %zu rays (%zu brute force), best of %d\n", count, rays, brute, runs);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(0.0f, kWorld), size(0.5f, 2.0f), dir(-1.0f, 1.0f);
+    std::vector<std::pair<Entity, AABB>> items(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Vec3 c(pos(rng), pos(rng), pos(rng));
+        const float h = 0.5f * size(rng);
+        items[i] = {Entity{(uint32_t)i, 1}, AABB{c - Vec3(h, h, h), c + Vec3(h, h, h)}};
+    }
+    auto randomRay = [&] {
+        Ray r{Vec3(pos(rng), pos(rng), pos(rng)), Vec3(dir(rng), dir(rng), dir(rng))};
+        if (Dot(r.Dir, r.Dir) < 1e-6f) r.Dir = Vec3(0, 0, 1);
+        return r;
+    };
+
+    SpatialIndex index;
+    const double build = bench::BestOf(runs, [&] { index.Build(items); });
+    std::printf("\n%-10s %10.1f ms   height %d\n", "build", build * 1e3, index.Height());
+
+    // Ray picks: average, and the 99th percentile of single queries in the last run
+    std::vector<Ray> rayList(rays);
+    for (Ray& r : rayList) r = randomRay();
+    std::vector<double> each(rays);
+    size_t hits = 0;
+    const double pick = bench::BestOf(runs, [&] {
+        hits = 0;
+        for (size_t i = 0; i < rays; ++i) {
+            const auto t0 = bench::Clock::now();
+            SpatialIndex::RayHit h;
+            hits += index.Raycast(rayList[i], 2 * kWorld, h);
+            each[i] = bench::SecondsSince(t0);
+        }
+    });
+    std::sort(each.begin(), each.end());
+    const double p99 = rays ? each[rays * 99 / 100] : 0.0;
+    std::printf("%-10s %10.2f us avg, %.1f us p99, %zu/%zu hit\n", "ray pick", pick / rays * 1e6, p99 * 1e6, hits, rays);
+
+    size_t agree = 0;
+    const auto bt0 = bench::Clock::now();
+    for (size_t i = 0; i < brute && i < rays; ++i) {
+        const Ray& r = rayList[i];
+        float best = 2 * kWorld;
+        bool  hit  = false;
+        for (const auto& [e, box] : items) {
+            const float t = Enter(r, box, best);
+            if (t <= best) { best = t; hit = true; }
+        }
+        SpatialIndex::RayHit h;
+        const bool treeHit = index.Raycast(r, 2 * kWorld, h);
+        agree += treeHit == hit && (!hit || std::fabs(h.T - best) <= 1e-3f * std::max(1.0f, best));
+    }
+    const double bruteEach = brute ? bench::SecondsSince(bt0) / (double)std::min(brute, rays) : 0.0;
+    std::printf("%-10s %10.2f us avg, %zu/%zu agree with the tree\n", "brute", bruteEach * 1e6, agree, std::min(brute, rays));
+
+    // Frustum from the centre of the scene, reaching a quarter of the way out
+    const Frustum frustum = MakeFrustum(Vec3(kWorld / 2, kWorld / 2, kWorld / 2), 0.5236f, 1.0f, kWorld / 4);
+    size_t inFrustum = 0;
+    const double frus = bench::BestOf(runs, [&] {
+        inFrustum = 0;
+        index.QueryFrustum(frustum, [&](Entity) { ++inFrustum; });
+    });
+    std::printf("%-10s %10.2f ms, %zu entities\n", "frustum", frus * 1e3, inFrustum);
+
+    // k nearest
+    std::vector<Vec3> points(1000);
+    for (Vec3& p : points) p = Vec3(pos(rng), pos(rng), pos(rng));
+    std::vector<Entity> near;
+    const double knn = bench::BestOf(runs, [&] {
+        for (const Vec3& p : points) index.Nearest(p, 16, near);
+    });
+    std::printf("%-10s %10.2f us per query (k = 16)\n", "nearest", knn / points.size() * 1e6);
+
+    // Jitter below the margin: Update() should never restructure
+    const size_t moves = std::min<size_t>(count, 100'000);
+    std::uniform_real_distribution<float> jitter(-0.04f, 0.04f);
+    size_t restructured = 0;
+    const auto ut0 = bench::Clock::now();
+    for (size_t i = 0; i < moves; ++i) {
+        const Vec3 d(jitter(rng), jitter(rng), jitter(rng));
+        const AABB& b = items[i].second;
+        restructured += index.Update(items[i].first, AABB{b.Min + d, b.Max + d});
+    }
+    std::printf("%-10s %10.2f ms for %zu moves, %zu restructured\n", "update", bench::SecondsSince(ut0) * 1e3, moves, restructured);
+    return 0;
+}
@@ -0,0 +1,439 @@
+﻿#include "Cooker.h"
+#include "Runtime/Asset/CookedAsset.h"
+#include "Runtime/Asset/DerivedDataCache.h"
+#include "Runtime/Blueprint/BlueprintCompiler.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Hash.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Profiler.h"
+#include "Runtime/IO/VFS.h"
+#include "Runtime/Project/Project.h"
+#include "Runtime/World/MapBinary.h"
+#include "Runtime/World/MapJson.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace ace::cook {
+    namespace {
+        // Bump when the manifest layout changes; old manifests are then ignored
+        constexpr int kManifestVersion = 1;
+        constexpr std::string_view kMount = Project::kContentMount;
+
+        // Turns one source file into its runtime form. Bump Version whenever
+        // the output for the same input changes, so cached results are not reused.
+        struct Processor {
+            const char* Name;
+            uint32_t    Version;
+            bool        UsesDependencies;   // output depends on referenced assets
+            bool (*Run)(const AssetData& asset, const uint8_t* data, size_t size,
+                        std::vector<uint8_t>& out, std::string& error);
+        };
+
+        bool CookMap(const AssetData&, const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error)
+        {
+            if (DetectMapFormat(data, size) == MapFileFormat::Binary) {
+                out.assign(data, data + size);
+                return true;
+            }
+            // Parsed on this thread: assets already cook in parallel, and a nested
+            // ParallelFor would run other assets' jobs here and blur the timings
+            const json j = json::parse(data, data + size, nullptr, false);
+            if (j.is_discarded()) { error = "invalid map JSON"; return false; }
+            World world;
+            if (!MapFromJson(world, j, nullptr, &error)) return false;
+            WriteMapBinary(world, out);
+            return true;
+        }
+
+        // Fields only the editor reads
+        void StripEditorData(AssetType type, json& j)
+        {
+            j.erase("Guid");        // stored in the cooked header
+            if (type != AssetType::Blueprint || !j.contains("Graph") || !j["Graph"].is_object()) return;
+            json& g = j["Graph"];
+            g.erase("nextId");
+            if (g.contains("nodes") && g["nodes"].is_array())
+                for (auto& n : g["nodes"]) if (n.is_object()) n.erase("pos");
+        }
+
+        bool CookJsonAsset(const AssetData& asset, const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error)
+        {
+            json j = json::parse(data, data + size, nullptr, false);
+            if (j.is_discarded() || !j.is_object()) { error = "invalid JSON"; return false; }
+            StripEditorData(asset.Type, j);
+            WriteCookedAsset(asset.Type, asset.Guid, j, out);
+            return true;
+        }
+
+        // As CookJsonAsset; a graph that does not compile fails the cook
+        // rather than the game
+        bool CookBlueprint(const AssetData& asset, const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::string& error)
+        {
+            json j = json::parse(data, data + size, nullptr, false);
+            if (j.is_discarded() || !j.is_object()) { error = "invalid JSON"; return false; }
+            BlueprintGraph graph;
+            BlueprintProgram program;
+            const bool hasGraph = BlueprintGraphFromJson(j, graph, &error);
+            if (!error.empty() || (hasGraph && !CompileBlueprint(graph, program, error))) {
+                error = "blueprint: " + error;
+                return false;
+            }
+            StripEditorData(asset.Type, j);
+            WriteCookedAsset(asset.Type, asset.Guid, j, out);
+            return true;
+        }
+
+        constexpr Processor kMapProcessor       { "Map",       1, false, CookMap };
+        constexpr Processor kBlueprintProcessor { "Blueprint", 2, true,  CookBlueprint };
+        constexpr Processor kDataProcessor      { "DataAsset", 1, false, CookJsonAsset };
+
+        // null: copied unchanged
+        const Processor* ProcessorFor(AssetType type)
+        {
+            switch (type) {
+                case AssetType::Map:       return &kMapProcessor;
+                case AssetType::Blueprint:
+                case AssetType::GameMode:  return &kBlueprintProcessor;
+                case AssetType::Material:
+                case AssetType::DataAsset: return &kDataProcessor;
+                default:                   return nullptr;
+            }
+        }
+
+        struct ManifestEntry {
+            DdcKey      Key;
+            std::string Output;         // relative to OutputDir, '/'-separated
+            uint64_t    Size = 0;
+            uint64_t    Hash = 0;       // Hash64 of the output
+        };
+        using Manifest = std::unordered_map<std::string, ManifestEntry>;
+
+        fs::path ManifestPath(const CookOptions& o) { return o.OutputDir / "CookManifest.json"; }
+
+        Manifest LoadManifest(const CookOptions& o)
+        {
+            Manifest m;
+            std::ifstream in(ManifestPath(o), std::ios::binary);
+            if (!in) return m;
+            // Fields are type-checked (value() throws on a mismatch): a corrupt
+            // manifest reads as missing, a corrupt entry as an uncooked asset
+            json j = json::parse(in, nullptr, false);
+            const auto str = [](const json& o, const char* key) {
+                const auto it = o.find(key);
+                return it != o.end() && it->is_string() ? it->get<std::string>() : std::string();
+            };
+            if (!j.is_object() || !j.contains("Version") || !j["Version"].is_number_integer() ||
+                j["Version"].get<int64_t>() != kManifestVersion || str(j, "Platform") != o.Platform ||
+                !j.contains("Assets") || !j["Assets"].is_object())
+                return m;
+            for (auto it = j["Assets"].begin(); it != j["Assets"].end(); ++it) {
+                if (!it->is_object() || !it->contains("Size") || !(*it)["Size"].is_number_unsigned()) continue;
+                ManifestEntry e;
+                e.Output = str(*it, "Output");
+                e.Size   = (*it)["Size"].get<uint64_t>();
+                if (e.Output.empty() || !DdcKey::FromString(str(*it, "Key"), e.Key) ||
+                    !HashFromHex(str(*it, "Hash"), e.Hash)) continue;
+                m.emplace(it.key(), std::move(e));
+            }
+            return m;
+        }
+
+        struct Node {
+            const AssetData*      Asset = nullptr;
+            const Processor*      Proc = nullptr;
+            std::vector<uint32_t> Deps;         // indices of referenced nodes
+            std::vector<uint32_t> Users;        // nodes referencing this one
+            DdcKey                Key;
+            uint32_t              Level = 0;
+            bool                  Keyed = false;
+        };
+
+        DdcKey MakeKey(const Node& n, const std::vector<Node>& nodes, const std::string& platform)
+        {
+            const AssetData& a = *n.Asset;
+            DdcKeyBuilder b(n.Proc ? n.Proc->Name : "Copy", n.Proc ? n.Proc->Version : 1);
+            b.Add(a.ContentHash).Add(a.Size).Add(platform).Add((uint64_t)a.Type).Add(a.Guid.Hi).Add(a.Guid.Lo);
+            if (n.Proc && n.Proc->UsesDependencies) {
+                // Inside a reference cycle the dependency's key is not known yet: its content stands in
+                for (uint32_t d : n.Deps) {
+                    const Node& dep = nodes[d];
+                    if (dep.Keyed) b.Add(dep.Key.Hi).Add(dep.Key.Lo);
+                    else           b.Add(dep.Asset->ContentHash);
+                }
+            }
+            return b.Finish();
+        }
+    }
+
+    const char* HostPlatform()
+    {
+#if defined(_WIN32)
+        return "Windows";
+#elif defined(__APPLE__)
+        return "macOS";
+#else
+        return "Linux";
+#endif
+    }
+
+    CookOptions MakeOptions(const Project& project, std::string_view platform)
+    {
+        CookOptions o;
+        o.ContentDir      = project.ContentDir();
+        o.OutputDir       = project.CookedDir() / std::string(platform);
+        o.IntermediateDir = project.IntermediateDir();
+        o.DdcDir          = project.DerivedDataDir();
+        o.Platform        = std::string(platform);
+        return o;
+    }
+
+    bool Cook(const CookOptions& options, CookStats& stats)
+    {
+        ACE_PROFILE_FUNCTION();
+        const auto t0 = std::chrono::steady_clock::now();
+        stats = CookStats{};
+        CookProgress* progress = options.Progress;
+        std::error_code ec;
+        if (!fs::is_directory(options.ContentDir, ec)) {
+            stats.Messages.push_back(options.ContentDir.string() + ": error: content directory not found");
+            stats.Errors = 1;
+            return false;
+        }
+
+        // 1) What is there: a private VFS, so the editor's pak mounts stay out of the cook
+        VFS vfs;
+        vfs.MountDirectory(kMount, options.ContentDir);
+        AssetRegistry reg;
+        reg.SetVfs(&vfs);
+        const fs::path snapshot = options.IntermediateDir / "Cook" / "AssetRegistry.bin";
+        const bool warm = reg.LoadSnapshot(snapshot);
+        const AssetScanStats scan = reg.Scan(kMount);
+        if (!warm || scan.Added || scan.Updated || scan.Removed) {
+            fs::create_directories(snapshot.parent_path(), ec);
+            reg.SaveSnapshot(snapshot);
+        }
+        stats.Assets = reg.Count();
+
+        DerivedDataCache ddc;
+        if (!options.DdcDir.empty() && !ddc.Open(options.DdcDir))
+            stats.Messages.push_back(options.DdcDir.string() + ": warning: cannot open derived-data cache");
+
+        // 2) Reference DAG, levels (Kahn) and keys in dependency order
+        std::vector<Node> nodes(reg.Count());
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            nodes[i].Asset = &reg.At(i);
+            nodes[i].Proc  = ProcessorFor(nodes[i].Asset->Type);
+        }
+        std::unordered_map<std::string_view, uint32_t> byPath;
+        byPath.reserve(nodes.size());
+        for (uint32_t i = 0; i < nodes.size(); ++i) byPath.emplace(nodes[i].Asset->Path, i);
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            for (const auto& ref : nodes[i].Asset->References) {
+                auto it = byPath.find(ref);
+                if (it == byPath.end()) {
+                    // Folder references are fine; anything with an extension should exist
+                    if (ref.find('.', ref.find_last_of('/')) != std::string::npos)
+                        stats.Messages.push_back((options.ContentDir / nodes[i].Asset->Path.substr(kMount.size() + 1)).string() +
+                                                 ": warning: references missing asset " + ref);
+                    continue;
+                }
+                nodes[i].Deps.push_back(it->second);
+                nodes[it->second].Users.push_back(i);
+            }
+        }
+
+        std::vector<uint32_t> pending(nodes.size()), ready;
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            pending[i] = (uint32_t)nodes[i].Deps.size();
+            if (!pending[i]) ready.push_back(i);
+        }
+        uint32_t maxLevel = 0;
+        size_t keyed = 0;
+        while (!ready.empty()) {
+            const uint32_t i = ready.back();
+            ready.pop_back();
+            Node& n = nodes[i];
+            n.Key   = MakeKey(n, nodes, options.Platform);
+            n.Keyed = true;
+            ++keyed;
+            maxLevel = std::max(maxLevel, n.Level);
+            for (uint32_t u : n.Users) {
+                nodes[u].Level = std::max(nodes[u].Level, n.Level + 1);
+                if (--pending[u] == 0) ready.push_back(u);
+            }
+        }
+        if (keyed < nodes.size()) {
+            // Reference cycles (and whatever depends on them) cook last, together
+            for (Node& n : nodes) {
+                if (n.Keyed) continue;
+                n.Level = maxLevel + 1;
+                n.Key   = MakeKey(n, nodes, options.Platform);
+                stats.Messages.push_back((options.ContentDir / n.Asset->Path.substr(kMount.size() + 1)).string() +
+                                         ": warning: part of (or depends on) a reference cycle");
+            }
+            for (Node& n : nodes) n.Keyed = true;
+            ++maxLevel;
+        }
+
+        // 3) Dirty nodes: key or output differs from the manifest
+        const Manifest old = options.Force ? Manifest{} : LoadManifest(options);
+        std::vector<std::optional<ManifestEntry>> cooked(nodes.size());
+        std::vector<std::vector<uint32_t>> levels(maxLevel + 1);
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            const Node& n = nodes[i];
+            if (auto it = old.find(n.Asset->Path); it != old.end() && it->second.Key == n.Key) {
+                const uint64_t size = fs::file_size(options.OutputDir / it->second.Output, ec);
+                if (!ec && size == it->second.Size) { cooked[i] = it->second; ++stats.Unchanged; continue; }
+            }
+            levels[n.Level].push_back(i);
+        }
+        const size_t dirty = nodes.size() - stats.Unchanged;
+        if (progress) { progress->Done = 0; progress->Total = dirty; }
+
+        std::vector<AssetTiming> timings(nodes.size());
+        std::vector<std::string> errors(nodes.size());
+        auto cookOne = [&](uint32_t i) {
+            const Node& n = nodes[i];
+            const AssetData& a = *n.Asset;
+            const auto start = std::chrono::steady_clock::now();
+            AssetTiming& t = timings[i];
+            t.Path = a.Path;
+            t.Type = a.Type;
+            t.Result = CookResult::Failed;
+
+            const std::string rel = a.Path.substr(kMount.size() + 1);
+            VfsFile file;
+            std::vector<uint8_t> out;
+            const uint8_t* outData = nullptr;
+            size_t outSize = 0;
+            if (!vfs.Open(a.Path, file)) {
+                errors[i] = "cannot read file";
+            } else if (Hash64(file.Data(), file.Size()) != a.ContentHash) {
+                errors[i] = "changed during the cook";      // its key is stale; the next cook picks it up
+            } else if (!n.Proc) {
+                outData = file.Data();
+                outSize = file.Size();
+                t.Result = CookResult::Copied;
+            } else {
+                std::string error;
+                bool built = false;
+                // A processor that throws fails its asset, not the cook
+                const auto build = [&](std::vector<uint8_t>& o) {
+                    built = true;
+                    try {
+                        return n.Proc->Run(a, file.Data(), file.Size(), o, error);
+                    } catch (const std::exception& e) {
+                        error = std::string("processor threw: ") + e.what();
+                        return false;
+                    }
+                };
+                const bool ok = ddc.IsOpen() ? ddc.GetOrBuild(n.Key, out, build) : build(out);
+                if (ok) {
+                    outData = out.data();
+                    outSize = out.size();
+                    t.Result = built ? CookResult::Cooked : CookResult::CacheHit;
+                } else {
+                    errors[i] = error.empty() ? "processor failed" : error;
+                }
+            }
+
+            if (t.Result != CookResult::Failed) {
+                if (WriteFileAtomic(options.OutputDir / "Content" / rel, outData, outSize)) {
+                    cooked[i] = ManifestEntry{ n.Key, "Content/" + rel, outSize, Hash64(outData, outSize) };
+                } else {
+                    errors[i] = "cannot write " + (options.OutputDir / "Content" / rel).string();
+                    t.Result = CookResult::Failed;
+                }
+            }
+            t.InBytes  = file.Size();
+            t.OutBytes = outSize;
+            t.Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (progress) progress->Done.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        // A level only reads outputs of earlier levels, so each one runs fully in parallel
+        std::vector<uint32_t> done;
+        for (const auto& level : levels) {
+            if (level.empty()) continue;
+            if (progress && progress->Cancel) { stats.Canceled = true; break; }
+            ++stats.Levels;
+            JobSystem::Get().ParallelFor(level.size(), [&](size_t b, size_t e) {
+                for (size_t k = b; k < e; ++k) {
+                    if (progress && progress->Cancel) return;
+                    cookOne(level[k]);
+                }
+            }, 1);
+            done.insert(done.end(), level.begin(), level.end());
+        }
+        if (progress && progress->Cancel) stats.Canceled = true;
+
+        for (uint32_t i : done) {
+            if (timings[i].Path.empty()) continue;      // skipped by a cancel
+            switch (timings[i].Result) {
+                case CookResult::Cooked:   ++stats.Cooked;    break;
+                case CookResult::CacheHit: ++stats.CacheHits; break;
+                case CookResult::Copied:   ++stats.Copied;    break;
+                case CookResult::Failed:
+                    ++stats.Errors;
+                    stats.Messages.push_back((options.ContentDir / timings[i].Path.substr(kMount.size() + 1)).string() +
+                                             ": error: " + errors[i]);
+                    break;
+            }
+            stats.Timings.push_back(std::move(timings[i]));
+        }
+
+        // 4) Outputs of assets that are gone, then the manifest. Failed and
+        // canceled assets are left out so the next cook retries them.
+        for (const auto& [path, e] : old) {
+            if (byPath.count(path)) continue;
+            if (fs::remove(options.OutputDir / e.Output, ec)) ++stats.Removed;
+        }
+        if (options.Force) {
+            // Without the old manifest, find stale outputs by walking the tree
+            std::unordered_set<std::string> live;
+            for (const auto& c : cooked) if (c) live.insert(c->Output);
+            std::vector<fs::path> stale;
+            for (fs::recursive_directory_iterator it(options.OutputDir / "Content", ec), end; it != end; it.increment(ec)) {
+                if (ec) break;
+                if (!it->is_regular_file(ec)) continue;
+                if (!live.count(fs::relative(it->path(), options.OutputDir, ec).generic_string())) stale.push_back(it->path());
+            }
+            for (const auto& p : stale) if (fs::remove(p, ec)) ++stats.Removed;
+        }
+
+        json assets = json::object();
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            if (!cooked[i]) continue;
+            const ManifestEntry& e = *cooked[i];
+            const AssetData& a = *nodes[i].Asset;
+            json deps = json::array();
+            for (uint32_t d : nodes[i].Deps) deps.push_back(nodes[d].Asset->Path);
+            assets[a.Path] = { {"Guid", a.Guid.ToString()}, {"Type", AssetTypeName(a.Type)}, {"Key", e.Key.ToString()},
+                               {"Output", e.Output}, {"Size", e.Size}, {"Hash", HashToHex(e.Hash)}, {"Deps", std::move(deps)} };
+        }
+        const json manifest = { {"Version", kManifestVersion}, {"Platform", options.Platform}, {"Assets", std::move(assets)} };
+        const std::string text = manifest.dump(1);
+        if (!WriteFileAtomic(ManifestPath(options), text.data(), text.size())) {
+            stats.Messages.push_back(ManifestPath(options).string() + ": error: cannot write manifest");
+            ++stats.Errors;
+        }
+
+        stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return stats.Errors == 0 && !stats.Canceled;
+    }
+
+    bool Clean(const CookOptions& options)
+    {
+        std::error_code ec;
+        fs::remove_all(options.OutputDir, ec);
+        return !ec;
+    }
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+#include "Runtime/Asset/AssetRegistry.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ace {
+    class Project;
+}
+
+namespace ace::cook {
+    // Shared with a UI thread: progress counters and a cancel flag
+    struct CookProgress {
+        std::atomic<size_t> Done{0};        // dirty assets finished (cooked or failed)
+        std::atomic<size_t> Total{0};       // dirty assets found; 0 while scanning
+        std::atomic<bool>   Cancel{false};  // stop after the assets in flight
+    };
+
+    struct CookOptions {
+        std::filesystem::path ContentDir;       // mounted at /Game for the cook
+        std::filesystem::path OutputDir;        // <Project>/Cooked/<Platform>
+        std::filesystem::path IntermediateDir;  // registry snapshot for the cook
+        std::filesystem::path DdcDir;           // empty = no derived-data cache
+        std::string           Platform;         // part of every cache key
+        bool                  Force = false;    // ignore the manifest; the DDC still serves hits
+        CookProgress*         Progress = nullptr;
+    };
+
+    // Defaults for a project: Cooked/<platform>, its Intermediate dir and DDC
+    CookOptions MakeOptions(const Project& project, std::string_view platform);
+    const char* HostPlatform();                 // "Windows", "Linux" or "macOS"
+
+    enum class CookResult : uint8_t {
+        Cooked,         // processed now
+        CacheHit,       // output came from the derived-data cache
+        Copied,         // no processor for the type: copied as is
+        Failed,
+    };
+
+    struct AssetTiming {
+        std::string Path;                       // virtual, e.g. "/Game/Maps/Start.acemap"
+        AssetType   Type = AssetType::Unknown;
+        CookResult  Result = CookResult::Cooked;
+        double      Ms = 0.0;                   // read, process and write
+        uint64_t    InBytes = 0;
+        uint64_t    OutBytes = 0;
+    };
+
+    struct CookStats {
+        size_t Assets = 0;          // under /Game
+        size_t Unchanged = 0;       // key and output matched the manifest: not touched
+        size_t Cooked = 0;
+        size_t CacheHits = 0;
+        size_t Copied = 0;
+        size_t Removed = 0;         // outputs of deleted assets
+        size_t Errors = 0;
+        size_t Levels = 0;          // dependency levels cooked one after another
+        bool   Canceled = false;
+        double Seconds = 0.0;
+        std::vector<AssetTiming> Timings;       // every asset that was not Unchanged
+        std::vector<std::string> Messages;      // "path: error: ..." / "path: warning: ..."
+    };
+
+    // Brings OutputDir up to date with ContentDir:
+    //  1. scans /Game with the AssetRegistry (hashes, types, references),
+    //     reusing the snapshot so unchanged files are not opened;
+    //  2. builds the reference DAG and a key per asset from its content,
+    //     processor version, platform and, for assets whose output depends
+    //     on other assets, their keys;
+    //  3. cooks every asset whose key or output differs from the manifest,
+    //     one dependency level at a time, in parallel on the job system;
+    //  4. deletes outputs of removed assets and writes CookManifest.json.
+    // Maps become binary .acemap, JSON assets become CookedAsset files, and
+    // anything else is copied. Returns false if any asset failed.
+    bool Cook(const CookOptions& options, CookStats& stats);
+
+    // Deletes OutputDir (cooked files and manifest)
+    bool Clean(const CookOptions& options);
+}
@@ -0,0 +1,91 @@
+﻿#include "Cooker.h"
+#include "Runtime/Core/JobSystem.h"
+#include "Runtime/Core/Log.h"
+#include "Runtime/Project/Project.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// ACECook --project <Game.aceproj> [--platform <name>] [--force] [--clean] [--no-ddc] [--jobs <n>] [--top <n>] [--quiet]
+static void PrintUsage()
+{
+    std::cerr << "Usage: ACECook --project <file.aceproj> [--platform <Windows|Linux|macOS>] [--force] [--clean]\n"
+                 "                [--no-ddc] [--jobs <n>] [--top <n>] [--quiet]\n";
+}
+
+static const char* ResultName(ace::cook::CookResult r)
+{
+    switch (r) {
+        case ace::cook::CookResult::Cooked:   return "cooked";
+        case ace::cook::CookResult::CacheHit: return "ddc";
+        case ace::cook::CookResult::Copied:   return "copied";
+        case ace::cook::CookResult::Failed:   return "FAILED";
+    }
+    return "?";
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path projectFile;
+    std::string platform = ace::cook::HostPlatform();
+    bool force = false, clean = false, useDdc = true, quiet = false;
+    int jobs = 0, top = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if      (!std::strcmp(a, "--project")  && i + 1 < argc) projectFile = argv[++i];
+        else if (!std::strcmp(a, "--platform") && i + 1 < argc) platform = argv[++i];
+        else if (!std::strcmp(a, "--jobs")     && i + 1 < argc) jobs = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--top")      && i + 1 < argc) top = std::atoi(argv[++i]);
+        else if (!std::strcmp(a, "--force"))   force = true;
+        else if (!std::strcmp(a, "--clean"))   clean = true;
+        else if (!std::strcmp(a, "--no-ddc"))  useDdc = false;
+        else if (!std::strcmp(a, "--quiet"))   quiet = true;
+        else { PrintUsage(); return 2; }
+    }
+    if (projectFile.empty()) { PrintUsage(); return 2; }
+
+    auto proj = ace::Project::Load(projectFile);
+    if (!proj) { std::cerr << projectFile.string() << ": error: cannot load project\n"; return 2; }
+
+    ace::cook::CookOptions opt = ace::cook::MakeOptions(*proj, platform);
+    opt.Force = force;
+    if (!useDdc) opt.DdcDir.clear();
+    if (clean) {
+        if (!ace::cook::Clean(opt)) { std::cerr << opt.OutputDir.string() << ": error: cannot delete\n"; return 1; }
+        std::printf("ACECook: removed %s\n", opt.OutputDir.string().c_str());
+        return 0;
+    }
+
+    // Engine log lines go through the async writer (stdout) while cooking
+    ace::Log::Startup();
+    ace::JobSystem::Startup(jobs > 0 ? (uint32_t)std::max(1, jobs - 1) : 0);
+    ace::cook::CookStats stats;
+    const bool ok = ace::cook::Cook(opt, stats);
+
+    // One line per processed asset, in path order, for grepping and diffing runs
+    std::sort(stats.Timings.begin(), stats.Timings.end(),
+              [](const auto& a, const auto& b) { return a.Path < b.Path; });
+    if (!quiet)
+        for (const auto& t : stats.Timings)
+            std::printf("%9.2f ms  %-7s %-10s %10llu -> %10llu  %s\n", t.Ms, ResultName(t.Result), ace::AssetTypeName(t.Type),
+                        (unsigned long long)t.InBytes, (unsigned long long)t.OutBytes, t.Path.c_str());
+    for (const auto& m : stats.Messages) std::cerr << m << "\n";
+
+    if (top > 0 && !stats.Timings.empty()) {
+        std::sort(stats.Timings.begin(), stats.Timings.end(), [](const auto& a, const auto& b) { return a.Ms > b.Ms; });
+        std::printf("Slowest:\n");
+        for (size_t i = 0; i < stats.Timings.size() && i < (size_t)top; ++i)
+            std::printf("%9.2f ms  %s\n", stats.Timings[i].Ms, stats.Timings[i].Path.c_str());
+    }
+
+    std::printf("ACECook [%s]: %zu assets, %zu unchanged, %zu cooked, %zu from DDC, %zu copied, %zu removed, "
+                "%zu error(s), %zu level(s) in %.3fs%s\n",
+                platform.c_str(), stats.Assets, stats.Unchanged, stats.Cooked, stats.CacheHits, stats.Copied,
+                stats.Removed, stats.Errors, stats.Levels, stats.Seconds, stats.Canceled ? " (canceled)" : "");
+    ace::JobSystem::Shutdown();
+    ace::Log::Shutdown();
+    return ok ? 0 : 1;
+}
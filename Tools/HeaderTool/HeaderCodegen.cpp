@@ -0,0 +1,361 @@
+﻿#include "HeaderCodegen.h"
+#include "Runtime/Core/FileUtil.h"
+#include "Runtime/Core/Hash.h"
+#include <nlohmann/json.hpp>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace ace::hdr {
+    namespace {
+        // Bump when the generated output changes shape so every cache entry is invalidated.
+        constexpr int kGeneratorVersion = 2;
+        constexpr std::string_view kMarker    = "// Generated by ACEHeaderTool";
+        constexpr std::string_view kOldStub   = "// Auto-generated stub by ACE Editor";
+
+        struct FlagName { std::string_view Key; std::string_view Flag; };
+
+        constexpr FlagName kPropertyFlags[] = {
+            {"EditAnywhere",       "PF_EditAnywhere"},
+            {"EditDefaultsOnly",   "PF_EditDefaultsOnly"},
+            {"VisibleAnywhere",    "PF_VisibleAnywhere"},
+            {"BlueprintReadOnly",  "PF_BlueprintReadOnly"},
+            {"BlueprintReadWrite", "PF_BlueprintReadWrite"},
+            {"Transient",          "PF_Transient"},
+            {"SaveGame",           "PF_SaveGame"},
+            {"Config",             "PF_Config"},
+        };
+
+        constexpr FlagName kFunctionFlags[] = {
+            {"BlueprintCallable", "FF_BlueprintCallable"},
+            {"BlueprintPure",     "FF_BlueprintPure"},
+            {"Exec",              "FF_Exec"},
+        };
+
+        // Specifiers we accept for UE familiarity but do not act on yet
+        constexpr std::string_view kIgnoredKeys[] = { "meta", "DisplayName", "ToolTip", "Blueprintable", "BlueprintType" };
+
+        static std::string CString(std::string_view s)
+        {
+            std::string out = "\"";
+            for (char c : s) {
+                if (c == '"' || c == '\\') out.push_back('\\');
+                out.push_back(c);
+            }
+            out.push_back('"');
+            return out;
+        }
+
+        template<size_t N>
+        static std::string BuildFlags(const std::vector<Specifier>& specs, const FlagName (&table)[N],
+                                      std::string& category, std::vector<std::string>& unknown)
+        {
+            std::string flags;
+            for (const auto& s : specs) {
+                if (s.Key == "Category") { category = s.Value; continue; }
+                bool known = false;
+                for (const auto& f : table) {
+                    if (s.Key != f.Key) continue;
+                    if (!flags.empty()) flags += " | ";
+                    flags += "::ace::reflect::";
+                    flags += f.Flag;
+                    known = true;
+                    break;
+                }
+                if (known) continue;
+                for (auto k : kIgnoredKeys) if (s.Key == k) known = true;
+                if (!known) unknown.push_back(s.Key);
+            }
+            return flags.empty() ? "0" : flags;
+        }
+
+        static bool ReadFile(const fs::path& p, std::string& out)
+        {
+            std::ifstream in(p, std::ios::binary);
+            if (!in) return false;
+            std::ostringstream ss;
+            ss << in.rdbuf();
+            out = ss.str();
+            return true;
+        }
+
+        // Writes only when content differs, so untouched outputs keep their
+        // timestamps and do not trigger recompiles.
+        static bool WriteIfChanged(const fs::path& p, const std::string& content, bool& changed)
+        {
+            changed = false;
+            std::string existing;
+            if (ReadFile(p, existing) && existing == content) return true;
+            std::ofstream out(p, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out << content;
+            changed = true;
+            return (bool)out;
+        }
+
+        static fs::path GeneratedPathFor(const fs::path& header)
+        {
+            return header.parent_path() / (header.stem().string() + ".generated.h");
+        }
+
+        static bool IsHeader(const fs::path& p)
+        {
+            const auto ext = p.extension();
+            if (ext != ".h" && ext != ".hpp") return false;
+            const auto name = p.filename().string();
+            return name.size() < 12 || name.compare(name.size() - 12, 12, ".generated.h") != 0;
+        }
+
+        static int64_t MTimeOf(const fs::directory_entry& e)
+        {
+            std::error_code ec;
+            auto t = e.last_write_time(ec);
+            return ec ? 0 : (int64_t)t.time_since_epoch().count();
+        }
+
+        struct CacheEntry {
+            uint64_t Size = 0;
+            int64_t  MTime = 0;
+            uint64_t Hash = 0;
+            bool     Reflected = false;
+        };
+
+        using Cache = std::unordered_map<std::string, CacheEntry>;
+
+        static Cache LoadCache(const fs::path& file)
+        {
+            Cache cache;
+            std::ifstream in(file, std::ios::binary);
+            if (!in) return cache;
+            json j = json::parse(in, nullptr, false);
+            if (j.is_discarded() || j.value("Version", 0) != kGeneratorVersion || !j.contains("Files")) return cache;
+            for (auto it = j["Files"].begin(); it != j["Files"].end(); ++it) {
+                CacheEntry e;
+                e.Size      = it->value("Size", 0ull);
+                e.MTime     = it->value("MTime", 0ll);
+                e.Reflected = it->value("Reflected", false);
+                if (!HashFromHex(it->value("Hash", std::string()), e.Hash)) continue;
+                cache.emplace(it.key(), e);
+            }
+            return cache;
+        }
+
+        static void SaveCache(const fs::path& file, const Cache& cache)
+        {
+            json files = json::object();
+            for (const auto& [rel, e] : cache)
+                files[rel] = { {"Size", e.Size}, {"MTime", e.MTime}, {"Hash", HashToHex(e.Hash)}, {"Reflected", e.Reflected} };
+            json j = { {"Version", kGeneratorVersion}, {"Files", std::move(files)} };
+
+            const std::string text = j.dump();
+            WriteFileAtomic(file, text.data(), text.size());
+        }
+    }
+
+    std::string MakeFileId(const fs::path& relPath)
+    {
+        std::string id = "FID_";
+        for (char c : relPath.generic_string())
+            id.push_back(std::isalnum((unsigned char)c) ? c : '_');
+        return id;
+    }
+
+    static std::string Preamble(const fs::path& relPath)
+    {
+        std::string out;
+        out += kMarker;
+        out += " from " + relPath.generic_string() + ". Do not edit.\n";
+        out += "#pragma once\n"
+               "#include \"Runtime/Core/AceObjectMacros.h\"\n";
+        return out;
+    }
+
+    std::string GenerateEmptyHeader(const fs::path& relPath)
+    {
+        std::string out = Preamble(relPath);
+        out += "\n#undef GENERATED_BODY\n"
+               "#define GENERATED_BODY(...)\n";
+        return out;
+    }
+
+    std::string GenerateHeader(const ParsedHeader& parsed, const fs::path& relPath, std::vector<ParseMessage>* warnings)
+    {
+        if (parsed.Classes.empty()) return GenerateEmptyHeader(relPath);
+
+        const std::string fileId = MakeFileId(relPath);
+        std::string out = Preamble(relPath);
+        out += "#include \"Runtime/Core/Reflection.h\"\n\n";
+        out += "#undef ACE_CURRENT_FILE_ID\n";
+        out += "#define ACE_CURRENT_FILE_ID " + fileId + "\n";
+
+        for (const auto& c : parsed.Classes) {
+            std::vector<std::string> unknown;
+            std::ostringstream m;
+            m << "\n#define " << fileId << "_" << c.BodyLine << "_GENERATED_BODY \\\n"
+              << "    ACE_REFLECT_DISABLE_OFFSETOF_WARNING \\\n"
+              << "public: \\\n"
+              << "    using ThisClass = " << c.Name << "; \\\n";
+            if (!c.SuperName.empty())
+                m << "    using Super = " << c.SuperName << "; \\\n";
+            m << "    static constexpr std::string_view AceStaticName() { return " << CString(c.Name) << "; } \\\n"
+              << "    static constexpr std::string_view AceStaticSuperName() { return " << CString(c.SuperName) << "; } \\\n";
+
+            m << "    static constexpr auto AceStaticProperties() \\\n    { \\\n"
+              << "        return std::array<::ace::reflect::PropertyInfo, " << c.Properties.size() << ">{{ \\\n";
+            for (const auto& p : c.Properties) {
+                std::string category;
+                const std::string flags = BuildFlags(p.Specifiers, kPropertyFlags, category, unknown);
+                m << "            ACE_REFLECT_PROPERTY(" << p.Name << ", " << CString(p.TypeName) << ", "
+                  << CString(category) << ", " << flags << "), \\\n";
+                if (warnings) for (auto& u : unknown) warnings->push_back({p.Line, "unknown ACE_PROPERTY specifier '" + u + "'"});
+                unknown.clear();
+            }
+            m << "        }}; \\\n    } \\\n";
+
+            m << "    static constexpr auto AceStaticFunctions() \\\n    { \\\n"
+              << "        return std::array<::ace::reflect::FunctionInfo, " << c.Functions.size() << ">{{ \\\n";
+            for (const auto& f : c.Functions) {
+                std::string category;
+                std::string flags = BuildFlags(f.Specifiers, kFunctionFlags, category, unknown);
+                if (f.IsStatic) flags = (flags == "0" ? "" : flags + " | ") + "::ace::reflect::FF_Static";
+                if (f.IsConst)  flags = (flags == "0" ? "" : flags + " | ") + "::ace::reflect::FF_Const";
+                m << "            ACE_REFLECT_FUNCTION(" << f.Name << ", " << CString(category) << ", " << flags << "), \\\n";
+                if (warnings) for (auto& u : unknown) warnings->push_back({f.Line, "unknown ACE_FUNCTION specifier '" + u + "'"});
+                unknown.clear();
+            }
+            m << "        }}; \\\n    } \\\n";
+
+            m << "    static const ::ace::reflect::ClassInfo& StaticClass() { return ::ace::reflect::TClass<ThisClass>::Info; } \\\n"
+              << "    ACE_REFLECT_RESTORE_WARNINGS \\\n"
+              << (c.AccessAtBody.empty() ? (c.IsStruct ? "public" : "private") : c.AccessAtBody) << ":\n";
+            out += m.str();
+        }
+
+        out += "\n#undef GENERATED_BODY\n"
+               "#define GENERATED_BODY(...) ACE_GENERATED_BODY_FOR_LINE()\n";
+        return out;
+    }
+
+    bool IsToolOwnedFile(const fs::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        std::string head(128, '\0');
+        in.read(head.data(), (std::streamsize)head.size());
+        head.resize((size_t)in.gcount());
+        return head.find(kMarker) != std::string::npos || head.find(kOldStub) != std::string::npos;
+    }
+
+    bool RunIncremental(const RunOptions& options, RunStats& stats)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        stats = RunStats{};
+
+        std::error_code ec;
+        if (!fs::is_directory(options.SourceDir, ec)) {
+            stats.Messages.push_back(options.SourceDir.string() + ": error: source directory not found");
+            stats.Errors = 1;
+            return false;
+        }
+
+        const fs::path cacheFile = options.CacheFile.empty()
+            ? options.SourceDir.parent_path() / "Intermediate" / "HeaderTool" / "Cache.json"
+            : options.CacheFile;
+
+        Cache oldCache = options.Force ? Cache{} : LoadCache(cacheFile);
+        Cache newCache;
+        newCache.reserve(oldCache.size() + 64);
+
+        auto report = [&](const fs::path& file, const std::vector<ParseMessage>& msgs, const char* kind) {
+            for (const auto& m : msgs)
+                stats.Messages.push_back(file.string() + "(" + std::to_string(m.Line) + "): " + kind + ": " + m.Text);
+        };
+
+        std::string text;
+        for (fs::recursive_directory_iterator it(options.SourceDir, fs::directory_options::skip_permission_denied, ec), end;
+             it != end; it.increment(ec))
+        {
+            if (ec) break;
+            if (!it->is_regular_file(ec) || !IsHeader(it->path())) continue;
+            ++stats.Headers;
+
+            const fs::path& header = it->path();
+            const std::string rel = fs::relative(header, options.SourceDir, ec).generic_string();
+            const uint64_t size  = (uint64_t)it->file_size(ec);
+            const int64_t  mtime = MTimeOf(*it);
+
+            // An unchanged header is only skipped while its generated file
+            // is still there; a deleted .generated.h is written again
+            auto old = oldCache.find(rel);
+            const bool outputPresent = old == oldCache.end() || !old->second.Reflected ||
+                                       fs::exists(GeneratedPathFor(header), ec);
+            if (old != oldCache.end() && outputPresent && old->second.Size == size && old->second.MTime == mtime) {
+                newCache.emplace(rel, old->second);
+                continue;
+            }
+
+            if (!ReadFile(header, text)) {
+                stats.Messages.push_back(header.string() + ": error: cannot read file");
+                ++stats.Errors;
+                continue;
+            }
+            CacheEntry entry{size, mtime, HashString(text), false};
+
+            // Touched but not edited: nothing to regenerate
+            if (old != oldCache.end() && outputPresent && old->second.Hash == entry.Hash) {
+                entry.Reflected = old->second.Reflected;
+                newCache.emplace(rel, entry);
+                continue;
+            }
+
+            const fs::path gen = GeneratedPathFor(header);
+            std::string output;
+            if (HasReflectionMarkup(text)) {
+                ++stats.Parsed;
+                if (options.Verbose) stats.Messages.push_back("Parsing " + rel);
+                ParsedHeader parsed = ParseHeader(text);
+                std::vector<ParseMessage> warnings = parsed.Warnings;
+                if (!parsed.Errors.empty()) {
+                    report(header, parsed.Errors, "error");
+                    report(header, warnings, "warning");
+                    stats.Errors += parsed.Errors.size();
+                    continue; // no cache entry: re-parsed next run
+                }
+                output = GenerateHeader(parsed, rel, &warnings);
+                report(header, warnings, "warning");
+                entry.Reflected = !parsed.Classes.empty();
+            } else if (fs::exists(gen, ec) && IsToolOwnedFile(gen)) {
+                output = GenerateEmptyHeader(rel);
+            }
+
+            if (!output.empty()) {
+                bool changed = false;
+                if (!WriteIfChanged(gen, output, changed)) {
+                    stats.Messages.push_back(gen.string() + ": error: cannot write file");
+                    ++stats.Errors;
+                    continue;
+                }
+                if (changed) ++stats.Written;
+            }
+            newCache.emplace(rel, entry);
+        }
+
+        // Headers that disappeared: drop their generated files if we own them
+        for (const auto& [rel, e] : oldCache) {
+            if (newCache.count(rel)) continue;
+            const fs::path header = options.SourceDir / rel;
+            if (fs::exists(header, ec)) continue; // failed this run, keep output
+            const fs::path gen = GeneratedPathFor(header);
+            if (fs::exists(gen, ec) && IsToolOwnedFile(gen) && fs::remove(gen, ec)) ++stats.Removed;
+        }
+
+        SaveCache(cacheFile, newCache);
+        stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return stats.Errors == 0;
+    }
+}
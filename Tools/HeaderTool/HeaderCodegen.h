@@ -0,0 +1,44 @@
+﻿#pragma once
+#include "HeaderParser.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ace::hdr {
+    // "Gameplay/MyActor.h" -> "FID_Gameplay_MyActor_h"
+    std::string MakeFileId(const std::filesystem::path& relPath);
+
+    // Full text of <Header>.generated.h. Diagnostics about unknown specifiers are
+    // appended to 'warnings'.
+    std::string GenerateHeader(const ParsedHeader& parsed, const std::filesystem::path& relPath,
+                               std::vector<ParseMessage>* warnings = nullptr);
+
+    // Generated file for a header without reflected classes: GENERATED_BODY() stays a no-op.
+    std::string GenerateEmptyHeader(const std::filesystem::path& relPath);
+
+    // True if the file at 'path' was written by the header tool (or the editor stub),
+    // i.e. it is safe to overwrite or delete.
+    bool IsToolOwnedFile(const std::filesystem::path& path);
+
+    struct RunOptions {
+        std::filesystem::path SourceDir;
+        std::filesystem::path CacheFile;   // empty = <SourceDir>/../Intermediate/HeaderTool/Cache.json
+        bool Force   = false;              // ignore the cache and re-parse everything
+        bool Verbose = false;
+    };
+
+    struct RunStats {
+        size_t Headers   = 0;   // headers found under SourceDir
+        size_t Parsed    = 0;   // content changed (or forced) and re-scanned
+        size_t Written   = 0;   // .generated.h files whose content changed
+        size_t Removed   = 0;   // stale .generated.h files deleted
+        size_t Errors    = 0;
+        double Seconds   = 0.0;
+        std::vector<std::string> Messages;   // "path(line): error: ..." lines
+    };
+
+    // Scans SourceDir and brings every <Header>.generated.h up to date.
+    // Headers whose size+mtime match the cache are not opened; headers whose
+    // content hash matches the cache are not parsed. Returns false on any error.
+    bool RunIncremental(const RunOptions& options, RunStats& stats);
+}
@@ -0,0 +1,475 @@
+﻿#include "HeaderParser.h"
+#include <cctype>
+#include <optional>
+
+namespace ace::hdr {
+    namespace {
+        enum class TokKind { Ident, Number, String, Punct };
+
+        struct Token {
+            TokKind          Kind = TokKind::Punct;
+            std::string_view Text;
+            int              Line = 1;
+
+            bool Is(std::string_view s) const { return Text == s; }
+            bool IsIdent() const { return Kind == TokKind::Ident; }
+        };
+
+        static bool IsIdentStart(char c) { return std::isalpha((unsigned char)c) || c == '_'; }
+        static bool IsIdentChar(char c)  { return std::isalnum((unsigned char)c) || c == '_'; }
+
+        // Produces identifiers, numbers, literals and punctuation. Comments and
+        // preprocessor lines are dropped; line numbers are kept exact because
+        // GENERATED_BODY() expansion is keyed by __LINE__.
+        static std::vector<Token> Tokenize(std::string_view s)
+        {
+            std::vector<Token> out;
+            out.reserve(s.size() / 4);
+            size_t i = 0, n = s.size();
+            int  line = 1;
+            bool lineStart = true;
+
+            if (n >= 3 && (unsigned char)s[0] == 0xEF && (unsigned char)s[1] == 0xBB && (unsigned char)s[2] == 0xBF) i = 3;
+
+            auto push = [&](TokKind k, size_t b, size_t e, int ln) { out.push_back({k, s.substr(b, e - b), ln}); };
+
+            while (i < n) {
+                const char c = s[i];
+                if (c == '\n') { ++line; ++i; lineStart = true; continue; }
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') { ++i; continue; }
+
+                if (c == '#' && lineStart) {
+                    // Preprocessor directive, including backslash continuations
+                    while (i < n && s[i] != '\n') {
+                        if (s[i] == '\\' && i + 1 < n && (s[i + 1] == '\n' || (s[i + 1] == '\r' && i + 2 < n && s[i + 2] == '\n'))) {
+                            i += (s[i + 1] == '\r') ? 3 : 2; ++line; continue;
+                        }
+                        if (s[i] == '/' && i + 1 < n && s[i + 1] == '*') {
+                            i += 2;
+                            while (i + 1 < n && !(s[i] == '*' && s[i + 1] == '/')) { if (s[i] == '\n') ++line; ++i; }
+                            i += 2; continue;
+                        }
+                        if (s[i] == '/' && i + 1 < n && s[i + 1] == '/') { while (i < n && s[i] != '\n') ++i; break; }
+                        ++i;
+                    }
+                    continue;
+                }
+                lineStart = false;
+
+                if (c == '/' && i + 1 < n && s[i + 1] == '/') { while (i < n && s[i] != '\n') ++i; continue; }
+                if (c == '/' && i + 1 < n && s[i + 1] == '*') {
+                    i += 2;
+                    while (i + 1 < n && !(s[i] == '*' && s[i + 1] == '/')) { if (s[i] == '\n') ++line; ++i; }
+                    i = std::min(n, i + 2);
+                    continue;
+                }
+
+                if (IsIdentStart(c)) {
+                    size_t b = i;
+                    while (i < n && IsIdentChar(s[i])) ++i;
+                    std::string_view id = s.substr(b, i - b);
+                    // Raw string literal: R"delim( ... )delim" with optional encoding prefix
+                    if (i < n && s[i] == '"' && !id.empty() && id.back() == 'R' &&
+                        (id == "R" || id == "LR" || id == "uR" || id == "UR" || id == "u8R"))
+                    {
+                        const int startLine = line;
+                        size_t d0 = i + 1, d1 = d0;
+                        while (d1 < n && s[d1] != '(') ++d1;
+                        const std::string close = ")" + std::string(s.substr(d0, d1 - d0)) + "\"";
+                        size_t end = s.find(close, d1);
+                        end = (end == std::string_view::npos) ? n : end + close.size();
+                        for (size_t k = i; k < end; ++k) if (s[k] == '\n') ++line;
+                        push(TokKind::String, b, end, startLine);
+                        i = end;
+                        continue;
+                    }
+                    push(TokKind::Ident, b, i, line);
+                    continue;
+                }
+
+                if (std::isdigit((unsigned char)c) || (c == '.' && i + 1 < n && std::isdigit((unsigned char)s[i + 1]))) {
+                    size_t b = i;
+                    while (i < n) {
+                        char d = s[i];
+                        if (IsIdentChar(d) || d == '.' || d == '\'') { ++i; continue; }
+                        if ((d == '+' || d == '-') && (s[i - 1] == 'e' || s[i - 1] == 'E' || s[i - 1] == 'p' || s[i - 1] == 'P')) { ++i; continue; }
+                        break;
+                    }
+                    push(TokKind::Number, b, i, line);
+                    continue;
+                }
+
+                if (c == '"' || c == '\'') {
+                    const int startLine = line;
+                    size_t b = i++;
+                    while (i < n && s[i] != c) {
+                        if (s[i] == '\\' && i + 1 < n) { if (s[i + 1] == '\n') ++line; i += 2; continue; }
+                        if (s[i] == '\n') break; // unterminated; recover at end of line
+                        ++i;
+                    }
+                    if (i < n && s[i] == c) ++i;
+                    push(TokKind::String, b, i, startLine);
+                    continue;
+                }
+
+                if (c == ':' && i + 1 < n && s[i + 1] == ':') { push(TokKind::Punct, i, i + 2, line); i += 2; continue; }
+                push(TokKind::Punct, i, i + 1, line);
+                ++i;
+            }
+            return out;
+        }
+
+        // Joins type tokens back into readable C++ ("std::vector<int>", "const Foo*").
+        static std::string JoinTokens(const std::vector<Token>& toks, size_t b, size_t e)
+        {
+            std::string out;
+            for (size_t i = b; i < e; ++i) {
+                const auto& t = toks[i];
+                const bool tight = t.Is("::") || t.Is("<") || t.Is(">") || t.Is(",") || t.Is("*") ||
+                                   t.Is("&") || t.Is("[") || t.Is("]") || t.Is(")") || t.Is("(");
+                const bool prevTight = !out.empty() && (out.back() == ':' || out.back() == '<' || out.back() == '(' || out.back() == '[');
+                if (!out.empty() && !tight && !prevTight) out.push_back(' ');
+                out.append(t.Text);
+                if (t.Is(",")) out.push_back(' ');
+            }
+            return out;
+        }
+
+        static std::string Unquote(std::string_view v)
+        {
+            if (v.size() >= 2 && v.front() == '"' && v.back() == '"') return std::string(v.substr(1, v.size() - 2));
+            return std::string(v);
+        }
+
+        class Parser {
+        public:
+            explicit Parser(std::vector<Token> toks) : T(std::move(toks)) {}
+
+            ParsedHeader Run()
+            {
+                Stack.push_back(Scope{ScopeKind::Namespace});
+                while (P < T.size()) Step();
+                return std::move(Out);
+            }
+
+        private:
+            enum class ScopeKind { Namespace, Class, Other };
+
+            struct Scope {
+                explicit Scope(ScopeKind kind) : Kind(kind) {}
+
+                ScopeKind Kind = ScopeKind::Other;
+                std::optional<ParsedClass> Class;
+                std::string Access;
+                bool Templated = false;
+            };
+
+            std::vector<Token> T;
+            size_t P = 0;
+            std::vector<Scope> Stack;
+            ParsedHeader Out;
+            bool PendingTemplate = false;
+
+            const Token* Peek(size_t ahead = 0) const { return (P + ahead < T.size()) ? &T[P + ahead] : nullptr; }
+            bool PeekIs(size_t ahead, std::string_view s) const { auto* t = Peek(ahead); return t && t->Is(s); }
+
+            void Error(int line, std::string msg)   { Out.Errors.push_back({line, std::move(msg)}); }
+            void Warning(int line, std::string msg) { Out.Warnings.push_back({line, std::move(msg)}); }
+
+            // Skips a balanced (), [], {} or <> group starting at P; leaves P after the closer.
+            void SkipGroup(char open, char close)
+            {
+                int depth = 0;
+                while (P < T.size()) {
+                    const auto& t = T[P++];
+                    if (t.Kind != TokKind::Punct) continue;
+                    if (t.Text[0] == open) ++depth;
+                    else if (t.Text[0] == close && --depth == 0) return;
+                }
+            }
+
+            void Step()
+            {
+                const Token& tok = T[P];
+                Scope& top = Stack.back();
+
+                if (top.Kind == ScopeKind::Other) {
+                    if (tok.Is("{")) Stack.push_back(Scope{ScopeKind::Other});
+                    else if (tok.Is("}")) PopScope(tok.Line);
+                    ++P;
+                    return;
+                }
+
+                if (tok.Is("}")) { PopScope(tok.Line); ++P; return; }
+                if (tok.Is("{")) { Stack.push_back(Scope{ScopeKind::Other}); PendingTemplate = false; ++P; return; }
+                if (tok.Is(";")) { PendingTemplate = false; ++P; return; }
+
+                if (tok.IsIdent()) {
+                    if (tok.Is("namespace")) { ParseNamespace(); return; }
+                    if (tok.Is("extern") && Peek(1) && Peek(1)->Kind == TokKind::String && PeekIs(2, "{")) {
+                        Stack.push_back(Scope{ScopeKind::Namespace});
+                        P += 3;
+                        return;
+                    }
+                    if (tok.Is("template")) {
+                        ++P;
+                        if (PeekIs(0, "<")) SkipGroup('<', '>');
+                        PendingTemplate = true;
+                        return;
+                    }
+                    if (tok.Is("enum")) {
+                        // enum [class] Name [: type] { ... } — body is never reflected
+                        while (P < T.size() && !T[P].Is("{") && !T[P].Is(";")) ++P;
+                        if (P < T.size() && T[P].Is("{")) SkipGroup('{', '}');
+                        return;
+                    }
+                    if (tok.Is("friend")) {
+                        while (P < T.size() && !T[P].Is(";") && !T[P].Is("{")) ++P;
+                        return;
+                    }
+                    if (tok.Is("class") || tok.Is("struct") || tok.Is("union")) { ParseClassHead(); return; }
+
+                    if (top.Kind == ScopeKind::Class) {
+                        if ((tok.Is("public") || tok.Is("protected") || tok.Is("private")) && PeekIs(1, ":")) {
+                            top.Access = std::string(tok.Text);
+                            P += 2;
+                            return;
+                        }
+                        if ((tok.Is("GENERATED_BODY") || tok.Is("ACE_GENERATED_BODY")) && PeekIs(1, "(")) {
+                            if (top.Class->BodyLine != 0) Error(tok.Line, "GENERATED_BODY() used twice in '" + top.Class->Name + "'");
+                            top.Class->BodyLine     = tok.Line;
+                            top.Class->AccessAtBody = top.Access;
+                            ++P;
+                            SkipGroup('(', ')');
+                            return;
+                        }
+                        if ((tok.Is("ACE_PROPERTY") || tok.Is("UPROPERTY")) && PeekIs(1, "(")) { ParseProperty(top); return; }
+                        if ((tok.Is("ACE_FUNCTION") || tok.Is("UFUNCTION")) && PeekIs(1, "(")) { ParseFunction(top); return; }
+                    }
+                }
+                ++P;
+            }
+
+            void PopScope(int line)
+            {
+                if (Stack.size() <= 1) { Error(line, "unbalanced '}'"); return; }
+                Scope s = std::move(Stack.back());
+                Stack.pop_back();
+                if (s.Kind != ScopeKind::Class || !s.Class) return;
+
+                ParsedClass& c = *s.Class;
+                if (c.BodyLine == 0) {
+                    if (!c.Properties.empty() || !c.Functions.empty())
+                        Warning(line, "'" + c.Name + "' has ACE_PROPERTY/ACE_FUNCTION but no GENERATED_BODY(); ignored");
+                    return;
+                }
+                if (s.Templated) { Error(c.BodyLine, "class templates cannot be reflected ('" + c.Name + "')"); return; }
+                if (c.Name.empty()) { Error(c.BodyLine, "anonymous classes cannot be reflected"); return; }
+                for (size_t i = 0; i < c.Functions.size(); ++i)
+                    for (size_t k = i + 1; k < c.Functions.size(); ++k)
+                        if (c.Functions[i].Name == c.Functions[k].Name)
+                            Error(c.Functions[k].Line, "overloaded ACE_FUNCTION '" + c.Functions[k].Name + "' is not supported");
+                Out.Classes.push_back(std::move(c));
+            }
+
+            void ParseNamespace()
+            {
+                ++P;
+                while (P < T.size() && !T[P].Is("{") && !T[P].Is(";") && !T[P].Is("=")) ++P;
+                if (P < T.size() && T[P].Is("{")) { Stack.push_back(Scope{ScopeKind::Namespace}); ++P; return; }
+                while (P < T.size() && !T[P].Is(";")) ++P; // namespace alias
+            }
+
+            void ParseClassHead()
+            {
+                const size_t start = P;
+                const bool isStruct = !T[P].Is("class");
+                const bool templated = PendingTemplate;
+                PendingTemplate = false;
+                ++P;
+
+                // Skip attributes, alignas(...), ACE_CLASS(...) / export macros
+                std::string name;
+                while (P < T.size()) {
+                    if (T[P].Is("[") && PeekIs(1, "[")) { SkipGroup('[', ']'); continue; }
+                    if (T[P].IsIdent() && PeekIs(1, "(")) { ++P; SkipGroup('(', ')'); continue; }
+                    if (T[P].IsIdent() && !T[P].Is("final")) {
+                        name = std::string(T[P].Text);
+                        ++P;
+                        while (PeekIs(0, "::") && Peek(1) && Peek(1)->IsIdent()) { name = std::string(T[P + 1].Text); P += 2; }
+                        // "class ACE_API Name" — previous identifier was a macro
+                        if (Peek() && Peek()->IsIdent() && !Peek()->Is("final")) continue;
+                    }
+                    break;
+                }
+                if (PeekIs(0, "final")) ++P;
+
+                std::string super;
+                if (PeekIs(0, ":")) {
+                    ++P;
+                    while (Peek() && (Peek()->Is("public") || Peek()->Is("protected") || Peek()->Is("private") || Peek()->Is("virtual"))) ++P;
+                    const size_t b = P;
+                    int angle = 0;
+                    while (P < T.size()) {
+                        const auto& t = T[P];
+                        if (t.Is("<")) ++angle;
+                        else if (t.Is(">")) --angle;
+                        else if (angle == 0 && (t.Is(",") || t.Is("{") || t.Is(";"))) break;
+                        ++P;
+                    }
+                    super = JoinTokens(T, b, P);
+                    while (P < T.size() && !T[P].Is("{") && !T[P].Is(";")) ++P; // remaining bases
+                }
+
+                if (!PeekIs(0, "{")) { P = start + 1; return; } // forward decl or elaborated type
+
+                Scope s{ScopeKind::Class};
+                s.Class.emplace();
+                s.Class->Name      = name;
+                s.Class->SuperName = super;
+                s.Class->IsStruct  = isStruct;
+                s.Access           = isStruct ? "public" : "private";
+                s.Templated        = templated;
+                Stack.push_back(std::move(s));
+                ++P;
+            }
+
+            std::vector<Specifier> ParseSpecifiers()
+            {
+                std::vector<Specifier> specs;
+                ++P; // macro name
+                const size_t open = P;
+                SkipGroup('(', ')');
+                const size_t close = P - 1;
+                size_t i = open + 1;
+                while (i < close) {
+                    Specifier sp;
+                    size_t b = i;
+                    int depth = 0;
+                    while (i < close && !(depth == 0 && T[i].Is(","))) {
+                        if (T[i].Is("(")) ++depth; else if (T[i].Is(")")) --depth;
+                        ++i;
+                    }
+                    if (b < i) {
+                        sp.Key = std::string(T[b].Text);
+                        if (b + 2 <= i && T[b + 1].Is("=")) {
+                            std::string v;
+                            for (size_t k = b + 2; k < i; ++k) v += Unquote(T[k].Text);
+                            sp.Value = std::move(v);
+                        }
+                        specs.push_back(std::move(sp));
+                    }
+                    ++i; // ','
+                }
+                return specs;
+            }
+
+            void ParseProperty(Scope& scope)
+            {
+                const int line = T[P].Line;
+                auto specs = ParseSpecifiers();
+
+                std::vector<Token> decl;
+                int depth = 0;
+                while (P < T.size()) {
+                    const auto& t = T[P];
+                    if (depth == 0 && t.Is(";")) break;
+                    if (t.Is("(") || t.Is("{") || t.Is("[")) ++depth;
+                    else if (t.Is(")") || t.Is("}") || t.Is("]")) --depth;
+                    decl.push_back(t);
+                    ++P;
+                }
+                ++P; // ';'
+
+                // Declarator ends at the initializer, array bound or bitfield width
+                size_t end = decl.size();
+                int angle = 0;
+                for (size_t i = 0; i < decl.size(); ++i) {
+                    const auto& t = decl[i];
+                    if (t.Is("<")) ++angle;
+                    else if (t.Is(">")) --angle;
+                    else if (angle == 0 && (t.Is("=") || t.Is("{") || t.Is("[") || t.Is(":"))) { end = i; break; }
+                    else if (angle == 0 && t.Is(",")) { Error(line, "declare one member per ACE_PROPERTY"); return; }
+                }
+                if (end < decl.size() && decl[end].Is(":")) { Error(line, "bitfields cannot be ACE_PROPERTY"); return; }
+                if (end < 2 || !decl[end - 1].IsIdent()) { Error(line, "could not parse ACE_PROPERTY declaration"); return; }
+
+                size_t typeBegin = 0;
+                for (size_t i = 0; i + 1 < end; ++i) {
+                    if (decl[i].Is("static")) { Error(line, "static members cannot be ACE_PROPERTY"); return; }
+                    if (decl[i].Is("mutable") && i == typeBegin) ++typeBegin;
+                }
+                if (decl[end - 2].Is("&")) { Error(line, "reference members cannot be ACE_PROPERTY"); return; }
+
+                // Array bounds belong to the type: "float Weights[3]" is a float[3]
+                size_t extentEnd = end;
+                for (int d = 0; extentEnd < decl.size(); ++extentEnd) {
+                    if (decl[extentEnd].Is("[")) ++d;
+                    else if (decl[extentEnd].Is("]")) --d;
+                    else if (d == 0) break;
+                }
+
+                ParsedProperty prop;
+                prop.Name       = std::string(decl[end - 1].Text);
+                prop.TypeName   = JoinTokens(decl, typeBegin, end - 1) + JoinTokens(decl, end, extentEnd);
+                prop.Specifiers = std::move(specs);
+                prop.Line       = line;
+                scope.Class->Properties.push_back(std::move(prop));
+            }
+
+            void ParseFunction(Scope& scope)
+            {
+                const int line = T[P].Line;
+                auto specs = ParseSpecifiers();
+
+                ParsedFunction fn;
+                fn.Specifiers = std::move(specs);
+                fn.Line = line;
+
+                // Declaration runs to ';' or to the start of an inline body
+                size_t nameIdx = 0, parenOpen = 0, parenClose = 0;
+                int depth = 0;
+                const size_t b = P;
+                while (P < T.size()) {
+                    const auto& t = T[P];
+                    if (depth == 0 && (t.Is(";") || t.Is("{"))) break;
+                    if (t.Is("(")) {
+                        if (depth == 0 && parenOpen == 0) { parenOpen = P; nameIdx = P - 1; }
+                        ++depth;
+                    } else if (t.Is(")")) {
+                        if (--depth == 0 && parenClose == 0) parenClose = P;
+                    }
+                    ++P;
+                }
+                const size_t e = P;
+                if (P < T.size() && T[P].Is("{")) SkipGroup('{', '}');
+                else ++P;
+
+                if (parenOpen == 0 || nameIdx < b || !T[nameIdx].IsIdent()) { Error(line, "could not parse ACE_FUNCTION declaration"); return; }
+                for (size_t i = b; i < nameIdx; ++i) {
+                    if (T[i].Is("operator")) { Error(line, "operators cannot be ACE_FUNCTION"); return; }
+                    if (T[i].Is("static")) fn.IsStatic = true;
+                }
+                for (size_t i = parenClose + 1; i < e; ++i) {
+                    if (T[i].Is("const")) fn.IsConst = true;
+                    if (T[i].Is("=")) break;
+                }
+                fn.Name = std::string(T[nameIdx].Text);
+                if (fn.Name == scope.Class->Name) { Error(line, "constructors cannot be ACE_FUNCTION"); return; }
+                if (nameIdx > b && T[nameIdx - 1].Is("~")) { Error(line, "destructors cannot be ACE_FUNCTION"); return; }
+                scope.Class->Functions.push_back(std::move(fn));
+            }
+        };
+    }
+
+    bool HasReflectionMarkup(std::string_view text)
+    {
+        return text.find("GENERATED_BODY") != std::string_view::npos;
+    }
+
+    ParsedHeader ParseHeader(std::string_view text)
+    {
+        Parser p(Tokenize(text));
+        return p.Run();
+    }
+}
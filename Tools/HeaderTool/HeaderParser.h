@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ace::hdr {
+    // One "Key" or "Key=Value" entry from ACE_PROPERTY(...) / ACE_FUNCTION(...)
+    struct Specifier {
+        std::string Key;
+        std::string Value;
+    };
+
+    struct ParsedProperty {
+        std::string Name;
+        std::string TypeName;
+        std::vector<Specifier> Specifiers;
+        int Line = 0;
+    };
+
+    struct ParsedFunction {
+        std::string Name;
+        std::vector<Specifier> Specifiers;
+        bool IsStatic = false;
+        bool IsConst  = false;
+        int Line = 0;
+    };
+
+    struct ParsedClass {
+        std::string Name;
+        std::string SuperName;          // first base, empty if none
+        bool        IsStruct = false;
+        int         BodyLine = 0;       // line of GENERATED_BODY()
+        std::string AccessAtBody;       // "public" / "protected" / "private"
+        std::vector<ParsedProperty> Properties;
+        std::vector<ParsedFunction> Functions;
+    };
+
+    struct ParseMessage {
+        int Line = 0;
+        std::string Text;
+    };
+
+    struct ParsedHeader {
+        std::vector<ParsedClass>  Classes;     // only classes containing GENERATED_BODY()
+        std::vector<ParseMessage> Errors;
+        std::vector<ParseMessage> Warnings;
+    };
+
+    // Cheap pre-check so unreflected headers are never tokenized.
+    bool HasReflectionMarkup(std::string_view text);
+
+    // Lightweight C++ scanner: understands namespaces, class/struct bodies, access
+    // specifiers and the ACE_* markup. It does not need a preprocessor or includes.
+    ParsedHeader ParseHeader(std::string_view text);
+}
@@ -0,0 +1,44 @@
+﻿#include "HeaderCodegen.h"
+#include "Runtime/Project/Project.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// ACEHeaderTool <SourceDir> [--cache <file>] [--force] [--verbose]
+// ACEHeaderTool --project <Game.aceproj> [...]
+static void PrintUsage()
+{
+    std::cerr << "Usage: ACEHeaderTool <SourceDir> | --project <file.aceproj> [--cache <file>] [--force] [--verbose]\n";
+}
+
+int main(int argc, char** argv)
+{
+    ace::hdr::RunOptions opt;
+    std::filesystem::path projectFile;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if      (!std::strcmp(a, "--project") && i + 1 < argc) projectFile = argv[++i];
+        else if (!std::strcmp(a, "--cache")   && i + 1 < argc) opt.CacheFile = argv[++i];
+        else if (!std::strcmp(a, "--force"))   opt.Force = true;
+        else if (!std::strcmp(a, "--verbose")) opt.Verbose = true;
+        else if (a[0] != '-' && opt.SourceDir.empty()) opt.SourceDir = a;
+        else { PrintUsage(); return 2; }
+    }
+
+    if (!projectFile.empty()) {
+        auto proj = ace::Project::Load(projectFile);
+        if (!proj) { std::cerr << projectFile.string() << ": error: cannot load project\n"; return 2; }
+        opt.SourceDir = proj->SourceDir();
+        if (opt.CacheFile.empty()) opt.CacheFile = proj->IntermediateDir() / "HeaderTool" / "Cache.json";
+    }
+    if (opt.SourceDir.empty()) { PrintUsage(); return 2; }
+
+    ace::hdr::RunStats stats;
+    const bool ok = ace::hdr::RunIncremental(opt, stats);
+    for (const auto& m : stats.Messages) std::cerr << m << "\n";
+
+    std::printf("ACEHeaderTool: %zu headers, %zu parsed, %zu written, %zu removed, %zu error(s) in %.3fs\n",
+                stats.Headers, stats.Parsed, stats.Written, stats.Removed, stats.Errors, stats.Seconds);
+    return ok ? 0 : 1;
+}